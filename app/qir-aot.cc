@@ -0,0 +1,70 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qir-aot/qir-aot.cc
+//---------------------------------------------------------------------------//
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <CLI/CLI.hpp>
+
+#include "qiree_version.h"
+
+#include "qiree/AotCompiler.hh"
+#include "qiree/Module.hh"
+
+//---------------------------------------------------------------------------//
+/*!
+ * Compile QIR to a shared library loadable by QIR-EE.
+ */
+int main(int argc, char* argv[])
+{
+    std::string filename;
+    std::string output;
+    bool object_only{false};
+    qiree::AotCompiler::Options opts;
+
+    CLI::App app{"Compile QIR ahead of time for QIR-EE"};
+    app.add_option("--input,-i,input", filename, "QIR input file")
+        ->required();
+    app.add_option("-o,--output", output, "Output shared library")
+        ->required();
+    app.add_flag("-c,--object",
+                 object_only,
+                 "Write a relocatable object file rather than a library");
+    auto* opt_level_opt = app.add_option(
+        "-O,--opt-level", opts.opt_level, "LLVM optimization level");
+    opt_level_opt->transform(CLI::CheckedTransformer(
+        std::map<std::string, qiree::AotCompiler::OptLevel>{
+            {"0", qiree::AotCompiler::OptLevel::O0},
+            {"1", qiree::AotCompiler::OptLevel::O1},
+            {"2", qiree::AotCompiler::OptLevel::O2},
+            {"3", qiree::AotCompiler::OptLevel::O3},
+        }));
+    opt_level_opt->default_str("2");
+    app.add_flag("--qis-inaccessible-memory",
+                 opts.qis_inaccessible_memory,
+                 "Let the optimizer assume quantum operations do not access "
+                 "classical memory");
+    app.add_flag("--host-cpu",
+                 opts.host_cpu,
+                 "Tune for the host CPU (the library may not run elsewhere)");
+    app.add_option("--linker", opts.linker, "Compiler driver used to link");
+
+    CLI11_PARSE(app, argc, argv);
+
+    qiree::AotCompiler compile{opts};
+    qiree::Module mod{filename};
+    if (object_only)
+    {
+        compile.compile(std::move(mod), output);
+    }
+    else
+    {
+        compile(std::move(mod), output);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,123 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qir-dispatch-bench/qir-dispatch-bench.cc
+//---------------------------------------------------------------------------//
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <CLI/CLI.hpp>
+
+#include "qiree/DirectExecutor.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree/Stopwatch.hh"
+#include "qirsim/HistogramRuntime.hh"
+#include "qirsim/StateVectorQuantum.hh"
+
+namespace qiree
+{
+namespace app
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Execute a program repeatedly and return the wall time.
+ */
+template<class E>
+double time_execution(E const& execute, size_type num_repeats)
+{
+    StateVectorQuantum sim;
+    HistogramRuntime rt{sim};
+    Stopwatch get_time;
+    for (size_type i = 0; i < num_repeats; ++i)
+    {
+        execute(sim, rt);
+        rt.end_shot();
+    }
+    return get_time();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Time each program with virtual and statically dispatched QIR functions.
+ */
+void run(std::vector<std::string> const& filenames,
+         Executor::Options const& opts,
+         size_type num_repeats)
+{
+    std::cout << std::left << std::setw(24) << "program" << std::right
+              << std::setw(14) << "virtual (s)" << std::setw(14)
+              << "direct (s)" << std::setw(10) << "speedup" << std::endl;
+
+    for (auto const& filename : filenames)
+    {
+        double virtual_time{0};
+        double direct_time{0};
+        try
+        {
+            Executor virtual_execute{Module{filename}, opts};
+            virtual_time = time_execution(virtual_execute, num_repeats);
+
+            DirectExecutor<StateVectorQuantum, HistogramRuntime>
+                direct_execute{Module{filename}, opts};
+            direct_time = time_execution(direct_execute, num_repeats);
+        }
+        catch (std::exception const& e)
+        {
+            std::cerr << filename << ": skipped: " << e.what() << std::endl;
+            continue;
+        }
+
+        auto name = filename.substr(filename.find_last_of('/') + 1);
+        std::cout << std::left << std::setw(24) << name << std::right
+                  << std::setw(14) << virtual_time << std::setw(14)
+                  << direct_time << std::setw(10)
+                  << virtual_time / direct_time << std::endl;
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace app
+}  // namespace qiree
+
+//---------------------------------------------------------------------------//
+/*!
+ * Compare virtual and static dispatch of QIR functions to the simulator.
+ */
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> filenames;
+    qiree::size_type num_repeats{10};
+    qiree::Executor::Options opts;
+    opts.opt_level = qiree::Executor::OptLevel::O2;
+
+    CLI::App app;
+    auto* filename_opt
+        = app.add_option("--input,-i,input", filenames, "QIR programs");
+    filename_opt->required();
+    auto* repeat_opt = app.add_option(
+        "-r,--repeat", num_repeats, "Number of executions of each program");
+    repeat_opt->capture_default_str();
+    auto* opt_level_opt = app.add_option(
+        "-O,--opt-level", opts.opt_level, "LLVM optimization level");
+    opt_level_opt->transform(CLI::CheckedTransformer(
+        std::map<std::string, qiree::Executor::OptLevel>{
+            {"0", qiree::Executor::OptLevel::O0},
+            {"1", qiree::Executor::OptLevel::O1},
+            {"2", qiree::Executor::OptLevel::O2},
+            {"3", qiree::Executor::OptLevel::O3},
+        }));
+    opt_level_opt->default_str("2");
+
+    CLI11_PARSE(app, argc, argv);
+
+    qiree::app::run(filenames, opts, num_repeats);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,270 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qir-fusion-bench/qir-fusion-bench.cc
+//---------------------------------------------------------------------------//
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <CLI/CLI.hpp>
+
+#include "qiree/Circuit.hh"
+#include "qiree/Executor.hh"
+#include "qiree/MemManager.hh"
+#include "qiree/Module.hh"
+#include "qiree/RuntimeInterface.hh"
+#include "qiree/Stopwatch.hh"
+#include "qirsim/CircuitRecorder.hh"
+#include "qirsim/StateVectorQuantum.hh"
+#include "qirsim/detail/GateFusion.hh"
+
+namespace qiree
+{
+namespace app
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Runtime that discards output so that programs can be recorded.
+ */
+class DiscardRuntime final : virtual public RuntimeInterface
+{
+  public:
+    Array array_create_1d(uint32_t elem_size, uint64_t length) final
+    {
+        return MemManager::array_create_1d(elem_size, length);
+    }
+    void array_update_reference_count(Array array, int32_t delta) final
+    {
+        MemManager::array_update_reference_count(array, delta);
+    }
+    void* array_get_element_ptr_1d(Array array, uint64_t index) final
+    {
+        return MemManager::array_get_element_ptr_1d(array, index);
+    }
+    uint64_t array_get_size_1d(Array array) final
+    {
+        return MemManager::array_get_size_1d(array);
+    }
+    Tuple tuple_create(uint64_t num_bytes) final
+    {
+        return MemManager::tuple_create(num_bytes);
+    }
+    void tuple_update_reference_count(Tuple tuple, int32_t delta) final
+    {
+        MemManager::tuple_update_reference_count(tuple, delta);
+    }
+
+    void initialize(OptionalCString) final {}
+    void array_record_output(size_type, OptionalCString) final {}
+    void tuple_record_output(size_type, OptionalCString) final {}
+    void result_record_output(Result, OptionalCString) final {}
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Repeat a circuit on consecutive blocks of qubits.
+ *
+ * Each copy acts on its own qubits and measures into its own results, so the
+ * copies are independent executions of the original program.
+ */
+Circuit tile(Circuit const& c,
+             size_type num_qubits,
+             size_type num_results,
+             size_type num_copies)
+{
+    Circuit result;
+    result.reserve(c.size() * num_copies, c.num_operands() * num_copies);
+    Circuit::Operation op;
+    for (size_type copy = 0; copy < num_copies; ++copy)
+    {
+        auto const offset = static_cast<Circuit::Index>(copy * num_qubits);
+        for (size_type i = 0; i < c.size(); ++i)
+        {
+            auto const ref = c[i];
+            op.op = ref.op;
+            op.controls.assign(ref.controls,
+                               ref.controls + ref.num_controls);
+            op.targets.assign(ref.targets, ref.targets + ref.num_targets);
+            for (auto& q : op.controls)
+            {
+                q += offset;
+            }
+            for (auto& q : op.targets)
+            {
+                q += offset;
+            }
+            op.paulis.clear();
+            if (has_paulis(ref.op))
+            {
+                op.paulis.assign(ref.paulis, ref.paulis + ref.num_targets);
+            }
+            op.theta = ref.theta;
+            op.result = Result{ref.result.value + copy * num_results};
+            result.push_back(op);
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Number of sweeps of the state vector needed to apply the gates.
+ */
+size_type count_sweeps(Circuit const& c, detail::FusedCircuit const& fused)
+{
+    size_type result{0};
+    for (auto const& step : fused.steps)
+    {
+        if (step.num_qubits > 0 || detail::is_unitary(c.op(step.begin)))
+        {
+            ++result;
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute a circuit on a state vector and return the wall time.
+ */
+double time_execution(Circuit const& c,
+                      size_type num_qubits,
+                      size_type num_results,
+                      bool fuse)
+{
+    StateVectorQuantum::Options opts;
+    opts.max_qubits = num_qubits;
+    StateVectorQuantum sim{opts};
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = num_qubits;
+    attrs.required_num_results = num_results;
+    sim.set_up(attrs);
+
+    Stopwatch get_time;
+    if (fuse)
+    {
+        sim.apply(c);
+    }
+    else
+    {
+        replay(c, sim);
+    }
+    double const result = get_time();
+    sim.tear_down();
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record each program, scale it up, and report the sweeps saved by fusion.
+ */
+void run(std::vector<std::string> const& filenames,
+         size_type min_qubits,
+         bool execute)
+{
+    std::cout << std::left << std::setw(24) << "program" << std::right
+              << std::setw(8) << "qubits" << std::setw(8) << "gates";
+    for (size_type k = 1; k <= detail::max_dense_qubits; ++k)
+    {
+        std::cout << std::setw(7) << "k=" << k;
+    }
+    std::cout << std::setw(8) << "chosen" << std::setw(8) << "saved";
+    if (execute)
+    {
+        std::cout << std::setw(12) << "time (s)" << std::setw(12) << "fused";
+    }
+    std::cout << std::endl;
+
+    detail::FusedCircuit fused;
+    for (auto const& filename : filenames)
+    {
+        // Record the straight-line program
+        CircuitRecorder rec;
+        try
+        {
+            Executor execute_program{Module{filename}};
+            DiscardRuntime rt;
+            execute_program(rec, rt);
+        }
+        catch (std::exception const& e)
+        {
+            std::cerr << filename << ": skipped: " << e.what() << std::endl;
+            continue;
+        }
+        if (rec.num_qubits() == 0)
+        {
+            std::cerr << filename << ": skipped: no qubits" << std::endl;
+            continue;
+        }
+
+        size_type const num_copies
+            = (min_qubits + rec.num_qubits() - 1) / rec.num_qubits();
+        size_type const num_qubits = num_copies * rec.num_qubits();
+        size_type const num_results = num_copies * rec.num_results();
+        Circuit const c = tile(
+            rec.circuit(), rec.num_qubits(), rec.num_results(), num_copies);
+
+        detail::fuse_gates(c, 0, &fused);
+        size_type const num_gates = count_sweeps(c, fused);
+        auto name = filename.substr(filename.find_last_of('/') + 1);
+        std::cout << std::left << std::setw(24) << name << std::right
+                  << std::setw(8) << num_qubits << std::setw(8) << num_gates;
+        for (size_type k = 1; k <= detail::max_dense_qubits; ++k)
+        {
+            detail::fuse_gates(c, k, &fused);
+            std::cout << std::setw(8) << count_sweeps(c, fused);
+        }
+        size_type const chosen
+            = detail::fuse_gates_min_cost(c, num_qubits, &fused);
+        size_type const saved = num_gates - count_sweeps(c, fused);
+        std::cout << std::setw(8) << chosen << std::setw(8) << saved;
+        if (execute)
+        {
+            std::cout << std::setw(12)
+                      << time_execution(c, num_qubits, num_results, false)
+                      << std::setw(12)
+                      << time_execution(c, num_qubits, num_results, true);
+        }
+        std::cout << std::endl;
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace app
+}  // namespace qiree
+
+//---------------------------------------------------------------------------//
+/*!
+ * Report the state vector sweeps saved by fusing gates.
+ */
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> filenames;
+    qiree::size_type min_qubits{28};
+    bool execute{false};
+
+    CLI::App app;
+    auto* filename_opt = app.add_option(
+        "--input,-i,input", filenames, "QIR programs without feed-forward");
+    filename_opt->required();
+    auto* qubits_opt = app.add_option(
+        "-n,--num-qubits",
+        min_qubits,
+        "Minimum number of qubits after repeating each program");
+    qubits_opt->capture_default_str();
+    app.add_flag("--execute",
+                 execute,
+                 "Time the programs on the statevector simulator with and "
+                 "without fusion (16 * 2^n bytes of memory)");
+
+    CLI11_PARSE(app, argc, argv);
+
+    qiree::app::run(filenames, min_qubits, execute);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,466 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qir-sim/qir-sim.cc
+//---------------------------------------------------------------------------//
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <CLI/CLI.hpp>
+
+#include "qiree_version.h"
+
+#include "qiree/Assert.hh"
+#include "qiree/DirectExecutor.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree/ObjectCache.hh"
+#include "qiree/Stopwatch.hh"
+#include "qirsim/Backend.hh"
+#include "qirsim/BranchingShots.hh"
+#include "qirsim/ClassicalBitQuantum.hh"
+#include "qirsim/HistogramRuntime.hh"
+#include "qirsim/MpsQuantum.hh"
+#include "qirsim/NoiseModel.hh"
+#include "qirsim/OptimizingQuantum.hh"
+#include "qirsim/ParallelShots.hh"
+#include "qirsim/PauliFrameQuantum.hh"
+#include "qirsim/StateVectorQuantum.hh"
+
+namespace qiree
+{
+namespace app
+{
+//---------------------------------------------------------------------------//
+//! How shots are executed
+enum class ShotMode
+{
+    serial,  //!< Execute the program once per shot
+    parallel,  //!< Execute shots on several threads
+    sampled,  //!< Execute once and sample terminal measurements
+    branching,  //!< Execute once per distinct measurement history
+    exact,  //!< Execute every measurement history with its probability
+};
+
+char const* to_cstring(ShotMode mode)
+{
+    static char const* const strings[]
+        = {"serial", "parallel", "sampled", "branching", "exact"};
+    return strings[static_cast<int>(mode)];
+}
+
+//! Options for executing shots
+struct ShotOptions
+{
+    size_type num_shots{1024};
+    unsigned int num_threads{1};
+    bool sample_terminal{true};
+    bool share_prefixes{true};
+    bool exact{false};
+    double prune_threshold{0};
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Compile and run all shots with a given simulator.
+ *
+ * With the state vector simulator, a program whose measurements are all
+ * terminal is executed once and the remaining shots are sampled from its
+ * final state; otherwise shots that share measurement outcomes are executed
+ * together. The Pauli frame simulator always executes once and samples every
+ * shot from the recorded program, and the deterministic classical simulator
+ * executes once for all shots. Shots may instead execute the program
+ * independently, optionally spread over several threads with separate
+ * simulators. Programs whose instructions are optimized before simulation
+ * execute serially.
+ */
+template<class QI>
+void run_shots(Module&& mod,
+               QI& sim,
+               ShotOptions const& shot_opts,
+               SimulatorOptions const& sim_opts,
+               bool group_tuples,
+               bool print_time,
+               Executor::Options const& exec_opts)
+{
+    ShotMode mode = shot_opts.num_threads == 1 ? ShotMode::serial
+                                               : ShotMode::parallel;
+    if constexpr (std::is_same_v<QI, StateVectorQuantum>)
+    {
+        if (shot_opts.exact)
+        {
+            mode = ShotMode::exact;
+        }
+        else if (shot_opts.sample_terminal && mod.has_terminal_measurements())
+        {
+            mode = ShotMode::sampled;
+        }
+        else if (mode == ShotMode::serial && shot_opts.share_prefixes)
+        {
+            mode = ShotMode::branching;
+        }
+    }
+    if constexpr (std::is_same_v<QI, PauliFrameQuantum>
+                  || std::is_same_v<QI, ClassicalBitQuantum>)
+    {
+        mode = ShotMode::sampled;
+    }
+    if constexpr (std::is_same_v<QI, OptimizingQuantum>)
+    {
+        // Optimized instructions are replayed on a single simulator
+        mode = ShotMode::serial;
+    }
+
+    QIREE_VALIDATE(!shot_opts.exact || mode == ShotMode::exact,
+                   << "exact distributions require the statevector backend");
+
+    // Simulator and runtime calls are statically dispatched
+    Stopwatch get_time;
+    DirectExecutor<QI, HistogramRuntime> execute{std::move(mod), exec_opts};
+    double const compile_time = get_time();
+
+    HistogramRuntime rt{sim};
+    size_type const num_shots = shot_opts.num_shots;
+    get_time = {};
+    if constexpr (std::is_same_v<QI, StateVectorQuantum>)
+    {
+        if (mode == ShotMode::sampled && num_shots > 0)
+        {
+            sim.defer_measurements(true);
+            execute(sim, rt);
+            rt.end_shot();
+            for (size_type i = 1; i < num_shots; ++i)
+            {
+                sim.resample();
+                rt.repeat_shot();
+            }
+        }
+        else if (mode == ShotMode::branching)
+        {
+            run_branching_shots(execute, sim, rt, num_shots);
+        }
+        else if (mode == ShotMode::exact)
+        {
+            enumerate_branches(execute, sim, rt, shot_opts.prune_threshold);
+            if (sim.pruned_probability() > 0)
+            {
+                std::cerr << "pruned probability: "
+                          << sim.pruned_probability() << std::endl;
+            }
+        }
+    }
+    if constexpr (std::is_same_v<QI, PauliFrameQuantum>)
+    {
+        if (num_shots > 0)
+        {
+            execute(sim, rt);
+            rt.end_shot();
+            for (size_type i = 1; i < num_shots; ++i)
+            {
+                sim.next_shot();
+                rt.repeat_shot();
+            }
+        }
+    }
+    if constexpr (std::is_same_v<QI, ClassicalBitQuantum>)
+    {
+        if (num_shots > 0)
+        {
+            execute(sim, rt);
+            rt.end_shot(num_shots);
+        }
+    }
+    if (mode == ShotMode::parallel)
+    {
+        if constexpr (!std::is_same_v<QI, OptimizingQuantum>)
+        {
+            unsigned int num_threads = shot_opts.num_threads;
+            run_parallel_shots<QI>(execute,
+                                   simulator_options<QI>(sim_opts),
+                                   num_shots,
+                                   num_threads > 0 ? num_threads
+                                                   : default_num_threads(),
+                                   rt);
+        }
+    }
+    else if (mode == ShotMode::serial)
+    {
+        double max_discarded = 0;
+        for (size_type i = 0; i < num_shots; ++i)
+        {
+            execute(sim, rt);
+            rt.end_shot();
+            if constexpr (std::is_same_v<QI, MpsQuantum>)
+            {
+                max_discarded
+                    = std::max(max_discarded, sim.discarded_weight());
+            }
+        }
+        if constexpr (std::is_same_v<QI, MpsQuantum>)
+        {
+            std::cerr << "discarded weight: " << max_discarded
+                      << " (largest of any shot)" << std::endl;
+        }
+    }
+    double const run_time = get_time();
+
+    if (mode == ShotMode::exact)
+    {
+        rt.print_probabilities(std::cout);
+    }
+    else if (group_tuples)
+    {
+        rt.print_tuples(std::cout);
+    }
+    else
+    {
+        rt.print_results(std::cout);
+    }
+
+    if (print_time)
+    {
+        std::cerr << "time (s): compile " << compile_time << " (optimize ("
+                  << to_cstring(exec_opts.opt_level) << ") "
+                  << execute.executor().timing().optimize << ", build "
+                  << execute.executor().timing().build << "), execute "
+                  << run_time << " (" << to_cstring(mode) << " shots)"
+                  << std::endl;
+    }
+}
+
+//---------------------------------------------------------------------------//
+void run(std::string const& filename,
+         std::string const& backend_name,
+         ShotOptions const& shot_opts,
+         SimulatorOptions const& sim_opts,
+         bool group_tuples,
+         bool optimize_circuit,
+         bool print_time,
+         Executor::Options const& exec_opts)
+{
+    Stopwatch get_time;
+    Module mod{filename};
+    if (print_time)
+    {
+        std::cerr << "time (s): load " << get_time() << std::endl;
+    }
+
+    // Choose the simulator
+    Backend backend{Backend::size_};
+    if (backend_name == "auto")
+    {
+        backend = select_backend(mod);
+        std::cerr << "backend: " << to_cstring(backend) << " ("
+                  << to_cstring(classify_gate_set(mod.load_qis_functions()))
+                  << " gates)" << std::endl;
+    }
+    for (int i = 0; i < static_cast<int>(Backend::size_); ++i)
+    {
+        if (backend_name == to_cstring(static_cast<Backend>(i)))
+        {
+            backend = static_cast<Backend>(i);
+        }
+    }
+    QIREE_VALIDATE(backend != Backend::size_,
+                   << "unknown backend '" << backend_name << "'");
+    QIREE_VALIDATE(
+        !sim_opts.noise || backend == Backend::density
+            || backend == Backend::frame,
+        << "noise models require the density or frame backend");
+    QIREE_VALIDATE(!optimize_circuit || shot_opts.num_threads == 1,
+                   << "circuit optimization requires a single thread");
+    QIREE_VALIDATE(!optimize_circuit || !shot_opts.exact,
+                   << "exact distributions cannot be combined with circuit "
+                      "optimization");
+
+    visit_simulator(backend, sim_opts, [&](auto& sim) {
+        if (optimize_circuit)
+        {
+            OptimizingQuantum opt{sim};
+            run_shots(std::move(mod),
+                      opt,
+                      shot_opts,
+                      sim_opts,
+                      group_tuples,
+                      print_time,
+                      exec_opts);
+            opt.optimizer().print_counts(std::cerr);
+            return;
+        }
+        run_shots(std::move(mod),
+                  sim,
+                  shot_opts,
+                  sim_opts,
+                  group_tuples,
+                  print_time,
+                  exec_opts);
+    });
+
+    if (auto const& cache = exec_opts.object_cache)
+    {
+        std::cerr << "object cache '" << cache->directory()
+                  << "': " << cache->hits() << " hits, " << cache->misses()
+                  << " misses" << std::endl;
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace app
+}  // namespace qiree
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute and run.
+ */
+int main(int argc, char* argv[])
+{
+    std::string filename;
+    std::string backend{"statevector"};
+    qiree::app::ShotOptions shot_opts;
+    qiree::SimulatorOptions sim_opts;
+    bool group_tuples{false};
+    bool optimize_circuit{false};
+    bool print_time{false};
+    qiree::Executor::Options exec_opts;
+    std::string cache_dir;
+    std::string noise_model;
+
+    CLI::App app;
+    auto* filename_opt
+        = app.add_option("--input,-i,input", filename, "QIR input file");
+    filename_opt->required();
+    auto* nshot_opt = app.add_option(
+        "-s,--shots", shot_opts.num_shots, "Number of shots");
+    nshot_opt->capture_default_str();
+    auto* backend_opt = app.add_option(
+        "-b,--backend",
+        backend,
+        "Simulation method (auto: cheapest simulator supporting the program)");
+    backend_opt->check(CLI::IsMember(std::vector<std::string>{
+        "auto",
+        "statevector",
+        "stabilizer",
+        "mps",
+        "density",
+        "frame",
+        "classical",
+        "sparse"}));
+    backend_opt->capture_default_str();
+    auto* seed_opt = app.add_option(
+        "--seed", sim_opts.seed, "Random number seed for measurements");
+    seed_opt->capture_default_str();
+    app.add_option("--max-qubits",
+                   sim_opts.max_qubits,
+                   "Maximum number of qubits (default depends on backend)");
+    app.add_option("--max-bond",
+                   sim_opts.max_bond,
+                   "Maximum bond dimension of the mps backend (default: 64)");
+    app.add_option("--truncation",
+                   sim_opts.truncation_threshold,
+                   "Largest squared weight discarded by each mps truncation "
+                   "(default: 1e-12)");
+    app.add_option("--max-support",
+                   sim_opts.max_support,
+                   "Maximum number of nonzero amplitudes of the sparse "
+                   "backend (default: 16777216)");
+    app.add_option("--fusion-qubits",
+                   sim_opts.fusion_qubits,
+                   "Maximum qubits per fused gate of the statevector backend "
+                   "with --optimize-circuit (default: chosen by cost)");
+    app.add_option("--noise-model",
+                   noise_model,
+                   "JSON file of gate and readout errors for the density "
+                   "and frame backends");
+    auto* threads_opt = app.add_option(
+        "-j,--threads",
+        shot_opts.num_threads,
+        "Number of threads that execute shots (0: one per core)");
+    threads_opt->capture_default_str();
+    app.add_flag("--sample-terminal,!--no-sample-terminal",
+                 shot_opts.sample_terminal,
+                 "Sample all shots from one execution if measurements are "
+                 "terminal (statevector only)");
+    app.add_flag("--share-prefixes,!--no-share-prefixes",
+                 shot_opts.share_prefixes,
+                 "Execute shots with the same measurement outcomes together "
+                 "(statevector with one thread only)");
+    app.add_flag("--exact",
+                 shot_opts.exact,
+                 "Print the exact probability of each output rather than "
+                 "sampling shots (statevector only)");
+    auto* prune_opt = app.add_option(
+        "--prune",
+        shot_opts.prune_threshold,
+        "Skip measurement outcomes less likely than this with --exact");
+    prune_opt->capture_default_str();
+    app.add_flag("--group-tuples,!--no-group-tuples",
+                 group_tuples,
+                 "Print per-tuple measurement statistics rather than "
+                 "per-qubit");
+    auto* engine_opt
+        = app.add_option("--engine", exec_opts.engine, "JIT engine");
+    engine_opt->transform(CLI::CheckedTransformer(
+        std::map<std::string, qiree::Executor::Engine>{
+            {"mcjit", qiree::Executor::Engine::mcjit},
+            {"orc", qiree::Executor::Engine::orc_lazy},
+        },
+        CLI::ignore_case));
+    engine_opt->default_str("orc");
+    app.add_option("--cache-dir",
+                   cache_dir,
+                   "Directory for caching compiled objects between runs");
+    auto* opt_level_opt = app.add_option(
+        "-O,--opt-level", exec_opts.opt_level, "LLVM optimization level");
+    opt_level_opt->transform(CLI::CheckedTransformer(
+        std::map<std::string, qiree::Executor::OptLevel>{
+            {"0", qiree::Executor::OptLevel::O0},
+            {"1", qiree::Executor::OptLevel::O1},
+            {"2", qiree::Executor::OptLevel::O2},
+            {"3", qiree::Executor::OptLevel::O3},
+        }));
+    opt_level_opt->default_str("0");
+    app.add_flag("--qis-inaccessible-memory",
+                 exec_opts.qis_inaccessible_memory,
+                 "Let the optimizer assume quantum operations do not access "
+                 "classical memory");
+    app.add_flag("--static-replay,!--no-static-replay",
+                 exec_opts.static_replay,
+                 "Replay straight-line programs without JIT compilation");
+    app.add_flag("--optimize-circuit",
+                 optimize_circuit,
+                 "Cancel and merge redundant gates before simulating them and "
+                 "print gate counts to stderr");
+    app.add_flag("--print-time", print_time, "Print timing to stderr");
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (!noise_model.empty())
+    {
+        sim_opts.noise = qiree::load_noise_model(noise_model);
+    }
+    if (!cache_dir.empty())
+    {
+        exec_opts.object_cache
+            = std::make_shared<qiree::ObjectCache>(cache_dir);
+    }
+
+    qiree::app::run(filename,
+                    backend,
+                    shot_opts,
+                    sim_opts,
+                    group_tuples,
+                    optimize_circuit,
+                    print_time,
+                    exec_opts);
+
+    return EXIT_SUCCESS;
+}
@@ -7,15 +7,22 @@
 //---------------------------------------------------------------------------//
 #include <cstdlib>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <CLI/CLI.hpp>
 
 #include "qiree_version.h"
 
+#include "qiree/AotExecutor.hh"
+#include "qiree/DirectExecutor.hh"
 #include "qiree/Executor.hh"
 #include "qiree/Module.hh"
+#include "qiree/ObjectCache.hh"
 #include "qiree/QuantumNotImpl.hh"
+#include "qiree/Stopwatch.hh"
 #include "qirxacc/XaccDefaultRuntime.hh"
 #include "qirxacc/XaccQuantum.hh"
 #include "qirxacc/XaccTupleRuntime.hh"
@@ -26,15 +33,50 @@ namespace qiree
 {
 namespace app
 {
+//---------------------------------------------------------------------------//
+/*!
+ * Whether the input is a library compiled with qir-aot.
+ */
+bool is_compiled_library(std::string_view filename)
+{
+    for (auto ext : {".so"sv, ".dylib"sv})
+    {
+        if (filename.size() > ext.size()
+            && filename.substr(filename.size() - ext.size()) == ext)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 //---------------------------------------------------------------------------//
 void run(std::string const& filename,
          std::string const& accel_name,
          int num_shots,
          bool print_accelbuf,
-         bool group_tuples)
+         bool group_tuples,
+         bool print_time,
+         Executor::Options const& exec_opts)
 {
-    // Load the input
-    Executor execute{Module{filename}};
+    // Load the input, which may be precompiled
+    Stopwatch get_time;
+    std::unique_ptr<AotExecutor> aot_execute;
+    // XACC calls are statically dispatched
+    using JitExecutor = DirectExecutor<XaccQuantum, RuntimeInterface>;
+    std::unique_ptr<JitExecutor> jit_execute;
+    double load_time{0};
+    if (is_compiled_library(filename))
+    {
+        aot_execute = std::make_unique<AotExecutor>(filename);
+        load_time = get_time();
+    }
+    else
+    {
+        Module mod{filename};
+        load_time = get_time();
+        jit_execute = std::make_unique<JitExecutor>(std::move(mod), exec_opts);
+    }
 
     // Set up XACC
     XaccQuantum xacc(std::cout, accel_name, num_shots);
@@ -51,7 +93,37 @@ void run(std::string const& filename,
     }
 
     // Run
-    execute(xacc, *rt);
+    get_time = {};
+    if (aot_execute)
+    {
+        (*aot_execute)(xacc, *rt);
+    }
+    else
+    {
+        (*jit_execute)(xacc, *rt);
+    }
+    double const run_time = get_time();
+
+    if (print_time && aot_execute)
+    {
+        std::cerr << "time (s): load " << load_time << ", execute "
+                  << run_time << std::endl;
+    }
+    else if (print_time)
+    {
+        std::cerr << "time (s): load " << load_time << ", optimize ("
+                  << to_cstring(exec_opts.opt_level) << ") "
+                  << jit_execute->executor().timing().optimize << ", build "
+                  << jit_execute->executor().timing().build << ", execute "
+                  << run_time << std::endl;
+    }
+
+    if (auto const& cache = exec_opts.object_cache)
+    {
+        std::cerr << "object cache '" << cache->directory()
+                  << "': " << cache->hits() << " hits, " << cache->misses()
+                  << " misses" << std::endl;
+    }
 }
 
 //---------------------------------------------------------------------------//
@@ -69,10 +141,13 @@ int main(int argc, char* argv[])
     std::string filename;
     bool print_accelbuf{true};
     bool group_tuples{false};
+    bool print_time{false};
+    qiree::Executor::Options exec_opts;
+    std::string cache_dir;
 
     CLI::App app;
-    auto* filename_opt
-        = app.add_option("--input,-i,input", filename, "QIR input file");
+    auto* filename_opt = app.add_option(
+        "--input,-i,input", filename, "QIR input file or qir-aot library");
     filename_opt->required();
     auto* accel_opt
         = app.add_option("-a,--accelerator", accel_name, "Accelerator name");
@@ -87,11 +162,52 @@ int main(int argc, char* argv[])
                  group_tuples,
                  "Print per-tuple measurement statistics rather than "
                  "per-qubit");
+    auto* engine_opt
+        = app.add_option("--engine", exec_opts.engine, "JIT engine");
+    engine_opt->transform(CLI::CheckedTransformer(
+        std::map<std::string, qiree::Executor::Engine>{
+            {"mcjit", qiree::Executor::Engine::mcjit},
+            {"orc", qiree::Executor::Engine::orc_lazy},
+        },
+        CLI::ignore_case));
+    engine_opt->default_str("orc");
+    app.add_option("--cache-dir",
+                   cache_dir,
+                   "Directory for caching compiled objects between runs");
+    auto* opt_level_opt = app.add_option(
+        "-O,--opt-level", exec_opts.opt_level, "LLVM optimization level");
+    opt_level_opt->transform(CLI::CheckedTransformer(
+        std::map<std::string, qiree::Executor::OptLevel>{
+            {"0", qiree::Executor::OptLevel::O0},
+            {"1", qiree::Executor::OptLevel::O1},
+            {"2", qiree::Executor::OptLevel::O2},
+            {"3", qiree::Executor::OptLevel::O3},
+        }));
+    opt_level_opt->default_str("0");
+    app.add_flag("--qis-inaccessible-memory",
+                 exec_opts.qis_inaccessible_memory,
+                 "Let the optimizer assume quantum operations do not access "
+                 "classical memory");
+    app.add_flag("--static-replay,!--no-static-replay",
+                 exec_opts.static_replay,
+                 "Replay straight-line programs without JIT compilation");
+    app.add_flag("--print-time", print_time, "Print timing to stderr");
 
     CLI11_PARSE(app, argc, argv);
 
-    qiree::app::run(
-        filename, accel_name, num_shots, print_accelbuf, group_tuples);
+    if (!cache_dir.empty())
+    {
+        exec_opts.object_cache
+            = std::make_shared<qiree::ObjectCache>(cache_dir);
+    }
+
+    qiree::app::run(filename,
+                    accel_name,
+                    num_shots,
+                    print_accelbuf,
+                    group_tuples,
+                    print_time,
+                    exec_opts);
 
     return EXIT_SUCCESS;
 }
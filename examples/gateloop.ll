@@ -0,0 +1,34 @@
+; ModuleID = 'gateloop'
+source_filename = "gateloop"
+
+%Qubit = type opaque
+%Result = type opaque
+
+; Apply two gates per iteration for a million iterations
+define void @main() #0 {
+entry:
+  br label %loop
+
+loop:                                             ; preds = %loop, %entry
+  %i = phi i64 [ 0, %entry ], [ %next, %loop ]
+  call void @__quantum__qis__h__body(%Qubit* null)
+  call void @__quantum__qis__cnot__body(%Qubit* null, %Qubit* inttoptr (i64 1 to %Qubit*))
+  %next = add i64 %i, 1
+  %done = icmp eq i64 %next, 1000000
+  br i1 %done, label %exit, label %loop
+
+exit:                                             ; preds = %loop
+  call void @__quantum__qis__mz__body(%Qubit* null, %Result* null)
+  call void @__quantum__rt__array_record_output(i64 1, i8* null)
+  call void @__quantum__rt__result_record_output(%Result* null, i8* null)
+  ret void
+}
+
+declare void @__quantum__qis__h__body(%Qubit*)
+declare void @__quantum__qis__cnot__body(%Qubit*, %Qubit*)
+declare void @__quantum__qis__mz__body(%Qubit*, %Result* writeonly) #1
+declare void @__quantum__rt__array_record_output(i64, i8*)
+declare void @__quantum__rt__result_record_output(%Result*, i8*)
+
+attributes #0 = { "entry_point" "required_num_qubits"="2" "required_num_results"="1" "output_labeling_schema" "qir_profiles"="adaptive_profile" }
+attributes #1 = { "irreversible" }
@@ -78,6 +78,7 @@ class Generator:
         self.interface = []
         self.bindings = []
         self.apply_bind = []
+        self.dispatch = []
         self.cc_code = []
 
     def __call__(self, line):
@@ -99,6 +100,7 @@ class Generator:
         self.interface.extend(["//@}", "//@{", "//! \\name " + section, ""])
         self.bindings.extend([SEPARATOR, "// " + section.upper(), SEPARATOR])
         self.apply_bind.append("// " + section)
+        self.dispatch.extend([SEPARATOR, "// " + section.upper(), SEPARATOR])
 
 
 class QisGenerator(Generator):
@@ -140,7 +142,7 @@ class QisGenerator(Generator):
         ]))
         self.bindings.extend([
             " ".join([
-                get_ctype(sig.ret),
+                "static", get_ctype(sig.ret),
                 "QIREE_" + qis_function,
                 "(", ", ".join(cargs), ")"
             ]),
@@ -149,6 +151,17 @@ class QisGenerator(Generator):
             "}"
         ])
         self.apply_bind.append("QIREE_BIND_" + qis_function + ";")
+        self.dispatch.extend([
+            " ".join([
+                get_ctype(sig.ret),
+                "QIREE_C_" + qis_function,
+                "(", ", ".join(cargs), ")"
+            ]),
+            "{",
+            "  return Functions::QIREE_" + qis_function + "("
+            + ", ".join(f"arg{i}" for i in range(1, len(cargs) + 1)) + ");",
+            "}"
+        ])
         self.cc_code.append(" ".join([
             get_cpptype(sig.ret), "QuantumNotImpl::", cpp_decl
         ]))
@@ -177,6 +190,8 @@ def generate_qis():
         write_lines(f, process_line.interface)
         f.write("\n\n/** APPLY BIND **/\n\n")
         write_lines(f, process_line.apply_bind)
+    with open("dispatch.cc", "w") as f:
+        write_lines(f, process_line.dispatch)
     with open("concrete.cc", "w") as f:
         write_lines(f, process_line.cc_code)
 
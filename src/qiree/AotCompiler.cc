@@ -0,0 +1,352 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/AotCompiler.cc
+//---------------------------------------------------------------------------//
+#include "AotCompiler.hh"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/StringSet.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalAlias.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Module.h>
+#include <llvm/MC/TargetRegistry.h>
+#include <llvm/Support/CodeGen.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/FileUtilities.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Target/TargetOptions.h>
+
+#include "Assert.hh"
+#include "Module.hh"
+#include "detail/AotDescriptor.hh"
+#include "detail/GlobalMapper.hh"
+#include "detail/LlvmUtils.hh"
+#include "detail/QirFunctions.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Get the host CPU features as a target feature string.
+ */
+std::string host_cpu_features()
+{
+    llvm::StringMap<bool> features;
+    std::string result;
+    if (llvm::sys::getHostCPUFeatures(features))
+    {
+        for (auto const& kv : features)
+        {
+            if (!result.empty())
+            {
+                result += ',';
+            }
+            result += (kv.getValue() ? '+' : '-');
+            result += kv.getKey().str();
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create a position-independent target machine for the running process.
+ */
+std::unique_ptr<llvm::TargetMachine>
+make_target_machine(AotCompiler::Options const& opts)
+{
+    std::string const triple = llvm::sys::getProcessTriple();
+    std::string err;
+    llvm::Target const* target = llvm::TargetRegistry::lookupTarget(triple,
+                                                                    err);
+    QIREE_VALIDATE(target,
+                   << "failed to find target for '" << triple << "': " << err);
+
+    std::string cpu = "generic";
+    std::string features;
+    if (opts.host_cpu)
+    {
+        cpu = llvm::sys::getHostCPUName().str();
+        features = host_cpu_features();
+    }
+
+#if LLVM_VERSION_MAJOR >= 18
+    using CodeGenLevel = llvm::CodeGenOptLevel;
+#else
+    using CodeGenLevel = llvm::CodeGenOpt::Level;
+#endif
+    CodeGenLevel level = [&opts] {
+        switch (opts.opt_level)
+        {
+            case AotCompiler::OptLevel::O0:
+                return CodeGenLevel::None;
+            case AotCompiler::OptLevel::O1:
+                return CodeGenLevel::Less;
+            case AotCompiler::OptLevel::O2:
+                return CodeGenLevel::Default;
+            case AotCompiler::OptLevel::O3:
+                return CodeGenLevel::Aggressive;
+        }
+        QIREE_ASSERT_UNREACHABLE();
+    }();
+
+    std::unique_ptr<llvm::TargetMachine> tm{
+        target->createTargetMachine(triple,
+                                    cpu,
+                                    features,
+                                    llvm::TargetOptions{},
+                                    llvm::Reloc::PIC_,
+                                    {},
+                                    level)};
+    QIREE_VALIDATE(tm, << "failed to create target machine for " << triple);
+    return tm;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Make all definitions except the entry point local to the library.
+ *
+ * This lets the optimizer inline and remove them, and prevents them from
+ * being interposed by (or conflicting with) symbols of the same name in the
+ * loading process, e.g. \c main.
+ */
+void internalize(llvm::Module& m, llvm::Function& entry)
+{
+    for (llvm::GlobalValue& gv : m.global_values())
+    {
+        if (&gv == &entry || gv.isDeclaration() || gv.hasLocalLinkage()
+            || gv.hasAppendingLinkage() || gv.getName().startswith("llvm."))
+        {
+            continue;
+        }
+        gv.setLinkage(llvm::GlobalValue::InternalLinkage);
+    }
+    entry.setVisibility(llvm::GlobalValue::HiddenVisibility);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Remove local functions that are never referenced.
+ *
+ * Unreachable functions (which are allowed to call unimplemented QIR
+ * functions) would otherwise leave undefined symbols in the library, even
+ * without optimization.
+ */
+void remove_dead_functions(llvm::Module& m)
+{
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (auto iter = m.begin(); iter != m.end();)
+        {
+            llvm::Function& f = *iter++;
+            if (!f.hasLocalLinkage())
+            {
+                continue;
+            }
+            f.removeDeadConstantUsers();
+            if (f.use_empty())
+            {
+                f.eraseFromParent();
+                changed = true;
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Export the entry point and its attributes under fixed names.
+ */
+void add_descriptor(llvm::Module& m,
+                    llvm::Function& entry,
+                    EntryPointAttrs const& attrs)
+{
+    using Desc = detail::AotDescriptor;
+
+    llvm::GlobalAlias::create(
+        llvm::GlobalValue::ExternalLinkage, Desc::entry_symbol, &entry);
+
+    auto add_constant = [&m](char const* name, llvm::Constant* value) {
+        new llvm::GlobalVariable(m,
+                                 value->getType(),
+                                 /* isConstant = */ true,
+                                 llvm::GlobalValue::ExternalLinkage,
+                                 value,
+                                 name);
+    };
+    llvm::LLVMContext& ctx = m.getContext();
+    auto* i32 = llvm::Type::getInt32Ty(ctx);
+    auto* i64 = llvm::Type::getInt64Ty(ctx);
+    add_constant(Desc::version_symbol,
+                 llvm::ConstantInt::get(i32, Desc::version));
+    add_constant(Desc::num_qubits_symbol,
+                 llvm::ConstantInt::get(i64, attrs.required_num_qubits));
+    add_constant(Desc::num_results_symbol,
+                 llvm::ConstantInt::get(i64, attrs.required_num_results));
+    add_constant(Desc::output_labeling_schema_symbol,
+                 llvm::ConstantDataArray::getString(
+                     ctx, attrs.output_labeling_schema));
+    add_constant(
+        Desc::qir_profiles_symbol,
+        llvm::ConstantDataArray::getString(ctx, attrs.qir_profiles));
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with default options.
+ */
+AotCompiler::AotCompiler() : AotCompiler{Options{}} {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with options.
+ */
+AotCompiler::AotCompiler(Options const& opts) : options_{opts} {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Compile a module to a shared library.
+ *
+ * The intermediate object file is written to a temporary location.
+ */
+void AotCompiler::operator()(Module&& module, std::string const& library) const
+{
+    llvm::SmallString<128> object_file;
+    std::error_code ec = llvm::sys::fs::createTemporaryFile(
+        "qiree-aot", "o", object_file);
+    QIREE_VALIDATE(!ec,
+                   << "failed to create temporary object file: "
+                   << ec.message());
+    llvm::FileRemover remove_object{object_file};
+
+    this->compile(std::move(module), object_file.str().str());
+    this->link(object_file.str().str(), library);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Compile a module to a relocatable object file.
+ *
+ * This throws \c DebugError (like the JIT) if the entry point can reach a QIR
+ * function that isn't implemented.
+ */
+void AotCompiler::compile(Module&& module,
+                          std::string const& object_file) const
+{
+    QIREE_EXPECT(module);
+    QIREE_EXPECT(module.entrypoint_ && module.module_);
+    QIREE_VALIDATE(module.entrypoint_->arg_empty(),
+                   << "entry point '" << module.entrypoint_->getName().str()
+                   << "' cannot take arguments");
+
+    EntryPointAttrs const attrs = module.load_entry_point_attrs();
+    llvm::Module& llmod = *module.module_;
+    llvm::Function& entry = *module.entrypoint_;
+
+    detail::initialize_llvm();
+    auto tm = make_target_machine(options_);
+    llmod.setTargetTriple(tm->getTargetTriple().str());
+    llmod.setDataLayout(tm->createDataLayout());
+
+    // Only the entry point is kept through optimization
+    if (entry.hasLocalLinkage())
+    {
+        entry.setLinkage(llvm::GlobalValue::ExternalLinkage);
+    }
+    internalize(llmod, entry);
+
+    // Optimize the module
+    if (options_.qis_inaccessible_memory)
+    {
+        detail::mark_qis_inaccessible_memory(llmod);
+    }
+    if (options_.opt_level != OptLevel::O0)
+    {
+        detail::optimize_module(llmod, options_.opt_level, *tm);
+    }
+    remove_dead_functions(llmod);
+
+    // Check function signatures and availability against the binding table
+    llvm::StringSet<> bound;
+    detail::bind_functions(
+        detail::GlobalMapper{llmod, [&bound](llvm::Function& irfunc, void*) {
+                                 bound.insert(irfunc.getName());
+                             }});
+    detail::validate_reachable_bindings(entry, bound);
+
+    add_descriptor(llmod, entry, attrs);
+
+    // Emit the object file
+    std::error_code ec;
+    llvm::raw_fd_ostream os{object_file, ec, llvm::sys::fs::OF_None};
+    QIREE_VALIDATE(!ec,
+                   << "failed to open object file '" << object_file
+                   << "': " << ec.message());
+
+#if LLVM_VERSION_MAJOR >= 18
+    auto const file_type = llvm::CodeGenFileType::ObjectFile;
+#else
+    auto const file_type = llvm::CGFT_ObjectFile;
+#endif
+    llvm::legacy::PassManager pm;
+    QIREE_VALIDATE(!tm->addPassesToEmitFile(pm, os, nullptr, file_type),
+                   << "target '" << tm->getTargetTriple().str()
+                   << "' cannot emit object files");
+    pm.run(llmod);
+    os.close();
+    QIREE_VALIDATE(!os.has_error(),
+                   << "failed to write object file '" << object_file
+                   << "': " << os.error().message());
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Link an object file into a shared library.
+ *
+ * QIR functions are left undefined in the library.
+ */
+void AotCompiler::link(std::string const& object_file,
+                       std::string const& library) const
+{
+    std::string const linker = options_.linker.empty() ? "cc"
+                                                       : options_.linker;
+    auto program = llvm::sys::findProgramByName(linker);
+    QIREE_VALIDATE(program,
+                   << "failed to find linker '" << linker
+                   << "': " << program.getError().message());
+
+    llvm::SmallVector<llvm::StringRef, 8> args{*program, "-shared"};
+#ifdef __APPLE__
+    args.append({"-undefined", "dynamic_lookup"});
+#endif
+    args.append({"-o", library, object_file});
+
+    std::string err;
+    int result = llvm::sys::ExecuteAndWait(
+        *program, args, {}, {}, 0, 0, &err);
+    QIREE_VALIDATE(result == 0,
+                   << "failed to link '" << library << "' with '" << *program
+                   << "'" << (err.empty() ? "" : ": ") << err);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
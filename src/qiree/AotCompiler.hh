@@ -0,0 +1,81 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/AotCompiler.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <string>
+
+#include "Executor.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+class Module;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Compile QIR ahead of time to a native shared library.
+ *
+ * The module is optimized and compiled for the host with the same binding
+ * table used by \c Executor: every QIR function reachable from the entry point
+ * must be one that QIR-EE implements. Calls to QIR functions are left as
+ * undefined symbols, which are resolved when the library is loaded by \c
+ * AotExecutor against the QIR-EE library itself. The entry point and its
+ * attributes are exported under fixed names.
+ *
+ * \code
+    AotCompiler compile;
+    compile(Module{"bell.ll"}, "libbell.so");
+    // ...
+    AotExecutor execute{"libbell.so"};
+    execute(quantum_interface, runtime_interface);
+   \endcode
+ */
+class AotCompiler
+{
+  public:
+    //! Optimization level
+    using OptLevel = Executor::OptLevel;
+
+    //! Compilation options
+    struct Options
+    {
+        //! Optimization pipeline applied to the module
+        OptLevel opt_level{OptLevel::O2};
+        //! Let the optimizer assume QIS calls don't touch classical memory
+        bool qis_inaccessible_memory{false};
+        //! Tune for the host CPU rather than a generic one for its triple
+        bool host_cpu{false};
+        //! Compiler driver used to link (default: \c cc on the path)
+        std::string linker;
+    };
+
+  public:
+    // Construct with default options
+    AotCompiler();
+
+    // Construct with options
+    explicit AotCompiler(Options const& opts);
+
+    // Compile a module to a shared library
+    void operator()(Module&& module, std::string const& library) const;
+
+    // Compile a module to a relocatable object file
+    void compile(Module&& module, std::string const& object_file) const;
+
+    // Link an object file into a shared library
+    void link(std::string const& object_file, std::string const& library) const;
+
+    //! Compilation options
+    Options const& options() const { return options_; }
+
+  private:
+    Options options_;
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,132 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/AotExecutor.cc
+//---------------------------------------------------------------------------//
+#include "AotExecutor.hh"
+
+#include <cstdint>
+#include <dlfcn.h>
+
+#include "Assert.hh"
+#include "QuantumInterface.hh"
+#include "RuntimeInterface.hh"
+#include "detail/AotDescriptor.hh"
+#include "detail/EndGuard.hh"
+#include "detail/QirFunctions.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Look up a required symbol in a loaded library.
+ */
+void* require_symbol(void* handle, char const* name, std::string const& lib)
+{
+    void* result = dlsym(handle, name);
+    QIREE_VALIDATE(result,
+                   << "'" << lib << "' is not a QIR-EE compiled library: "
+                   << "missing symbol '" << name << "'");
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Load a compiled QIR library.
+ *
+ * All symbols are bound immediately so that missing QIR functions are
+ * reported now rather than during execution.
+ */
+AotExecutor::AotExecutor(std::string const& library)
+{
+    using Desc = detail::AotDescriptor;
+
+    handle_ = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle_)
+    {
+        char const* err = dlerror();
+        QIREE_VALIDATE(false,
+                       << "failed to load QIR library '" << library
+                       << "': " << (err ? err : "unknown error")
+                       << " (QIR functions are resolved from the QIR-EE "
+                          "library, which must be shared or have its "
+                          "symbols exported)");
+    }
+
+    try
+    {
+        auto version = *static_cast<std::int32_t const*>(
+            require_symbol(handle_, Desc::version_symbol, library));
+        QIREE_VALIDATE(version == Desc::version,
+                       << "'" << library << "' was compiled with version "
+                       << version << " of the QIR-EE library format (expected "
+                       << Desc::version << ")");
+
+        entry_func_ = reinterpret_cast<EntryFunction>(
+            reinterpret_cast<std::uintptr_t>(
+                require_symbol(handle_, Desc::entry_symbol, library)));
+
+        auto get_size = [this, &library](char const* name) {
+            return static_cast<size_type>(*static_cast<std::int64_t const*>(
+                require_symbol(handle_, name, library)));
+        };
+        auto get_string = [this, &library](char const* name) {
+            return std::string{static_cast<char const*>(
+                require_symbol(handle_, name, library))};
+        };
+        entry_point_attrs_.required_num_qubits
+            = get_size(Desc::num_qubits_symbol);
+        entry_point_attrs_.required_num_results
+            = get_size(Desc::num_results_symbol);
+        entry_point_attrs_.output_labeling_schema
+            = get_string(Desc::output_labeling_schema_symbol);
+        entry_point_attrs_.qir_profiles
+            = get_string(Desc::qir_profiles_symbol);
+    }
+    catch (...)
+    {
+        dlclose(handle_);
+        throw;
+    }
+
+    QIREE_ENSURE(handle_ && entry_func_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Unload the library.
+ */
+AotExecutor::~AotExecutor()
+{
+    dlclose(handle_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute with the given interface functions.
+ */
+void AotExecutor::operator()(QuantumInterface& qi, RuntimeInterface& ri) const
+{
+    QIREE_EXPECT(entry_func_);
+
+    // Activate the interfaces for this thread, saving any from an enclosing
+    // execution, and tear down before restoring them
+    detail::ActiveInterfaces active_interfaces{qi, ri};
+    detail::EndGuard on_end_scope_([&qi] { qi.tear_down(); });
+
+    // Call setup on the interface
+    qi.set_up(entry_point_attrs_);
+
+    // Execute the main function
+    (*entry_func_)();
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,61 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/AotExecutor.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <string>
+
+#include "Macros.hh"
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+class QuantumInterface;
+class RuntimeInterface;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Load and run a QIR library compiled by \c AotCompiler.
+ *
+ * This is a drop-in replacement for \c Executor that needs neither the IR nor
+ * LLVM at run time. The library's QIR function calls are resolved against the
+ * QIR-EE library loaded in the current process, so QIR-EE must be built as a
+ * shared library (or its symbols exported from the executable).
+ *
+ * Like \c Executor, execution is thread-safe and re-entrant.
+ */
+class AotExecutor
+{
+  public:
+    // Load a compiled QIR library
+    explicit AotExecutor(std::string const& library);
+
+    // Unload the library
+    ~AotExecutor();
+
+    QIREE_DELETE_COPY_MOVE(AotExecutor);
+
+    // Execute with the given interface functions
+    void operator()(QuantumInterface& qi, RuntimeInterface& ri) const;
+
+    //! Attributes of the compiled entry point
+    EntryPointAttrs const& entry_point_attrs() const
+    {
+        return entry_point_attrs_;
+    }
+
+  private:
+    using EntryFunction = void (*)();
+
+    void* handle_{nullptr};
+    EntryFunction entry_func_{nullptr};
+    EntryPointAttrs entry_point_attrs_;
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
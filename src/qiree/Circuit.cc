@@ -0,0 +1,273 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/Circuit.cc
+//---------------------------------------------------------------------------//
+#include "Circuit.hh"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+#include "Assert.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Number of targets of an operation, or zero for any number.
+ */
+Circuit::Index num_fixed_targets(GateOp op)
+{
+    switch (op)
+    {
+        case GateOp::rxx:
+        case GateOp::ryy:
+        case GateOp::rzz:
+        case GateOp::swap:
+            return 2;
+        case GateOp::pauli_rotation:
+        case GateOp::measure_pauli:
+            return 0;
+        default:
+            return 1;
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a view of an operation.
+ *
+ * The view is invalidated when operations are added.
+ */
+auto Circuit::operator[](size_type i) const -> OperationRef
+{
+    QIREE_EXPECT(i < this->size());
+
+    OperationRef result;
+    result.op = ops_[i];
+    result.controls = qubits_.data() + offsets_[i];
+    result.num_controls = num_controls_[i];
+    result.targets = result.controls + result.num_controls;
+    result.num_targets = offsets_[i + 1] - offsets_[i] - result.num_controls;
+    if (has_paulis(result.op))
+    {
+        result.paulis = paulis_.data() + offsets_[i] + result.num_controls;
+    }
+    if (has_angle(result.op))
+    {
+        result.theta = params_[data_[i]];
+    }
+    else if (is_measurement(result.op))
+    {
+        result.result = Result{data_[i]};
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add an operation.
+ */
+void Circuit::push_back(Operation const& op)
+{
+    QIREE_EXPECT(!has_paulis(op.op) || op.paulis.size() == op.targets.size());
+
+    OperationRef ref;
+    ref.op = op.op;
+    ref.controls = op.controls.data();
+    ref.num_controls = op.controls.size();
+    ref.targets = op.targets.data();
+    ref.num_targets = op.targets.size();
+    ref.paulis = op.paulis.data();
+    ref.theta = op.theta;
+    ref.result = op.result;
+    this->append(ref);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add an operation from the operands of a view.
+ *
+ * The view may refer to an operation in another circuit, which lets passes
+ * copy operations without building an \c Operation .
+ */
+void Circuit::append(OperationRef const& op)
+{
+    QIREE_EXPECT(op.op != GateOp::size_);
+    QIREE_EXPECT(num_fixed_targets(op.op) == 0
+                 || op.num_targets == num_fixed_targets(op.op));
+    QIREE_EXPECT(!has_paulis(op.op) || op.paulis);
+    QIREE_EXPECT(!is_measurement(op.op) || op.num_controls == 0);
+
+    ops_.push_back(op.op);
+    num_controls_.push_back(op.num_controls);
+
+    qubits_.insert(qubits_.end(), op.controls, op.controls + op.num_controls);
+    qubits_.insert(qubits_.end(), op.targets, op.targets + op.num_targets);
+    paulis_.resize(paulis_.size() + op.num_controls, Pauli::i);
+    if (has_paulis(op.op))
+    {
+        paulis_.insert(paulis_.end(), op.paulis, op.paulis + op.num_targets);
+    }
+    else
+    {
+        paulis_.resize(paulis_.size() + op.num_targets, Pauli::i);
+    }
+    QIREE_VALIDATE(qubits_.size() <= std::numeric_limits<Index>::max(),
+                   << "too many operands in circuit");
+    offsets_.push_back(static_cast<Index>(qubits_.size()));
+
+    Index data{0};
+    if (has_angle(op.op))
+    {
+        data = static_cast<Index>(params_.size());
+        params_.push_back(op.theta);
+    }
+    else if (is_measurement(op.op))
+    {
+        QIREE_VALIDATE(op.result.value <= std::numeric_limits<Index>::max(),
+                       << "result " << op.result.value
+                       << " is out of range for a circuit");
+        data = static_cast<Index>(op.result.value);
+    }
+    data_.push_back(data);
+
+    for (auto it = qubits_.end() - (op.num_controls + op.num_targets);
+         it != qubits_.end();
+         ++it)
+    {
+        num_qubits_ = std::max<size_type>(num_qubits_, *it + 1);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Allocate space for operations and their operands.
+ */
+void Circuit::reserve(size_type num_ops, size_type num_operands)
+{
+    ops_.reserve(num_ops);
+    num_controls_.reserve(num_ops);
+    offsets_.reserve(num_ops + 1);
+    data_.reserve(num_ops);
+    qubits_.reserve(num_operands);
+    paulis_.reserve(num_operands);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Remove all operations.
+ *
+ * Memory is kept so that a circuit can be rerecorded without allocating.
+ */
+void Circuit::clear()
+{
+    ops_.clear();
+    num_controls_.clear();
+    offsets_.assign(1, 0);
+    data_.clear();
+    qubits_.clear();
+    paulis_.clear();
+    params_.clear();
+    num_qubits_ = 0;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Count operations with each opcode.
+ *
+ * The result is indexed by the opcode.
+ */
+std::vector<size_type> Circuit::count_ops() const
+{
+    std::vector<size_type> result(static_cast<size_type>(GateOp::size_), 0);
+    for (GateOp op : ops_)
+    {
+        ++result[static_cast<size_type>(op)];
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get a string representation of a circuit operation.
+ */
+char const* to_cstring(GateOp value)
+{
+    static char const* const strings[] = {
+        "h",
+        "x",
+        "y",
+        "z",
+        "s",
+        "s_adj",
+        "t",
+        "t_adj",
+        "rx",
+        "ry",
+        "rz",
+        "rxx",
+        "ryy",
+        "rzz",
+        "pauli_rotation",
+        "swap",
+        "measure_z",
+        "measure_pauli",
+        "reset",
+    };
+    static_assert(std::size(strings) == static_cast<int>(GateOp::size_));
+    QIREE_EXPECT(value != GateOp::size_);
+    return strings[static_cast<int>(value)];
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether an operation has a rotation angle.
+ */
+bool has_angle(GateOp op)
+{
+    switch (op)
+    {
+        case GateOp::rx:
+        case GateOp::ry:
+        case GateOp::rz:
+        case GateOp::rxx:
+        case GateOp::ryy:
+        case GateOp::rzz:
+        case GateOp::pauli_rotation:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether an operation has a Pauli per target.
+ */
+bool has_paulis(GateOp op)
+{
+    return op == GateOp::pauli_rotation || op == GateOp::measure_pauli;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether an operation stores a measurement result.
+ */
+bool is_measurement(GateOp op)
+{
+    return op == GateOp::measure_z || op == GateOp::measure_pauli;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
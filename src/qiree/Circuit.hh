@@ -0,0 +1,173 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/Circuit.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Operation in a recorded circuit.
+ *
+ * Rotations are \f$ \exp(-i \theta P / 2) \f$ about a Pauli operator on the
+ * targets. Any operation may have control qubits.
+ */
+enum class GateOp : std::uint8_t
+{
+    h,
+    x,
+    y,
+    z,
+    s,
+    s_adj,
+    t,
+    t_adj,
+    rx,
+    ry,
+    rz,
+    rxx,
+    ryy,
+    rzz,
+    pauli_rotation,  //!< Rotation about one Pauli per target
+    swap,
+    measure_z,  //!< Z measurement of the target into a result
+    measure_pauli,  //!< Measurement of one Pauli per target into a result
+    reset,
+    size_
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Compact list of quantum operations.
+ *
+ * Operations are stored as a structure of arrays: one byte of opcode per
+ * operation, with the control and target qubit indices of all operations
+ * packed into a single operand array and the rotation angles in a parameter
+ * pool, so a backend can traverse thousands of gates without chasing
+ * pointers. Pauli operations store their Paulis alongside the target
+ * operands, and measurements store their result index in place of a
+ * parameter. Adding an operation only allocates when the arrays grow, so a
+ * recorder that reuses one \c Operation amortizes allocations over the
+ * whole program.
+ *
+ * \code
+   Circuit c;
+   c.push_back({GateOp::h, {}, {0}});
+   c.push_back({GateOp::x, {0}, {1}});
+   for (size_type i = 0; i < c.size(); ++i)
+   {
+       Circuit::OperationRef op = c[i];
+       ...
+   }
+ * \endcode
+ */
+class Circuit
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using Index = std::uint32_t;
+    using VecIndex = std::vector<Index>;
+    //!@}
+
+    //! Operation to add to a circuit
+    struct Operation
+    {
+        GateOp op{GateOp::size_};
+        VecIndex controls{};
+        VecIndex targets{};
+        std::vector<Pauli> paulis{};  //!< One per target for Pauli ops
+        double theta{0};  //!< Rotation angle
+        Result result{};  //!< Measured result
+    };
+
+    //! View of a stored operation
+    struct OperationRef
+    {
+        GateOp op{GateOp::size_};
+        Index const* controls{nullptr};
+        Index num_controls{0};
+        Index const* targets{nullptr};
+        Index num_targets{0};
+        Pauli const* paulis{nullptr};  //!< One per target
+        double theta{0};
+        Result result{};
+    };
+
+  public:
+    //!@{
+    //! \name Accessors
+    //! Number of operations
+    size_type size() const { return ops_.size(); }
+    //! Whether no operations are stored
+    bool empty() const { return ops_.empty(); }
+    //! Number of control and target operands of all operations
+    size_type num_operands() const { return qubits_.size(); }
+    //! Number of qubits needed by the operations
+    size_type num_qubits() const { return num_qubits_; }
+    //! Opcode of an operation
+    GateOp op(size_type i) const { return ops_[i]; }
+    //!@}
+
+    // Get a view of an operation
+    OperationRef operator[](size_type i) const;
+
+    // Add an operation
+    void push_back(Operation const& op);
+
+    // Add an operation from the operands of a view
+    void append(OperationRef const& op);
+
+    // Allocate space for operations and their operands
+    void reserve(size_type num_ops, size_type num_operands);
+
+    // Remove all operations
+    void clear();
+
+    // Count operations with each opcode
+    std::vector<size_type> count_ops() const;
+
+  private:
+    // Per operation
+    std::vector<GateOp> ops_;
+    VecIndex num_controls_;
+    VecIndex offsets_{0};
+    VecIndex data_;
+
+    // Per operand
+    VecIndex qubits_;
+    std::vector<Pauli> paulis_;
+
+    // Pool of rotation angles
+    std::vector<double> params_;
+
+    size_type num_qubits_{0};
+};
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Get a string representation of a circuit operation
+char const* to_cstring(GateOp);
+
+// Whether an operation has a rotation angle
+bool has_angle(GateOp);
+
+// Whether an operation has a Pauli per target
+bool has_paulis(GateOp);
+
+// Whether an operation stores a measurement result
+bool is_measurement(GateOp);
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
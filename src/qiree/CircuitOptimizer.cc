@@ -0,0 +1,434 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/CircuitOptimizer.cc
+//---------------------------------------------------------------------------//
+#include "CircuitOptimizer.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+
+#include "Assert.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+constexpr double pi = 3.141592653589793;
+constexpr size_type no_node = static_cast<size_type>(-1);
+
+using OperationRef = Circuit::OperationRef;
+
+//! Pauli basis of an operand, ordered like \c Pauli
+enum class Basis
+{
+    i,
+    x,
+    z,
+    y,
+    general,  //!< Not diagonal in any Pauli basis
+};
+
+//! How two operations combine
+enum class Combination
+{
+    none,
+    cancel,
+    merge,
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the qubit of an operand: controls followed by targets.
+ */
+Circuit::Index operand(OperationRef const& op, size_type k)
+{
+    return k < op.num_controls ? op.controls[k]
+                               : op.targets[k - op.num_controls];
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Number of operands of an operation.
+ */
+size_type num_operands(OperationRef const& op)
+{
+    return op.num_controls + op.num_targets;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the Pauli basis in which an operation acts on an operand.
+ */
+Basis operand_basis(OperationRef const& op, size_type k)
+{
+    if (k < op.num_controls)
+    {
+        return Basis::z;
+    }
+    switch (op.op)
+    {
+        case GateOp::x:
+        case GateOp::rx:
+        case GateOp::rxx:
+            return Basis::x;
+        case GateOp::y:
+        case GateOp::ry:
+        case GateOp::ryy:
+            return Basis::y;
+        case GateOp::z:
+        case GateOp::s:
+        case GateOp::s_adj:
+        case GateOp::t:
+        case GateOp::t_adj:
+        case GateOp::rz:
+        case GateOp::rzz:
+            return Basis::z;
+        case GateOp::pauli_rotation:
+            return static_cast<Basis>(op.paulis[k - op.num_controls]);
+        default:
+            return Basis::general;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether two operations commute.
+ *
+ * This is true if each operation is a sum of products of single-qubit
+ * factors in the span of the identity and its Pauli on that qubit, and the
+ * Paulis agree on every shared qubit.
+ */
+bool commutes(OperationRef const& a, OperationRef const& b)
+{
+    for (size_type i = 0; i < num_operands(a); ++i)
+    {
+        for (size_type j = 0; j < num_operands(b); ++j)
+        {
+            if (operand(a, i) != operand(b, j))
+            {
+                continue;
+            }
+            Basis const ba = operand_basis(a, i);
+            Basis const bb = operand_basis(b, j);
+            if (ba == Basis::i || bb == Basis::i)
+            {
+                continue;
+            }
+            if (ba != bb || ba == Basis::general)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether a list of qubits contains a qubit.
+ */
+bool contains(Circuit::Index const* qubits,
+              size_type size,
+              Circuit::Index q)
+{
+    return std::find(qubits, qubits + size, q) != qubits + size;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether two-qubit operations are symmetric in their targets.
+ */
+bool is_symmetric(GateOp op)
+{
+    return op == GateOp::swap || op == GateOp::rxx || op == GateOp::ryy
+           || op == GateOp::rzz;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether an operation is its own inverse.
+ */
+bool is_self_inverse(GateOp op)
+{
+    switch (op)
+    {
+        case GateOp::h:
+        case GateOp::x:
+        case GateOp::y:
+        case GateOp::z:
+        case GateOp::swap:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Determine whether a later operation cancels or merges with an earlier one.
+ */
+Combination combination(OperationRef const& prev, OperationRef const& next)
+{
+    auto is_pair = [&prev, &next](GateOp a, GateOp b) {
+        return (prev.op == a && next.op == b) || (prev.op == b && next.op == a);
+    };
+    bool const adjoints = is_pair(GateOp::s, GateOp::s_adj)
+                          || is_pair(GateOp::t, GateOp::t_adj);
+    if ((prev.op != next.op && !adjoints)
+        || prev.num_controls != next.num_controls
+        || prev.num_targets != next.num_targets)
+    {
+        return Combination::none;
+    }
+
+    for (size_type k = 0; k < next.num_controls; ++k)
+    {
+        if (!contains(prev.controls, prev.num_controls, next.controls[k]))
+        {
+            return Combination::none;
+        }
+    }
+    bool const symmetric = is_symmetric(next.op);
+    for (size_type k = 0; k < next.num_targets; ++k)
+    {
+        if (symmetric
+                ? !contains(prev.targets, prev.num_targets, next.targets[k])
+                : prev.targets[k] != next.targets[k])
+        {
+            return Combination::none;
+        }
+        if (has_paulis(next.op) && prev.paulis[k] != next.paulis[k])
+        {
+            return Combination::none;
+        }
+    }
+
+    if (adjoints || is_self_inverse(next.op))
+    {
+        return Combination::cancel;
+    }
+    if (has_angle(next.op))
+    {
+        return Combination::merge;
+    }
+    return Combination::none;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add operation counts to a running total.
+ */
+void accumulate(Circuit const& c, CircuitOptimizer::VecCount* total)
+{
+    auto counts = c.count_ops();
+    total->resize(counts.size(), 0);
+    for (size_type i = 0; i < counts.size(); ++i)
+    {
+        (*total)[i] += counts[i];
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with options.
+ */
+CircuitOptimizer::CircuitOptimizer(Options const& opts) : options_{opts}
+{
+    QIREE_VALIDATE(opts.tolerance >= 0,
+                   << "invalid rotation tolerance " << opts.tolerance);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Optimize a circuit into another.
+ *
+ * The output is cleared first and must be a different circuit than the
+ * input.
+ */
+void CircuitOptimizer::operator()(Circuit const& input, Circuit* output)
+{
+    QIREE_EXPECT(output && output != &input);
+
+    nodes_.clear();
+    if (qubit_nodes_.size() < input.num_qubits())
+    {
+        qubit_nodes_.resize(input.num_qubits());
+    }
+    for (auto& nodes : qubit_nodes_)
+    {
+        nodes.clear();
+    }
+
+    for (size_type i = 0; i < input.size(); ++i)
+    {
+        auto op = input[i];
+        if (has_angle(op.op) && this->is_identity(op))
+        {
+            continue;
+        }
+        if (this->combine_with_previous(input, i))
+        {
+            continue;
+        }
+        nodes_.push_back({i, op.theta, true});
+        for (size_type k = 0; k < num_operands(op); ++k)
+        {
+            qubit_nodes_[operand(op, k)].push_back(nodes_.size() - 1);
+        }
+    }
+
+    output->clear();
+    output->reserve(nodes_.size(), input.num_operands());
+    for (Node const& node : nodes_)
+    {
+        if (node.alive)
+        {
+            auto op = input[node.index];
+            op.theta = node.theta;
+            output->append(op);
+        }
+    }
+
+    accumulate(input, &before_);
+    accumulate(*output, &after_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write a table of operation counts before and after optimization.
+ */
+void CircuitOptimizer::print_counts(std::ostream& os) const
+{
+    os << std::left << std::setw(16) << "operation" << std::right
+       << std::setw(10) << "before" << std::setw(10) << "after" << std::endl;
+
+    size_type total_before{0};
+    size_type total_after{0};
+    for (size_type i = 0; i < before_.size(); ++i)
+    {
+        if (before_[i] == 0 && after_[i] == 0)
+        {
+            continue;
+        }
+        os << std::left << std::setw(16) << to_cstring(static_cast<GateOp>(i))
+           << std::right << std::setw(10) << before_[i] << std::setw(10)
+           << after_[i] << std::endl;
+        total_before += before_[i];
+        total_after += after_[i];
+    }
+    os << std::left << std::setw(16) << "total" << std::right << std::setw(10)
+       << total_before << std::setw(10) << total_after << std::endl;
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Whether a rotation is the identity up to a global phase.
+ *
+ * Without controls, a rotation by \f$ 2\pi \f$ is a global phase, as is any
+ * rotation about the identity. With controls the phase is relative, so the
+ * period is \f$ 4\pi \f$.
+ */
+bool CircuitOptimizer::is_identity(OperationRef const& op) const
+{
+    QIREE_EXPECT(has_angle(op.op));
+    if (op.num_controls == 0 && op.op == GateOp::pauli_rotation
+        && std::all_of(op.paulis, op.paulis + op.num_targets, [](Pauli p) {
+               return p == Pauli::i;
+           }))
+    {
+        return true;
+    }
+    double const period = (op.num_controls == 0 ? 2 : 4) * pi;
+    return std::fabs(std::remainder(op.theta, period)) <= options_.tolerance;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Cancel or merge an operation with an earlier one.
+ *
+ * Earlier operations on the same qubits are visited from the most recent,
+ * skipping those that commute with the new operation, so that the new
+ * operation can be moved back to the one it combines with. Returns true if
+ * the new operation was absorbed.
+ */
+bool CircuitOptimizer::combine_with_previous(Circuit const& input,
+                                             size_type i)
+{
+    auto const op = input[i];
+
+    // Position in the node list of each qubit of the operation
+    cursors_.clear();
+    for (size_type k = 0; k < num_operands(op); ++k)
+    {
+        cursors_.push_back(qubit_nodes_[operand(op, k)].size());
+    }
+
+    for (size_type depth = 0; depth < options_.max_depth; ++depth)
+    {
+        // Find the latest live operation that shares a qubit
+        size_type latest = no_node;
+        for (size_type k = 0; k < cursors_.size(); ++k)
+        {
+            auto const& nodes = qubit_nodes_[operand(op, k)];
+            size_type& pos = cursors_[k];
+            while (pos > 0 && !nodes_[nodes[pos - 1]].alive)
+            {
+                --pos;
+            }
+            if (pos > 0 && (latest == no_node || nodes[pos - 1] > latest))
+            {
+                latest = nodes[pos - 1];
+            }
+        }
+        if (latest == no_node)
+        {
+            return false;
+        }
+
+        Node& prev = nodes_[latest];
+        auto prev_op = input[prev.index];
+        prev_op.theta = prev.theta;
+        switch (combination(prev_op, op))
+        {
+            case Combination::cancel:
+                prev.alive = false;
+                return true;
+            case Combination::merge:
+                prev.theta += op.theta;
+                prev_op.theta = prev.theta;
+                prev.alive = !this->is_identity(prev_op);
+                return true;
+            case Combination::none:
+                break;
+        }
+        if (!commutes(prev_op, op))
+        {
+            return false;
+        }
+
+        // Move past the commuting operation on all its shared qubits
+        for (size_type k = 0; k < cursors_.size(); ++k)
+        {
+            auto const& nodes = qubit_nodes_[operand(op, k)];
+            if (cursors_[k] > 0 && nodes[cursors_[k] - 1] == latest)
+            {
+                --cursors_[k];
+            }
+        }
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
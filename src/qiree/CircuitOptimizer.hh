@@ -0,0 +1,110 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/CircuitOptimizer.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <iosfwd>
+#include <vector>
+
+#include "Circuit.hh"
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Remove redundant operations from a circuit.
+ *
+ * Each operation is compared with the earlier operations on its qubits,
+ * looking past operations it commutes with:
+ * - self-inverse gates (H, X, Y, Z, swap, and their controlled forms) cancel
+ *   with an identical gate, and S and T cancel with their adjoints;
+ * - rotations about the same Pauli operators with the same controls merge
+ *   into a single rotation; and
+ * - rotations by a multiple of \f$ 4\pi \f$ (or of \f$ 2\pi \f$ without
+ *   controls, which is a global phase) are dropped.
+ *
+ * Two operations commute if, on every qubit they share, they both act in
+ * the same Pauli basis: controls and diagonal gates such as Z, S, T, and RZ
+ * are in the Z basis, and the targets of X and RX gates are in the X basis.
+ * Diagonal gates therefore move past controls, which lets rotations on
+ * either side of a CNOT merge. Hadamard, swap, measurement, and reset
+ * operations commute only with operations on other qubits.
+ *
+ * Operation counts are accumulated over every optimized circuit so that they
+ * can be reported after a run.
+ *
+ * \code
+   CircuitOptimizer optimize;
+   Circuit result;
+   optimize(recorded, &result);
+   optimize.print_counts(std::cerr);
+ * \endcode
+ */
+class CircuitOptimizer
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using VecCount = std::vector<size_type>;
+    //!@}
+
+    //! Optimization options
+    struct Options
+    {
+        //! Rotation angle below which a rotation is the identity
+        double tolerance{1e-12};
+        //! Maximum number of commuting operations to look past
+        size_type max_depth{32};
+    };
+
+  public:
+    // Construct with default options
+    CircuitOptimizer() = default;
+
+    // Construct with options
+    explicit CircuitOptimizer(Options const& opts);
+
+    // Optimize a circuit into another
+    void operator()(Circuit const& input, Circuit* output);
+
+    //!@{
+    //! \name Accessors
+    Options const& options() const { return options_; }
+    //! Operations in every input circuit, indexed by opcode
+    VecCount const& counts_before() const { return before_; }
+    //! Operations in every output circuit, indexed by opcode
+    VecCount const& counts_after() const { return after_; }
+    //!@}
+
+    // Write a table of operation counts before and after optimization
+    void print_counts(std::ostream& os) const;
+
+  private:
+    //! Operation kept from the input
+    struct Node
+    {
+        size_type index{0};  //!< Index in the input circuit
+        double theta{0};  //!< Accumulated rotation angle
+        bool alive{true};
+    };
+
+    Options options_;
+    VecCount before_;
+    VecCount after_;
+
+    // Storage reused between circuits
+    std::vector<Node> nodes_;
+    std::vector<std::vector<size_type>> qubit_nodes_;
+    std::vector<size_type> cursors_;
+
+    bool is_identity(Circuit::OperationRef const& op) const;
+    bool combine_with_previous(Circuit const& input, size_type i);
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,157 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/DirectExecutor.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "EntryPoint.hh"
+#include "Executor.hh"
+#include "Macros.hh"
+#include "Module.hh"
+#include "QuantumInterface.hh"
+#include "RuntimeInterface.hh"
+#include "detail/QirFunctions.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Execute QIR with statically dispatched calls to concrete interfaces.
+ *
+ * The \c Executor binds QIR functions to wrappers that call through the
+ * virtual \c QuantumInterface and \c RuntimeInterface, which adds an indirect
+ * call (plus a thunk for virtual bases such as \c QuantumNotImpl) to every
+ * instruction. This executor instead binds wrappers instantiated for the
+ * given \c final classes, so the compiler devirtualizes each call and can
+ * inline implementations defined in headers. This matters for programs with
+ * classical loops that emit many instructions.
+ *
+ * The runtime interface may be the base \c RuntimeInterface if the concrete
+ * type is only known at run time. Every interface function is called by
+ * name through the concrete class, so a class that overrides only some
+ * overloads of a function must bring the others into scope with a \c using
+ * declaration.
+ *
+ * \code
+    DirectExecutor<MyQuantum, MyRuntime> execute{Module{"loop.ll"}};
+    execute(my_quantum, my_runtime);
+   \endcode
+ */
+template<class QI, class RI>
+class DirectExecutor
+{
+    static_assert(std::is_base_of_v<QuantumInterface, QI>,
+                  "quantum type must implement QuantumInterface");
+    static_assert(std::is_base_of_v<RuntimeInterface, RI>,
+                  "runtime type must implement RuntimeInterface");
+    static_assert(std::is_final_v<QI>,
+                  "quantum type must be final for calls to be devirtualized");
+
+  public:
+    //!@{
+    //! \name Type aliases
+    using Options = Executor::Options;
+    //!@}
+
+  public:
+    // Construct with a QIR module
+    inline explicit DirectExecutor(Module&& module);
+
+    // Construct with a QIR module and options
+    inline DirectExecutor(Module&& module, Options const& opts);
+
+    QIREE_DELETE_COPY_MOVE(DirectExecutor);
+
+    // Execute with the given interfaces
+    inline void operator()(QI& qi, RI& ri) const;
+
+    // Get the compiled entry point to call with arguments
+    template<class F>
+    inline EntryPoint<F, QI, RI> entry_point() const;
+
+    //! Access the underlying executor
+    Executor const& executor() const { return execute_; }
+
+  private:
+    Executor execute_;
+
+    static Executor::FunctionMap const* function_map();
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with a QIR module using the default options.
+ */
+template<class QI, class RI>
+DirectExecutor<QI, RI>::DirectExecutor(Module&& module)
+    : DirectExecutor{std::move(module), Options{}}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with a QIR module and options.
+ */
+template<class QI, class RI>
+DirectExecutor<QI, RI>::DirectExecutor(Module&& module, Options const& opts)
+    : execute_{std::move(module), opts, function_map()}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute with the given interfaces.
+ *
+ * The typed interfaces are activated for this thread in addition to the
+ * virtual ones used by \c Executor.
+ */
+template<class QI, class RI>
+void DirectExecutor<QI, RI>::operator()(QI& qi, RI& ri) const
+{
+    detail::ActiveInterfaces<QI, RI> active_interfaces{qi, ri};
+    execute_(qi, ri);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the compiled entry point to call with arguments.
+ *
+ * See \c Executor::entry_point .
+ */
+template<class QI, class RI>
+template<class F>
+EntryPoint<F, QI, RI> DirectExecutor<QI, RI>::entry_point() const
+{
+    using EP = EntryPoint<F, QI, RI>;
+    return EP{reinterpret_cast<typename EP::FunctionPtr>(
+                  execute_.entry_address(EP::signature())),
+              execute_.entry_point_attrs_};
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the addresses of the wrappers for these interface types.
+ */
+template<class QI, class RI>
+Executor::FunctionMap const* DirectExecutor<QI, RI>::function_map()
+{
+    static Executor::FunctionMap const result = [] {
+        Executor::FunctionMap result;
+        detail::bind_functions<QI, RI>([&result](char const* name, auto* f) {
+            result[name] = reinterpret_cast<void*>(f);
+        });
+        return result;
+    }();
+    return &result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
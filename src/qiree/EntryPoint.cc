@@ -0,0 +1,60 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/EntryPoint.cc
+//---------------------------------------------------------------------------//
+#include "EntryPoint.hh"
+
+#include <sstream>
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Write an IR-like representation of a native type.
+ */
+std::ostream& operator<<(std::ostream& os, NativeType const& t)
+{
+    switch (t.kind)
+    {
+        case NativeType::Kind::none:
+            return os << "void";
+        case NativeType::Kind::integer:
+            return os << 'i' << t.bits;
+        case NativeType::Kind::floating:
+            if (t.bits == 32)
+            {
+                return os << "float";
+            }
+            return os << "double";
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get an IR-like string representation of a signature.
+ */
+std::string to_string(EntrySignature const& sig)
+{
+    std::ostringstream os;
+    os << sig.result << '(';
+    char const* sep = "";
+    for (NativeType const& arg : sig.arguments)
+    {
+        os << sep << arg;
+        sep = ", ";
+    }
+    os << ')';
+    return os.str();
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,187 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/EntryPoint.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Assert.hh"
+#include "QuantumInterface.hh"
+#include "RuntimeInterface.hh"
+#include "Types.hh"
+#include "detail/EndGuard.hh"
+#include "detail/QirFunctions.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Scalar type of an entry point argument or return value.
+ */
+struct NativeType
+{
+    enum class Kind
+    {
+        none,  //!< Return type of a void function
+        integer,
+        floating,
+    };
+
+    Kind kind{Kind::none};
+    unsigned int bits{0};
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Native signature of an entry point.
+ */
+struct EntrySignature
+{
+    NativeType result;
+    std::vector<NativeType> arguments;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Native entry point function with a given signature.
+ *
+ * This is obtained from an executor (\c Executor::entry_point) after checking
+ * the C++ signature against the one in the IR. Each call activates the
+ * interfaces for the calling thread and sets them up and tears them down like
+ * the executor, but arguments and the return value are passed directly to
+ * and from the compiled code. Only integer and floating point arguments are
+ * supported.
+ *
+ * \code
+    Executor execute{Module{"kernel.ll", "kernel"}};
+    auto kernel = execute.entry_point<std::int64_t(double)>();
+    for (double theta : thetas)
+    {
+        std::int64_t result = kernel(quantum, runtime, theta);
+    }
+   \endcode
+ */
+template<class F, class QI = QuantumInterface, class RI = RuntimeInterface>
+class EntryPoint;
+
+template<class R, class... Args, class QI, class RI>
+class EntryPoint<R(Args...), QI, RI>
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using FunctionPtr = R (*)(Args...);
+    //!@}
+
+  public:
+    // Get the signature corresponding to the template parameters
+    static EntrySignature signature();
+
+    // Construct from a compiled function and its attributes
+    inline EntryPoint(FunctionPtr func, EntryPointAttrs const& attrs);
+
+    // Call with the given interfaces and arguments
+    inline R operator()(QI& qi, RI& ri, Args... args) const;
+
+    //! Access the native function
+    FunctionPtr get() const { return func_; }
+
+  private:
+    FunctionPtr func_;
+    EntryPointAttrs const* attrs_;
+};
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the native type of a C++ argument or return value.
+ */
+template<class T>
+constexpr NativeType native_type()
+{
+    if constexpr (std::is_void_v<T>)
+    {
+        return {};
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        return {NativeType::Kind::integer, 1};
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        return {NativeType::Kind::integer, 8 * sizeof(T)};
+    }
+    else
+    {
+        static_assert(std::is_floating_point_v<T>,
+                      "entry point types must be integer or floating point");
+        return {NativeType::Kind::floating, 8 * sizeof(T)};
+    }
+}
+
+//---------------------------------------------------------------------------//
+//! Whether two native types are the same
+inline bool operator==(NativeType const& lhs, NativeType const& rhs)
+{
+    return lhs.kind == rhs.kind && lhs.bits == rhs.bits;
+}
+
+//! Whether two signatures are the same
+inline bool operator==(EntrySignature const& lhs, EntrySignature const& rhs)
+{
+    return lhs.result == rhs.result && lhs.arguments == rhs.arguments;
+}
+
+// Get an IR-like string representation of a signature, e.g. "i64(double)"
+std::string to_string(EntrySignature const&);
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the signature corresponding to the template parameters.
+ */
+template<class R, class... Args, class QI, class RI>
+EntrySignature EntryPoint<R(Args...), QI, RI>::signature()
+{
+    return {native_type<R>(), {native_type<Args>()...}};
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct from a compiled function and its attributes.
+ *
+ * The attributes must outlive this object.
+ */
+template<class R, class... Args, class QI, class RI>
+EntryPoint<R(Args...), QI, RI>::EntryPoint(FunctionPtr func,
+                                           EntryPointAttrs const& attrs)
+    : func_{func}, attrs_{&attrs}
+{
+    QIREE_EXPECT(func_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Call with the given interfaces and arguments.
+ */
+template<class R, class... Args, class QI, class RI>
+R EntryPoint<R(Args...), QI, RI>::operator()(QI& qi,
+                                             RI& ri,
+                                             Args... args) const
+{
+    detail::ActiveInterfaces active_interfaces{qi, ri};
+    detail::EndGuard on_end_scope_([&qi] { qi.tear_down(); });
+    qi.set_up(*attrs_);
+    return (*func_)(args...);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -7,337 +7,378 @@
 //---------------------------------------------------------------------------//
 #include "Executor.hh"
 
-#include <iostream>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringSet.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
-#include <llvm/ExecutionEngine/GenericValue.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
-#include <llvm/Support/SourceMgr.h>
-#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
 
 #include "Assert.hh"
 #include "Module.hh"
+#include "ObjectCache.hh"
 #include "QuantumInterface.hh"
 #include "RuntimeInterface.hh"
+#include "Stopwatch.hh"
 #include "detail/EndGuard.hh"
 #include "detail/GlobalMapper.hh"
+#include "detail/LlvmUtils.hh"
+#include "detail/QirFunctions.hh"
+#include "detail/StaticBinder.hh"
 
 namespace qiree
 {
+using detail::unwrap_llvm;
+using detail::validate_llvm;
+
 namespace
 {
-//---------------------------------------------------------------------------//
-/*!
- * Pointer to active interfaces.
- *
- * LLVM's addGlobalMapping requires a global function symbol rather than a
- * std::function.
- */
-static QuantumInterface* q_interface_{nullptr};
-static RuntimeInterface* r_interface_{nullptr};
-
-//---------------------------------------------------------------------------//
-//! Generate a function name without a specialization suffix
-#define QIREE_RT_FUNCTION(FUNC) quantum__rt__##FUNC
-
-//! Generate a function name with a specialization suffix
-#define QIREE_QIS_FUNCTION(FUNC, SUFFIX) quantum__qis__##FUNC##__##SUFFIX
-
 //---------------------------------------------------------------------------//
 //!@{
-/*!
- * QIR function wrappers.
- *
- * \note These are generated from scripts/dev/generate-bindings.py .
- */
-//---------------------------------------------------------------------------//
-// MEASUREMENTS
-//---------------------------------------------------------------------------//
-std::uintptr_t QIREE_QIS_FUNCTION(m, body)(std::uintptr_t arg1)
-{
-    return q_interface_->m(Qubit{arg1}).value;
-}
-std::uintptr_t QIREE_QIS_FUNCTION(measure, body)(Array arg1, Array arg2)
-{
-    return q_interface_->measure(arg1, arg2).value;
-}
-std::uintptr_t QIREE_QIS_FUNCTION(mresetz, body)(std::uintptr_t arg1)
-{
-    return q_interface_->mresetz(Qubit{arg1}).value;
-}
-void QIREE_QIS_FUNCTION(mz, body)(std::uintptr_t arg1, std::uintptr_t arg2)
+//! Get the address from an ORC lookup result (changed in LLVM 15)
+inline std::uint64_t lookup_address(llvm::orc::ExecutorAddr addr)
 {
-    return q_interface_->mz(Qubit{arg1}, Result{arg2});
+    return addr.getValue();
 }
-bool QIREE_QIS_FUNCTION(read_result, body)(std::uintptr_t arg1)
+template<class T>
+std::uint64_t lookup_address(T const& sym)
 {
-    return static_cast<bool>(q_interface_->read_result(Result{arg1}));
+    return sym.getAddress();
 }
+//!@}
+
 //---------------------------------------------------------------------------//
-// GATES
-//---------------------------------------------------------------------------//
-void QIREE_QIS_FUNCTION(ccx, body)(std::uintptr_t arg1,
-                                   std::uintptr_t arg2,
-                                   std::uintptr_t arg3)
-{
-    return q_interface_->ccx(Qubit{arg1}, Qubit{arg2}, Qubit{arg3});
-}
-void QIREE_QIS_FUNCTION(cnot, body)(std::uintptr_t arg1, std::uintptr_t arg2)
-{
-    return q_interface_->cnot(Qubit{arg1}, Qubit{arg2});
-}
-void QIREE_QIS_FUNCTION(cx, body)(std::uintptr_t arg1, std::uintptr_t arg2)
-{
-    return q_interface_->cx(Qubit{arg1}, Qubit{arg2});
-}
-void QIREE_QIS_FUNCTION(cy, body)(std::uintptr_t arg1, std::uintptr_t arg2)
-{
-    return q_interface_->cy(Qubit{arg1}, Qubit{arg2});
-}
-void QIREE_QIS_FUNCTION(cz, body)(std::uintptr_t arg1, std::uintptr_t arg2)
-{
-    return q_interface_->cz(Qubit{arg1}, Qubit{arg2});
-}
-void QIREE_QIS_FUNCTION(exp, adj)(Array arg1, double arg2, Array arg3)
-{
-    return q_interface_->exp_adj(arg1, arg2, arg3);
-}
-void QIREE_QIS_FUNCTION(exp, body)(Array arg1, double arg2, Array arg3)
-{
-    return q_interface_->exp(arg1, arg2, arg3);
-}
-void QIREE_QIS_FUNCTION(exp, ctl)(Array arg1, Tuple arg2)
-{
-    return q_interface_->exp(arg1, arg2);
-}
-void QIREE_QIS_FUNCTION(exp, ctladj)(Array arg1, Tuple arg2)
-{
-    return q_interface_->exp_adj(arg1, arg2);
-}
-void QIREE_QIS_FUNCTION(h, body)(std::uintptr_t arg1)
-{
-    return q_interface_->h(Qubit{arg1});
-}
-void QIREE_QIS_FUNCTION(h, ctl)(Array arg1, std::uintptr_t arg2)
-{
-    return q_interface_->h(arg1, Qubit{arg2});
-}
-void QIREE_QIS_FUNCTION(r,
-                        adj)(pauli_type arg1, double arg2, std::uintptr_t arg3)
-{
-    return q_interface_->r_adj(static_cast<Pauli>(arg1), arg2, Qubit{arg3});
-}
-void QIREE_QIS_FUNCTION(r,
-                        body)(pauli_type arg1, double arg2, std::uintptr_t arg3)
-{
-    return q_interface_->r(static_cast<Pauli>(arg1), arg2, Qubit{arg3});
-}
-void QIREE_QIS_FUNCTION(r, ctl)(Array arg1, Tuple arg2)
-{
-    return q_interface_->r(arg1, arg2);
-}
-void QIREE_QIS_FUNCTION(r, ctladj)(Array arg1, Tuple arg2)
-{
-    return q_interface_->r_adj(arg1, arg2);
-}
-void QIREE_QIS_FUNCTION(reset, body)(std::uintptr_t arg1)
-{
-    return q_interface_->reset(Qubit{arg1});
-}
-void QIREE_QIS_FUNCTION(rx, body)(double arg1, std::uintptr_t arg2)
-{
-    return q_interface_->rx(arg1, Qubit{arg2});
-}
-void QIREE_QIS_FUNCTION(rx, ctl)(Array arg1, Tuple arg2)
-{
-    return q_interface_->rx(arg1, arg2);
-}
-void QIREE_QIS_FUNCTION(rxx, body)(double arg1,
-                                   std::uintptr_t arg2,
-                                   std::uintptr_t arg3)
-{
-    return q_interface_->rxx(arg1, Qubit{arg2}, Qubit{arg3});
-}
-void QIREE_QIS_FUNCTION(ry, body)(double arg1, std::uintptr_t arg2)
-{
-    return q_interface_->ry(arg1, Qubit{arg2});
-}
-void QIREE_QIS_FUNCTION(ry, ctl)(Array arg1, Tuple arg2)
-{
-    return q_interface_->ry(arg1, arg2);
-}
-void QIREE_QIS_FUNCTION(ryy, body)(double arg1,
-                                   std::uintptr_t arg2,
-                                   std::uintptr_t arg3)
-{
-    return q_interface_->ryy(arg1, Qubit{arg2}, Qubit{arg3});
-}
-void QIREE_QIS_FUNCTION(rz, body)(double arg1, std::uintptr_t arg2)
-{
-    return q_interface_->rz(arg1, Qubit{arg2});
-}
-void QIREE_QIS_FUNCTION(rz, ctl)(Array arg1, Tuple arg2)
-{
-    return q_interface_->rz(arg1, arg2);
-}
-void QIREE_QIS_FUNCTION(rzz, body)(double arg1,
-                                   std::uintptr_t arg2,
-                                   std::uintptr_t arg3)
-{
-    return q_interface_->rzz(arg1, Qubit{arg2}, Qubit{arg3});
-}
-void QIREE_QIS_FUNCTION(s, adj)(std::uintptr_t arg1)
-{
-    return q_interface_->s_adj(Qubit{arg1});
-}
-void QIREE_QIS_FUNCTION(s, body)(std::uintptr_t arg1)
-{
-    return q_interface_->s(Qubit{arg1});
-}
-void QIREE_QIS_FUNCTION(s, ctl)(Array arg1, std::uintptr_t arg2)
-{
-    return q_interface_->s(arg1, Qubit{arg2});
-}
-void QIREE_QIS_FUNCTION(s, ctladj)(Array arg1, std::uintptr_t arg2)
-{
-    return q_interface_->s_adj(arg1, Qubit{arg2});
-}
-void QIREE_QIS_FUNCTION(swap, body)(std::uintptr_t arg1, std::uintptr_t arg2)
-{
-    return q_interface_->swap(Qubit{arg1}, Qubit{arg2});
-}
-void QIREE_QIS_FUNCTION(t, adj)(std::uintptr_t arg1)
-{
-    return q_interface_->t_adj(Qubit{arg1});
-}
-void QIREE_QIS_FUNCTION(t, body)(std::uintptr_t arg1)
-{
-    return q_interface_->t(Qubit{arg1});
-}
-void QIREE_QIS_FUNCTION(t, ctl)(Array arg1, std::uintptr_t arg2)
-{
-    return q_interface_->t(arg1, Qubit{arg2});
-}
-void QIREE_QIS_FUNCTION(t, ctladj)(Array arg1, std::uintptr_t arg2)
-{
-    return q_interface_->t_adj(arg1, Qubit{arg2});
-}
-void QIREE_QIS_FUNCTION(x, body)(std::uintptr_t arg1)
-{
-    return q_interface_->x(Qubit{arg1});
-}
-void QIREE_QIS_FUNCTION(x, ctl)(Array arg1, std::uintptr_t arg2)
-{
-    return q_interface_->x(arg1, Qubit{arg2});
-}
-void QIREE_QIS_FUNCTION(y, body)(std::uintptr_t arg1)
-{
-    return q_interface_->y(Qubit{arg1});
-}
-void QIREE_QIS_FUNCTION(y, ctl)(Array arg1, std::uintptr_t arg2)
+/*!
+ * Create an ORC absolute symbol definition for an in-process function.
+ */
+auto make_absolute_symbol(void* addr)
 {
-    return q_interface_->y(arg1, Qubit{arg2});
+    auto flags = llvm::JITSymbolFlags::Exported
+                 | llvm::JITSymbolFlags::Callable;
+#if LLVM_VERSION_MAJOR >= 17
+    return llvm::orc::ExecutorSymbolDef{llvm::orc::ExecutorAddr::fromPtr(addr),
+                                        flags};
+#else
+    return llvm::JITEvaluatedSymbol{llvm::pointerToJITTargetAddress(addr),
+                                    flags};
+#endif
 }
-void QIREE_QIS_FUNCTION(z, body)(std::uintptr_t arg1)
-{
-    return q_interface_->z(Qubit{arg1});
+
+//---------------------------------------------------------------------------//
+/*!
+ * Wrap a module for use by ORC, moving it into a JIT-owned context.
+ *
+ * Modules loaded from files own their context, which is simply transferred.
+ * Externally created modules are copied (through bitcode) into a new context.
+ */
+llvm::orc::ThreadSafeModule
+make_thread_safe(Module::UPModule module, Module::UPContext context)
+{
+    if (!context)
+    {
+        llvm::SmallVector<char, 0> buffer;
+        {
+            llvm::raw_svector_ostream os{buffer};
+            llvm::WriteBitcodeToFile(*module, os);
+        }
+        context = std::make_unique<llvm::LLVMContext>();
+        module = unwrap_llvm(
+            llvm::parseBitcodeFile(
+                llvm::MemoryBufferRef{
+                    llvm::StringRef{buffer.data(), buffer.size()},
+                    module->getModuleIdentifier()},
+                *context),
+            "failed to copy QIR module into JIT context");
+    }
+    return llvm::orc::ThreadSafeModule{
+        std::move(module), llvm::orc::ThreadSafeContext{std::move(context)}};
 }
-void QIREE_QIS_FUNCTION(z, ctl)(Array arg1, std::uintptr_t arg2)
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the IR representation of a type.
+ */
+std::string type_to_string(llvm::Type const& t)
 {
-    return q_interface_->z(arg1, Qubit{arg2});
+    std::string result;
+    llvm::raw_string_ostream os{result};
+    t.print(os);
+    return os.str();
 }
+
 //---------------------------------------------------------------------------//
-// ASSERTIONS
-//---------------------------------------------------------------------------//
-void QIREE_QIS_FUNCTION(assertmeasurementprobability, body)(Array arg1,
-                                                            Array arg2,
-                                                            std::uintptr_t arg3,
-                                                            double arg4,
-                                                            std::uintptr_t arg5,
-                                                            double arg6)
-{
-    return q_interface_->assertmeasurementprobability(
-        arg1, arg2, Result{arg3}, arg4, String{arg5}, arg6);
+/*!
+ * Get the native type of an entry point argument or return value.
+ */
+NativeType to_native_type(llvm::Type const& t, std::string const& entry_name)
+{
+    bool const is_integer = t.isIntegerTy() && t.getIntegerBitWidth() <= 64;
+    bool const is_floating = t.isFloatTy() || t.isDoubleTy();
+    QIREE_VALIDATE(t.isVoidTy() || is_integer || is_floating,
+                   << "entry point '" << entry_name
+                   << "' has an unsupported argument or return type '"
+                   << type_to_string(t) << "'");
+
+    if (is_integer)
+    {
+        return {NativeType::Kind::integer, t.getIntegerBitWidth()};
+    }
+    if (is_floating)
+    {
+        return {NativeType::Kind::floating, t.isFloatTy() ? 32u : 64u};
+    }
+    return {};
 }
-void QIREE_QIS_FUNCTION(assertmeasurementprobability, ctl)(Array arg1,
-                                                           Tuple arg2)
-{
-    return q_interface_->assertmeasurementprobability(arg1, arg2);
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the native signature of an entry point.
+ */
+EntrySignature load_entry_signature(llvm::Function const& func)
+{
+    std::string const name = func.getName().str();
+    llvm::FunctionType const& ftype = *func.getFunctionType();
+    QIREE_VALIDATE(!ftype.isVarArg(),
+                   << "entry point '" << name << "' cannot be variadic");
+
+    EntrySignature result;
+    result.result = to_native_type(*ftype.getReturnType(), name);
+    for (llvm::Type const* t : ftype.params())
+    {
+        NativeType arg = to_native_type(*t, name);
+        QIREE_VALIDATE(arg.kind != NativeType::Kind::none,
+                       << "entry point '" << name
+                       << "' has an invalid argument type");
+        result.arguments.push_back(arg);
+    }
+    return result;
 }
 
 //---------------------------------------------------------------------------//
-// RUNTIME
+}  // namespace
+
 //---------------------------------------------------------------------------//
-void QIREE_RT_FUNCTION(initialize)(OptionalCString env)
-{
-    return r_interface_->initialize(env);
-}
-void QIREE_RT_FUNCTION(array_record_output)(size_type s, OptionalCString tag)
-{
-    return r_interface_->array_record_output(s, tag);
-}
-void QIREE_RT_FUNCTION(tuple_record_output)(size_type s, OptionalCString tag)
-{
-    return r_interface_->tuple_record_output(s, tag);
-}
-void QIREE_RT_FUNCTION(result_record_output)(std::uintptr_t r,
-                                             OptionalCString tag)
+/*!
+ * Construct with a QIR module using the default options.
+ */
+Executor::Executor(Module&& module) : Executor{std::move(module), Options{}}
 {
-    return r_interface_->result_record_output(Result{r}, tag);
 }
 
-Array QIREE_RT_FUNCTION(array_create_1d)(uint32_t elem_size, uint64_t length)
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with a QIR module and options.
+ */
+Executor::Executor(Module&& module, Options const& opts)
+    : Executor{std::move(module), opts, nullptr}
 {
-    return r_interface_->array_create_1d(elem_size, length);
 }
 
-void QIREE_RT_FUNCTION(array_update_reference_count)(Array array, int32_t delta)
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with QIR wrappers for specific interface types.
+ *
+ * The function map (owned by \c DirectExecutor) replaces the address of each
+ * virtual wrapper by the one instantiated for the concrete interfaces.
+ */
+Executor::Executor(Module&& module,
+                   Options const& opts,
+                   FunctionMap const* direct_functions)
+    : engine_{opts.engine}
+    , object_cache_{opts.object_cache}
+    , direct_functions_{direct_functions}
 {
-    r_interface_->array_update_reference_count(array, delta);
-}
+    QIREE_EXPECT(module);
+    QIREE_EXPECT(module.entrypoint_ && module.module_);
 
-void* QIREE_RT_FUNCTION(array_get_element_ptr_1d)(Array array, uint64_t index)
-{
-    return r_interface_->array_get_element_ptr_1d(array, index);
-}
+    // Save module and entry point attributes
+    entry_point_attrs_ = module.load_entry_point_attrs();
+    entry_signature_ = load_entry_signature(*module.entrypoint_);
+    module_flags_ = module.load_module_flags();
 
-uint64_t QIREE_RT_FUNCTION(array_get_size_1d)(Array array)
-{
-    return r_interface_->array_get_size_1d(array);
+    // Initialize LLVM
+    detail::initialize_llvm();
+
+    // The entry point must be visible to the JIT's symbol lookup (and
+    // must not be removed by the optimizer)
+    if (module.entrypoint_->hasLocalLinkage())
+    {
+        module.entrypoint_->setLinkage(llvm::GlobalValue::ExternalLinkage);
+    }
+
+    // Optimize the module
+    Stopwatch get_time;
+    if (opts.qis_inaccessible_memory)
+    {
+        detail::mark_qis_inaccessible_memory(*module.module_);
+    }
+    if (opts.opt_level != OptLevel::O0)
+    {
+        // Target information lets the passes make host-specific decisions
+        auto jtmb = unwrap_llvm(
+            llvm::orc::JITTargetMachineBuilder::detectHost(),
+            "failed to detect host target");
+        auto tm = unwrap_llvm(jtmb.createTargetMachine(),
+                              "failed to create target machine");
+        detail::optimize_module(*module.module_, opts.opt_level, *tm);
+    }
+    timing_.optimize = get_time();
+
+    // Create the JIT if needed
+    get_time = {};
+    if (opts.static_replay && entry_signature_ == EntrySignature{}
+        && module.is_straight_line())
+    {
+        static_replay_ = this->build_static(module);
+    }
+    if (static_replay_)
+    {
+        // The IR is no longer needed
+        module = Module{};
+    }
+    else
+    {
+        switch (engine_)
+        {
+            case Engine::mcjit:
+                this->build_mcjit(std::move(module));
+                break;
+            case Engine::orc_lazy:
+                this->build_orc_lazy(std::move(module));
+                break;
+            default:
+                QIREE_ASSERT_UNREACHABLE();
+        }
+    }
+
+    timing_.build = get_time();
+    direct_functions_ = nullptr;
+
+    QIREE_ENSURE(!module);
+    QIREE_ENSURE(static_replay_ || ((ee_ || jit_) && entry_func_));
 }
 
-Tuple QIREE_RT_FUNCTION(tuple_create)(uint64_t num_bytes)
+//---------------------------------------------------------------------------//
+//! Default destructor
+Executor::~Executor() = default;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute with the given interface functions.
+ */
+void Executor::operator()(QuantumInterface& qi, RuntimeInterface& ri) const
 {
-    return r_interface_->tuple_create(num_bytes);
+    QIREE_EXPECT(static_replay_ || entry_func_);
+    QIREE_VALIDATE(entry_signature_.arguments.empty(),
+                   << "entry point with signature '"
+                   << to_string(entry_signature_)
+                   << "' must be called with arguments");
+
+    // Activate the interfaces for this thread, saving any from an enclosing
+    // execution, and tear down before restoring them
+    detail::ActiveInterfaces active_interfaces{qi, ri};
+    detail::EndGuard on_end_scope_([&qi] { qi.tear_down(); });
+
+    // Call setup on the interface
+    qi.set_up(entry_point_attrs_);
+
+    // Execute the main function
+    if (static_replay_)
+    {
+        for (auto const& call : static_calls_)
+        {
+            call();
+        }
+    }
+    else
+    {
+        // Any return value is ignored
+        (*entry_func_)();
+    }
 }
 
-void QIREE_RT_FUNCTION(tuple_update_reference_count)(Tuple tuple, int32_t delta)
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Check the signature and get the address of the entry point.
+ */
+void* Executor::entry_address(EntrySignature const& sig) const
 {
-    return r_interface_->tuple_update_reference_count(tuple, delta);
+    QIREE_VALIDATE(!static_replay_,
+                   << "entry point is replayed rather than compiled: "
+                      "disable static replay to call it directly");
+    QIREE_VALIDATE(sig == entry_signature_,
+                   << "requested entry point signature '" << to_string(sig)
+                   << "' does not match '" << to_string(entry_signature_)
+                   << "'");
+    QIREE_ASSERT(entry_func_);
+    return reinterpret_cast<void*>(entry_func_);
 }
 
-//!@}
 //---------------------------------------------------------------------------//
-}  // namespace
+/*!
+ * Bind all QIR functions, substituting direct wrappers if available.
+ *
+ * The direct wrappers have the same signatures as the virtual ones since
+ * they're instantiated from the same template.
+ */
+template<class BindFunction>
+void Executor::bind_functions(BindFunction&& bind_function) const
+{
+    detail::bind_functions([this, &bind_function](char const* name,
+                                                  auto* func) {
+        if (direct_functions_)
+        {
+            auto iter = direct_functions_->find(name);
+            QIREE_ASSERT(iter != direct_functions_->end());
+            func = reinterpret_cast<decltype(func)>(iter->second);
+        }
+        bind_function(name, func);
+    });
+}
 
 //---------------------------------------------------------------------------//
 /*!
- * Construct with a QIR input filename.
+ * Extract the calls of a straight-line entry point for replay.
+ *
+ * The constant arguments of each call are bound to the same wrapper functions
+ * used by the JIT. This returns false (leaving the module to be compiled) if
+ * any call is to an unknown function or has an argument that can't be
+ * converted.
  */
-Executor::Executor(Module&& module)
-    : entrypoint_{module.entrypoint_}, module_{module.module_.get()}
+bool Executor::build_static(Module const& module)
 {
-    QIREE_EXPECT(module);
-    QIREE_EXPECT(entrypoint_ && module_);
+    QIREE_EXPECT(module.is_straight_line());
 
-    // Save module and entry point attributes
-    entry_point_attrs_ = module.load_entry_point_attrs();
-    module_flags_ = module.load_module_flags();
+    detail::StaticBinder binder{*module.entrypoint_};
+    this->bind_functions(binder);
+    if (!binder.complete())
+    {
+        return false;
+    }
+    static_calls_ = binder.release();
+    return true;
+}
 
-    // Initialize LLVM
-    llvm::InitializeNativeTarget();
-    llvm::InitializeNativeTargetAsmPrinter();
-    LLVMLinkInMCJIT();
+//---------------------------------------------------------------------------//
+/*!
+ * Create an MCJIT execution engine that compiles the whole module.
+ */
+void Executor::build_mcjit(Module&& module)
+{
+    std::string const entry_name = module.entrypoint_->getName().str();
+    llvm::Module* llmod = module.module_.get();
 
     // Create execution engine by capturing the module
     ee_ = [&module] {
@@ -358,6 +399,16 @@ Executor::Executor(Module&& module)
         return ee;
     }();
 
+    // The engine now owns the module, but the context must outlive it
+    ee_context_ = std::move(module.context_);
+    module.entrypoint_ = nullptr;
+
+    // Reuse previously compiled objects
+    if (object_cache_)
+    {
+        ee_->setObjectCache(object_cache_->llvm_cache());
+    }
+
     // Suppress symbol lookup in system dynamic libraries
     ee_->DisableSymbolSearching(true);
 
@@ -367,109 +418,127 @@ Executor::Executor(Module&& module)
     });
 
     // Bind functions if available
-    detail::GlobalMapper bind_function(*module_, ee_.get());
-#define QIREE_BIND_RT_FUNCTION(FUNC) \
-    bind_function("__quantum__rt__" #FUNC, QIREE_RT_FUNCTION(FUNC))
-#define QIREE_BIND_QIS_FUNCTION(FUNC, SUFFIX)            \
-    bind_function("__quantum__qis__" #FUNC "__" #SUFFIX, \
-                  QIREE_QIS_FUNCTION(FUNC, SUFFIX))
-    // Measurements
-    QIREE_BIND_QIS_FUNCTION(m, body);
-    QIREE_BIND_QIS_FUNCTION(measure, body);
-    QIREE_BIND_QIS_FUNCTION(mresetz, body);
-    QIREE_BIND_QIS_FUNCTION(mz, body);
-    QIREE_BIND_QIS_FUNCTION(read_result, body);
-    // Gates
-    QIREE_BIND_QIS_FUNCTION(ccx, body);
-    QIREE_BIND_QIS_FUNCTION(cnot, body);
-    QIREE_BIND_QIS_FUNCTION(cx, body);
-    QIREE_BIND_QIS_FUNCTION(cy, body);
-    QIREE_BIND_QIS_FUNCTION(cz, body);
-    QIREE_BIND_QIS_FUNCTION(exp, adj);
-    QIREE_BIND_QIS_FUNCTION(exp, body);
-    QIREE_BIND_QIS_FUNCTION(exp, ctl);
-    QIREE_BIND_QIS_FUNCTION(exp, ctladj);
-    QIREE_BIND_QIS_FUNCTION(h, body);
-    QIREE_BIND_QIS_FUNCTION(h, ctl);
-    QIREE_BIND_QIS_FUNCTION(r, adj);
-    QIREE_BIND_QIS_FUNCTION(r, body);
-    QIREE_BIND_QIS_FUNCTION(r, ctl);
-    QIREE_BIND_QIS_FUNCTION(r, ctladj);
-    QIREE_BIND_QIS_FUNCTION(reset, body);
-    QIREE_BIND_QIS_FUNCTION(rx, body);
-    QIREE_BIND_QIS_FUNCTION(rx, ctl);
-    QIREE_BIND_QIS_FUNCTION(rxx, body);
-    QIREE_BIND_QIS_FUNCTION(ry, body);
-    QIREE_BIND_QIS_FUNCTION(ry, ctl);
-    QIREE_BIND_QIS_FUNCTION(ryy, body);
-    QIREE_BIND_QIS_FUNCTION(rz, body);
-    QIREE_BIND_QIS_FUNCTION(rz, ctl);
-    QIREE_BIND_QIS_FUNCTION(rzz, body);
-    QIREE_BIND_QIS_FUNCTION(s, adj);
-    QIREE_BIND_QIS_FUNCTION(s, body);
-    QIREE_BIND_QIS_FUNCTION(s, ctl);
-    QIREE_BIND_QIS_FUNCTION(s, ctladj);
-    QIREE_BIND_QIS_FUNCTION(swap, body);
-    QIREE_BIND_QIS_FUNCTION(t, adj);
-    QIREE_BIND_QIS_FUNCTION(t, body);
-    QIREE_BIND_QIS_FUNCTION(t, ctl);
-    QIREE_BIND_QIS_FUNCTION(t, ctladj);
-    QIREE_BIND_QIS_FUNCTION(x, body);
-    QIREE_BIND_QIS_FUNCTION(x, ctl);
-    QIREE_BIND_QIS_FUNCTION(y, body);
-    QIREE_BIND_QIS_FUNCTION(y, ctl);
-    QIREE_BIND_QIS_FUNCTION(z, body);
-    QIREE_BIND_QIS_FUNCTION(z, ctl);
-    // Assertions
-    QIREE_BIND_QIS_FUNCTION(assertmeasurementprobability, body);
-    QIREE_BIND_QIS_FUNCTION(assertmeasurementprobability, ctl);
-
-    QIREE_BIND_RT_FUNCTION(array_create_1d);
-    QIREE_BIND_RT_FUNCTION(array_update_reference_count);
-    QIREE_BIND_RT_FUNCTION(array_get_element_ptr_1d);
-    QIREE_BIND_RT_FUNCTION(array_get_size_1d);
-    QIREE_BIND_RT_FUNCTION(tuple_create);
-    QIREE_BIND_RT_FUNCTION(tuple_update_reference_count);
-
-    QIREE_BIND_RT_FUNCTION(initialize);
-    QIREE_BIND_RT_FUNCTION(array_record_output);
-    QIREE_BIND_RT_FUNCTION(tuple_record_output);
-    QIREE_BIND_RT_FUNCTION(result_record_output);
-#undef QIREE_BIND_RT_FUNCTION
-#undef QIREE_BIND_QIS_FUNCTION
+    this->bind_functions(detail::GlobalMapper{*llmod, ee_.get()});
 
-    QIREE_ENSURE(!module);
+    // Compile the module and get the entry point so that later calls don't
+    // need the engine's lock
+    entry_func_ = reinterpret_cast<EntryFunction>(
+        static_cast<std::uintptr_t>(ee_->getFunctionAddress(entry_name)));
+    QIREE_VALIDATE(entry_func_,
+                   << "failed to compile entry point '" << entry_name << "'");
 }
 
 //---------------------------------------------------------------------------//
-//! Default destructor
-Executor::~Executor() = default;
+/*!
+ * Create an ORC JIT that lazily compiles functions on their first call.
+ *
+ * Every function in the module is replaced by a stub that compiles it (and
+ * only it) when first called. Calls to QIR functions are resolved against the
+ * same binding table used by MCJIT; any other external symbols (e.g. \c
+ * memset emitted by code generation) are resolved from the current process.
+ */
+void Executor::build_orc_lazy(Module&& module)
+{
+    using namespace llvm::orc;
+
+    llvm::Module& llmod = *module.module_;
+    std::string const entry_name = module.entrypoint_->getName().str();
+
+    // Create the JIT
+    auto jtmb = unwrap_llvm(JITTargetMachineBuilder::detectHost(),
+                            "failed to detect host target");
+    jtmb.getOptions().ExceptionModel = llvm::ExceptionHandling::DwarfCFI;
+    LLLazyJITBuilder builder;
+    builder.setJITTargetMachineBuilder(std::move(jtmb));
+
+    // Functions may be compiled lazily from several threads at once, so use a
+    // compiler that creates a target machine for each module rather than
+    // sharing one. Each lazily compiled function is cached separately.
+    builder.setCompileFunctionCreator(
+        [cache = object_cache_ ? object_cache_->llvm_cache() : nullptr](
+            JITTargetMachineBuilder jtmb)
+            -> llvm::Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
+            return std::make_unique<ConcurrentIRCompiler>(std::move(jtmb),
+                                                          cache);
+        });
+    jit_ = unwrap_llvm(builder.create(), "failed to create ORC JIT");
+    llmod.setDataLayout(jit_->getDataLayout());
+
+    // Bind QIR functions as absolute symbols in the main library
+    JITDylib& jd = jit_->getMainJITDylib();
+    SymbolMap symbols;
+    llvm::StringSet<> bound;
+    this->bind_functions(detail::GlobalMapper{
+        llmod, [this, &symbols, &bound](llvm::Function& irfunc, void* addr) {
+            symbols[jit_->mangleAndIntern(irfunc.getName())]
+                = make_absolute_symbol(addr);
+            bound.insert(irfunc.getName());
+        }});
+
+    // Reachable unbound QIR functions would only fail during lazy
+    // compilation, so check them now
+    detail::validate_reachable_bindings(*module.entrypoint_, bound);
+    validate_llvm(jd.define(absoluteSymbols(std::move(symbols))),
+                  "failed to bind QIR functions");
+
+    // Resolve non-QIR external symbols from the running process
+    jd.addGenerator(unwrap_llvm(
+        DynamicLibrarySearchGenerator::GetForCurrentProcess(
+            jit_->getDataLayout().getGlobalPrefix(),
+            [](SymbolStringPtr const& name) {
+                return !(*name).startswith("__quantum__");
+            }),
+        "failed to create process symbol generator"));
+
+    // Add the module: nothing is compiled yet
+    module.entrypoint_ = nullptr;
+    validate_llvm(jit_->addLazyIRModule(make_thread_safe(
+                      std::move(module.module_), std::move(module.context_))),
+                  "failed to add QIR module to JIT");
+
+    // Look up the (uncompiled) entry point stub
+    auto addr = lookup_address(
+        unwrap_llvm(jit_->lookup(entry_name), "failed to find entry point"));
+    entry_func_ = reinterpret_cast<EntryFunction>(
+        static_cast<std::uintptr_t>(addr));
+}
 
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
 //---------------------------------------------------------------------------//
 /*!
- * Execute with the given interface functions.
+ * Get a string representation of a JIT engine.
  */
-void Executor::operator()(QuantumInterface& qi, RuntimeInterface& ri) const
+char const* to_cstring(Executor::Engine value)
 {
-    QIREE_EXPECT(ee_);
-
-    QIREE_VALIDATE(!q_interface_ && !r_interface_,
-                   << "cannot call LLVM executor recursively or in MT "
-                      "environment (for now)");
-    detail::EndGuard on_end_scope_([] {
-        q_interface_->tear_down();
-        q_interface_ = nullptr;
-        r_interface_ = nullptr;
-    });
-    q_interface_ = &qi;
-    r_interface_ = &ri;
-
-    // Call setup on the interface
-    qi.set_up(entry_point_attrs_);
+    switch (value)
+    {
+        case Executor::Engine::mcjit:
+            return "mcjit";
+        case Executor::Engine::orc_lazy:
+            return "orc_lazy";
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
 
-    // Execute the main function
-    auto result = ee_->runFunction(entrypoint_, {});
-    QIREE_DISCARD(result);
+//---------------------------------------------------------------------------//
+/*!
+ * Get a string representation of an optimization level.
+ */
+char const* to_cstring(Executor::OptLevel value)
+{
+    switch (value)
+    {
+        case Executor::OptLevel::O0:
+            return "O0";
+        case Executor::OptLevel::O1:
+            return "O1";
+        case Executor::OptLevel::O2:
+            return "O2";
+        case Executor::OptLevel::O3:
+            return "O3";
+    }
+    QIREE_ASSERT_UNREACHABLE();
 }
 
 //---------------------------------------------------------------------------//
@@ -7,36 +7,108 @@
 //---------------------------------------------------------------------------//
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
+#include "EntryPoint.hh"
 #include "Macros.hh"
 #include "Types.hh"
 
 namespace llvm
 {
+class LLVMContext;
 class Module;
 class ExecutionEngine;
-class Function;
+namespace orc
+{
+class LLLazyJIT;
+}  // namespace orc
 }  // namespace llvm
 
 namespace qiree
 {
 //---------------------------------------------------------------------------//
 class Module;
+class ObjectCache;
 class QuantumInterface;
 class RuntimeInterface;
 
 //---------------------------------------------------------------------------//
 /*!
  * Set up and run an LLVM Execution Engine that wraps QIR.
+ *
+ * By default the module is compiled with the ORC "lazy" JIT, which emits a
+ * compile-on-first-call stub for every function in the module: only the
+ * functions actually reachable from the entry point are ever compiled. The
+ * legacy MCJIT engine, which compiles the entire module before execution, is
+ * still available through the construction options.
+ *
+ * Straight-line programs (a single block of quantum and runtime calls with
+ * constant arguments, typical of the QIR base profile) don't need a JIT at
+ * all: unless disabled by the options, their calls are extracted from the IR
+ * and replayed directly. Programs with classical control flow fall back to
+ * the JIT.
+ *
+ * The entry point may take integer and floating point arguments and return
+ * such a value: \c entry_point returns a typed native function that can be
+ * called repeatedly (e.g. for a parameter sweep) with arguments.
+ *
+ * Executing is thread-safe: the interfaces passed to each call are visible
+ * only to the calling thread, so the same executor (or independent ones) can
+ * run concurrently on several threads with separate interfaces. An interface
+ * may also invoke another executor from inside a QIR function call.
  */
 class Executor
 {
   public:
-    // Construct with a QIR input filename and function name
+    //! JIT engine used to compile and run the module
+    enum class Engine
+    {
+        mcjit,  //!< Compile the whole module before execution
+        orc_lazy,  //!< Compile each function on its first call
+    };
+
+    //! LLVM optimization pipeline run before code generation
+    enum class OptLevel
+    {
+        O0,  //!< Execute the module as parsed
+        O1,
+        O2,
+        O3,
+    };
+
+    //! Construction options
+    struct Options
+    {
+        Engine engine{Engine::orc_lazy};
+        //! Optional persistent cache of compiled objects
+        std::shared_ptr<ObjectCache> object_cache;
+        //! Optimization pipeline applied to the module
+        OptLevel opt_level{OptLevel::O0};
+        //! Let the optimizer assume QIS calls don't touch classical memory
+        bool qis_inaccessible_memory{false};
+        //! Replay straight-line programs without compiling them
+        bool static_replay{true};
+    };
+
+    //! Time spent [s] preparing the module during construction
+    struct Timing
+    {
+        double optimize{0};  //!< Running the optimization pipeline
+        double build{0};  //!< Creating the JIT (and compiling for MCJIT)
+    };
+
+  public:
+    // Construct with a QIR module
     explicit Executor(Module&& module);
 
+    // Construct with a QIR module and options
+    Executor(Module&& module, Options const& opts);
+
     // Default destructor
     ~Executor();
 
@@ -45,14 +117,96 @@ class Executor
     // Execute with the given interface functions
     void operator()(QuantumInterface& qi, RuntimeInterface& ri) const;
 
+    // Get the compiled entry point to call with arguments
+    template<class F>
+    inline EntryPoint<F> entry_point() const;
+
+    //! Native signature of the entry point
+    EntrySignature const& entry_signature() const { return entry_signature_; }
+
+    //! JIT engine used by this executor (unused for static replay)
+    Engine engine() const { return engine_; }
+
+    //! Whether the program is replayed without a JIT
+    bool static_replay() const { return static_replay_; }
+
+    //! Time spent during construction
+    Timing const& timing() const { return timing_; }
+
   private:
-    llvm::Function* entrypoint_{nullptr};
-    llvm::Module* module_{nullptr};
+    using EntryFunction = void (*)();
+    using FunctionMap = std::unordered_map<std::string_view, void*>;
 
+    Engine engine_;
     EntryPointAttrs entry_point_attrs_;
+    EntrySignature entry_signature_;
     ModuleFlags module_flags_;
+    std::shared_ptr<ObjectCache> object_cache_;
+    Timing timing_;
+
+    // MCJIT engine (the context must outlive the engine's module)
+    std::unique_ptr<llvm::LLVMContext> ee_context_;
     std::unique_ptr<llvm::ExecutionEngine> ee_;
+
+    // ORC engine
+    std::unique_ptr<llvm::orc::LLLazyJIT> jit_;
+
+    // Native entry point
+    EntryFunction entry_func_{nullptr};
+
+    // Calls replayed in place of a straight-line entry point
+    bool static_replay_{false};
+    std::vector<std::function<void()>> static_calls_;
+
+    // Addresses replacing the virtual QIR wrappers during construction
+    FunctionMap const* direct_functions_{nullptr};
+
+    // Construct with QIR wrappers for specific interface types
+    Executor(Module&& module,
+             Options const& opts,
+             FunctionMap const* direct_functions);
+
+    template<class QI, class RI>
+    friend class DirectExecutor;
+
+    // Check the signature and get the address of the entry point
+    void* entry_address(EntrySignature const& sig) const;
+
+    template<class BindFunction>
+    void bind_functions(BindFunction&& bind_function) const;
+    bool build_static(Module const& module);
+    void build_mcjit(Module&& module);
+    void build_orc_lazy(Module&& module);
 };
 
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+// Get a string representation of a JIT engine
+char const* to_cstring(Executor::Engine);
+
+// Get a string representation of an optimization level
+char const* to_cstring(Executor::OptLevel);
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the compiled entry point to call with arguments.
+ *
+ * The function type \c F (e.g. \c std::int64_t(double) ) must match the
+ * entry point's signature in the IR. Straight-line programs are only
+ * replayed if the entry point has no arguments or return value; construct
+ * with \c static_replay disabled to get a native \c void() entry point.
+ */
+template<class F>
+EntryPoint<F> Executor::entry_point() const
+{
+    using EP = EntryPoint<F>;
+    return EP{reinterpret_cast<typename EP::FunctionPtr>(
+                  this->entry_address(EP::signature())),
+              entry_point_attrs_};
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace qiree
@@ -3,11 +3,13 @@
 // See the top-level COPYRIGHT file for details.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 //---------------------------------------------------------------------------//
-//! \file qirxacc/MemManager.cc
+//! \file qiree/MemManager.cc
 //---------------------------------------------------------------------------//
 
 #include "MemManager.hh"
 
+#include <cstdlib>
+
 namespace
 {
 struct RuntimeTuple
@@ -3,11 +3,11 @@
 // See the top-level COPYRIGHT file for details.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 //---------------------------------------------------------------------------//
-//! \file qirxacc/MemManager.hh
+//! \file qiree/MemManager.hh
 //---------------------------------------------------------------------------//
 #pragma once
 
-#include "qiree/Types.hh"
+#include "Types.hh"
 
 namespace qiree
 {
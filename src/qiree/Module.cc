@@ -7,16 +7,26 @@
 //---------------------------------------------------------------------------//
 #include "Module.hh"
 
+#include <algorithm>
+#include <iterator>
 #include <sstream>
 #include <string_view>
+#include <vector>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/IR/Attributes.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IRReader/IRReader.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
 
 #include "Assert.hh"
+#include "detail/LlvmUtils.hh"
 
 using namespace std::string_view_literals;
 
@@ -26,24 +36,65 @@ namespace
 {
 //---------------------------------------------------------------------------//
 /*!
- * Shared, thread-local LLVM context.
+ * Load an LLVM module from a file.
+ */
+std::unique_ptr<llvm::Module>
+load_llvm_module(std::string const& filename, llvm::LLVMContext& context)
+{
+    llvm::SMDiagnostic err;
+    auto module = llvm::parseIRFile(filename, err, context);
+    if (!module)
+    {
+        err.print("qiree", llvm::errs());
+        QIREE_VALIDATE(module,
+                       << "failed to read QIR input at '" << filename << "'");
+    }
+    return module;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Load an LLVM module from memory.
  *
- * This must exceed the lifetime of any IR, modules, etc.
+ * Bitcode is read directly from the buffer. The assembly parser requires a
+ * null-terminated buffer, so textual IR is copied.
  */
-llvm::LLVMContext& context()
+std::unique_ptr<llvm::Module> load_llvm_module(std::string_view contents,
+                                               std::string const& name,
+                                               llvm::LLVMContext& context)
 {
-    static llvm::LLVMContext ctx;
-    return ctx;
+    llvm::StringRef buffer{contents.data(), contents.size()};
+    if (llvm::isBitcode(buffer.bytes_begin(), buffer.bytes_end()))
+    {
+        return detail::unwrap_llvm(
+            llvm::parseBitcodeFile(llvm::MemoryBufferRef{buffer, name},
+                                   context),
+            "failed to read QIR bitcode");
+    }
+
+    auto copy = llvm::MemoryBuffer::getMemBufferCopy(buffer, name);
+    llvm::SMDiagnostic err;
+    auto module = llvm::parseIR(copy->getMemBufferRef(), err, context);
+    if (!module)
+    {
+        err.print("qiree", llvm::errs());
+        QIREE_VALIDATE(module,
+                       << "failed to read QIR input from '" << name << "'");
+    }
+    return module;
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * Load an LLVM module from a file.
+ * Load an LLVM module whose bitcode function bodies are read on demand.
+ *
+ * The file is memory-mapped if possible; textual IR is parsed completely.
  */
-std::unique_ptr<llvm::Module> load_llvm_module(std::string const& filename)
+std::unique_ptr<llvm::Module>
+load_lazy_llvm_module(std::string const& filename, llvm::LLVMContext& context)
 {
     llvm::SMDiagnostic err;
-    auto module = llvm::parseIRFile(filename, err, context());
+    auto module = llvm::getLazyIRFileModule(filename, err, context);
     if (!module)
     {
         err.print("qiree", llvm::errs());
@@ -53,6 +104,90 @@ std::unique_ptr<llvm::Module> load_llvm_module(std::string const& filename)
     return module;
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * Read the bodies of functions reachable from the entry point.
+ *
+ * Functions referenced (directly or through constants and global variables)
+ * by a materialized function are materialized in turn. The remaining
+ * function bodies are discarded, leaving declarations, and then the rest of
+ * the module (metadata etc.) is loaded so that it can be used normally.
+ */
+void materialize_reachable(llvm::Function& entry)
+{
+    llvm::Module& m = *entry.getParent();
+    llvm::SmallPtrSet<llvm::Value const*, 32> visited;
+    std::vector<llvm::Function*> functions;
+    std::vector<llvm::Constant*> constants;
+
+    auto visit = [&](llvm::Value* v) {
+        if (!llvm::isa<llvm::Constant>(v) || !visited.insert(v).second)
+        {
+            return;
+        }
+        if (auto* f = llvm::dyn_cast<llvm::Function>(v))
+        {
+            functions.push_back(f);
+        }
+        else if (auto* gv = llvm::dyn_cast<llvm::GlobalVariable>(v))
+        {
+            if (gv->hasInitializer())
+            {
+                constants.push_back(gv->getInitializer());
+            }
+        }
+        else if (auto* ga = llvm::dyn_cast<llvm::GlobalAlias>(v))
+        {
+            constants.push_back(ga->getAliasee());
+        }
+        else if (!llvm::isa<llvm::GlobalValue>(v))
+        {
+            constants.push_back(llvm::cast<llvm::Constant>(v));
+        }
+    };
+
+    visit(&entry);
+    while (!functions.empty() || !constants.empty())
+    {
+        if (!constants.empty())
+        {
+            llvm::Constant* c = constants.back();
+            constants.pop_back();
+            for (llvm::Use& op : c->operands())
+            {
+                visit(op.get());
+            }
+            continue;
+        }
+
+        llvm::Function* f = functions.back();
+        functions.pop_back();
+        detail::validate_llvm(f->materialize(),
+                              "failed to read QIR function");
+        for (llvm::Use& op : f->operands())
+        {
+            // Personality, prefix, and prologue
+            visit(op.get());
+        }
+        for (llvm::Instruction& inst : llvm::instructions(*f))
+        {
+            for (llvm::Use& op : inst.operands())
+            {
+                visit(op.get());
+            }
+        }
+    }
+
+    for (llvm::Function& f : m)
+    {
+        if (f.isMaterializable())
+        {
+            f.deleteBody();
+        }
+    }
+    detail::validate_llvm(m.materializeAll(), "failed to read QIR module");
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * Find a function tagged with the QIR `entry_point`.
@@ -80,6 +215,33 @@ llvm::Function* find_entry_point(llvm::Module& m)
     return nullptr;
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * Find the QIR entry point, raising an error if none exists.
+ */
+llvm::Function* require_entry_point(llvm::Module& m)
+{
+    llvm::Function* result = find_entry_point(m);
+    QIREE_VALIDATE(result,
+                   << "no function with QIR 'entry_point' attribute "
+                      "exists in '"
+                   << m.getSourceFileName() << "'");
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Find an explicitly named entry point, raising an error if it is missing.
+ */
+llvm::Function*
+require_entry_point(llvm::Module& m, std::string const& entrypoint)
+{
+    llvm::Function* result = m.getFunction(entrypoint);
+    QIREE_VALIDATE(result,
+                   << "no entrypoint function '" << entrypoint << "' exists");
+    return result;
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * Interpret a string attribute as a certain type.
@@ -100,17 +262,16 @@ void attr_get_to(llvm::Attribute const& attr, T& dest)
 //---------------------------------------------------------------------------//
 /*!
  * Construct with an LLVM module.
+ *
+ * The module's LLVM context is owned externally and must outlive this object
+ * (and any \c Executor constructed from it).
  */
 Module::Module(UPModule&& module) : module_{std::move(module)}
 {
     QIREE_EXPECT(module_);
 
     // Search for entry point
-    entrypoint_ = find_entry_point(*module_);
-    QIREE_VALIDATE(entrypoint_,
-                   << "no function with QIR 'entry_point' attribute "
-                      "exists in '"
-                   << module_->getSourceFileName() << "'");
+    entrypoint_ = require_entry_point(*module_);
 }
 
 //---------------------------------------------------------------------------//
@@ -123,19 +284,24 @@ Module::Module(UPModule&& module, std::string const& entrypoint)
     QIREE_EXPECT(module_);
 
     // Search for explicitly named entry point
-    entrypoint_ = module_->getFunction(entrypoint);
-    QIREE_VALIDATE(entrypoint_,
-                   << "no entrypoint function '" << entrypoint << "' exists");
+    entrypoint_ = require_entry_point(*module_, entrypoint);
 }
 
-
 //---------------------------------------------------------------------------//
 /*!
  * Construct with an LLVM IR file (bitcode or disassembled).
+ *
+ * Each module loaded from a file owns a separate LLVM context so that
+ * independent modules can be loaded and executed on different threads.
  */
 Module::Module(std::string const& filename)
-    : Module{load_llvm_module(filename)}
+    : context_{std::make_unique<llvm::LLVMContext>()}
+    , module_{load_llvm_module(filename, *context_)}
 {
+    QIREE_EXPECT(module_);
+
+    // Search for entry point
+    entrypoint_ = require_entry_point(*module_);
 }
 
 //---------------------------------------------------------------------------//
@@ -143,21 +309,86 @@ Module::Module(std::string const& filename)
  * Construct with an LLVM IR file (bitcode or disassembled) and entry point.
  */
 Module::Module(std::string const& filename, std::string const& entrypoint)
-    : module_{load_llvm_module(filename)}
+    : context_{std::make_unique<llvm::LLVMContext>()}
+    , module_{load_llvm_module(filename, *context_)}
 {
     QIREE_EXPECT(module_);
 
     // Search for explicitly named entry point
-    entrypoint_ = module_->getFunction(entrypoint);
-    QIREE_VALIDATE(entrypoint_,
-                   << "no entrypoint function '" << entrypoint << "' exists");
+    entrypoint_ = require_entry_point(*module_, entrypoint);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct from a module that owns its context.
+ *
+ * An empty entry point name searches for the QIR entry point attribute.
+ */
+Module::Module(UPContext&& context,
+               UPModule&& module,
+               std::string const& entrypoint)
+    : context_{std::move(context)}, module_{std::move(module)}
+{
+    QIREE_EXPECT(context_ && module_);
+    QIREE_EXPECT(&module_->getContext() == context_.get());
+
+    entrypoint_ = entrypoint.empty()
+                      ? require_entry_point(*module_)
+                      : require_entry_point(*module_, entrypoint);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct from LLVM IR (bitcode or disassembled) in memory.
+ *
+ * The name is used for diagnostics. The buffer need not outlive the module.
+ * An empty entry point name searches for the QIR entry point attribute.
+ */
+Module Module::from_buffer(std::string_view contents,
+                           std::string const& name,
+                           std::string const& entrypoint)
+{
+    auto context = std::make_unique<llvm::LLVMContext>();
+    auto module = load_llvm_module(contents, name, *context);
+    return Module{std::move(context), std::move(module), entrypoint};
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Load only the functions reachable from the entry point of a file.
+ *
+ * For a bitcode file, only the function bodies reachable from the entry point
+ * are read from the (memory-mapped) file; others are left as declarations.
+ * This avoids deserializing large libraries linked into the module. Textual
+ * IR must be parsed in its entirety so is loaded as usual.
+ */
+Module Module::from_file_lazy(std::string const& filename,
+                              std::string const& entrypoint)
+{
+    auto context = std::make_unique<llvm::LLVMContext>();
+    auto module = load_lazy_llvm_module(filename, *context);
+    Module result{std::move(context), std::move(module), entrypoint};
+    materialize_reachable(*result.entrypoint_);
+    return result;
 }
 
 //---------------------------------------------------------------------------//
 Module::Module() = default;
 Module::~Module() = default;
 Module::Module(Module&&) = default;
-Module& Module::operator=(Module&&) = default;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Move assign, destroying the old module before its context.
+ */
+Module& Module::operator=(Module&& other)
+{
+    module_ = std::move(other.module_);
+    context_ = std::move(other.context_);
+    entrypoint_ = other.entrypoint_;
+    other.entrypoint_ = nullptr;
+    return *this;
+}
 
 //---------------------------------------------------------------------------//
 /*!
@@ -233,5 +464,128 @@ ModuleFlags Module::load_module_flags() const
     return flags;
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * Get the quantum instructions called by the module.
+ *
+ * This returns the sorted names of all \c __quantum__qis__ functions with at
+ * least one use, without the prefix (e.g. \c "h__body" and \c "rx__ctl").
+ * Only declarations are examined, so this is much cheaper than compiling and
+ * can be used to choose an execution backend.
+ */
+std::vector<std::string> Module::load_qis_functions() const
+{
+    QIREE_EXPECT(*this);
+
+    constexpr auto prefix = "__quantum__qis__"sv;
+    std::vector<std::string> result;
+    for (llvm::Function const& f : *module_)
+    {
+        auto name = std::string_view(f.getName());
+        if (name.substr(0, prefix.size()) == prefix && !f.use_empty())
+        {
+            result.emplace_back(name.substr(prefix.size()));
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether the entry point is straight-line base-profile code.
+ *
+ * This is true if the entry point is a single basic block of direct calls to
+ * external functions, with constant arguments and unused results, followed by
+ * a return. Such a program can be executed by replaying its calls in order
+ * rather than by compiling it.
+ */
+bool Module::is_straight_line() const
+{
+    QIREE_EXPECT(*this);
+
+    if (entrypoint_->size() != 1)
+    {
+        return false;
+    }
+    for (llvm::Instruction const& inst : entrypoint_->getEntryBlock())
+    {
+        if (llvm::isa<llvm::ReturnInst>(inst))
+        {
+            continue;
+        }
+        auto const* call = llvm::dyn_cast<llvm::CallInst>(&inst);
+        if (!call)
+        {
+            return false;
+        }
+        llvm::Function const* callee = call->getCalledFunction();
+        if (!callee || !callee->isDeclaration() || callee->isIntrinsic()
+            || !call->use_empty())
+        {
+            return false;
+        }
+        if (!std::all_of(call->arg_begin(), call->arg_end(), [](auto const& u) {
+                return llvm::isa<llvm::Constant>(u.get());
+            }))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether all measurements are Z measurements at the end of the program.
+ *
+ * This is true for straight-line code (see \c is_straight_line ) in which no
+ * quantum instruction other than \c mz follows the first \c mz, and that
+ * has no other measurement, reset, or result read. The results of such a
+ * program are a sample of the final state, so a simulator can prepare the
+ * state once and draw many shots from it.
+ */
+bool Module::has_terminal_measurements() const
+{
+    if (!this->is_straight_line())
+    {
+        return false;
+    }
+
+    constexpr auto prefix = "__quantum__qis__"sv;
+    constexpr std::string_view nonunitary[]
+        = {"m__body"sv, "measure__body"sv, "mresetz__body"sv, "reset__body"sv};
+    bool measured{false};
+    for (llvm::Instruction const& inst : entrypoint_->getEntryBlock())
+    {
+        auto const* call = llvm::dyn_cast<llvm::CallInst>(&inst);
+        if (!call)
+        {
+            continue;
+        }
+        auto name = std::string_view(call->getCalledFunction()->getName());
+        if (name.find("read_result") != std::string_view::npos)
+        {
+            return false;
+        }
+        if (name.substr(0, prefix.size()) != prefix)
+        {
+            continue;
+        }
+        name = name.substr(prefix.size());
+        if (name == "mz__body"sv)
+        {
+            measured = true;
+        }
+        else if (measured
+                 || std::find(std::begin(nonunitary), std::end(nonunitary), name)
+                        != std::end(nonunitary))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace qiree
@@ -8,11 +8,15 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "Types.hh"
 
 namespace llvm
 {
+class LLVMContext;
 class Module;
 class Function;
 }  // namespace llvm
@@ -29,6 +33,7 @@ class Module
     //!@{
     //! \name Type aliases
     using UPModule = std::unique_ptr<llvm::Module>;
+    using UPContext = std::unique_ptr<llvm::LLVMContext>;
     //!@}
 
   public:
@@ -54,21 +59,48 @@ class Module
     // Construct with an LLVM IR file (bitcode or disassembled) and entry point
     Module(std::string const& filename, std::string const& entrypoint);
 
+    // Construct from LLVM IR (bitcode or disassembled) in memory
+    static Module from_buffer(std::string_view contents,
+                              std::string const& name,
+                              std::string const& entrypoint = {});
+
+    // Load only the functions reachable from the entry point of a file
+    static Module from_file_lazy(std::string const& filename,
+                                 std::string const& entrypoint = {});
+
     // Process entry point attributes
     EntryPointAttrs load_entry_point_attrs() const;
 
     // Translate module attributes into flags
     ModuleFlags load_module_flags() const;
 
+    // Get the quantum instructions called by the module
+    std::vector<std::string> load_qis_functions() const;
+
+    // Whether the entry point is a single block of calls with constant args
+    bool is_straight_line() const;
+
+    // Whether all measurements are Z measurements at the end of the program
+    bool has_terminal_measurements() const;
+
     //! True if the module has been constructed (and not moved)
     explicit operator bool() const { return static_cast<bool>(module_); }
 
   private:
-    std::unique_ptr<llvm::Module> module_;
+    // Context owned by this module (null if created externally)
+    UPContext context_;
+    UPModule module_;
     llvm::Function* entrypoint_{nullptr};
 
-    // Make Executor a friend so it can take ownership of the pointer
+    // Construct from a module that owns its context
+    Module(UPContext&& context,
+           UPModule&& module,
+           std::string const& entrypoint);
+
+    // Make compilers friends so they can take ownership of the pointer
+    friend class AotCompiler;
     friend class Executor;
+    friend class ModuleCache;
 };
 
 //---------------------------------------------------------------------------//
@@ -0,0 +1,347 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ModuleCache.cc
+//---------------------------------------------------------------------------//
+#include "ModuleCache.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/Twine.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "Assert.hh"
+#include "Module.hh"
+#include "detail/LlvmUtils.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * File attributes used to detect modification.
+ */
+struct FileStamp
+{
+    llvm::sys::TimePoint<> mtime;
+    std::uint64_t size{0};
+};
+
+bool operator==(FileStamp const& lhs, FileStamp const& rhs)
+{
+    return lhs.mtime == rhs.mtime && lhs.size == rhs.size;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the current attributes of a file, returning false on failure.
+ */
+bool read_stamp(llvm::Twine const& path, FileStamp* stamp)
+{
+    llvm::sys::fs::file_status status;
+    if (llvm::sys::fs::status(path, status))
+    {
+        return false;
+    }
+    *stamp = {status.getLastModificationTime(), status.getSize()};
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Load a module from a file, searching for the entry point if unnamed.
+ */
+Module load_module(std::string const& filename, std::string const& entrypoint)
+{
+    if (entrypoint.empty())
+    {
+        return Module{filename};
+    }
+    return Module{filename, entrypoint};
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Bitcode of each cached file in least-recently-used order.
+ *
+ * Bitcode buffers are shared so that modules can be reconstructed without
+ * holding the lock.
+ */
+class ModuleCache::Impl
+{
+  public:
+    using SPConstBuffer = std::shared_ptr<llvm::MemoryBuffer const>;
+
+    explicit Impl(size_type budget) : memory_budget{budget} {}
+
+    // Get the bitcode for a file if cached and unmodified
+    SPConstBuffer find(std::string const& path, FileStamp const& stamp);
+
+    // Add or replace the bitcode for a file, evicting old entries
+    void insert(std::string const& path,
+                FileStamp const& stamp,
+                SPConstBuffer bitcode);
+
+    // Remove all entries
+    void clear();
+
+    //! Number of entries (the lock must be held)
+    size_type size() const { return entries_.size(); }
+
+    size_type const memory_budget;
+    std::atomic<size_type> hits{0};
+    std::atomic<size_type> misses{0};
+
+    mutable std::mutex mutex;
+    size_type memory_usage{0};
+
+  private:
+    struct Entry
+    {
+        std::string path;
+        FileStamp stamp;
+        SPConstBuffer bitcode;
+    };
+    using EntryList = std::list<Entry>;
+
+    // Most recently used first
+    EntryList lru_;
+    std::unordered_map<std::string, EntryList::iterator> entries_;
+
+    void erase(EntryList::iterator iter);
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the bitcode for a file if cached and unmodified.
+ */
+auto ModuleCache::Impl::find(std::string const& path, FileStamp const& stamp)
+    -> SPConstBuffer
+{
+    std::lock_guard<std::mutex> scoped_lock{mutex};
+    auto iter = entries_.find(path);
+    if (iter == entries_.end())
+    {
+        return nullptr;
+    }
+    if (!(iter->second->stamp == stamp))
+    {
+        // File changed since it was cached
+        this->erase(iter->second);
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, iter->second);
+    return iter->second->bitcode;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add or replace the bitcode for a file, evicting old entries.
+ *
+ * A module larger than the budget is evicted immediately.
+ */
+void ModuleCache::Impl::insert(std::string const& path,
+                               FileStamp const& stamp,
+                               SPConstBuffer bitcode)
+{
+    QIREE_EXPECT(bitcode);
+    std::lock_guard<std::mutex> scoped_lock{mutex};
+    if (auto iter = entries_.find(path); iter != entries_.end())
+    {
+        // Another thread loaded the same file
+        this->erase(iter->second);
+    }
+
+    memory_usage += bitcode->getBufferSize();
+    lru_.push_front({path, stamp, std::move(bitcode)});
+    entries_[path] = lru_.begin();
+
+    while (memory_usage > memory_budget)
+    {
+        QIREE_ASSERT(!lru_.empty());
+        this->erase(std::prev(lru_.end()));
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Remove all entries.
+ */
+void ModuleCache::Impl::clear()
+{
+    std::lock_guard<std::mutex> scoped_lock{mutex};
+    lru_.clear();
+    entries_.clear();
+    memory_usage = 0;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Remove an entry while holding the lock.
+ */
+void ModuleCache::Impl::erase(EntryList::iterator iter)
+{
+    QIREE_EXPECT(memory_usage >= iter->bitcode->getBufferSize());
+    memory_usage -= iter->bitcode->getBufferSize();
+    entries_.erase(iter->path);
+    lru_.erase(iter);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the default memory budget.
+ */
+ModuleCache::ModuleCache() : ModuleCache{default_memory_budget} {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with a maximum size of cached bitcode.
+ */
+ModuleCache::ModuleCache(size_type memory_budget)
+    : impl_{std::make_unique<Impl>(memory_budget)}
+{
+}
+
+//---------------------------------------------------------------------------//
+//! Default destructor
+ModuleCache::~ModuleCache() = default;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a copy of the module in a file.
+ */
+Module ModuleCache::operator()(std::string const& filename)
+{
+    return (*this)(filename, {});
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a copy of the module in a file with a given entry point.
+ *
+ * An empty entry point name searches for the QIR entry point attribute.
+ */
+Module ModuleCache::operator()(std::string const& filename,
+                               std::string const& entrypoint)
+{
+    // Identify the file and its current version
+    llvm::SmallString<256> real_path;
+    FileStamp stamp;
+    if (llvm::sys::fs::real_path(filename, real_path)
+        || !read_stamp(real_path, &stamp))
+    {
+        // Let the module report the error
+        ++impl_->misses;
+        return load_module(filename, entrypoint);
+    }
+    std::string const path{real_path.str()};
+
+    if (auto bitcode = impl_->find(path, stamp))
+    {
+        // Reconstruct in a new context
+        ++impl_->hits;
+        auto context = std::make_unique<llvm::LLVMContext>();
+        auto module = detail::unwrap_llvm(
+            llvm::parseBitcodeFile(bitcode->getMemBufferRef(), *context),
+            "failed to read cached QIR module");
+        return Module{std::move(context), std::move(module), entrypoint};
+    }
+
+    // Parse the file and save its pristine bitcode
+    ++impl_->misses;
+    Module result = load_module(path, entrypoint);
+    if (FileStamp loaded; !read_stamp(path, &loaded) || !(loaded == stamp))
+    {
+        // The file changed while it was parsed, so the stamp may not match
+        // the contents
+        return result;
+    }
+    llvm::SmallVector<char, 0> buffer;
+    {
+        llvm::raw_svector_ostream os{buffer};
+        llvm::WriteBitcodeToFile(*result.module_, os);
+    }
+    impl_->insert(path,
+                  stamp,
+                  llvm::MemoryBuffer::getMemBufferCopy(
+                      llvm::StringRef{buffer.data(), buffer.size()}, path));
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Remove all cached modules.
+ */
+void ModuleCache::clear()
+{
+    impl_->clear();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Number of modules reconstructed from the cache.
+ */
+size_type ModuleCache::hits() const
+{
+    return impl_->hits;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Number of modules parsed from files.
+ */
+size_type ModuleCache::misses() const
+{
+    return impl_->misses;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Number of cached modules.
+ */
+size_type ModuleCache::size() const
+{
+    std::lock_guard<std::mutex> scoped_lock{impl_->mutex};
+    return impl_->size();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Total size of cached bitcode [bytes].
+ */
+size_type ModuleCache::memory_usage() const
+{
+    std::lock_guard<std::mutex> scoped_lock{impl_->mutex};
+    return impl_->memory_usage;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Maximum size of cached bitcode [bytes].
+ */
+size_type ModuleCache::memory_budget() const
+{
+    return impl_->memory_budget;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
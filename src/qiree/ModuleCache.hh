@@ -0,0 +1,96 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ModuleCache.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "Macros.hh"
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+class Module;
+
+//---------------------------------------------------------------------------//
+/*!
+ * In-memory cache of parsed QIR modules.
+ *
+ * Constructing an \c Executor consumes its \c Module, so running the same
+ * program many times requires a new module each time. This cache parses each
+ * file once and keeps a pristine copy as LLVM bitcode, from which every
+ * request is reconstructed. Reading bitcode from memory is much faster than
+ * parsing (and verifying) textual IR from disk, and each returned module
+ * still owns a separate LLVM context so that it can be executed on any
+ * thread.
+ *
+ * Entries are keyed by the file's real path and are reloaded if the file's
+ * modification time or size changes. When the total size of the cached
+ * bitcode exceeds the memory budget, the least recently used entries are
+ * evicted. The cache is thread-safe.
+ *
+ * \code
+   ModuleCache load_module;
+   for (auto const& job : jobs)
+   {
+       Executor execute{load_module(job.filename), opts};
+       execute(qi, ri);
+   }
+ * \endcode
+ */
+class ModuleCache
+{
+  public:
+    //! Default maximum size of cached bitcode [bytes]
+    static constexpr size_type default_memory_budget = 256 * 1024 * 1024;
+
+  public:
+    // Construct with the default memory budget
+    ModuleCache();
+
+    // Construct with a maximum size of cached bitcode
+    explicit ModuleCache(size_type memory_budget);
+
+    // Default destructor
+    ~ModuleCache();
+
+    QIREE_DELETE_COPY_MOVE(ModuleCache);
+
+    // Get a copy of the module in a file
+    Module operator()(std::string const& filename);
+
+    // Get a copy of the module in a file with a given entry point
+    Module operator()(std::string const& filename,
+                      std::string const& entrypoint);
+
+    // Remove all cached modules
+    void clear();
+
+    // Number of modules reconstructed from the cache
+    size_type hits() const;
+
+    // Number of modules parsed from files
+    size_type misses() const;
+
+    // Number of cached modules
+    size_type size() const;
+
+    // Total size of cached bitcode [bytes]
+    size_type memory_usage() const;
+
+    // Maximum size of cached bitcode [bytes]
+    size_type memory_budget() const;
+
+  private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,267 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ObjectCache.cc
+//---------------------------------------------------------------------------//
+#include "ObjectCache.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/SHA1.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "Assert.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Describe the host and compiler so that objects are never shared between
+ * incompatible machines or LLVM versions.
+ */
+std::string host_signature()
+{
+    std::string result = LLVM_VERSION_STRING;
+    result += '\0';
+    result += llvm::sys::getHostCPUName();
+
+    // Sort features since the map iteration order is unspecified
+    llvm::StringMap<bool> features;
+    if (llvm::sys::getHostCPUFeatures(features))
+    {
+        std::vector<std::string> sorted;
+        for (auto const& kv : features)
+        {
+            sorted.push_back((kv.getValue() ? '+' : '-') + kv.getKey().str());
+        }
+        std::sort(sorted.begin(), sorted.end());
+        for (auto const& f : sorted)
+        {
+            result += ',';
+            result += f;
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * LLVM object cache backed by a directory.
+ *
+ * LLVM queries the cache with \c getObject before compiling a module, and
+ * calls \c notifyObjectCompiled with the result on a miss. Code generation
+ * may modify the IR in between, so the key computed during the lookup is
+ * saved for the notification.
+ */
+class ObjectCache::Impl final : public llvm::ObjectCache
+{
+  public:
+    explicit Impl(std::string directory);
+
+    void notifyObjectCompiled(llvm::Module const* m,
+                              llvm::MemoryBufferRef obj) final;
+    std::unique_ptr<llvm::MemoryBuffer> getObject(llvm::Module const* m) final;
+
+    std::string directory;
+    std::atomic<size_type> hits{0};
+    std::atomic<size_type> misses{0};
+
+  private:
+    std::string host_;
+    std::mutex pending_mutex_;
+    std::unordered_map<llvm::Module const*, std::string> pending_;
+
+    std::string key(llvm::Module const& m) const;
+    std::string object_path(std::string const& key) const;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create the cache directory if needed.
+ */
+ObjectCache::Impl::Impl(std::string dir)
+    : directory{std::move(dir)}, host_{host_signature()}
+{
+    QIREE_VALIDATE(!directory.empty(),
+                   << "object cache directory cannot be empty");
+    std::error_code ec = llvm::sys::fs::create_directories(directory);
+    QIREE_VALIDATE(!ec,
+                   << "failed to create object cache directory '"
+                   << directory << "': " << ec.message());
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Load a previously compiled object if available.
+ */
+std::unique_ptr<llvm::MemoryBuffer>
+ObjectCache::Impl::getObject(llvm::Module const* m)
+{
+    QIREE_EXPECT(m);
+    std::string k = this->key(*m);
+    auto buf = llvm::MemoryBuffer::getFile(this->object_path(k),
+                                           /* IsText = */ false,
+                                           /* RequiresNullTerminator = */ false);
+    if (buf)
+    {
+        ++hits;
+        return std::move(*buf);
+    }
+
+    ++misses;
+    std::lock_guard<std::mutex> scoped_lock{pending_mutex_};
+    pending_[m] = std::move(k);
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Atomically save a newly compiled object.
+ */
+void ObjectCache::Impl::notifyObjectCompiled(llvm::Module const* m,
+                                             llvm::MemoryBufferRef obj)
+{
+    QIREE_EXPECT(m);
+    std::string k;
+    {
+        std::lock_guard<std::mutex> scoped_lock{pending_mutex_};
+        auto iter = pending_.find(m);
+        if (iter != pending_.end())
+        {
+            k = std::move(iter->second);
+            pending_.erase(iter);
+        }
+    }
+    if (k.empty())
+    {
+        // Not looked up through this cache
+        k = this->key(*m);
+    }
+
+    // Write to a unique temporary file in the same directory
+    std::string const path = this->object_path(k);
+    llvm::SmallString<128> temp_path;
+    int fd{-1};
+    if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%%%.tmp", fd, temp_path))
+    {
+        return;
+    }
+    bool ok{false};
+    {
+        llvm::raw_fd_ostream os{fd, /* shouldClose = */ true};
+        os << obj.getBuffer();
+        os.close();
+        ok = !os.has_error();
+        os.clear_error();
+    }
+
+    // Rename into place so readers never see a partial object
+    if (!ok || llvm::sys::fs::rename(temp_path, path))
+    {
+        llvm::sys::fs::remove(temp_path);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Hash the module contents along with the target and host signature.
+ */
+std::string ObjectCache::Impl::key(llvm::Module const& m) const
+{
+    llvm::SmallVector<char, 0> buffer;
+    {
+        llvm::raw_svector_ostream os{buffer};
+        llvm::WriteBitcodeToFile(m, os);
+        os << '\0' << m.getTargetTriple() << '\0' << host_;
+    }
+    return llvm::toHex(
+        llvm::SHA1::hash(llvm::arrayRefFromStringRef(
+            llvm::StringRef{buffer.data(), buffer.size()})),
+        /* LowerCase = */ true);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the path to the object file for a key.
+ */
+std::string ObjectCache::Impl::object_path(std::string const& key) const
+{
+    llvm::SmallString<128> path{directory};
+    llvm::sys::path::append(path, key + ".o");
+    return std::string(path.str());
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the directory in which to store objects.
+ *
+ * The directory is created if it does not exist.
+ */
+ObjectCache::ObjectCache(std::string const& directory)
+    : impl_{std::make_unique<Impl>(directory)}
+{
+}
+
+//---------------------------------------------------------------------------//
+//! Default destructor
+ObjectCache::~ObjectCache() = default;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Directory where objects are stored.
+ */
+std::string const& ObjectCache::directory() const
+{
+    return impl_->directory;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Number of compiled objects loaded from the cache.
+ */
+size_type ObjectCache::hits() const
+{
+    return impl_->hits.load(std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Number of objects that had to be compiled.
+ */
+size_type ObjectCache::misses() const
+{
+    return impl_->misses.load(std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Access the underlying LLVM cache.
+ */
+llvm::ObjectCache* ObjectCache::llvm_cache() const
+{
+    return impl_.get();
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,77 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ObjectCache.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "Macros.hh"
+#include "Types.hh"
+
+namespace llvm
+{
+class ObjectCache;
+}  // namespace llvm
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Persistent on-disk cache of JIT-compiled object code.
+ *
+ * Each compiled LLVM module is stored as an object file whose name is a SHA-1
+ * hash of the module bitcode, the target triple, the host CPU and its
+ * features, and the LLVM version. Passing a cache to the \c Executor options
+ * lets repeated runs of an identical QIR program skip code generation
+ * entirely.
+ *
+ * A single cache can be shared among executors. Objects are written to a
+ * temporary file and renamed into place, so multiple processes can safely use
+ * the same directory. Failing to write an object is not an error: it will
+ * simply be recompiled next time.
+ *
+ * \code
+   auto cache = std::make_shared<ObjectCache>("/tmp/qiree-cache");
+   Executor::Options opts;
+   opts.object_cache = cache;
+   Executor execute{Module{filename}, opts};
+   execute(qi, ri);
+   std::cout << cache->hits() << " hits, " << cache->misses() << " misses\n";
+ * \endcode
+ */
+class ObjectCache
+{
+  public:
+    // Construct with the directory in which to store objects
+    explicit ObjectCache(std::string const& directory);
+
+    // Default destructor
+    ~ObjectCache();
+
+    QIREE_DELETE_COPY_MOVE(ObjectCache);
+
+    // Directory where objects are stored
+    std::string const& directory() const;
+
+    // Number of compiled objects loaded from the cache
+    size_type hits() const;
+
+    // Number of objects that had to be compiled
+    size_type misses() const;
+
+  private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+
+    // Executor needs access to the underlying LLVM cache
+    friend class Executor;
+    llvm::ObjectCache* llvm_cache() const;
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,295 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/QirDispatch.cc
+//---------------------------------------------------------------------------//
+#include "detail/QirFunctions.hh"
+
+//---------------------------------------------------------------------------//
+//! Generate a QIR runtime symbol name
+#define QIREE_C_RT_FUNCTION(FUNC) __quantum__rt__##FUNC
+
+//! Generate a QIR quantum instruction set symbol name
+#define QIREE_C_QIS_FUNCTION(FUNC, SUFFIX) __quantum__qis__##FUNC##__##SUFFIX
+
+using namespace ::qiree;
+using Functions = ::qiree::detail::VirtualQirFunctions;
+
+//---------------------------------------------------------------------------//
+/*!
+ * QIR dispatch runtime.
+ *
+ * These C symbols resolve the undefined QIR functions of an ahead-of-time
+ * compiled shared object (see \c AotCompiler) against the interfaces active
+ * on the current thread. They forward to the same wrappers used by the JIT.
+ */
+extern "C" {
+//---------------------------------------------------------------------------//
+// MEASUREMENTS
+//---------------------------------------------------------------------------//
+std::uintptr_t QIREE_C_QIS_FUNCTION(m, body)(std::uintptr_t arg1)
+{
+    return Functions::QIREE_QIS_FUNCTION(m, body)(arg1);
+}
+std::uintptr_t QIREE_C_QIS_FUNCTION(measure, body)(Array arg1, Array arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(measure, body)(arg1, arg2);
+}
+std::uintptr_t QIREE_C_QIS_FUNCTION(mresetz, body)(std::uintptr_t arg1)
+{
+    return Functions::QIREE_QIS_FUNCTION(mresetz, body)(arg1);
+}
+void QIREE_C_QIS_FUNCTION(mz, body)(std::uintptr_t arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(mz, body)(arg1, arg2);
+}
+bool QIREE_C_QIS_FUNCTION(read_result, body)(std::uintptr_t arg1)
+{
+    return Functions::QIREE_QIS_FUNCTION(read_result, body)(arg1);
+}
+//---------------------------------------------------------------------------//
+// GATES
+//---------------------------------------------------------------------------//
+void QIREE_C_QIS_FUNCTION(ccx, body)(std::uintptr_t arg1,
+                                     std::uintptr_t arg2,
+                                     std::uintptr_t arg3)
+{
+    return Functions::QIREE_QIS_FUNCTION(ccx, body)(arg1, arg2, arg3);
+}
+void QIREE_C_QIS_FUNCTION(cnot, body)(std::uintptr_t arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(cnot, body)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(cx, body)(std::uintptr_t arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(cx, body)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(cy, body)(std::uintptr_t arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(cy, body)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(cz, body)(std::uintptr_t arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(cz, body)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(exp, adj)(Array arg1, double arg2, Array arg3)
+{
+    return Functions::QIREE_QIS_FUNCTION(exp, adj)(arg1, arg2, arg3);
+}
+void QIREE_C_QIS_FUNCTION(exp, body)(Array arg1, double arg2, Array arg3)
+{
+    return Functions::QIREE_QIS_FUNCTION(exp, body)(arg1, arg2, arg3);
+}
+void QIREE_C_QIS_FUNCTION(exp, ctl)(Array arg1, Tuple arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(exp, ctl)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(exp, ctladj)(Array arg1, Tuple arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(exp, ctladj)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(h, body)(std::uintptr_t arg1)
+{
+    return Functions::QIREE_QIS_FUNCTION(h, body)(arg1);
+}
+void QIREE_C_QIS_FUNCTION(h, ctl)(Array arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(h, ctl)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(r, adj)(pauli_type arg1,
+                                  double arg2,
+                                  std::uintptr_t arg3)
+{
+    return Functions::QIREE_QIS_FUNCTION(r, adj)(arg1, arg2, arg3);
+}
+void QIREE_C_QIS_FUNCTION(r, body)(pauli_type arg1,
+                                   double arg2,
+                                   std::uintptr_t arg3)
+{
+    return Functions::QIREE_QIS_FUNCTION(r, body)(arg1, arg2, arg3);
+}
+void QIREE_C_QIS_FUNCTION(r, ctl)(Array arg1, Tuple arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(r, ctl)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(r, ctladj)(Array arg1, Tuple arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(r, ctladj)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(reset, body)(std::uintptr_t arg1)
+{
+    return Functions::QIREE_QIS_FUNCTION(reset, body)(arg1);
+}
+void QIREE_C_QIS_FUNCTION(rx, body)(double arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(rx, body)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(rx, ctl)(Array arg1, Tuple arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(rx, ctl)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(rxx, body)(double arg1,
+                                     std::uintptr_t arg2,
+                                     std::uintptr_t arg3)
+{
+    return Functions::QIREE_QIS_FUNCTION(rxx, body)(arg1, arg2, arg3);
+}
+void QIREE_C_QIS_FUNCTION(ry, body)(double arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(ry, body)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(ry, ctl)(Array arg1, Tuple arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(ry, ctl)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(ryy, body)(double arg1,
+                                     std::uintptr_t arg2,
+                                     std::uintptr_t arg3)
+{
+    return Functions::QIREE_QIS_FUNCTION(ryy, body)(arg1, arg2, arg3);
+}
+void QIREE_C_QIS_FUNCTION(rz, body)(double arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(rz, body)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(rz, ctl)(Array arg1, Tuple arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(rz, ctl)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(rzz, body)(double arg1,
+                                     std::uintptr_t arg2,
+                                     std::uintptr_t arg3)
+{
+    return Functions::QIREE_QIS_FUNCTION(rzz, body)(arg1, arg2, arg3);
+}
+void QIREE_C_QIS_FUNCTION(s, adj)(std::uintptr_t arg1)
+{
+    return Functions::QIREE_QIS_FUNCTION(s, adj)(arg1);
+}
+void QIREE_C_QIS_FUNCTION(s, body)(std::uintptr_t arg1)
+{
+    return Functions::QIREE_QIS_FUNCTION(s, body)(arg1);
+}
+void QIREE_C_QIS_FUNCTION(s, ctl)(Array arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(s, ctl)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(s, ctladj)(Array arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(s, ctladj)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(swap, body)(std::uintptr_t arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(swap, body)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(t, adj)(std::uintptr_t arg1)
+{
+    return Functions::QIREE_QIS_FUNCTION(t, adj)(arg1);
+}
+void QIREE_C_QIS_FUNCTION(t, body)(std::uintptr_t arg1)
+{
+    return Functions::QIREE_QIS_FUNCTION(t, body)(arg1);
+}
+void QIREE_C_QIS_FUNCTION(t, ctl)(Array arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(t, ctl)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(t, ctladj)(Array arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(t, ctladj)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(x, body)(std::uintptr_t arg1)
+{
+    return Functions::QIREE_QIS_FUNCTION(x, body)(arg1);
+}
+void QIREE_C_QIS_FUNCTION(x, ctl)(Array arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(x, ctl)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(y, body)(std::uintptr_t arg1)
+{
+    return Functions::QIREE_QIS_FUNCTION(y, body)(arg1);
+}
+void QIREE_C_QIS_FUNCTION(y, ctl)(Array arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(y, ctl)(arg1, arg2);
+}
+void QIREE_C_QIS_FUNCTION(z, body)(std::uintptr_t arg1)
+{
+    return Functions::QIREE_QIS_FUNCTION(z, body)(arg1);
+}
+void QIREE_C_QIS_FUNCTION(z, ctl)(Array arg1, std::uintptr_t arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(z, ctl)(arg1, arg2);
+}
+//---------------------------------------------------------------------------//
+// ASSERTIONS
+//---------------------------------------------------------------------------//
+void QIREE_C_QIS_FUNCTION(assertmeasurementprobability, body)(
+    Array arg1,
+    Array arg2,
+    std::uintptr_t arg3,
+    double arg4,
+    std::uintptr_t arg5,
+    double arg6)
+{
+    return Functions::QIREE_QIS_FUNCTION(assertmeasurementprobability, body)(
+        arg1, arg2, arg3, arg4, arg5, arg6);
+}
+void QIREE_C_QIS_FUNCTION(assertmeasurementprobability, ctl)(Array arg1,
+                                                             Tuple arg2)
+{
+    return Functions::QIREE_QIS_FUNCTION(assertmeasurementprobability, ctl)(
+        arg1, arg2);
+}
+//---------------------------------------------------------------------------//
+// RUNTIME
+//---------------------------------------------------------------------------//
+void QIREE_C_RT_FUNCTION(initialize)(OptionalCString env)
+{
+    return Functions::QIREE_RT_FUNCTION(initialize)(env);
+}
+void QIREE_C_RT_FUNCTION(array_record_output)(size_type s, OptionalCString tag)
+{
+    return Functions::QIREE_RT_FUNCTION(array_record_output)(s, tag);
+}
+void QIREE_C_RT_FUNCTION(tuple_record_output)(size_type s, OptionalCString tag)
+{
+    return Functions::QIREE_RT_FUNCTION(tuple_record_output)(s, tag);
+}
+void QIREE_C_RT_FUNCTION(result_record_output)(std::uintptr_t r,
+                                               OptionalCString tag)
+{
+    return Functions::QIREE_RT_FUNCTION(result_record_output)(r, tag);
+}
+Array QIREE_C_RT_FUNCTION(array_create_1d)(uint32_t elem_size, uint64_t length)
+{
+    return Functions::QIREE_RT_FUNCTION(array_create_1d)(elem_size, length);
+}
+void QIREE_C_RT_FUNCTION(array_update_reference_count)(Array array,
+                                                       int32_t delta)
+{
+    return Functions::QIREE_RT_FUNCTION(array_update_reference_count)(array,
+                                                                      delta);
+}
+void* QIREE_C_RT_FUNCTION(array_get_element_ptr_1d)(Array array, uint64_t index)
+{
+    return Functions::QIREE_RT_FUNCTION(array_get_element_ptr_1d)(array, index);
+}
+uint64_t QIREE_C_RT_FUNCTION(array_get_size_1d)(Array array)
+{
+    return Functions::QIREE_RT_FUNCTION(array_get_size_1d)(array);
+}
+Tuple QIREE_C_RT_FUNCTION(tuple_create)(uint64_t num_bytes)
+{
+    return Functions::QIREE_RT_FUNCTION(tuple_create)(num_bytes);
+}
+void QIREE_C_RT_FUNCTION(tuple_update_reference_count)(Tuple tuple,
+                                                       int32_t delta)
+{
+    return Functions::QIREE_RT_FUNCTION(tuple_update_reference_count)(tuple,
+                                                                      delta);
+}
+}  // extern "C"
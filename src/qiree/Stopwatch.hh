@@ -0,0 +1,64 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/Stopwatch.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <chrono>
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Simple timer.
+ *
+ * The stopwatch starts counting upward at construction and can be reset by
+ * assigning a new stopwatch instance.
+ *
+ * \code
+    Stopwatch get_elapsed_time;
+    // ...
+    double time = get_elapsed_time();
+    // Reset the stopwatch
+    get_elapsed_time = {};
+   \endcode
+ */
+class Stopwatch
+{
+  public:
+    // Start the count at construction
+    inline Stopwatch();
+
+    // Get the current elapsed time [s]
+    inline double operator()() const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+    using Duration = std::chrono::duration<double>;
+
+    TimePoint start_;
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Start the count at construction.
+ */
+Stopwatch::Stopwatch() : start_(Clock::now()) {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the current elapsed time in seconds.
+ */
+double Stopwatch::operator()() const
+{
+    return Duration{Clock::now() - start_}.count();
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
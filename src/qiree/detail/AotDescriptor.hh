@@ -0,0 +1,39 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/detail/AotDescriptor.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Symbols exported by an ahead-of-time compiled QIR library.
+ *
+ * The entry point is aliased to a fixed name, and its attributes are saved as
+ * constants so that the library can be executed without the original IR.
+ * The version must be incremented whenever these symbols change.
+ */
+struct AotDescriptor
+{
+    static constexpr std::int32_t version = 1;
+
+    static constexpr char version_symbol[] = "__qiree_aot_version";
+    static constexpr char entry_symbol[] = "__qiree_aot_entry";
+    static constexpr char num_qubits_symbol[] = "__qiree_aot_num_qubits";
+    static constexpr char num_results_symbol[] = "__qiree_aot_num_results";
+    static constexpr char output_labeling_schema_symbol[]
+        = "__qiree_aot_output_labeling_schema";
+    static constexpr char qir_profiles_symbol[] = "__qiree_aot_qir_profiles";
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
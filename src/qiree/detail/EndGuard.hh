@@ -7,6 +7,10 @@
 //---------------------------------------------------------------------------//
 #pragma once
 
+#include <utility>
+
+#include "qiree/Macros.hh"
+
 namespace qiree
 {
 namespace detail
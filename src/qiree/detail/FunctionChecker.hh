@@ -75,7 +75,7 @@ class FunctionChecker
   private:
     llvm::Function const& irfunc_;
 
-    void check_impl(std::size_t num_args) const;
+    inline void check_impl(std::size_t num_args) const;
 };
 
 //---------------------------------------------------------------------------//
@@ -7,6 +7,7 @@
 //---------------------------------------------------------------------------//
 #pragma once
 
+#include <functional>
 #include <type_traits>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/IR/Function.h>
@@ -22,11 +23,21 @@ namespace detail
 //---------------------------------------------------------------------------//
 /*!
  * Map IR functions to compiled functions.
+ *
+ * The mapping itself is delegated to a callback so that the same binding
+ * table can be used for the different JIT engines.
  */
 class GlobalMapper
 {
   public:
-    // Construct with module and engine
+    //! Callback that associates an IR function with a compiled address
+    using MapFunction = std::function<void(llvm::Function&, void*)>;
+
+  public:
+    // Construct with module and mapping callback
+    inline GlobalMapper(llvm::Module const& mod, MapFunction map);
+
+    // Construct with module and MCJIT engine
     inline GlobalMapper(llvm::Module const& mod, llvm::ExecutionEngine* ee);
 
     // Map a symbol name to a compiled function pointer
@@ -35,7 +46,7 @@ class GlobalMapper
 
   private:
     llvm::Module const& mod_;
-    llvm::ExecutionEngine* ee_;
+    MapFunction map_;
 
     // Non-templated function checks
     inline void check_func(llvm::Function const& irfunc) const;
@@ -45,12 +56,24 @@ class GlobalMapper
 // INLINE DEFINITIONS
 //---------------------------------------------------------------------------//
 /*!
- * Construct with module and engine.
+ * Construct with module and mapping callback.
+ */
+GlobalMapper::GlobalMapper(llvm::Module const& mod, MapFunction map)
+    : mod_{mod}, map_{std::move(map)}
+{
+    QIREE_EXPECT(map_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with module and MCJIT engine.
  */
 GlobalMapper::GlobalMapper(llvm::Module const& mod, llvm::ExecutionEngine* ee)
-    : mod_{mod}, ee_{ee}
+    : GlobalMapper{mod, [ee](llvm::Function& irfunc, void* addr) {
+                       ee->addGlobalMapping(&irfunc, addr);
+                   }}
 {
-    QIREE_EXPECT(ee_);
+    QIREE_EXPECT(ee);
 }
 
 //---------------------------------------------------------------------------//
@@ -73,7 +96,7 @@ void GlobalMapper::operator()(char const* name, F* func) const
     // Throw an assertion if the function types don't match
     FunctionChecker{*irfunc}(func);
 
-    return ee_->addGlobalMapping(irfunc, reinterpret_cast<void*>(func));
+    return map_(*irfunc, reinterpret_cast<void*>(func));
 }
 
 //---------------------------------------------------------------------------//
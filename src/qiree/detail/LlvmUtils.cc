@@ -0,0 +1,201 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/detail/LlvmUtils.cc
+//---------------------------------------------------------------------------//
+#include "LlvmUtils.hh"
+
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ExecutionEngine/MCJIT.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/PassManager.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Target/TargetMachine.h>
+
+namespace qiree
+{
+namespace detail
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Whether a QIS function can be assumed to access only quantum state.
+ *
+ * Controlled variants and functions that take arrays (exponentials, joint
+ * measurements, and assertions) read memory written by the program, so they
+ * are excluded.
+ */
+bool is_inaccessible_qis(llvm::StringRef name)
+{
+    if (!name.consume_front("__quantum__qis__"))
+    {
+        return false;
+    }
+    auto [gate, suffix] = name.rsplit("__");
+    if (suffix == "ctl" || suffix == "ctladj")
+    {
+        return false;
+    }
+    return !(gate == "exp" || gate == "measure"
+             || gate == "assertmeasurementprobability");
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Initialize LLVM's native target exactly once.
+ */
+void initialize_llvm()
+{
+    static bool const initialized = [] {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+        LLVMLinkInMCJIT();
+        return true;
+    }();
+    QIREE_DISCARD(initialized);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Throw a runtime error from an LLVM error.
+ */
+void validate_llvm(llvm::Error err, char const* what)
+{
+    QIREE_VALIDATE(!err, << what << ": " << llvm::toString(std::move(err)));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Find all function declarations reachable from the entry point.
+ *
+ * This follows direct calls and any other function references (e.g. function
+ * pointers stored or passed as arguments) in the bodies of defined functions.
+ */
+llvm::SmallVector<llvm::Function const*>
+find_reachable_declarations(llvm::Function const& entry)
+{
+    llvm::SmallVector<llvm::Function const*> result;
+    llvm::SmallPtrSet<llvm::Function const*, 16> visited{&entry};
+    llvm::SmallVector<llvm::Function const*> stack{&entry};
+    while (!stack.empty())
+    {
+        llvm::Function const* f = stack.pop_back_val();
+        if (f->isDeclaration())
+        {
+            result.push_back(f);
+            continue;
+        }
+        for (llvm::Instruction const& inst : llvm::instructions(*f))
+        {
+            for (llvm::Value const* op : inst.operand_values())
+            {
+                auto const* callee
+                    = llvm::dyn_cast<llvm::Function>(op->stripPointerCasts());
+                if (callee && visited.insert(callee).second)
+                {
+                    stack.push_back(callee);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Check that all QIR functions reachable from the entry point are bound.
+ *
+ * Unbound functions that are never called are allowed.
+ */
+void validate_reachable_bindings(llvm::Function const& entry,
+                                 llvm::StringSet<> const& bound)
+{
+    for (llvm::Function const* f : find_reachable_declarations(entry))
+    {
+        if (f->getName().startswith("__quantum__")
+            && !bound.count(f->getName()))
+        {
+            QIREE_NOT_IMPLEMENTED(f->getName().str().c_str());
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Mark QIS declarations as only accessing memory outside the module.
+ *
+ * This lets the optimizer keep classical values in registers across quantum
+ * operations (and hoist loads out of loops containing them) while still
+ * treating each call as a side effect on the quantum state, so the calls are
+ * never reordered or removed. The functions are not marked \c nounwind since
+ * the quantum interface may throw.
+ */
+void mark_qis_inaccessible_memory(llvm::Module& m)
+{
+    for (llvm::Function& f : m)
+    {
+        if (f.isDeclaration() && is_inaccessible_qis(f.getName()))
+        {
+            f.setOnlyAccessesInaccessibleMemory();
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Run the new pass manager's default pipeline for a target.
+ *
+ * Target information lets the passes make target-specific decisions; the
+ * module's data layout is updated to match.
+ */
+void optimize_module(llvm::Module& m,
+                     Executor::OptLevel level,
+                     llvm::TargetMachine& tm)
+{
+    QIREE_EXPECT(level != Executor::OptLevel::O0);
+
+    m.setDataLayout(tm.createDataLayout());
+
+    // Analysis managers must be declared in this order so they are
+    // destroyed correctly
+    llvm::LoopAnalysisManager lam;
+    llvm::FunctionAnalysisManager fam;
+    llvm::CGSCCAnalysisManager cgam;
+    llvm::ModuleAnalysisManager mam;
+
+    llvm::PassBuilder pb{&tm};
+    pb.registerModuleAnalyses(mam);
+    pb.registerCGSCCAnalyses(cgam);
+    pb.registerFunctionAnalyses(fam);
+    pb.registerLoopAnalyses(lam);
+    pb.crossRegisterProxies(lam, fam, cgam, mam);
+
+    llvm::OptimizationLevel llvm_level = [level] {
+        switch (level)
+        {
+            case Executor::OptLevel::O1:
+                return llvm::OptimizationLevel::O1;
+            case Executor::OptLevel::O2:
+                return llvm::OptimizationLevel::O2;
+            case Executor::OptLevel::O3:
+                return llvm::OptimizationLevel::O3;
+            default:
+                QIREE_ASSERT_UNREACHABLE();
+        }
+    }();
+    pb.buildPerModuleDefaultPipeline(llvm_level).run(m, mam);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
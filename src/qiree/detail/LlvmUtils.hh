@@ -0,0 +1,68 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/detail/LlvmUtils.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <utility>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringSet.h>
+#include <llvm/Support/Error.h>
+
+#include "qiree/Assert.hh"
+#include "qiree/Executor.hh"
+
+namespace llvm
+{
+class Function;
+class Module;
+class TargetMachine;
+}  // namespace llvm
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+// Initialize LLVM's native target exactly once
+void initialize_llvm();
+
+// Throw a runtime error from an LLVM error
+void validate_llvm(llvm::Error err, char const* what);
+
+// Find all function declarations reachable from the entry point
+llvm::SmallVector<llvm::Function const*>
+find_reachable_declarations(llvm::Function const& entry);
+
+// Check that all QIR functions reachable from the entry point are bound
+void validate_reachable_bindings(llvm::Function const& entry,
+                                 llvm::StringSet<> const& bound);
+
+// Mark QIS declarations as only accessing memory outside the module
+void mark_qis_inaccessible_memory(llvm::Module& m);
+
+// Run the new pass manager's default pipeline for a target
+void optimize_module(llvm::Module& m,
+                     Executor::OptLevel level,
+                     llvm::TargetMachine& tm);
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Unwrap an expected LLVM value, throwing a runtime error on failure.
+ */
+template<class T>
+T unwrap_llvm(llvm::Expected<T> value, char const* what)
+{
+    QIREE_VALIDATE(value,
+                   << what << ": " << llvm::toString(value.takeError()));
+    return std::move(*value);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -0,0 +1,256 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/detail/StaticBinder.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <llvm/Analysis/ValueTracking.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/InstrTypes.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+
+#include "FunctionChecker.hh"
+#include "qiree/Assert.hh"
+#include "qiree/Types.hh"
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Convert a constant IR argument to a C++ function argument.
+ *
+ * The \c storage_type holds the converted value for the lifetime of the bound
+ * call. The default (used for runtime arrays and tuples) cannot be loaded
+ * from a constant.
+ */
+template<class T, class Enable = void>
+struct ConstantArg
+{
+    using storage_type = T;
+
+    static bool load(llvm::Value const*, storage_type*) { return false; }
+    static T get(storage_type const& s) { return s; }
+};
+
+//! Integers and opaque QIR pointers (qubits and results)
+template<class T>
+struct ConstantArg<T, std::enable_if_t<std::is_integral_v<T>>>
+{
+    using storage_type = T;
+
+    static bool load(llvm::Value const* v, storage_type* s)
+    {
+        if (llvm::isa<llvm::ConstantPointerNull>(v))
+        {
+            *s = 0;
+            return true;
+        }
+        if (auto* ce = llvm::dyn_cast<llvm::ConstantExpr>(v);
+            ce && ce->getOpcode() == llvm::Instruction::IntToPtr)
+        {
+            v = ce->getOperand(0);
+        }
+        if (auto* ci = llvm::dyn_cast<llvm::ConstantInt>(v))
+        {
+            // Zero-extend so that small Pauli values aren't sign extended;
+            // the cast restores the sign of full-width signed integers
+            *s = static_cast<T>(ci->getZExtValue());
+            return true;
+        }
+        return false;
+    }
+    static T get(storage_type const& s) { return s; }
+};
+
+//! Floating point values (rotation angles)
+template<>
+struct ConstantArg<double>
+{
+    using storage_type = double;
+
+    static bool load(llvm::Value const* v, storage_type* s)
+    {
+        if (auto* cf = llvm::dyn_cast<llvm::ConstantFP>(v))
+        {
+            *s = cf->getValueAPF().convertToDouble();
+            return true;
+        }
+        return false;
+    }
+    static double get(storage_type const& s) { return s; }
+};
+
+//! Null or global constant strings (output labels)
+template<>
+struct ConstantArg<OptionalCString>
+{
+    using storage_type = std::optional<std::string>;
+
+    static bool load(llvm::Value const* v, storage_type* s)
+    {
+        if (llvm::isa<llvm::ConstantPointerNull>(v))
+        {
+            *s = std::nullopt;
+            return true;
+        }
+        llvm::StringRef str;
+        if (llvm::getConstantStringInfo(v, str))
+        {
+            *s = str.str();
+            return true;
+        }
+        return false;
+    }
+    static OptionalCString get(storage_type const& s)
+    {
+        return s ? s->c_str() : nullptr;
+    }
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Bind the constant arguments of straight-line calls to compiled functions.
+ *
+ * This is used in place of the JIT for entry points that are a single block of
+ * calls with constant arguments. It is applied to the same binding table as
+ * \c GlobalMapper: each call in the entry point is paired with the compiled
+ * function of the same name and its converted arguments, yielding a nullary
+ * function that replays it.
+ */
+class StaticBinder
+{
+  public:
+    //! Replay a single call
+    using Call = std::function<void()>;
+    using VecCall = std::vector<Call>;
+
+  public:
+    // Construct with a straight-line entry point
+    inline explicit StaticBinder(llvm::Function const& entry);
+
+    // Bind calls to the given function
+    template<class R, class... Args>
+    inline void operator()(char const* name, R (*func)(Args...));
+
+    // Whether all calls in the entry point have been bound
+    inline bool complete() const;
+
+    // Release the bound calls
+    inline VecCall release();
+
+  private:
+    llvm::Module const& mod_;
+    std::vector<llvm::CallBase const*> calls_;
+    VecCall bound_;
+
+    template<class R, class... Args, std::size_t... Is>
+    static Call bind_call(llvm::CallBase const& call,
+                          R (*func)(Args...),
+                          std::index_sequence<Is...>);
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with a straight-line entry point.
+ */
+StaticBinder::StaticBinder(llvm::Function const& entry)
+    : mod_{*entry.getParent()}
+{
+    QIREE_EXPECT(entry.size() == 1);
+    for (llvm::Instruction const& inst : entry.getEntryBlock())
+    {
+        if (auto* call = llvm::dyn_cast<llvm::CallBase>(&inst))
+        {
+            calls_.push_back(call);
+        }
+    }
+    bound_.resize(calls_.size());
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Bind calls to the given function.
+ */
+template<class R, class... Args>
+void StaticBinder::operator()(char const* name, R (*func)(Args...))
+{
+    llvm::Function const* irfunc = mod_.getFunction(name);
+    if (!irfunc)
+    {
+        return;
+    }
+
+    // Throw an assertion if the function types don't match
+    FunctionChecker{*irfunc}(func);
+
+    for (std::size_t i = 0; i < calls_.size(); ++i)
+    {
+        if (calls_[i]->getCalledFunction() == irfunc)
+        {
+            bound_[i] = bind_call(
+                *calls_[i], func, std::index_sequence_for<Args...>{});
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether all calls in the entry point have been bound.
+ */
+bool StaticBinder::complete() const
+{
+    return std::all_of(
+        bound_.begin(), bound_.end(), [](Call const& c) { return bool(c); });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Release the bound calls.
+ */
+auto StaticBinder::release() -> VecCall
+{
+    QIREE_EXPECT(this->complete());
+    calls_.clear();
+    return std::move(bound_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Convert the arguments of a call, returning an empty function on failure.
+ */
+template<class R, class... Args, std::size_t... Is>
+auto StaticBinder::bind_call(llvm::CallBase const& call,
+                             R (*func)(Args...),
+                             std::index_sequence<Is...>) -> Call
+{
+    std::tuple<typename ConstantArg<Args>::storage_type...> args;
+    if (!(ConstantArg<Args>::load(call.getArgOperand(Is), &std::get<Is>(args))
+          && ...))
+    {
+        return {};
+    }
+    return [func, args = std::move(args)] {
+        func(ConstantArg<Args>::get(std::get<Is>(args))...);
+    };
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -0,0 +1,159 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/Backend.cc
+//---------------------------------------------------------------------------//
+#include "Backend.hh"
+
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+
+using namespace std::string_view_literals;
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+// Instructions that permute computational basis states
+constexpr std::string_view classical_functions[] = {
+    "ccx__body"sv,
+    "cnot__body"sv,
+    "cx__body"sv,
+    "m__body"sv,
+    "mresetz__body"sv,
+    "mz__body"sv,
+    "read_result__body"sv,
+    "reset__body"sv,
+    "swap__body"sv,
+    "x__body"sv,
+    "x__ctl"sv,
+};
+
+// Non-classical instructions in the Clifford group
+constexpr std::string_view clifford_functions[] = {
+    "cy__body"sv,
+    "cz__body"sv,
+    "h__body"sv,
+    "measure__body"sv,
+    "s__adj"sv,
+    "s__body"sv,
+    "y__body"sv,
+    "z__body"sv,
+};
+
+template<std::size_t N>
+bool contains(std::string_view const (&names)[N], std::string const& name)
+{
+    return std::find(std::begin(names), std::end(names), name)
+           != std::end(names);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Classify the gates in a set of QIS functions.
+ *
+ * The functions are named as in \c Module::load_qis_functions . Rotations are
+ * considered non-Clifford even though some angles are Clifford operations.
+ */
+GateSet classify_gate_set(std::vector<std::string> const& qis_functions)
+{
+    GateSet result;
+    for (auto const& name : qis_functions)
+    {
+        bool const classical = contains(classical_functions, name);
+        bool const clifford = contains(clifford_functions, name)
+                              || (classical && name != "ccx__body"
+                                  && name != "x__ctl");
+        result.classical = result.classical && classical;
+        result.clifford = result.clifford && clifford;
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Choose the cheapest simulator capable of running a program.
+ *
+ * Programs that only permute basis states are simulated with one bit per
+ * qubit, and other Clifford programs in polynomial time with a stabilizer
+ * tableau; everything else needs a state vector, which limits the number of
+ * qubits. The matrix product state simulator is never chosen automatically
+ * because it is only accurate for programs with limited entanglement, nor is
+ * the sparse simulator, which is only efficient when few basis states have
+ * nonzero amplitudes, nor are the density matrix and Pauli frame simulators,
+ * which are only needed to model noise.
+ */
+Backend select_backend(GateSet gates, size_type num_qubits)
+{
+    if (gates.classical)
+    {
+        return Backend::classical;
+    }
+    if (gates.clifford)
+    {
+        return Backend::stabilizer;
+    }
+
+    size_type const max_qubits = StateVectorQuantum::Options{}.max_qubits;
+    QIREE_VALIDATE(num_qubits <= max_qubits,
+                   << "program uses " << to_cstring(gates) << " gates on "
+                   << num_qubits << " qubits, which exceeds the "
+                   << max_qubits << "-qubit limit of the state vector "
+                      "simulator (use the mps backend for weakly entangled "
+                      "programs or the sparse backend for programs with "
+                      "few nonzero amplitudes)");
+    return Backend::statevector;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Choose the cheapest simulator capable of running a module.
+ */
+Backend select_backend(Module const& module)
+{
+    return select_backend(classify_gate_set(module.load_qis_functions()),
+                          module.load_entry_point_attrs().required_num_qubits);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a string representation of a simulation backend.
+ */
+char const* to_cstring(Backend value)
+{
+    static char const* const strings[] = {
+        "statevector",
+        "stabilizer",
+        "mps",
+        "density",
+        "frame",
+        "classical",
+        "sparse",
+    };
+    static_assert(std::size(strings) == static_cast<int>(Backend::size_));
+    QIREE_EXPECT(value != Backend::size_);
+    return strings[static_cast<int>(value)];
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a string representation of a gate set, e.g. "classical Clifford".
+ */
+char const* to_cstring(GateSet const& value)
+{
+    if (value.classical)
+    {
+        return value.clifford ? "classical Clifford" : "classical";
+    }
+    return value.clifford ? "Clifford" : "universal";
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
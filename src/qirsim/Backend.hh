@@ -0,0 +1,187 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/Backend.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "qiree/Assert.hh"
+#include "qiree/Module.hh"
+#include "qiree/Types.hh"
+
+#include "ClassicalBitQuantum.hh"
+#include "DensityMatrixQuantum.hh"
+#include "MpsQuantum.hh"
+#include "NoiseModel.hh"
+#include "PauliFrameQuantum.hh"
+#include "SparseQuantum.hh"
+#include "StabilizerQuantum.hh"
+#include "StateVectorQuantum.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+//! Native simulation method
+enum class Backend
+{
+    statevector,  //!< Dense state vector: any program with few qubits
+    stabilizer,  //!< Stabilizer tableau: Clifford programs
+    mps,  //!< Matrix product state: many qubits with limited entanglement
+    density,  //!< Density matrix: noisy programs with very few qubits
+    frame,  //!< Pauli frames: many shots of noisy Clifford programs
+    classical,  //!< Bit vector: reversible classical programs
+    sparse,  //!< Hash map of amplitudes: many qubits with small support
+    size_
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Classes of quantum instructions that contain a program.
+ *
+ * Classical reversible programs (X, CNOT, Toffoli, swap) are also Clifford
+ * programs if they have no Toffoli or multiply controlled X gates.
+ */
+struct GateSet
+{
+    bool classical{true};  //!< Only permutes computational basis states
+    bool clifford{true};  //!< Only Clifford operations
+};
+
+//---------------------------------------------------------------------------//
+//! Options common to all simulators
+struct SimulatorOptions
+{
+    //! Seed for measurement sampling
+    std::uint64_t seed{std::mt19937_64::default_seed};
+    //! Maximum number of qubits (zero for the simulator's default)
+    size_type max_qubits{0};
+    //! Maximum MPS bond dimension (zero for the default)
+    size_type max_bond{0};
+    //! Maximum squared weight discarded by each MPS truncation (negative for
+    //! the default)
+    double truncation_threshold{-1};
+    //! Maximum number of nonzero sparse amplitudes (zero for the default)
+    size_type max_support{0};
+    //! Maximum qubits per fused state vector gate (zero for a cost model)
+    size_type fusion_qubits{0};
+    //! Errors of the density matrix and Pauli frame simulators
+    NoiseModel noise;
+};
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Classify the gates in a set of QIS functions
+GateSet classify_gate_set(std::vector<std::string> const& qis_functions);
+
+// Choose the cheapest simulator capable of running a program
+Backend select_backend(GateSet gates, size_type num_qubits);
+
+// Choose the cheapest simulator capable of running a module
+Backend select_backend(Module const& module);
+
+// Get a string representation of a simulation backend
+char const* to_cstring(Backend);
+
+// Get a string representation of a gate set, e.g. "classical Clifford"
+char const* to_cstring(GateSet const&);
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the construction options for a simulator type.
+ */
+template<class QI>
+typename QI::Options simulator_options(SimulatorOptions const& opts)
+{
+    typename QI::Options result;
+    result.seed = opts.seed;
+    if (opts.max_qubits)
+    {
+        result.max_qubits = opts.max_qubits;
+    }
+    if constexpr (std::is_same_v<QI, MpsQuantum>)
+    {
+        if (opts.max_bond)
+        {
+            result.max_bond = opts.max_bond;
+        }
+        if (opts.truncation_threshold >= 0)
+        {
+            result.truncation_threshold = opts.truncation_threshold;
+        }
+    }
+    if constexpr (std::is_same_v<QI, StateVectorQuantum>)
+    {
+        result.fusion_qubits = opts.fusion_qubits;
+    }
+    if constexpr (std::is_same_v<QI, SparseQuantum>)
+    {
+        if (opts.max_support)
+        {
+            result.max_support = opts.max_support;
+        }
+    }
+    if constexpr (std::is_same_v<QI, DensityMatrixQuantum>
+                  || std::is_same_v<QI, PauliFrameQuantum>)
+    {
+        result.noise = opts.noise;
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct a simulator and pass it to a function.
+ *
+ * The function is called with the concrete simulator type so that it can
+ * instantiate statically dispatched executors:
+ * \code
+   visit_simulator(select_backend(mod), opts, [&](auto& sim) {
+       using QI = std::remove_reference_t<decltype(sim)>;
+       DirectExecutor<QI, HistogramRuntime> execute{std::move(mod)};
+       ...
+   });
+ * \endcode
+ */
+template<class F>
+decltype(auto)
+visit_simulator(Backend backend, SimulatorOptions const& opts, F&& apply)
+{
+    auto visit = [&](auto* type) -> decltype(auto) {
+        using QI = std::remove_pointer_t<decltype(type)>;
+        QI sim{simulator_options<QI>(opts)};
+        return apply(sim);
+    };
+
+    switch (backend)
+    {
+        case Backend::statevector:
+            return visit(static_cast<StateVectorQuantum*>(nullptr));
+        case Backend::stabilizer:
+            return visit(static_cast<StabilizerQuantum*>(nullptr));
+        case Backend::mps:
+            return visit(static_cast<MpsQuantum*>(nullptr));
+        case Backend::density:
+            return visit(static_cast<DensityMatrixQuantum*>(nullptr));
+        case Backend::frame:
+            return visit(static_cast<PauliFrameQuantum*>(nullptr));
+        case Backend::classical:
+            return visit(static_cast<ClassicalBitQuantum*>(nullptr));
+        case Backend::sparse:
+            return visit(static_cast<SparseQuantum*>(nullptr));
+        default:
+            QIREE_ASSERT_UNREACHABLE();
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,85 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/BranchingShots.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include "qiree/Types.hh"
+
+#include "HistogramRuntime.hh"
+#include "StateVectorQuantum.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Run shots that share measurement histories as a single execution.
+ *
+ * The program is executed once per distinct branch of its measurement tree,
+ * with shots allocated to branches multinomially by sampling each
+ * measurement's outcome counts (see \c StateVectorQuantum::start_branching ).
+ * The state up to each measurement is simulated once, so the cost scales with
+ * the number of distinct outcomes rather than the number of shots. The
+ * program must be deterministic given its measurement outcomes.
+ *
+ * The executor is called with the simulator and runtime, so it can be an
+ * \c Executor or a \c DirectExecutor .
+ *
+ * \return Number of executions
+ */
+template<class E>
+size_type run_branching_shots(E const& execute,
+                              StateVectorQuantum& sim,
+                              HistogramRuntime& rt,
+                              size_type num_shots)
+{
+    size_type num_executions{0};
+    sim.start_branching(num_shots);
+    while (sim.next_branch())
+    {
+        execute(sim, rt);
+        rt.end_shot(sim.branch_shots());
+        ++num_executions;
+    }
+    return num_executions;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Compute the exact distribution of a program's outputs.
+ *
+ * Every branch of the measurement tree whose probability exceeds the
+ * threshold is executed once, and its outputs are accumulated with its
+ * probability (see \c HistogramRuntime::end_branch ). An execution whose
+ * probability falls to the threshold is abandoned without recording its
+ * outputs. The total probability of the skipped branches is available from
+ * \c StateVectorQuantum::pruned_probability . Both outcomes of every
+ * measurement are explored whether or not the program reads them, so the
+ * number of executions can grow exponentially with the number of
+ * measurements. As with \c run_branching_shots , the executor can be an
+ * \c Executor or a \c DirectExecutor .
+ *
+ * \return Number of executions
+ */
+template<class E>
+size_type enumerate_branches(E const& execute,
+                             StateVectorQuantum& sim,
+                             HistogramRuntime& rt,
+                             double prune_threshold)
+{
+    size_type num_executions{0};
+    sim.start_enumeration(prune_threshold);
+    while (sim.next_branch())
+    {
+        execute(sim, rt);
+        rt.end_branch(sim.branch_probability());
+        ++num_executions;
+    }
+    return num_executions;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
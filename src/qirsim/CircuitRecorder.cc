@@ -0,0 +1,703 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/CircuitRecorder.cc
+//---------------------------------------------------------------------------//
+#include "CircuitRecorder.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "qiree/Assert.hh"
+#include "qiree/MemManager.hh"
+
+#include "detail/QirArgs.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * QIR array that is released at the end of its scope.
+ */
+class ScopedArray
+{
+  public:
+    //! Create an array of qubits
+    ScopedArray(Circuit::Index const* qubits, size_type size)
+        : arr_{MemManager::array_create_1d(sizeof(Qubit), size)}
+    {
+        for (size_type i = 0; i < size; ++i)
+        {
+            this->set(i, Qubit{qubits[i]});
+        }
+    }
+
+    //! Create an array of Paulis
+    ScopedArray(Pauli const* paulis, size_type size)
+        : arr_{MemManager::array_create_1d(sizeof(Pauli), size)}
+    {
+        for (size_type i = 0; i < size; ++i)
+        {
+            this->set(i, paulis[i]);
+        }
+    }
+
+    //! Release the array
+    ~ScopedArray() { MemManager::array_update_reference_count(arr_, -1); }
+
+    QIREE_DELETE_COPY_MOVE(ScopedArray);
+
+    //! Get the QIR array
+    operator Array() const { return arr_; }
+
+  private:
+    Array arr_;
+
+    template<class T>
+    void set(size_type i, T value)
+    {
+        std::memcpy(
+            MemManager::array_get_element_ptr_1d(arr_, i), &value, sizeof(T));
+    }
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply an uncontrolled circuit operation.
+ */
+void replay_uncontrolled(Circuit::OperationRef const& op,
+                         QuantumInterface& sim)
+{
+    Qubit const q{op.targets[0]};
+    switch (op.op)
+    {
+        // clang-format off
+        case GateOp::h: sim.h(q); break;
+        case GateOp::x: sim.x(q); break;
+        case GateOp::y: sim.y(q); break;
+        case GateOp::z: sim.z(q); break;
+        case GateOp::s: sim.s(q); break;
+        case GateOp::s_adj: sim.s_adj(q); break;
+        case GateOp::t: sim.t(q); break;
+        case GateOp::t_adj: sim.t_adj(q); break;
+        case GateOp::rx: sim.rx(op.theta, q); break;
+        case GateOp::ry: sim.ry(op.theta, q); break;
+        case GateOp::rz: sim.rz(op.theta, q); break;
+        case GateOp::reset: sim.reset(q); break;
+        case GateOp::measure_z: sim.mz(q, op.result); break;
+        // clang-format on
+        case GateOp::rxx:
+            sim.rxx(op.theta, q, Qubit{op.targets[1]});
+            break;
+        case GateOp::ryy:
+            sim.ryy(op.theta, q, Qubit{op.targets[1]});
+            break;
+        case GateOp::rzz:
+            sim.rzz(op.theta, q, Qubit{op.targets[1]});
+            break;
+        case GateOp::swap:
+            sim.swap(q, Qubit{op.targets[1]});
+            break;
+        case GateOp::pauli_rotation: {
+            ScopedArray paulis{op.paulis, op.num_targets};
+            ScopedArray qubits{op.targets, op.num_targets};
+            sim.exp(paulis, -op.theta / 2, qubits);
+            break;
+        }
+        case GateOp::measure_pauli: {
+            ScopedArray paulis{op.paulis, op.num_targets};
+            ScopedArray qubits{op.targets, op.num_targets};
+            sim.measure(paulis, qubits);
+            break;
+        }
+        default:
+            QIREE_ASSERT_UNREACHABLE();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a controlled circuit operation.
+ *
+ * Gates with one or two controls use the dedicated instructions if the QIS
+ * has them; two-qubit rotations become controlled Pauli exponentials, and a
+ * controlled swap is decomposed into CNOT gates around a controlled X.
+ */
+void replay_controlled(Circuit::OperationRef const& op, QuantumInterface& sim)
+{
+    Qubit const q{op.targets[0]};
+    if (op.num_controls == 1)
+    {
+        Qubit const c{op.controls[0]};
+        switch (op.op)
+        {
+            // clang-format off
+            case GateOp::x: sim.cnot(c, q); return;
+            case GateOp::y: sim.cy(c, q); return;
+            case GateOp::z: sim.cz(c, q); return;
+            // clang-format on
+            default:
+                break;
+        }
+    }
+    else if (op.num_controls == 2 && op.op == GateOp::x)
+    {
+        sim.ccx(Qubit{op.controls[0]}, Qubit{op.controls[1]}, q);
+        return;
+    }
+
+    ScopedArray ctls{op.controls, op.num_controls};
+    switch (op.op)
+    {
+        // clang-format off
+        case GateOp::h: sim.h(ctls, q); break;
+        case GateOp::x: sim.x(ctls, q); break;
+        case GateOp::y: sim.y(ctls, q); break;
+        case GateOp::z: sim.z(ctls, q); break;
+        case GateOp::s: sim.s(ctls, q); break;
+        case GateOp::s_adj: sim.s_adj(ctls, q); break;
+        case GateOp::t: sim.t(ctls, q); break;
+        case GateOp::t_adj: sim.t_adj(ctls, q); break;
+        // clang-format on
+        case GateOp::rx:
+        case GateOp::ry:
+        case GateOp::rz: {
+            RotationArgs args{op.theta, q};
+            if (op.op == GateOp::rx)
+            {
+                sim.rx(ctls, &args);
+            }
+            else if (op.op == GateOp::ry)
+            {
+                sim.ry(ctls, &args);
+            }
+            else
+            {
+                sim.rz(ctls, &args);
+            }
+            break;
+        }
+        case GateOp::rxx:
+        case GateOp::ryy:
+        case GateOp::rzz:
+        case GateOp::pauli_rotation: {
+            Pauli pair[2];
+            Pauli const* p = op.paulis;
+            if (op.op != GateOp::pauli_rotation)
+            {
+                pair[0] = op.op == GateOp::rxx   ? Pauli::x
+                          : op.op == GateOp::ryy ? Pauli::y
+                                                 : Pauli::z;
+                pair[1] = pair[0];
+                p = pair;
+            }
+            ScopedArray paulis{p, op.num_targets};
+            ScopedArray qubits{op.targets, op.num_targets};
+            detail::ExpArgs args{paulis, -op.theta / 2, qubits};
+            sim.exp(ctls, &args);
+            break;
+        }
+        case GateOp::swap: {
+            // Swap is CNOT(b, a) CCX(c..., a, b) CNOT(b, a)
+            Qubit const b{op.targets[1]};
+            std::vector<Circuit::Index> controls(
+                op.controls, op.controls + op.num_controls);
+            controls.push_back(op.targets[0]);
+            ScopedArray swap_ctls{controls.data(), controls.size()};
+            sim.cnot(b, q);
+            sim.x(swap_ctls, b);
+            sim.cnot(b, q);
+            break;
+        }
+        default:
+            QIREE_ASSERT_UNREACHABLE();
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Start recording an entry point.
+ */
+void CircuitRecorder::set_up(EntryPointAttrs const& attrs)
+{
+    QIREE_VALIDATE(
+        attrs.required_num_qubits <= std::numeric_limits<Index>::max(),
+        << "entry point requires " << attrs.required_num_qubits
+        << " qubits, which is too many to record");
+
+    circuit_.clear();
+    num_qubits_ = attrs.required_num_qubits;
+    num_results_ = attrs.required_num_results;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete an execution.
+ *
+ * The circuit is kept for inspection until the next set-up.
+ */
+void CircuitRecorder::tear_down() {}
+
+//---------------------------------------------------------------------------//
+// MEASUREMENTS
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis into a new result.
+ */
+Result CircuitRecorder::m(Qubit q)
+{
+    Result r{num_results_};
+    this->mz(q, r);
+    return r;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a joint Pauli observable into a new result.
+ */
+Result CircuitRecorder::measure(Array paulis, Array qubits)
+{
+    auto& op = this->start(GateOp::measure_pauli);
+    this->read_pauli_string(paulis, qubits);
+    op.result = Result{num_results_++};
+    circuit_.push_back(op);
+    return op.result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a new result and reset it.
+ */
+Result CircuitRecorder::mresetz(Qubit q)
+{
+    auto r = this->m(q);
+    this->add(GateOp::reset, q);
+    return r;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis and store the result.
+ */
+void CircuitRecorder::mz(Qubit q, Result r)
+{
+    auto& op = this->start(GateOp::measure_z);
+    op.targets.push_back(this->index(q));
+    op.result = r;
+    circuit_.push_back(op);
+    num_results_ = std::max(num_results_, r.value + 1);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Reading a result is unsupported because a circuit can't branch.
+ */
+QState CircuitRecorder::read_result(Result r)
+{
+    QIREE_VALIDATE(false,
+                   << "result " << r.value
+                   << " was read while recording a circuit (programs that "
+                      "branch on measurements can't be recorded)");
+    return QState::zero;
+}
+
+//---------------------------------------------------------------------------//
+// GATES
+//---------------------------------------------------------------------------//
+
+void CircuitRecorder::ccx(Qubit c1, Qubit c2, Qubit t)
+{
+    this->add_controlled(GateOp::x, {c1, c2}, t);
+}
+
+void CircuitRecorder::cnot(Qubit c, Qubit t)
+{
+    this->add_controlled(GateOp::x, {c}, t);
+}
+
+void CircuitRecorder::cx(Qubit c, Qubit t)
+{
+    this->cnot(c, t);
+}
+
+void CircuitRecorder::cy(Qubit c, Qubit t)
+{
+    this->add_controlled(GateOp::y, {c}, t);
+}
+
+void CircuitRecorder::cz(Qubit c, Qubit t)
+{
+    this->add_controlled(GateOp::z, {c}, t);
+}
+
+//! Apply exp(-i theta P)
+void CircuitRecorder::exp_adj(Array paulis, double theta, Array qubits)
+{
+    this->exp(paulis, -theta, qubits);
+}
+
+//! Apply exp(i theta P), which is a rotation by -2 theta
+void CircuitRecorder::exp(Array paulis, double theta, Array qubits)
+{
+    auto& op = this->start(GateOp::pauli_rotation);
+    this->read_pauli_string(paulis, qubits);
+    op.theta = -2 * theta;
+    circuit_.push_back(op);
+}
+
+void CircuitRecorder::exp(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<detail::ExpArgs>(args);
+    auto& op = this->start(GateOp::pauli_rotation);
+    this->read_controls(ctls);
+    this->read_pauli_string(a.paulis, a.qubits);
+    op.theta = -2 * a.theta;
+    circuit_.push_back(op);
+}
+
+void CircuitRecorder::exp_adj(Array ctls, Tuple args)
+{
+    auto a = detail::tuple_args<detail::ExpArgs>(args);
+    a.theta = -a.theta;
+    this->exp(ctls, &a);
+}
+
+void CircuitRecorder::h(Qubit q)
+{
+    this->add(GateOp::h, q);
+}
+
+void CircuitRecorder::h(Array ctls, Qubit q)
+{
+    this->add_controlled(GateOp::h, ctls, q, 0);
+}
+
+void CircuitRecorder::r_adj(Pauli p, double theta, Qubit q)
+{
+    this->rotate(p, -theta, nullptr, q);
+}
+
+void CircuitRecorder::r(Pauli p, double theta, Qubit q)
+{
+    this->rotate(p, theta, nullptr, q);
+}
+
+void CircuitRecorder::r(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<detail::PauliRotationArgs>(args);
+    this->rotate(a.pauli, a.theta, ctls, a.qubit);
+}
+
+void CircuitRecorder::r_adj(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<detail::PauliRotationArgs>(args);
+    this->rotate(a.pauli, -a.theta, ctls, a.qubit);
+}
+
+void CircuitRecorder::reset(Qubit q)
+{
+    this->add(GateOp::reset, q);
+}
+
+void CircuitRecorder::rx(double theta, Qubit q)
+{
+    this->add(GateOp::rx, q, theta);
+}
+
+void CircuitRecorder::rx(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    this->add_controlled(GateOp::rx, ctls, a.qubit, a.theta);
+}
+
+void CircuitRecorder::rxx(double theta, Qubit q1, Qubit q2)
+{
+    this->add(GateOp::rxx, q1, q2, theta);
+}
+
+void CircuitRecorder::ry(double theta, Qubit q)
+{
+    this->add(GateOp::ry, q, theta);
+}
+
+void CircuitRecorder::ry(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    this->add_controlled(GateOp::ry, ctls, a.qubit, a.theta);
+}
+
+void CircuitRecorder::ryy(double theta, Qubit q1, Qubit q2)
+{
+    this->add(GateOp::ryy, q1, q2, theta);
+}
+
+void CircuitRecorder::rz(double theta, Qubit q)
+{
+    this->add(GateOp::rz, q, theta);
+}
+
+void CircuitRecorder::rz(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    this->add_controlled(GateOp::rz, ctls, a.qubit, a.theta);
+}
+
+void CircuitRecorder::rzz(double theta, Qubit q1, Qubit q2)
+{
+    this->add(GateOp::rzz, q1, q2, theta);
+}
+
+void CircuitRecorder::s_adj(Qubit q)
+{
+    this->add(GateOp::s_adj, q);
+}
+
+void CircuitRecorder::s(Qubit q)
+{
+    this->add(GateOp::s, q);
+}
+
+void CircuitRecorder::s(Array ctls, Qubit q)
+{
+    this->add_controlled(GateOp::s, ctls, q, 0);
+}
+
+void CircuitRecorder::s_adj(Array ctls, Qubit q)
+{
+    this->add_controlled(GateOp::s_adj, ctls, q, 0);
+}
+
+void CircuitRecorder::swap(Qubit q1, Qubit q2)
+{
+    this->add(GateOp::swap, q1, q2);
+}
+
+void CircuitRecorder::t_adj(Qubit q)
+{
+    this->add(GateOp::t_adj, q);
+}
+
+void CircuitRecorder::t(Qubit q)
+{
+    this->add(GateOp::t, q);
+}
+
+void CircuitRecorder::t(Array ctls, Qubit q)
+{
+    this->add_controlled(GateOp::t, ctls, q, 0);
+}
+
+void CircuitRecorder::t_adj(Array ctls, Qubit q)
+{
+    this->add_controlled(GateOp::t_adj, ctls, q, 0);
+}
+
+void CircuitRecorder::x(Qubit q)
+{
+    this->add(GateOp::x, q);
+}
+
+void CircuitRecorder::x(Array ctls, Qubit q)
+{
+    this->add_controlled(GateOp::x, ctls, q, 0);
+}
+
+void CircuitRecorder::y(Qubit q)
+{
+    this->add(GateOp::y, q);
+}
+
+void CircuitRecorder::y(Array ctls, Qubit q)
+{
+    this->add_controlled(GateOp::y, ctls, q, 0);
+}
+
+void CircuitRecorder::z(Qubit q)
+{
+    this->add(GateOp::z, q);
+}
+
+void CircuitRecorder::z(Array ctls, Qubit q)
+{
+    this->add_controlled(GateOp::z, ctls, q, 0);
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the operand index of a qubit.
+ */
+auto CircuitRecorder::index(Qubit q) const -> Index
+{
+    QIREE_VALIDATE(q.value < num_qubits_,
+                   << "qubit " << q.value << " is out of range (entry point "
+                   << "requires " << num_qubits_ << " qubits)");
+    return static_cast<Index>(q.value);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add the qubits of a QIR array to the controls of the current operation.
+ */
+void CircuitRecorder::read_controls(Array controls)
+{
+    detail::read_qubits(controls, qubit_buf_);
+    for (Qubit q : qubit_buf_)
+    {
+        op_.controls.push_back(this->index(q));
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Set the Paulis and targets of the current operation from QIR arrays.
+ */
+void CircuitRecorder::read_pauli_string(Array paulis, Array qubits)
+{
+    detail::read_paulis(paulis, op_.paulis);
+    detail::read_qubits(qubits, qubit_buf_);
+    QIREE_VALIDATE(op_.paulis.size() == qubit_buf_.size(),
+                   << "mismatched Pauli and qubit array sizes ("
+                   << op_.paulis.size() << " != " << qubit_buf_.size()
+                   << ")");
+    for (Qubit q : qubit_buf_)
+    {
+        op_.targets.push_back(this->index(q));
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Reset the current operation.
+ */
+Circuit::Operation& CircuitRecorder::start(GateOp op)
+{
+    op_.op = op;
+    op_.controls.clear();
+    op_.targets.clear();
+    op_.paulis.clear();
+    op_.theta = 0;
+    op_.result = {};
+    return op_;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record an uncontrolled single-qubit operation.
+ */
+void CircuitRecorder::add(GateOp op, Qubit target, double theta)
+{
+    this->start(op).targets.push_back(this->index(target));
+    op_.theta = theta;
+    circuit_.push_back(op_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record an uncontrolled two-qubit operation.
+ */
+void CircuitRecorder::add(GateOp op, Qubit q1, Qubit q2, double theta)
+{
+    this->start(op);
+    op_.targets.push_back(this->index(q1));
+    op_.targets.push_back(this->index(q2));
+    op_.theta = theta;
+    circuit_.push_back(op_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record a gate with a fixed list of controls.
+ */
+void CircuitRecorder::add_controlled(GateOp op,
+                                     std::initializer_list<Qubit> controls,
+                                     Qubit target)
+{
+    this->start(op);
+    for (Qubit c : controls)
+    {
+        op_.controls.push_back(this->index(c));
+    }
+    op_.targets.push_back(this->index(target));
+    circuit_.push_back(op_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record a gate with a QIR array of controls.
+ */
+void CircuitRecorder::add_controlled(GateOp op,
+                                     Array controls,
+                                     Qubit target,
+                                     double theta)
+{
+    this->start(op);
+    this->read_controls(controls);
+    op_.targets.push_back(this->index(target));
+    op_.theta = theta;
+    circuit_.push_back(op_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record a rotation about a single-qubit Pauli with optional controls.
+ *
+ * A rotation about the identity is a (possibly controlled) phase, which is
+ * stored as a Pauli rotation.
+ */
+void CircuitRecorder::rotate(Pauli p, double theta, Array controls, Qubit q)
+{
+    static GateOp const ops[] = {
+        GateOp::pauli_rotation, GateOp::rx, GateOp::rz, GateOp::ry};
+    this->start(ops[static_cast<int>(p)]);
+    if (controls)
+    {
+        this->read_controls(controls);
+    }
+    op_.targets.push_back(this->index(q));
+    if (p == Pauli::i)
+    {
+        op_.paulis.push_back(p);
+    }
+    op_.theta = theta;
+    circuit_.push_back(op_);
+}
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Apply the operations of a circuit to a quantum interface.
+ *
+ * The interface must already be set up for enough qubits and results. Pauli
+ * measurements return a new result from the interface rather than the
+ * recorded one; the two agree for recorders and simulators that number new
+ * results consecutively after the entry point's required results.
+ */
+void replay(Circuit const& circuit, QuantumInterface& sim)
+{
+    for (size_type i = 0; i < circuit.size(); ++i)
+    {
+        auto op = circuit[i];
+        if (op.num_controls == 0)
+        {
+            replay_uncontrolled(op, sim);
+        }
+        else
+        {
+            replay_controlled(op, sim);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
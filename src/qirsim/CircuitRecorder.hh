@@ -0,0 +1,144 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/CircuitRecorder.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <initializer_list>
+#include <vector>
+
+#include "qiree/Circuit.hh"
+#include "qiree/Macros.hh"
+#include "qiree/QuantumInterface.hh"
+#include "qiree/QuantumNotImpl.hh"
+#include "qiree/Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Record the quantum instructions of an execution into a circuit.
+ *
+ * Each instruction is translated to a \c Circuit operation: CNOT and Toffoli
+ * gates become controlled X gates, exponentials and Pauli rotations become
+ * rotations about a Pauli string, and \c mresetz is a measurement followed by
+ * a reset. Results returned by \c m , \c measure , and \c mresetz are
+ * numbered after the entry point's required results, as the simulators do.
+ *
+ * A circuit is static, so reading a result (for example, to branch on it) is
+ * an error.
+ */
+class CircuitRecorder final : virtual public QuantumNotImpl
+{
+  public:
+    // Construct with an empty circuit
+    CircuitRecorder() = default;
+
+    QIREE_DELETE_COPY_MOVE(CircuitRecorder);
+
+    //!@{
+    //! \name Accessors
+    size_type num_qubits() const { return num_qubits_; }
+    size_type num_results() const { return num_results_; }
+    //! Operations recorded since the last set-up
+    Circuit const& circuit() const { return circuit_; }
+    //!@}
+
+    // Discard the recorded operations but keep numbering results
+    void clear_circuit() { circuit_.clear(); }
+
+    //!@{
+    //! \name Quantum interface
+    void set_up(EntryPointAttrs const&) final;
+    void tear_down() final;
+    //!@}
+
+    //!@{
+    //! \name Measurements
+    Result m(Qubit) final;
+    Result measure(Array, Array) final;
+    Result mresetz(Qubit) final;
+    void mz(Qubit, Result) final;
+    QState read_result(Result) final;
+    //!@}
+
+    //!@{
+    //! \name Gates
+    void ccx(Qubit, Qubit, Qubit) final;
+    void cnot(Qubit, Qubit) final;
+    void cx(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
+    void cz(Qubit, Qubit) final;
+    void exp_adj(Array, double, Array) final;
+    void exp(Array, double, Array) final;
+    void exp(Array, Tuple) final;
+    void exp_adj(Array, Tuple) final;
+    void h(Qubit) final;
+    void h(Array, Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    void r(Array, Tuple) final;
+    void r_adj(Array, Tuple) final;
+    void reset(Qubit) final;
+    void rx(double, Qubit) final;
+    void rx(Array, Tuple) final;
+    void rxx(double, Qubit, Qubit) final;
+    void ry(double, Qubit) final;
+    void ry(Array, Tuple) final;
+    void ryy(double, Qubit, Qubit) final;
+    void rz(double, Qubit) final;
+    void rz(Array, Tuple) final;
+    void rzz(double, Qubit, Qubit) final;
+    void s_adj(Qubit) final;
+    void s(Qubit) final;
+    void s(Array, Qubit) final;
+    void s_adj(Array, Qubit) final;
+    void swap(Qubit, Qubit) final;
+    void t_adj(Qubit) final;
+    void t(Qubit) final;
+    void t(Array, Qubit) final;
+    void t_adj(Array, Qubit) final;
+    void x(Qubit) final;
+    void x(Array, Qubit) final;
+    void y(Qubit) final;
+    void y(Array, Qubit) final;
+    void z(Qubit) final;
+    void z(Array, Qubit) final;
+    //!@}
+
+  private:
+    using Index = Circuit::Index;
+
+    Circuit circuit_;
+    size_type num_qubits_{0};
+    size_type num_results_{0};
+
+    // Operation being recorded, reused to avoid allocating
+    Circuit::Operation op_;
+    std::vector<Qubit> qubit_buf_;
+
+    Index index(Qubit q) const;
+    void read_controls(Array controls);
+    void read_pauli_string(Array paulis, Array qubits);
+    Circuit::Operation& start(GateOp op);
+    void add(GateOp op, Qubit target, double theta = 0);
+    void add(GateOp op, Qubit q1, Qubit q2, double theta = 0);
+    void add_controlled(GateOp op,
+                        std::initializer_list<Qubit> controls,
+                        Qubit target);
+    void add_controlled(GateOp op, Array controls, Qubit target, double theta);
+    void rotate(Pauli p, double theta, Array controls, Qubit target);
+};
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Apply the operations of a circuit to a quantum interface
+void replay(Circuit const& circuit, QuantumInterface& sim);
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
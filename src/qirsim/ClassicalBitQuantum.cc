@@ -0,0 +1,440 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/ClassicalBitQuantum.cc
+//---------------------------------------------------------------------------//
+#include "ClassicalBitQuantum.hh"
+
+#include "qiree/Assert.hh"
+
+#include "detail/CliffordUtils.hh"
+#include "detail/QirArgs.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with default options.
+ */
+ClassicalBitQuantum::ClassicalBitQuantum() : ClassicalBitQuantum{Options{}}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with options.
+ */
+ClassicalBitQuantum::ClassicalBitQuantum(Options const& opts)
+    : options_{opts}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether a qubit is in |1>.
+ */
+bool ClassicalBitQuantum::is_one(Qubit q) const
+{
+    return this->get(this->index(q));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare the all-zero state for an entry point.
+ */
+void ClassicalBitQuantum::set_up(EntryPointAttrs const& attrs)
+{
+    QIREE_VALIDATE(attrs.required_num_qubits <= options_.max_qubits,
+                   << "entry point requires " << attrs.required_num_qubits
+                   << " qubits but the classical simulator is limited to "
+                   << options_.max_qubits);
+
+    num_qubits_ = attrs.required_num_qubits;
+    num_operations_ = 0;
+    bits_.assign((num_qubits_ + 63) / 64, 0);
+    results_.assign(attrs.required_num_results, QState::zero);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete an execution.
+ */
+void ClassicalBitQuantum::tear_down() {}
+
+//---------------------------------------------------------------------------//
+// MEASUREMENTS
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis into a new result.
+ */
+Result ClassicalBitQuantum::m(Qubit q)
+{
+    ++num_operations_;
+    return this->push_result(this->is_one(q) ? QState::one : QState::zero);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a joint Pauli observable into a new result.
+ *
+ * A Z string measures the parity of its qubits. Measuring X or Y components
+ * of a basis state gives a random outcome and a superposition.
+ */
+Result ClassicalBitQuantum::measure(Array paulis, Array qubits)
+{
+    ++num_operations_;
+    detail::read_paulis(paulis, pauli_buf_);
+    detail::read_qubits(qubits, qubit_buf_);
+    QIREE_VALIDATE(pauli_buf_.size() == qubit_buf_.size(),
+                   << "mismatched Pauli and qubit array sizes ("
+                   << pauli_buf_.size() << " != " << qubit_buf_.size()
+                   << ")");
+
+    bool parity = false;
+    for (size_type i = 0; i < qubit_buf_.size(); ++i)
+    {
+        auto a = this->index(qubit_buf_[i]);
+        if (pauli_buf_[i] == Pauli::z)
+        {
+            parity ^= this->get(a);
+        }
+        else if (pauli_buf_[i] != Pauli::i)
+        {
+            this->superposition("measure.body");
+        }
+    }
+    return this->push_result(parity ? QState::one : QState::zero);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a new result and reset it.
+ */
+Result ClassicalBitQuantum::mresetz(Qubit q)
+{
+    ++num_operations_;
+    auto a = this->index(q);
+    bool const one = this->get(a);
+    if (one)
+    {
+        this->flip(a);
+    }
+    return this->push_result(one ? QState::one : QState::zero);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis and store the result.
+ */
+void ClassicalBitQuantum::mz(Qubit q, Result r)
+{
+    ++num_operations_;
+    if (r.value >= results_.size())
+    {
+        results_.resize(r.value + 1, QState::zero);
+    }
+    results_[r.value] = this->is_one(q) ? QState::one : QState::zero;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the value of a measured result.
+ */
+QState ClassicalBitQuantum::read_result(Result r)
+{
+    QIREE_VALIDATE(r.value < results_.size(),
+                   << "result " << r.value << " is out of range");
+    return results_[r.value];
+}
+
+//---------------------------------------------------------------------------//
+// PERMUTATIONS
+//---------------------------------------------------------------------------//
+
+void ClassicalBitQuantum::ccx(Qubit c1, Qubit c2, Qubit t)
+{
+    ++num_operations_;
+    QIREE_VALIDATE(c1.value != c2.value, << "duplicate control qubit");
+    QIREE_VALIDATE(c1.value != t.value && c2.value != t.value,
+                   << "target is also a control qubit");
+    auto b = this->index(t);
+    if (this->is_one(c1) && this->is_one(c2))
+    {
+        this->flip(b);
+    }
+}
+
+void ClassicalBitQuantum::cnot(Qubit c, Qubit t)
+{
+    ++num_operations_;
+    QIREE_VALIDATE(c.value != t.value, << "target is also a control qubit");
+    auto b = this->index(t);
+    if (this->is_one(c))
+    {
+        this->flip(b);
+    }
+}
+
+void ClassicalBitQuantum::cx(Qubit c, Qubit t)
+{
+    this->cnot(c, t);
+}
+
+//! Y flips the target up to a phase
+void ClassicalBitQuantum::cy(Qubit c, Qubit t)
+{
+    this->cnot(c, t);
+}
+
+void ClassicalBitQuantum::reset(Qubit q)
+{
+    ++num_operations_;
+    auto a = this->index(q);
+    if (this->get(a))
+    {
+        this->flip(a);
+    }
+}
+
+void ClassicalBitQuantum::rx(double theta, Qubit q)
+{
+    this->rotate(Pauli::x, theta, q, "rx.body");
+}
+
+void ClassicalBitQuantum::ry(double theta, Qubit q)
+{
+    this->rotate(Pauli::y, theta, q, "ry.body");
+}
+
+void ClassicalBitQuantum::swap(Qubit q1, Qubit q2)
+{
+    ++num_operations_;
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in swap");
+    auto a = this->index(q1);
+    auto b = this->index(q2);
+    if (this->get(a) != this->get(b))
+    {
+        this->flip(a);
+        this->flip(b);
+    }
+}
+
+void ClassicalBitQuantum::x(Qubit q)
+{
+    ++num_operations_;
+    this->flip(this->index(q));
+}
+
+void ClassicalBitQuantum::x(Array ctls, Qubit q)
+{
+    ++num_operations_;
+    if (this->controls_set(ctls, q))
+    {
+        this->flip(this->index(q));
+    }
+}
+
+void ClassicalBitQuantum::y(Qubit q)
+{
+    this->x(q);
+}
+
+void ClassicalBitQuantum::y(Array ctls, Qubit q)
+{
+    this->x(ctls, q);
+}
+
+//---------------------------------------------------------------------------//
+// PHASES
+//---------------------------------------------------------------------------//
+// A diagonal gate multiplies a basis state by a global phase, but its qubits
+// are still validated.
+
+void ClassicalBitQuantum::cz(Qubit c, Qubit t)
+{
+    ++num_operations_;
+    QIREE_VALIDATE(c.value != t.value, << "target is also a control qubit");
+    this->index(c);
+    this->index(t);
+}
+
+void ClassicalBitQuantum::rz(double, Qubit q)
+{
+    ++num_operations_;
+    this->index(q);
+}
+
+void ClassicalBitQuantum::rzz(double, Qubit q1, Qubit q2)
+{
+    ++num_operations_;
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in rzz");
+    this->index(q1);
+    this->index(q2);
+}
+
+void ClassicalBitQuantum::s_adj(Qubit q)
+{
+    this->rz(0, q);
+}
+
+void ClassicalBitQuantum::s(Qubit q)
+{
+    this->rz(0, q);
+}
+
+void ClassicalBitQuantum::s(Array ctls, Qubit q)
+{
+    this->z(ctls, q);
+}
+
+void ClassicalBitQuantum::s_adj(Array ctls, Qubit q)
+{
+    this->z(ctls, q);
+}
+
+void ClassicalBitQuantum::t_adj(Qubit q)
+{
+    this->rz(0, q);
+}
+
+void ClassicalBitQuantum::t(Qubit q)
+{
+    this->rz(0, q);
+}
+
+void ClassicalBitQuantum::t(Array ctls, Qubit q)
+{
+    this->z(ctls, q);
+}
+
+void ClassicalBitQuantum::t_adj(Array ctls, Qubit q)
+{
+    this->z(ctls, q);
+}
+
+void ClassicalBitQuantum::z(Qubit q)
+{
+    this->rz(0, q);
+}
+
+void ClassicalBitQuantum::z(Array ctls, Qubit q)
+{
+    ++num_operations_;
+    this->controls_set(ctls, q);
+}
+
+//---------------------------------------------------------------------------//
+// SUPERPOSITIONS
+//---------------------------------------------------------------------------//
+
+void ClassicalBitQuantum::h(Qubit q)
+{
+    ++num_operations_;
+    this->index(q);
+    this->superposition("h.body");
+}
+
+//! A controlled Hadamard is the identity unless its controls are set
+void ClassicalBitQuantum::h(Array ctls, Qubit q)
+{
+    ++num_operations_;
+    if (this->controls_set(ctls, q))
+    {
+        this->superposition("h.ctl");
+    }
+}
+
+void ClassicalBitQuantum::r_adj(Pauli p, double theta, Qubit q)
+{
+    this->rotate(p, -theta, q, "r.adj");
+}
+
+void ClassicalBitQuantum::r(Pauli p, double theta, Qubit q)
+{
+    this->rotate(p, theta, q, "r.body");
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the bit index of a qubit.
+ */
+size_type ClassicalBitQuantum::index(Qubit q) const
+{
+    return detail::qubit_index(q, num_qubits_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether all control qubits of a gate are in |1>.
+ */
+bool ClassicalBitQuantum::controls_set(Array controls, Qubit target)
+{
+    auto b = this->index(target);
+    detail::read_qubits(controls, qubit_buf_);
+    bool result = true;
+    for (Qubit c : qubit_buf_)
+    {
+        auto a = this->index(c);
+        QIREE_VALIDATE(a != b, << "target is also a control qubit");
+        result = result && this->get(a);
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Rotate about a Pauli axis, which must be diagonal or a multiple of pi.
+ *
+ * A rotation by \f$\pi\f$ about X or Y is the Pauli gate up to a phase.
+ */
+void ClassicalBitQuantum::rotate(Pauli p,
+                                 double theta,
+                                 Qubit target,
+                                 char const* instr)
+{
+    ++num_operations_;
+    auto a = this->index(target);
+    if (p == Pauli::i || p == Pauli::z)
+    {
+        return;
+    }
+    int const turns = detail::quarter_turns(theta);
+    if (turns < 0 || turns % 2 != 0)
+    {
+        this->superposition(instr);
+    }
+    if (turns == 2)
+    {
+        this->flip(a);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Report an operation that would create a superposition.
+ */
+void ClassicalBitQuantum::superposition(char const* instr) const
+{
+    QIREE_VALIDATE(false,
+                   << "quantum instruction '" << instr << "' (operation "
+                   << num_operations_
+                   << " of the execution) would create a superposition "
+                      "(use the stabilizer or statevector backend for "
+                      "non-classical programs)");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Store a measurement in a new result.
+ */
+Result ClassicalBitQuantum::push_result(QState value)
+{
+    return detail::push_result(value, results_);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,156 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/ClassicalBitQuantum.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "qiree/Macros.hh"
+#include "qiree/QuantumNotImpl.hh"
+#include "qiree/Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Simulate reversible classical QIR programs with a packed bit vector.
+ *
+ * Programs such as arithmetic circuits and oracles often keep the qubits in a
+ * computational basis state. The state is then a single bit per qubit, packed
+ * into 64-bit words, and X, CNOT, Toffoli, swap, and multiply controlled X
+ * gates are a few bit tests and flips regardless of the number of qubits.
+ * Diagonal gates (Z, S, T, Z rotations, and their controlled forms) only
+ * change the global phase of a basis state and are ignored, and Y gates and
+ * rotations by multiples of \f$\pi\f$ flip bits. Measurements are
+ * deterministic, so a program only needs to be executed once.
+ *
+ * A gate that would create a superposition, such as a Hadamard or a
+ * controlled Hadamard whose controls are set, raises a \c RuntimeError
+ * naming the instruction and its position in the execution.
+ */
+class ClassicalBitQuantum final : virtual public QuantumNotImpl
+{
+  public:
+    //! Construction options
+    struct Options
+    {
+        //! Unused: measurements of basis states are deterministic
+        std::uint64_t seed{std::mt19937_64::default_seed};
+        //! Maximum number of qubits
+        size_type max_qubits{size_type{1} << 24};
+    };
+
+    using Word = std::uint64_t;
+
+  public:
+    // Construct with default options
+    ClassicalBitQuantum();
+
+    // Construct with options
+    explicit ClassicalBitQuantum(Options const& opts);
+
+    QIREE_DELETE_COPY_MOVE(ClassicalBitQuantum);
+
+    //!@{
+    //! \name Accessors
+    size_type num_qubits() const { return num_qubits_; }
+    size_type num_results() const { return results_.size(); }
+    size_type num_operations() const { return num_operations_; }
+    Options const& options() const { return options_; }
+    //! Packed basis state: qubit \em i is bit <em>i</em> % 64 of word i / 64
+    std::vector<Word> const& state() const { return bits_; }
+    //!@}
+
+    // Whether a qubit is in |1>
+    bool is_one(Qubit) const;
+
+    //!@{
+    //! \name Quantum interface
+    void set_up(EntryPointAttrs const&) final;
+    void tear_down() final;
+    //!@}
+
+    //!@{
+    //! \name Measurements
+    Result m(Qubit) final;
+    Result measure(Array, Array) final;
+    Result mresetz(Qubit) final;
+    void mz(Qubit, Result) final;
+    QState read_result(Result) final;
+    //!@}
+
+    //!@{
+    //! \name Permutations
+    void ccx(Qubit, Qubit, Qubit) final;
+    void cnot(Qubit, Qubit) final;
+    void cx(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
+    void reset(Qubit) final;
+    void rx(double, Qubit) final;
+    void ry(double, Qubit) final;
+    void swap(Qubit, Qubit) final;
+    void x(Qubit) final;
+    void x(Array, Qubit) final;
+    void y(Qubit) final;
+    void y(Array, Qubit) final;
+    //!@}
+
+    //!@{
+    //! \name Phases
+    void cz(Qubit, Qubit) final;
+    void rz(double, Qubit) final;
+    void rzz(double, Qubit, Qubit) final;
+    void s_adj(Qubit) final;
+    void s(Qubit) final;
+    void s(Array, Qubit) final;
+    void s_adj(Array, Qubit) final;
+    void t_adj(Qubit) final;
+    void t(Qubit) final;
+    void t(Array, Qubit) final;
+    void t_adj(Array, Qubit) final;
+    void z(Qubit) final;
+    void z(Array, Qubit) final;
+    //!@}
+
+    //!@{
+    //! \name Superpositions
+    void h(Qubit) final;
+    void h(Array, Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    //!@}
+
+    using QuantumNotImpl::r;
+    using QuantumNotImpl::r_adj;
+    using QuantumNotImpl::rx;
+    using QuantumNotImpl::ry;
+    using QuantumNotImpl::rz;
+
+  private:
+    Options options_;
+    size_type num_qubits_{0};
+    size_type num_operations_{0};
+    std::vector<Word> bits_;
+    std::vector<QState> results_;
+
+    // Scratch space for reading QIR arrays
+    std::vector<Qubit> qubit_buf_;
+    std::vector<Pauli> pauli_buf_;
+
+    size_type index(Qubit q) const;
+    bool get(size_type a) const { return (bits_[a / 64] >> (a % 64)) & 1; }
+    void flip(size_type a) { bits_[a / 64] ^= Word{1} << (a % 64); }
+    bool controls_set(Array controls, Qubit target);
+    void rotate(Pauli p, double theta, Qubit target, char const* instr);
+    void superposition(char const* instr) const;
+    Result push_result(QState);
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
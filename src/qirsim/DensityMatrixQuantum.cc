@@ -0,0 +1,782 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/DensityMatrixQuantum.cc
+//---------------------------------------------------------------------------//
+#include "DensityMatrixQuantum.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "qiree/Assert.hh"
+
+#include "detail/BitUtils.hh"
+#include "detail/QirArgs.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+using Complex = DensityMatrixQuantum::Complex;
+using detail::Matrix2;
+using detail::Matrix4;
+
+constexpr double sqrt_half = 0.70710678118654752440;
+constexpr Complex imag{0, 1};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complex conjugate of a single-qubit operator.
+ */
+Matrix2 conj(Matrix2 const& m)
+{
+    return {std::conj(m[0]), std::conj(m[1]), std::conj(m[2]), std::conj(m[3])};
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add the superoperator of a Kraus operator, scaled by a probability.
+ *
+ * The column qubit is the high bit of the superoperator index so that
+ * element (r, c) of the density matrix maps to index 2c + r.
+ */
+void add_kraus(Matrix2 const& k, double probability, Matrix4& result)
+{
+    for (int c = 0; c < 2; ++c)
+    {
+        for (int r = 0; r < 2; ++r)
+        {
+            for (int cp = 0; cp < 2; ++cp)
+            {
+                for (int rp = 0; rp < 2; ++rp)
+                {
+                    result[4 * (2 * c + r) + 2 * cp + rp]
+                        += probability * k[2 * r + rp]
+                           * std::conj(k[2 * c + cp]);
+                }
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Superoperator of the amplitude damping channel.
+ */
+Matrix4 amplitude_damping(double gamma)
+{
+    Matrix4 result{};
+    add_kraus({1, 0, 0, std::sqrt(1 - gamma)}, 1, result);
+    add_kraus({0, 1, 0, 0}, gamma, result);
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Superoperator of depolarizing followed by amplitude damping.
+ */
+Matrix4 superoperator(NoiseModel::Channels const& channels)
+{
+    double const p = channels.depolarizing;
+    Matrix4 depolarize{};
+    add_kraus({1, 0, 0, 1}, 1 - p, depolarize);
+    add_kraus({0, 1, 1, 0}, p / 3, depolarize);
+    add_kraus({0, -imag, imag, 0}, p / 3, depolarize);
+    add_kraus({1, 0, 0, -1}, p / 3, depolarize);
+
+    Matrix4 const damp = amplitude_damping(channels.amplitude_damping);
+    Matrix4 result{};
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            for (int k = 0; k < 4; ++k)
+            {
+                result[4 * i + j] += damp[4 * i + k] * depolarize[4 * k + j];
+            }
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with default options.
+ */
+DensityMatrixQuantum::DensityMatrixQuantum()
+    : DensityMatrixQuantum{Options{}}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with options.
+ */
+DensityMatrixQuantum::DensityMatrixQuantum(Options const& opts)
+    : options_{opts}, rng_{opts.seed}
+{
+    QIREE_VALIDATE(options_.max_qubits < 32,
+                   << "density matrix simulator is limited to 31 qubits");
+    validate(options_.noise);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Reseed the random number generator.
+ */
+void DensityMatrixQuantum::seed(std::uint64_t value)
+{
+    rng_.seed(value);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Element of the density matrix.
+ */
+auto DensityMatrixQuantum::element(std::uint64_t row, std::uint64_t col) const
+    -> Complex
+{
+    size_type const dim = size_type{1} << num_qubits_;
+    QIREE_VALIDATE(row < dim && col < dim,
+                   << "density matrix element (" << row << ", " << col
+                   << ") is out of range");
+    return rho_[row + dim * col];
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Probability of measuring a qubit in |1> without collapsing the state.
+ */
+double DensityMatrixQuantum::probability_one(Qubit q) const
+{
+    size_type const dim = size_type{1} << num_qubits_;
+    size_type const bit = size_type{1} << this->index(q);
+    double result = 0;
+    for (size_type k = bit; k < dim; k = (k + 1) | bit)
+    {
+        result += rho_[k * (dim + 1)].real();
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Purity Tr(rho^2), which is one for a pure state.
+ */
+double DensityMatrixQuantum::purity() const
+{
+    double result = 0;
+    for (auto const& value : rho_)
+    {
+        result += std::norm(value);
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare the all-zero state for an entry point.
+ */
+void DensityMatrixQuantum::set_up(EntryPointAttrs const& attrs)
+{
+    QIREE_VALIDATE(attrs.required_num_qubits <= options_.max_qubits,
+                   << "entry point requires " << attrs.required_num_qubits
+                   << " qubits but the density matrix simulator is limited "
+                      "to "
+                   << options_.max_qubits);
+
+    num_qubits_ = attrs.required_num_qubits;
+    rho_.assign(size_type{1} << (2 * num_qubits_), Complex{0});
+    rho_.front() = 1;
+    results_.assign(attrs.required_num_results, QState::zero);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete an execution.
+ *
+ * The state and results are kept for inspection until the next set-up.
+ */
+void DensityMatrixQuantum::tear_down() {}
+
+//---------------------------------------------------------------------------//
+// MEASUREMENTS
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis into a new result.
+ */
+Result DensityMatrixQuantum::m(Qubit q)
+{
+    return this->push_result(this->read_out(this->sample(q)));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a joint Pauli observable into a new result.
+ *
+ * The result is zero for the +1 eigenvalue. Readout errors only apply to
+ * single-qubit Z measurements.
+ */
+Result DensityMatrixQuantum::measure(Array paulis, Array qubits)
+{
+    auto p = detail::pauli_string(
+        paulis, qubits, num_qubits_, pauli_buf_, qubit_buf_);
+
+    // Tr(P rho) = sum_j <j|P rho|j> with P|k> = i^{n_Y} (-1)^{|k & z|} |k^x>
+    size_type const dim = size_type{1} << num_qubits_;
+    Complex sum{0};
+    for (size_type j = 0; j < dim; ++j)
+    {
+        Complex const value = rho_[j + dim * (j ^ p.x)];
+        sum += detail::parity(j & p.z) ? -value : value;
+    }
+    constexpr Complex powers[] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+    double const expectation
+        = (powers[detail::popcount(p.x & p.z) % 4] * sum).real();
+
+    double const prob_minus = std::clamp(0.5 * (1 - expectation), 0.0, 1.0);
+    std::uniform_real_distribution<double> sample_uniform;
+    bool const minus = sample_uniform(rng_) < prob_minus;
+
+    // Project onto the eigenspace with (1 +- P) / 2 and renormalize
+    this->apply_pauli_sum(p, 0.5, minus ? -0.5 : 0.5, 0);
+    detail::scale(this->ref(), 1 / (minus ? prob_minus : 1 - prob_minus));
+    return this->push_result(minus ? QState::one : QState::zero);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a new result and reset it.
+ */
+Result DensityMatrixQuantum::mresetz(Qubit q)
+{
+    auto result = this->sample(q);
+    if (result == QState::one)
+    {
+        size_type const target = this->index(q);
+        detail::apply_x(this->ref(), target, 0);
+        detail::apply_x(this->ref(), target + num_qubits_, 0);
+    }
+    return this->push_result(this->read_out(result));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis and store the result.
+ */
+void DensityMatrixQuantum::mz(Qubit q, Result r)
+{
+    if (r.value >= results_.size())
+    {
+        results_.resize(r.value + 1, QState::zero);
+    }
+    results_[r.value] = this->read_out(this->sample(q));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the value of a measured result.
+ */
+QState DensityMatrixQuantum::read_result(Result r)
+{
+    QIREE_VALIDATE(r.value < results_.size(),
+                   << "result " << r.value << " is out of range");
+    return results_[r.value];
+}
+
+//---------------------------------------------------------------------------//
+// GATES
+//---------------------------------------------------------------------------//
+
+void DensityMatrixQuantum::ccx(Qubit c1, Qubit c2, Qubit t)
+{
+    QIREE_VALIDATE(c1.value != c2.value, << "duplicate control qubit");
+    auto mask = (QubitMask{1} << this->index(c1))
+                | (QubitMask{1} << this->index(c2));
+    auto target = QubitMask{1} << this->index(t);
+    QIREE_VALIDATE(!(mask & target), << "target is also a control qubit");
+    detail::apply_x(this->ref(), t.value, mask);
+    detail::apply_x(this->ref(), t.value + num_qubits_, mask << num_qubits_);
+    this->noise("ccx", mask | target);
+}
+
+void DensityMatrixQuantum::cnot(Qubit c, Qubit t)
+{
+    QIREE_VALIDATE(c.value != t.value, << "target is also a control qubit");
+    auto mask = QubitMask{1} << this->index(c);
+    auto target = QubitMask{1} << this->index(t);
+    detail::apply_x(this->ref(), t.value, mask);
+    detail::apply_x(this->ref(), t.value + num_qubits_, mask << num_qubits_);
+    this->noise("cnot", mask | target);
+}
+
+void DensityMatrixQuantum::cx(Qubit c, Qubit t)
+{
+    this->cnot(c, t);
+}
+
+void DensityMatrixQuantum::cy(Qubit c, Qubit t)
+{
+    QIREE_VALIDATE(c.value != t.value, << "target is also a control qubit");
+    auto mask = QubitMask{1} << this->index(c);
+    this->apply({0, -imag, imag, 0}, t, mask);
+    this->noise("cy", mask | (QubitMask{1} << t.value));
+}
+
+void DensityMatrixQuantum::cz(Qubit c, Qubit t)
+{
+    QIREE_VALIDATE(c.value != t.value, << "target is also a control qubit");
+    auto mask = QubitMask{1} << this->index(c);
+    this->apply_diagonal(1, -1, t, mask);
+    this->noise("cz", mask | (QubitMask{1} << t.value));
+}
+
+//! Apply exp(-i theta P)
+void DensityMatrixQuantum::exp_adj(Array paulis, double theta, Array qubits)
+{
+    this->exp(paulis, -theta, qubits);
+}
+
+//! Apply exp(i theta P)
+void DensityMatrixQuantum::exp(Array paulis, double theta, Array qubits)
+{
+    auto p = detail::pauli_string(
+        paulis, qubits, num_qubits_, pauli_buf_, qubit_buf_);
+    this->rotate(p, -2 * theta, 0);
+    this->noise("exp", p.x | p.z);
+}
+
+void DensityMatrixQuantum::exp(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<detail::ExpArgs>(args);
+    auto p = detail::pauli_string(
+        a.paulis, a.qubits, num_qubits_, pauli_buf_, qubit_buf_);
+    auto mask = detail::read_controls(ctls, num_qubits_, qubit_buf_);
+    QIREE_VALIDATE(!(mask & (p.x | p.z)), << "target is also a control qubit");
+    this->rotate(p, -2 * a.theta, mask);
+    this->noise("exp", mask | p.x | p.z);
+}
+
+void DensityMatrixQuantum::exp_adj(Array ctls, Tuple args)
+{
+    auto a = detail::tuple_args<detail::ExpArgs>(args);
+    a.theta = -a.theta;
+    this->exp(ctls, &a);
+}
+
+void DensityMatrixQuantum::h(Qubit q)
+{
+    this->apply({sqrt_half, sqrt_half, sqrt_half, -sqrt_half}, q, 0);
+    this->noise("h", QubitMask{1} << q.value);
+}
+
+void DensityMatrixQuantum::h(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply({sqrt_half, sqrt_half, sqrt_half, -sqrt_half}, q, mask);
+    this->noise("h", mask | (QubitMask{1} << q.value));
+}
+
+void DensityMatrixQuantum::r_adj(Pauli p, double theta, Qubit q)
+{
+    this->r(p, -theta, q);
+}
+
+//! Apply exp(-i theta/2 P), which is a global phase for the identity
+void DensityMatrixQuantum::r(Pauli p, double theta, Qubit q)
+{
+    PauliString ps;
+    ps.push_back(p, this->index(q));
+    this->rotate(ps, theta, 0);
+    this->noise("r", QubitMask{1} << q.value);
+}
+
+void DensityMatrixQuantum::r(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<detail::PauliRotationArgs>(args);
+    PauliString ps;
+    ps.push_back(a.pauli, this->index(a.qubit));
+    auto mask = detail::control_mask(ctls, a.qubit, num_qubits_, qubit_buf_);
+    this->rotate(ps, a.theta, mask);
+    this->noise("r", mask | (QubitMask{1} << a.qubit.value));
+}
+
+void DensityMatrixQuantum::r_adj(Array ctls, Tuple args)
+{
+    auto a = detail::tuple_args<detail::PauliRotationArgs>(args);
+    a.theta = -a.theta;
+    this->r(ctls, &a);
+}
+
+//! Reset a qubit to |0> by fully damping it
+void DensityMatrixQuantum::reset(Qubit q)
+{
+    auto bit = QubitMask{1} << this->index(q);
+    this->apply_channel(amplitude_damping(1), bit);
+    this->noise("reset", bit);
+}
+
+void DensityMatrixQuantum::rx(double theta, Qubit q)
+{
+    Complex c = std::cos(theta / 2);
+    Complex s = -imag * std::sin(theta / 2);
+    this->apply({c, s, s, c}, q, 0);
+    this->noise("rx", QubitMask{1} << q.value);
+}
+
+void DensityMatrixQuantum::rx(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    Complex c = std::cos(a.theta / 2);
+    Complex s = -imag * std::sin(a.theta / 2);
+    auto mask = detail::control_mask(ctls, a.qubit, num_qubits_, qubit_buf_);
+    this->apply({c, s, s, c}, a.qubit, mask);
+    this->noise("rx", mask | (QubitMask{1} << a.qubit.value));
+}
+
+void DensityMatrixQuantum::rxx(double theta, Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in rxx");
+    PauliString ps;
+    ps.push_back(Pauli::x, this->index(q1));
+    ps.push_back(Pauli::x, this->index(q2));
+    this->rotate(ps, theta, 0);
+    this->noise("rxx", ps.x);
+}
+
+void DensityMatrixQuantum::ry(double theta, Qubit q)
+{
+    double c = std::cos(theta / 2);
+    double s = std::sin(theta / 2);
+    this->apply({c, -s, s, c}, q, 0);
+    this->noise("ry", QubitMask{1} << q.value);
+}
+
+void DensityMatrixQuantum::ry(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    double c = std::cos(a.theta / 2);
+    double s = std::sin(a.theta / 2);
+    auto mask = detail::control_mask(ctls, a.qubit, num_qubits_, qubit_buf_);
+    this->apply({c, -s, s, c}, a.qubit, mask);
+    this->noise("ry", mask | (QubitMask{1} << a.qubit.value));
+}
+
+void DensityMatrixQuantum::ryy(double theta, Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in ryy");
+    PauliString ps;
+    ps.push_back(Pauli::y, this->index(q1));
+    ps.push_back(Pauli::y, this->index(q2));
+    this->rotate(ps, theta, 0);
+    this->noise("ryy", ps.x);
+}
+
+void DensityMatrixQuantum::rz(double theta, Qubit q)
+{
+    this->apply_diagonal(
+        std::polar(1.0, -theta / 2), std::polar(1.0, theta / 2), q, 0);
+    this->noise("rz", QubitMask{1} << q.value);
+}
+
+void DensityMatrixQuantum::rz(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    auto mask = detail::control_mask(ctls, a.qubit, num_qubits_, qubit_buf_);
+    this->apply_diagonal(std::polar(1.0, -a.theta / 2),
+                         std::polar(1.0, a.theta / 2),
+                         a.qubit,
+                         mask);
+    this->noise("rz", mask | (QubitMask{1} << a.qubit.value));
+}
+
+void DensityMatrixQuantum::rzz(double theta, Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in rzz");
+    PauliString ps;
+    ps.push_back(Pauli::z, this->index(q1));
+    ps.push_back(Pauli::z, this->index(q2));
+    this->rotate(ps, theta, 0);
+    this->noise("rzz", ps.z);
+}
+
+void DensityMatrixQuantum::s_adj(Qubit q)
+{
+    this->apply_diagonal(1, -imag, q, 0);
+    this->noise("s", QubitMask{1} << q.value);
+}
+
+void DensityMatrixQuantum::s(Qubit q)
+{
+    this->apply_diagonal(1, imag, q, 0);
+    this->noise("s", QubitMask{1} << q.value);
+}
+
+void DensityMatrixQuantum::s(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, imag, q, mask);
+    this->noise("s", mask | (QubitMask{1} << q.value));
+}
+
+void DensityMatrixQuantum::s_adj(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, -imag, q, mask);
+    this->noise("s", mask | (QubitMask{1} << q.value));
+}
+
+void DensityMatrixQuantum::swap(Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in swap");
+    size_type const a = this->index(q1);
+    size_type const b = this->index(q2);
+    detail::apply_swap(this->ref(), a, b, 0);
+    detail::apply_swap(this->ref(), a + num_qubits_, b + num_qubits_, 0);
+    this->noise("swap", (QubitMask{1} << a) | (QubitMask{1} << b));
+}
+
+void DensityMatrixQuantum::t_adj(Qubit q)
+{
+    this->apply_diagonal(1, Complex{sqrt_half, -sqrt_half}, q, 0);
+    this->noise("t", QubitMask{1} << q.value);
+}
+
+void DensityMatrixQuantum::t(Qubit q)
+{
+    this->apply_diagonal(1, Complex{sqrt_half, sqrt_half}, q, 0);
+    this->noise("t", QubitMask{1} << q.value);
+}
+
+void DensityMatrixQuantum::t(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, Complex{sqrt_half, sqrt_half}, q, mask);
+    this->noise("t", mask | (QubitMask{1} << q.value));
+}
+
+void DensityMatrixQuantum::t_adj(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, Complex{sqrt_half, -sqrt_half}, q, mask);
+    this->noise("t", mask | (QubitMask{1} << q.value));
+}
+
+void DensityMatrixQuantum::x(Qubit q)
+{
+    size_type const target = this->index(q);
+    detail::apply_x(this->ref(), target, 0);
+    detail::apply_x(this->ref(), target + num_qubits_, 0);
+    this->noise("x", QubitMask{1} << target);
+}
+
+void DensityMatrixQuantum::x(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    size_type const target = this->index(q);
+    detail::apply_x(this->ref(), target, mask);
+    detail::apply_x(this->ref(), target + num_qubits_, mask << num_qubits_);
+    this->noise("x", mask | (QubitMask{1} << target));
+}
+
+void DensityMatrixQuantum::y(Qubit q)
+{
+    this->apply({0, -imag, imag, 0}, q, 0);
+    this->noise("y", QubitMask{1} << q.value);
+}
+
+void DensityMatrixQuantum::y(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply({0, -imag, imag, 0}, q, mask);
+    this->noise("y", mask | (QubitMask{1} << q.value));
+}
+
+void DensityMatrixQuantum::z(Qubit q)
+{
+    this->apply_diagonal(1, -1, q, 0);
+    this->noise("z", QubitMask{1} << q.value);
+}
+
+void DensityMatrixQuantum::z(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, -1, q, mask);
+    this->noise("z", mask | (QubitMask{1} << q.value));
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the bit index of a qubit.
+ */
+size_type DensityMatrixQuantum::index(Qubit q) const
+{
+    return detail::qubit_index(q, num_qubits_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a single-qubit unitary to the rows and its conjugate to the columns.
+ */
+void DensityMatrixQuantum::apply(Matrix2 const& m,
+                                 Qubit target,
+                                 QubitMask controls)
+{
+    size_type const t = this->index(target);
+    detail::apply_matrix(this->ref(), t, m, controls);
+    detail::apply_matrix(
+        this->ref(), t + num_qubits_, conj(m), controls << num_qubits_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a diagonal single-qubit unitary to the rows and columns.
+ */
+void DensityMatrixQuantum::apply_diagonal(Complex d0,
+                                          Complex d1,
+                                          Qubit target,
+                                          QubitMask controls)
+{
+    size_type const t = this->index(target);
+    detail::apply_diagonal(this->ref(), t, d0, d1, controls);
+    detail::apply_diagonal(this->ref(),
+                           t + num_qubits_,
+                           std::conj(d0),
+                           std::conj(d1),
+                           controls << num_qubits_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply alpha + beta P to the rows and its conjugate to the columns.
+ *
+ * The conjugate of a Pauli string negates each Y operator.
+ */
+void DensityMatrixQuantum::apply_pauli_sum(PauliString const& p,
+                                           Complex alpha,
+                                           Complex beta,
+                                           QubitMask controls)
+{
+    detail::apply_pauli_sum(this->ref(), p, alpha, beta, controls);
+
+    PauliString cols;
+    cols.x = p.x << num_qubits_;
+    cols.z = p.z << num_qubits_;
+    Complex cols_beta = std::conj(beta);
+    if (detail::parity(p.x & p.z))
+    {
+        cols_beta = -cols_beta;
+    }
+    detail::apply_pauli_sum(this->ref(),
+                            cols,
+                            std::conj(alpha),
+                            cols_beta,
+                            controls << num_qubits_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply exp(-i theta/2 P).
+ */
+void DensityMatrixQuantum::rotate(PauliString const& p,
+                                  double theta,
+                                  QubitMask controls)
+{
+    this->apply_pauli_sum(
+        p, std::cos(theta / 2), -imag * std::sin(theta / 2), controls);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a single-qubit channel to each of the given qubits.
+ */
+void DensityMatrixQuantum::apply_channel(Matrix4 const& superop,
+                                         QubitMask qubits)
+{
+    for (size_type q = 0; qubits >> q; ++q)
+    {
+        if ((qubits >> q) & 1)
+        {
+            detail::apply_matrix4(this->ref(), q + num_qubits_, q, superop);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply the noise of a gate to the qubits it acts on.
+ */
+void DensityMatrixQuantum::noise(std::string_view gate, QubitMask qubits)
+{
+    auto const& channels = options_.noise.channels(gate);
+    if (channels)
+    {
+        this->apply_channel(superoperator(channels), qubits);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Project a qubit onto a measured state and renormalize.
+ */
+void DensityMatrixQuantum::collapse(size_type target,
+                                    bool one,
+                                    double probability)
+{
+    // Each projection scales by the square root of the inverse probability
+    detail::collapse(this->ref(), target, one, probability);
+    detail::collapse(this->ref(), target + num_qubits_, one, probability);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Sample a Z-basis measurement and collapse the state.
+ */
+QState DensityMatrixQuantum::sample(Qubit q)
+{
+    double const prob_one = std::clamp(this->probability_one(q), 0.0, 1.0);
+    std::uniform_real_distribution<double> sample_uniform;
+    bool const one = sample_uniform(rng_) < prob_one;
+    this->collapse(q.value, one, one ? prob_one : 1 - prob_one);
+    return one ? QState::one : QState::zero;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply the readout error to a measured state.
+ */
+QState DensityMatrixQuantum::read_out(QState value)
+{
+    auto const& readout = options_.noise.readout;
+    double const flip = value == QState::one ? readout.one_to_zero
+                                             : readout.zero_to_one;
+    if (flip > 0)
+    {
+        std::uniform_real_distribution<double> sample_uniform;
+        if (sample_uniform(rng_) < flip)
+        {
+            return value == QState::one ? QState::zero : QState::one;
+        }
+    }
+    return value;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Store a measurement in a new result.
+ */
+Result DensityMatrixQuantum::push_result(QState value)
+{
+    return detail::push_result(value, results_);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
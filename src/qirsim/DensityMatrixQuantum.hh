@@ -0,0 +1,191 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/DensityMatrixQuantum.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "qiree/Macros.hh"
+#include "qiree/QuantumNotImpl.hh"
+#include "qiree/Types.hh"
+
+#include "NoiseModel.hh"
+#include "detail/StateVectorKernels.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Simulate QIR programs on a noisy device with a density matrix.
+ *
+ * The \f$ 2^n \times 2^n \f$ density matrix \f$\rho\f$ of \em n qubits is
+ * stored as a vector of \f$ 4^n \f$ elements: element \f$ \rho_{rc} \f$ is at
+ * index \f$ r + 2^n c \f$. In this form, a gate \f$ U \rho U^\dagger \f$ is
+ * the state vector gate \em U on the "row" qubits followed by
+ * \f$ U^* \f$ on the "column" qubits \em n to \em 2n-1, so gates use the
+ * vectorized and multithreaded state vector kernels.
+ *
+ * After each gate, the channels of the noise model are applied to each qubit
+ * the gate acts on. A single-qubit channel with Kraus operators \f$ K_i \f$
+ * is the superoperator \f$ \sum_i K_i \otimes K_i^* \f$, a two-qubit
+ * operator on a row qubit and its column qubit. Resetting a qubit is the
+ * amplitude damping channel with unit probability, so it doesn't sample.
+ *
+ * Measurements sample an outcome, collapse the density matrix, and may
+ * misread the outcome according to the readout errors. Like
+ * \c StateVectorQuantum , each execution is one shot. The simulator
+ * implements \c QuantumInterface so it can be used by \c Executor as well as
+ * by \c DirectExecutor .
+ */
+class DensityMatrixQuantum final : virtual public QuantumNotImpl
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using Complex = detail::Complex;
+    using VecComplex = std::vector<Complex>;
+    //!@}
+
+    //! Construction options
+    struct Options
+    {
+        //! Seed for measurement sampling and readout errors
+        std::uint64_t seed{std::mt19937_64::default_seed};
+        //! Maximum number of qubits (16 * 4^n bytes of memory)
+        size_type max_qubits{14};
+        //! Errors applied after gates and measurements
+        NoiseModel noise;
+    };
+
+  public:
+    // Construct with default options
+    DensityMatrixQuantum();
+
+    // Construct with options
+    explicit DensityMatrixQuantum(Options const& opts);
+
+    QIREE_DELETE_COPY_MOVE(DensityMatrixQuantum);
+
+    //!@{
+    //! \name Accessors
+    size_type num_qubits() const { return num_qubits_; }
+    size_type num_results() const { return results_.size(); }
+    Options const& options() const { return options_; }
+    VecComplex const& density_matrix() const { return rho_; }
+    //!@}
+
+    // Reseed the random number generator
+    void seed(std::uint64_t value);
+
+    // Element of the density matrix
+    Complex element(std::uint64_t row, std::uint64_t col) const;
+
+    // Probability of measuring a qubit in |1> without collapsing the state
+    double probability_one(Qubit) const;
+
+    // Purity Tr(rho^2), which is one for a pure state
+    double purity() const;
+
+    //!@{
+    //! \name Quantum interface
+    void set_up(EntryPointAttrs const&) final;
+    void tear_down() final;
+    //!@}
+
+    //!@{
+    //! \name Measurements
+    Result m(Qubit) final;
+    Result measure(Array, Array) final;
+    Result mresetz(Qubit) final;
+    void mz(Qubit, Result) final;
+    QState read_result(Result) final;
+    //!@}
+
+    //!@{
+    //! \name Gates
+    void ccx(Qubit, Qubit, Qubit) final;
+    void cnot(Qubit, Qubit) final;
+    void cx(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
+    void cz(Qubit, Qubit) final;
+    void exp_adj(Array, double, Array) final;
+    void exp(Array, double, Array) final;
+    void exp(Array, Tuple) final;
+    void exp_adj(Array, Tuple) final;
+    void h(Qubit) final;
+    void h(Array, Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    void r(Array, Tuple) final;
+    void r_adj(Array, Tuple) final;
+    void reset(Qubit) final;
+    void rx(double, Qubit) final;
+    void rx(Array, Tuple) final;
+    void rxx(double, Qubit, Qubit) final;
+    void ry(double, Qubit) final;
+    void ry(Array, Tuple) final;
+    void ryy(double, Qubit, Qubit) final;
+    void rz(double, Qubit) final;
+    void rz(Array, Tuple) final;
+    void rzz(double, Qubit, Qubit) final;
+    void s_adj(Qubit) final;
+    void s(Qubit) final;
+    void s(Array, Qubit) final;
+    void s_adj(Array, Qubit) final;
+    void swap(Qubit, Qubit) final;
+    void t_adj(Qubit) final;
+    void t(Qubit) final;
+    void t(Array, Qubit) final;
+    void t_adj(Array, Qubit) final;
+    void x(Qubit) final;
+    void x(Array, Qubit) final;
+    void y(Qubit) final;
+    void y(Array, Qubit) final;
+    void z(Qubit) final;
+    void z(Array, Qubit) final;
+    //!@}
+
+  private:
+    using QubitMask = detail::QubitMask;
+    using Matrix2 = detail::Matrix2;
+    using Matrix4 = detail::Matrix4;
+    using PauliString = detail::PauliString;
+
+    Options options_;
+    std::mt19937_64 rng_;
+    size_type num_qubits_{0};
+    VecComplex rho_;
+    std::vector<QState> results_;
+
+    // Scratch space for reading QIR arrays
+    std::vector<Qubit> qubit_buf_;
+    std::vector<Pauli> pauli_buf_;
+
+    detail::StateRef ref() { return {rho_.data(), rho_.size()}; }
+    size_type index(Qubit q) const;
+
+    void apply(Matrix2 const& m, Qubit target, QubitMask controls);
+    void
+    apply_diagonal(Complex d0, Complex d1, Qubit target, QubitMask controls);
+    void apply_pauli_sum(PauliString const& p,
+                         Complex alpha,
+                         Complex beta,
+                         QubitMask controls);
+    void rotate(PauliString const& p, double theta, QubitMask controls);
+    void apply_channel(Matrix4 const& superop, QubitMask qubits);
+    void noise(std::string_view gate, QubitMask qubits);
+    void collapse(size_type target, bool one, double probability);
+    QState sample(Qubit);
+    QState read_out(QState);
+    Result push_result(QState);
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
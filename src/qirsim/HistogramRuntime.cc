@@ -0,0 +1,333 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/HistogramRuntime.cc
+//---------------------------------------------------------------------------//
+#include "HistogramRuntime.hh"
+
+#include "qiree/Assert.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the quantum interface that stores results.
+ */
+HistogramRuntime::HistogramRuntime(QuantumInterface& qi) : qi_(qi) {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete an execution that represents several identical shots.
+ *
+ * This is used by simulators that execute a program once for all shots that
+ * share a measurement history (see \c StateVectorQuantum::start_branching ).
+ */
+void HistogramRuntime::end_shot(size_type count)
+{
+    this->end_execution();
+    for (size_type i = 0; i < groups_.size(); ++i)
+    {
+        groups_[i].counts[shot_bits_[i]] += count;
+    }
+    shot_bits_.clear();
+    num_shots_ += count;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete an execution that occurs with the given probability.
+ *
+ * This accumulates the exact distribution of outputs over the branches of a
+ * program's measurement tree (see \c StateVectorQuantum::start_enumeration )
+ * separately from the shot counts. Outputs of a branch with zero probability
+ * (one that was pruned while it executed) are discarded.
+ */
+void HistogramRuntime::end_branch(double probability)
+{
+    this->end_execution();
+    for (size_type i = 0; probability > 0 && i < groups_.size(); ++i)
+    {
+        groups_[i].probabilities[shot_bits_[i]] += probability;
+    }
+    shot_bits_.clear();
+    total_probability_ += probability;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record another shot with the same outputs as the first.
+ *
+ * The results recorded by the first shot are read again from the quantum
+ * interface and counted without executing the program. This is only valid
+ * for programs that always record the same results, such as straight-line
+ * programs whose measurements are sampled from a single execution (see
+ * \c StateVectorQuantum::defer_measurements ).
+ */
+void HistogramRuntime::repeat_shot()
+{
+    QIREE_VALIDATE(num_executions_ > 0 && num_groups_ == 0,
+                   << "a shot can only be repeated after it has ended");
+    for (Group& g : groups_)
+    {
+        bits_.clear();
+        for (Result r : g.results)
+        {
+            bits_.push_back(qi_.read_result(r) == QState::one ? '1' : '0');
+        }
+        ++g.counts[bits_];
+    }
+    ++num_shots_;
+    ++num_executions_;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add the shots accumulated by another histogram.
+ *
+ * Both histograms must have recorded the same sequence of outputs, for
+ * example from executing one program with separate simulators. Neither may be
+ * in the middle of a shot.
+ */
+void HistogramRuntime::merge(HistogramRuntime const& other)
+{
+    QIREE_VALIDATE(num_groups_ == 0 && other.num_groups_ == 0,
+                   << "cannot merge histograms in the middle of a shot");
+    if (other.num_executions_ == 0)
+    {
+        return;
+    }
+    if (num_executions_ == 0)
+    {
+        groups_ = other.groups_;
+        num_shots_ = other.num_shots_;
+        num_executions_ = other.num_executions_;
+        total_probability_ = other.total_probability_;
+        return;
+    }
+
+    QIREE_VALIDATE(groups_.size() == other.groups_.size(),
+                   << "cannot merge histograms with " << groups_.size()
+                   << " and " << other.groups_.size() << " outputs");
+    for (size_type i = 0; i < groups_.size(); ++i)
+    {
+        Group& g = groups_[i];
+        Group const& og = other.groups_[i];
+        QIREE_VALIDATE(g.type == og.type && g.length == og.length
+                           && g.tag == og.tag,
+                       << "output " << i << " (" << to_cstring(og.type) << " "
+                       << og.tag << " length " << og.length
+                       << ") differs from merged histogram ("
+                       << to_cstring(g.type) << " " << g.tag << " length "
+                       << g.length << ")");
+        for (auto const& [bits, count] : og.counts)
+        {
+            g.counts[bits] += count;
+        }
+        for (auto const& [bits, prob] : og.probabilities)
+        {
+            g.probabilities[bits] += prob;
+        }
+    }
+    num_shots_ += other.num_shots_;
+    num_executions_ += other.num_executions_;
+    total_probability_ += other.total_probability_;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Print per-group bit string counts.
+ */
+void HistogramRuntime::print_tuples(std::ostream& os) const
+{
+    for (auto const& g : groups_)
+    {
+        auto name = to_cstring(g.type);
+        os << name << " " << g.tag << " length " << g.length
+           << " distinct results " << g.counts.size() << std::endl;
+        for (auto const& [bits, count] : g.counts)
+        {
+            os << name << " " << g.tag << " result " << bits << " count "
+               << count << std::endl;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Print per-group bit string probabilities.
+ */
+void HistogramRuntime::print_probabilities(std::ostream& os) const
+{
+    for (auto const& g : groups_)
+    {
+        auto name = to_cstring(g.type);
+        os << name << " " << g.tag << " length " << g.length
+           << " distinct results " << g.probabilities.size() << std::endl;
+        for (auto const& [bits, prob] : g.probabilities)
+        {
+            os << name << " " << g.tag << " result " << bits
+               << " probability " << prob << std::endl;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Print per-result counts.
+ */
+void HistogramRuntime::print_results(std::ostream& os) const
+{
+    for (auto const& g : groups_)
+    {
+        if (g.type != GroupType::result)
+        {
+            os << to_cstring(g.type) << " " << g.tag << " length " << g.length
+               << std::endl;
+        }
+        for (size_type i = 0; i < g.length; ++i)
+        {
+            size_type ones{0};
+            for (auto const& [bits, count] : g.counts)
+            {
+                if (bits[i] == '1')
+                {
+                    ones += count;
+                }
+            }
+            os << "result " << g.results[i].value << " experiment "
+               << g.result_tags[i] << ": {0: " << num_shots_ - ones
+               << ", 1: " << ones << '}' << std::endl;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Initialize the execution environment.
+ */
+void HistogramRuntime::initialize(OptionalCString) {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Mark the following N results as being part of an array named tag.
+ */
+void HistogramRuntime::array_record_output(size_type s, OptionalCString tag)
+{
+    this->start_group(GroupType::array, tag, s);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Mark the following N results as being part of a tuple named tag.
+ */
+void HistogramRuntime::tuple_record_output(size_type s, OptionalCString tag)
+{
+    this->start_group(GroupType::tuple, tag, s);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record one result into the program output.
+ */
+void HistogramRuntime::result_record_output(Result r, OptionalCString tag)
+{
+    if (remaining_ == 0)
+    {
+        this->start_group(GroupType::result, tag, 1);
+    }
+
+    Group& g = groups_[num_groups_ - 1];
+    if (g.results.size() < g.length)
+    {
+        g.results.push_back(r);
+        g.result_tags.push_back(tag ? tag : "<null>");
+    }
+    bits_.push_back(qi_.read_result(r) == QState::one ? '1' : '0');
+    if (--remaining_ == 0)
+    {
+        this->finish_group();
+    }
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+
+void HistogramRuntime::start_group(GroupType type,
+                                   OptionalCString tag,
+                                   size_type length)
+{
+    QIREE_VALIDATE(remaining_ == 0,
+                   << "new output started with " << remaining_
+                   << " results missing from the last "
+                   << to_cstring(groups_[num_groups_ - 1].type));
+
+    std::string tag_str = tag ? tag : "<null>";
+    if (num_groups_ == groups_.size())
+    {
+        QIREE_VALIDATE(num_executions_ == 0,
+                       << "shot " << num_executions_
+                       << " recorded more outputs than previous shots");
+        Group g;
+        g.type = type;
+        g.tag = std::move(tag_str);
+        g.length = length;
+        groups_.push_back(std::move(g));
+    }
+    else
+    {
+        Group const& g = groups_[num_groups_];
+        QIREE_VALIDATE(g.type == type && g.length == length && g.tag == tag_str,
+                       << "output " << num_groups_ << " of shot "
+                       << num_executions_
+                       << " (" << to_cstring(type) << " " << tag_str
+                       << " length " << length << ") differs from previous "
+                       << "shots (" << to_cstring(g.type) << " " << g.tag
+                       << " length " << g.length << ")");
+    }
+    ++num_groups_;
+    remaining_ = length;
+    bits_.clear();
+    if (remaining_ == 0)
+    {
+        this->finish_group();
+    }
+}
+
+void HistogramRuntime::end_execution()
+{
+    QIREE_VALIDATE(remaining_ == 0,
+                   << "shot ended with " << remaining_
+                   << " results missing from the last "
+                   << to_cstring(groups_[num_groups_ - 1].type));
+    QIREE_VALIDATE(num_groups_ == groups_.size(),
+                   << "shot " << num_executions_ << " recorded "
+                   << num_groups_ << " outputs but previous shots recorded "
+                   << groups_.size());
+    num_groups_ = 0;
+    ++num_executions_;
+}
+
+void HistogramRuntime::finish_group()
+{
+    shot_bits_.push_back(bits_);
+}
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get a string representation of an output group type.
+ */
+char const* to_cstring(HistogramRuntime::GroupType type)
+{
+    using GroupType = HistogramRuntime::GroupType;
+    return type == GroupType::tuple   ? "tuple"
+           : type == GroupType::array ? "array"
+                                      : "result";
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
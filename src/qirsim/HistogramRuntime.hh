@@ -0,0 +1,178 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/HistogramRuntime.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "qiree/MemManager.hh"
+#include "qiree/QuantumInterface.hh"
+#include "qiree/RuntimeInterface.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Accumulate recorded results over many shots.
+ *
+ * Each execution of a program is one shot. Results recorded by the program
+ * are read from the quantum interface as they are output, and every tuple,
+ * array, or bare result becomes a \em group whose bit strings are counted
+ * across shots. Groups are identified by their order within a shot, so every
+ * shot must record the same sequence of groups; call \c end_shot after each
+ * execution. The bit strings of a shot are counted when it ends.
+ *
+ * The histogram can be printed per group (like \c XaccTupleRuntime):
+ * \code
+ * tuple ret length 2 distinct results 2
+ * tuple ret result 00 count 512
+ * tuple ret result 11 count 512
+ * \endcode
+ * or per result (like \c XaccDefaultRuntime):
+ * \code
+ * tuple ret length 2
+ * result 0 experiment <null>: {0: 512, 1: 512}
+ * result 1 experiment <null>: {0: 512, 1: 512}
+ * \endcode
+ * Character \em i of a bit string is the \em i th result in the group.
+ */
+class HistogramRuntime final : virtual public RuntimeInterface
+{
+  public:
+    //! Kind of output record
+    enum class GroupType
+    {
+        tuple,
+        array,
+        result,  //!< Result recorded outside a tuple or array
+    };
+
+    //! Number of shots for each bit string
+    using Counts = std::map<std::string, size_type>;
+
+    //! Probability of each bit string
+    using Probabilities = std::map<std::string, double>;
+
+    //! Results recorded together
+    struct Group
+    {
+        GroupType type;
+        std::string tag;
+        size_type length{0};
+        std::vector<Result> results;  //!< Results recorded in the first shot
+        std::vector<std::string> result_tags;
+        Counts counts;
+        Probabilities probabilities;
+    };
+
+  public:
+    // Construct with the quantum interface that stores results
+    explicit HistogramRuntime(QuantumInterface& qi);
+
+    //!@{
+    //! \name Accessors
+    size_type num_shots() const { return num_shots_; }
+    double total_probability() const { return total_probability_; }
+    std::vector<Group> const& groups() const { return groups_; }
+    //!@}
+
+    // Complete a shot
+    void end_shot() { this->end_shot(1); }
+
+    // Complete an execution that represents several identical shots
+    void end_shot(size_type count);
+
+    // Complete an execution that occurs with the given probability
+    void end_branch(double probability);
+
+    // Record another shot with the same outputs as the first
+    void repeat_shot();
+
+    // Add the shots accumulated by another histogram
+    void merge(HistogramRuntime const& other);
+
+    // Print per-group bit string counts
+    void print_tuples(std::ostream& os) const;
+
+    // Print per-group bit string probabilities
+    void print_probabilities(std::ostream& os) const;
+
+    // Print per-result counts
+    void print_results(std::ostream& os) const;
+
+    //!@{
+    //! \name Runtime interface
+    // Initialize the execution environment
+    void initialize(OptionalCString env) final;
+
+    // Mark the following N results as being part of an array named tag
+    void array_record_output(size_type, OptionalCString tag) final;
+
+    // Mark the following N results as being part of a tuple named tag
+    void tuple_record_output(size_type, OptionalCString tag) final;
+
+    // Record one result into the program output
+    void result_record_output(Result result, OptionalCString tag) final;
+    //!@}
+
+    // Memory management
+
+    Array array_create_1d(uint32_t elem_size, uint64_t length) final
+    {
+        return MemManager::array_create_1d(elem_size, length);
+    }
+    void array_update_reference_count(Array array, int32_t delta) final
+    {
+        return MemManager::array_update_reference_count(array, delta);
+    }
+    void* array_get_element_ptr_1d(Array array, uint64_t index) final
+    {
+        return MemManager::array_get_element_ptr_1d(array, index);
+    }
+    uint64_t array_get_size_1d(Array array) final
+    {
+        return MemManager::array_get_size_1d(array);
+    }
+    Tuple tuple_create(uint64_t num_bytes) final
+    {
+        return MemManager::tuple_create(num_bytes);
+    }
+    void tuple_update_reference_count(Tuple tuple, int32_t delta) final
+    {
+        return MemManager::tuple_update_reference_count(tuple, delta);
+    }
+
+  private:
+    QuantumInterface& qi_;
+    std::vector<Group> groups_;
+    size_type num_shots_{0};
+    size_type num_executions_{0};
+    double total_probability_{0};
+
+    // Current shot
+    size_type num_groups_{0};
+    size_type remaining_{0};
+    std::string bits_;
+    std::vector<std::string> shot_bits_;
+
+    void start_group(GroupType type, OptionalCString tag, size_type length);
+    void finish_group();
+    void end_execution();
+};
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Get a string representation of an output group type
+char const* to_cstring(HistogramRuntime::GroupType);
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
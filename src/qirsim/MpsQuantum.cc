@@ -0,0 +1,1042 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/MpsQuantum.cc
+//---------------------------------------------------------------------------//
+#include "MpsQuantum.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "qiree/Assert.hh"
+
+#include "detail/QirArgs.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+using Complex = MpsQuantum::Complex;
+using Matrix2 = std::array<Complex, 4>;
+using Matrix4 = std::array<Complex, 16>;
+
+constexpr double sqrt_half = 0.70710678118654752440;
+constexpr Complex imag{0, 1};
+
+// Relative squared singular values that are indistinguishable from round-off
+constexpr double roundoff_weight = 1e-24;
+
+constexpr Matrix2 identity_matrix{1, 0, 0, 1};
+constexpr Matrix2 h_matrix{sqrt_half, sqrt_half, sqrt_half, -sqrt_half};
+constexpr Matrix2 x_matrix{0, 1, 1, 0};
+constexpr Matrix2 y_matrix{0, Complex{0, -1}, imag, 0};
+constexpr Matrix2 z_matrix{1, 0, 0, -1};
+constexpr Matrix2 t_matrix{1, 0, 0, Complex{sqrt_half, sqrt_half}};
+constexpr Matrix2 t_adj_matrix{1, 0, 0, Complex{sqrt_half, -sqrt_half}};
+constexpr Matrix4 swap_matrix{
+    1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 1};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the matrix of a Pauli operator.
+ */
+Matrix2 const& pauli_matrix(Pauli p)
+{
+    switch (p)
+    {
+        case Pauli::i:
+            return identity_matrix;
+        case Pauli::x:
+            return x_matrix;
+        case Pauli::y:
+            return y_matrix;
+        case Pauli::z:
+            return z_matrix;
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a unitary that rotates a Pauli operator's eigenbasis to the Z basis.
+ *
+ * The adjoint rotates back.
+ */
+Matrix2 to_z_basis(Pauli p, bool adjoint)
+{
+    switch (p)
+    {
+        case Pauli::x:
+            return h_matrix;
+        case Pauli::y:
+            // H S^dagger, or S H for the adjoint
+            return adjoint ? Matrix2{sqrt_half, sqrt_half, imag * sqrt_half,
+                                     -imag * sqrt_half}
+                           : Matrix2{sqrt_half, -imag * sqrt_half, sqrt_half,
+                                     imag * sqrt_half};
+        default:
+            return identity_matrix;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Tensor product of two single-qubit operators.
+ */
+Matrix4 kron(Matrix2 const& a, Matrix2 const& b)
+{
+    Matrix4 result;
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            result[i * 4 + j] = a[(i / 2) * 2 + j / 2] * b[(i % 2) * 2 + j % 2];
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Number of singular values to keep after truncation.
+ *
+ * At most \c max_rank values are kept, and the smallest are dropped while
+ * their total relative squared weight is at most the threshold. The dropped
+ * weight is returned through the last argument.
+ */
+size_type num_kept(std::vector<double> const& s,
+                   size_type max_rank,
+                   double threshold,
+                   double* discarded)
+{
+    double total = 0;
+    for (double v : s)
+    {
+        total += v * v;
+    }
+    size_type result = std::min<size_type>(s.size(), max_rank);
+    double dropped = 0;
+    for (size_type j = result; j < s.size(); ++j)
+    {
+        dropped += s[j] * s[j];
+    }
+    threshold *= total;
+    while (result > 1 && dropped + s[result - 1] * s[result - 1] <= threshold)
+    {
+        --result;
+        dropped += s[result] * s[result];
+    }
+    *discarded = total > 0 ? dropped / total : 0;
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with default options.
+ */
+MpsQuantum::MpsQuantum() : MpsQuantum{Options{}} {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with options.
+ */
+MpsQuantum::MpsQuantum(Options const& opts) : options_{opts}, rng_{opts.seed}
+{
+    QIREE_VALIDATE(options_.max_bond > 0,
+                   << "maximum bond dimension must be positive");
+    QIREE_VALIDATE(options_.truncation_threshold >= 0
+                       && options_.truncation_threshold < 1,
+                   << "truncation threshold " << options_.truncation_threshold
+                   << " is not in [0, 1)");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Dimension of the bond between qubit i and i + 1.
+ */
+size_type MpsQuantum::bond_dimension(size_type i) const
+{
+    QIREE_EXPECT(i + 1 < num_qubits_);
+    return sites_[i].right;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Reseed the random number generator.
+ */
+void MpsQuantum::seed(std::uint64_t value)
+{
+    rng_.seed(value);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Amplitude of a basis state.
+ *
+ * Qubit \em i is bit \em i of the index, as in \c StateVectorQuantum . The
+ * tensors are contracted along the chain in \f$ O(n \chi^2) \f$.
+ */
+auto MpsQuantum::amplitude(std::uint64_t index) const -> Complex
+{
+    QIREE_VALIDATE(num_qubits_ <= 64,
+                   << "cannot index the amplitudes of " << num_qubits_
+                   << " qubits");
+    VecComplex vec{1};
+    VecComplex next;
+    for (size_type i = 0; i < num_qubits_; ++i)
+    {
+        Site const& site = sites_[i];
+        size_type const s = (index >> i) & 1;
+        next.assign(site.right, Complex{0});
+        for (size_type l = 0; l < site.left; ++l)
+        {
+            Complex const* row = site.data.data() + (l * 2 + s) * site.right;
+            for (size_type r = 0; r < site.right; ++r)
+            {
+                next[r] += vec[l] * row[r];
+            }
+        }
+        vec.swap(next);
+    }
+    return vec.front();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare the all-zero product state for an entry point.
+ */
+void MpsQuantum::set_up(EntryPointAttrs const& attrs)
+{
+    QIREE_VALIDATE(attrs.required_num_qubits <= options_.max_qubits,
+                   << "entry point requires " << attrs.required_num_qubits
+                   << " qubits but the matrix product state simulator is "
+                      "limited to "
+                   << options_.max_qubits);
+
+    num_qubits_ = attrs.required_num_qubits;
+    sites_.assign(num_qubits_, Site{1, 1, {Complex{1}, Complex{0}}});
+    center_ = 0;
+    results_.assign(attrs.required_num_results, QState::zero);
+    discarded_weight_ = 0;
+    max_bond_dimension_ = 1;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete an execution.
+ *
+ * The state and results are kept for inspection until the next set-up.
+ */
+void MpsQuantum::tear_down() {}
+
+//---------------------------------------------------------------------------//
+// MEASUREMENTS
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis into a new result.
+ */
+Result MpsQuantum::m(Qubit q)
+{
+    return this->push_result(this->measure_z(this->index(q)));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a joint Pauli observable into a new result.
+ *
+ * The observable is rotated to a Z string and its parity computed onto one
+ * qubit, which is measured before undoing the rotation. The result is zero
+ * for the +1 eigenvalue.
+ */
+Result MpsQuantum::measure(Array paulis, Array qubits)
+{
+    auto targets = this->pauli_targets(paulis, qubits);
+    if (targets.empty())
+    {
+        return this->push_result(QState::zero);
+    }
+
+    for (auto [a, p] : targets)
+    {
+        this->apply(to_z_basis(p, false), a);
+    }
+    size_type const last = targets.back().first;
+    for (size_type i = 0; i + 1 < targets.size(); ++i)
+    {
+        this->apply(x_matrix, targets[i].first, last);
+    }
+    auto result = this->measure_z(last);
+    for (size_type i = targets.size() - 1; i-- > 0;)
+    {
+        this->apply(x_matrix, targets[i].first, last);
+    }
+    for (auto [a, p] : targets)
+    {
+        this->apply(to_z_basis(p, true), a);
+    }
+    return this->push_result(result);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a new result and reset it.
+ */
+Result MpsQuantum::mresetz(Qubit q)
+{
+    auto a = this->index(q);
+    auto result = this->measure_z(a);
+    if (result == QState::one)
+    {
+        this->apply(x_matrix, a);
+    }
+    return this->push_result(result);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis and store the result.
+ */
+void MpsQuantum::mz(Qubit q, Result r)
+{
+    if (r.value >= results_.size())
+    {
+        results_.resize(r.value + 1, QState::zero);
+    }
+    results_[r.value] = this->measure_z(this->index(q));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the value of a measured result.
+ */
+QState MpsQuantum::read_result(Result r)
+{
+    QIREE_VALIDATE(r.value < results_.size(),
+                   << "result " << r.value << " is out of range");
+    return results_[r.value];
+}
+
+//---------------------------------------------------------------------------//
+// GATES
+//---------------------------------------------------------------------------//
+
+//! Apply a Toffoli gate decomposed into CNOT and T gates
+void MpsQuantum::ccx(Qubit c1, Qubit c2, Qubit t)
+{
+    QIREE_VALIDATE(c1.value != c2.value, << "duplicate control qubit");
+    QIREE_VALIDATE(c1.value != t.value && c2.value != t.value,
+                   << "target is also a control qubit");
+    auto a = this->index(c1);
+    auto b = this->index(c2);
+    auto c = this->index(t);
+    this->apply(h_matrix, c);
+    this->apply(x_matrix, b, c);
+    this->apply(t_adj_matrix, c);
+    this->apply(x_matrix, a, c);
+    this->apply(t_matrix, c);
+    this->apply(x_matrix, b, c);
+    this->apply(t_adj_matrix, c);
+    this->apply(x_matrix, a, c);
+    this->apply(t_matrix, b);
+    this->apply(t_matrix, c);
+    this->apply(h_matrix, c);
+    this->apply(x_matrix, a, b);
+    this->apply(t_matrix, a);
+    this->apply(t_adj_matrix, b);
+    this->apply(x_matrix, a, b);
+}
+
+void MpsQuantum::cnot(Qubit c, Qubit t)
+{
+    this->apply(x_matrix, this->index(c), this->index(t));
+}
+
+void MpsQuantum::cx(Qubit c, Qubit t)
+{
+    this->cnot(c, t);
+}
+
+void MpsQuantum::cy(Qubit c, Qubit t)
+{
+    this->apply(y_matrix, this->index(c), this->index(t));
+}
+
+void MpsQuantum::cz(Qubit c, Qubit t)
+{
+    this->apply(z_matrix, this->index(c), this->index(t));
+}
+
+//! Apply exp(-i theta P)
+void MpsQuantum::exp_adj(Array paulis, double theta, Array qubits)
+{
+    this->exp(paulis, -theta, qubits);
+}
+
+//! Apply exp(i theta P)
+void MpsQuantum::exp(Array paulis, double theta, Array qubits)
+{
+    this->rotate(this->pauli_targets(paulis, qubits), -2 * theta, no_control);
+}
+
+void MpsQuantum::exp(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<detail::ExpArgs>(args);
+    auto targets = this->pauli_targets(a.paulis, a.qubits);
+    this->rotate(targets, -2 * a.theta, this->read_control(ctls));
+}
+
+void MpsQuantum::exp_adj(Array ctls, Tuple args)
+{
+    auto a = detail::tuple_args<detail::ExpArgs>(args);
+    a.theta = -a.theta;
+    this->exp(ctls, &a);
+}
+
+void MpsQuantum::h(Qubit q)
+{
+    this->apply(h_matrix, this->index(q));
+}
+
+void MpsQuantum::h(Array ctls, Qubit q)
+{
+    this->apply(h_matrix, this->read_control(ctls), this->index(q));
+}
+
+void MpsQuantum::r_adj(Pauli p, double theta, Qubit q)
+{
+    this->r(p, -theta, q);
+}
+
+//! Apply exp(-i theta/2 P), which is a global phase for the identity
+void MpsQuantum::r(Pauli p, double theta, Qubit q)
+{
+    this->rotate({{this->index(q), p}}, theta, no_control);
+}
+
+void MpsQuantum::r(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<detail::PauliRotationArgs>(args);
+    this->rotate(
+        {{this->index(a.qubit), a.pauli}}, a.theta, this->read_control(ctls));
+}
+
+void MpsQuantum::r_adj(Array ctls, Tuple args)
+{
+    auto a = detail::tuple_args<detail::PauliRotationArgs>(args);
+    a.theta = -a.theta;
+    this->r(ctls, &a);
+}
+
+//! Reset a qubit to |0> by measuring it
+void MpsQuantum::reset(Qubit q)
+{
+    auto a = this->index(q);
+    if (this->measure_z(a) == QState::one)
+    {
+        this->apply(x_matrix, a);
+    }
+}
+
+void MpsQuantum::rx(double theta, Qubit q)
+{
+    this->r(Pauli::x, theta, q);
+}
+
+void MpsQuantum::rx(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    this->rotate(
+        {{this->index(a.qubit), Pauli::x}}, a.theta, this->read_control(ctls));
+}
+
+void MpsQuantum::rxx(double theta, Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in rxx");
+    this->rotate({{this->index(q1), Pauli::x}, {this->index(q2), Pauli::x}},
+                 theta,
+                 no_control);
+}
+
+void MpsQuantum::ry(double theta, Qubit q)
+{
+    this->r(Pauli::y, theta, q);
+}
+
+void MpsQuantum::ry(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    this->rotate(
+        {{this->index(a.qubit), Pauli::y}}, a.theta, this->read_control(ctls));
+}
+
+void MpsQuantum::ryy(double theta, Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in ryy");
+    this->rotate({{this->index(q1), Pauli::y}, {this->index(q2), Pauli::y}},
+                 theta,
+                 no_control);
+}
+
+void MpsQuantum::rz(double theta, Qubit q)
+{
+    this->r(Pauli::z, theta, q);
+}
+
+void MpsQuantum::rz(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    this->rotate(
+        {{this->index(a.qubit), Pauli::z}}, a.theta, this->read_control(ctls));
+}
+
+void MpsQuantum::rzz(double theta, Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in rzz");
+    this->rotate({{this->index(q1), Pauli::z}, {this->index(q2), Pauli::z}},
+                 theta,
+                 no_control);
+}
+
+void MpsQuantum::s_adj(Qubit q)
+{
+    this->apply({1, 0, 0, -imag}, this->index(q));
+}
+
+void MpsQuantum::s(Qubit q)
+{
+    this->apply({1, 0, 0, imag}, this->index(q));
+}
+
+void MpsQuantum::s(Array ctls, Qubit q)
+{
+    this->apply(
+        Matrix2{1, 0, 0, imag}, this->read_control(ctls), this->index(q));
+}
+
+void MpsQuantum::s_adj(Array ctls, Qubit q)
+{
+    this->apply(
+        Matrix2{1, 0, 0, -imag}, this->read_control(ctls), this->index(q));
+}
+
+void MpsQuantum::swap(Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in swap");
+    this->apply(swap_matrix, this->index(q1), this->index(q2));
+}
+
+void MpsQuantum::t_adj(Qubit q)
+{
+    this->apply(t_adj_matrix, this->index(q));
+}
+
+void MpsQuantum::t(Qubit q)
+{
+    this->apply(t_matrix, this->index(q));
+}
+
+void MpsQuantum::t(Array ctls, Qubit q)
+{
+    this->apply(t_matrix, this->read_control(ctls), this->index(q));
+}
+
+void MpsQuantum::t_adj(Array ctls, Qubit q)
+{
+    this->apply(t_adj_matrix, this->read_control(ctls), this->index(q));
+}
+
+void MpsQuantum::x(Qubit q)
+{
+    this->apply(x_matrix, this->index(q));
+}
+
+//! Apply a controlled X gate, which may be a Toffoli gate
+void MpsQuantum::x(Array ctls, Qubit q)
+{
+    detail::read_qubits(ctls, qubit_buf_);
+    if (qubit_buf_.size() == 2)
+    {
+        this->ccx(qubit_buf_[0], qubit_buf_[1], q);
+        return;
+    }
+    this->apply(x_matrix, this->read_control(ctls), this->index(q));
+}
+
+void MpsQuantum::y(Qubit q)
+{
+    this->apply(y_matrix, this->index(q));
+}
+
+void MpsQuantum::y(Array ctls, Qubit q)
+{
+    this->apply(y_matrix, this->read_control(ctls), this->index(q));
+}
+
+void MpsQuantum::z(Qubit q)
+{
+    this->apply(z_matrix, this->index(q));
+}
+
+void MpsQuantum::z(Array ctls, Qubit q)
+{
+    this->apply(z_matrix, this->read_control(ctls), this->index(q));
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the site index of a qubit.
+ */
+size_type MpsQuantum::index(Qubit q) const
+{
+    return detail::qubit_index(q, num_qubits_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the control qubit in a QIR array, which may be empty.
+ */
+size_type MpsQuantum::read_control(Array controls)
+{
+    detail::read_qubits(controls, qubit_buf_);
+    QIREE_VALIDATE(qubit_buf_.size() <= 1,
+                   << "matrix product state simulator does not support "
+                   << qubit_buf_.size() << " control qubits");
+    return qubit_buf_.empty() ? no_control : this->index(qubit_buf_.front());
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the non-identity operators of a Pauli string from QIR arrays.
+ */
+auto MpsQuantum::pauli_targets(Array paulis, Array qubits) -> PauliTargets
+{
+    detail::read_paulis(paulis, pauli_buf_);
+    detail::read_qubits(qubits, qubit_buf_);
+    QIREE_VALIDATE(pauli_buf_.size() == qubit_buf_.size(),
+                   << "mismatched Pauli and qubit array sizes ("
+                   << pauli_buf_.size() << " != " << qubit_buf_.size()
+                   << ")");
+
+    PauliTargets result;
+    for (size_type i = 0; i < qubit_buf_.size(); ++i)
+    {
+        auto a = this->index(qubit_buf_[i]);
+        QIREE_VALIDATE(std::none_of(qubit_buf_.begin(),
+                                    qubit_buf_.begin() + i,
+                                    [a](Qubit q) { return q.value == a; }),
+                       << "duplicate qubit " << a << " in Pauli string");
+        if (pauli_buf_[i] != Pauli::i)
+        {
+            result.push_back({a, pauli_buf_[i]});
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a single-qubit unitary.
+ *
+ * This preserves the canonical form of the other tensors.
+ */
+void MpsQuantum::apply(Matrix2 const& m, size_type a)
+{
+    Site& site = sites_[a];
+    for (size_type l = 0; l < site.left; ++l)
+    {
+        Complex* zero = site.data.data() + l * 2 * site.right;
+        Complex* one = zero + site.right;
+        for (size_type r = 0; r < site.right; ++r)
+        {
+            Complex const v0 = zero[r];
+            Complex const v1 = one[r];
+            zero[r] = m[0] * v0 + m[1] * v1;
+            one[r] = m[2] * v0 + m[3] * v1;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a single-qubit unitary with an optional control qubit.
+ */
+void MpsQuantum::apply(Matrix2 const& m, size_type control, size_type a)
+{
+    if (control == no_control)
+    {
+        return this->apply(m, a);
+    }
+    QIREE_VALIDATE(control != a, << "target is also a control qubit");
+
+    Matrix4 cm{1, 0, 0, 0, 0, 1, 0, 0};
+    cm[10] = m[0];
+    cm[11] = m[1];
+    cm[14] = m[2];
+    cm[15] = m[3];
+    this->apply(cm, control, a);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a two-qubit unitary, moving the qubits together if needed.
+ *
+ * Qubit \c a is the high bit of the matrix index. If the qubits are not
+ * neighbors, \c a is swapped along the chain until it is next to \c b , and
+ * swapped back after the gate.
+ */
+void MpsQuantum::apply(Matrix4 const& m, size_type a, size_type b)
+{
+    QIREE_EXPECT(a != b);
+    if (a > b)
+    {
+        // Exchange the qubit order of the matrix
+        Matrix4 reversed;
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                int const ri = (i % 2) * 2 + i / 2;
+                int const rj = (j % 2) * 2 + j / 2;
+                reversed[ri * 4 + rj] = m[i * 4 + j];
+            }
+        }
+        return this->apply(reversed, b, a);
+    }
+
+    for (size_type i = a; i + 1 < b; ++i)
+    {
+        this->apply_adjacent(swap_matrix, i);
+    }
+    this->apply_adjacent(m, b - 1);
+    for (size_type i = b - 1; i > a; --i)
+    {
+        this->apply_adjacent(swap_matrix, i - 1);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a two-qubit unitary to neighboring qubits i and i + 1.
+ *
+ * The two tensors are contracted and transformed, then split with a
+ * truncated singular value decomposition. The orthogonality center moves to
+ * qubit i + 1, which absorbs the singular values.
+ */
+void MpsQuantum::apply_adjacent(Matrix4 const& m, size_type i)
+{
+    this->move_center(center_ <= i ? i : i + 1);
+    Site& a = sites_[i];
+    Site& b = sites_[i + 1];
+    size_type const left = a.left;
+    size_type const mid = a.right;
+    size_type const right = b.right;
+
+    // Contract the shared bond: theta(l, s, t, r)
+    theta_.assign(left * 4 * right, Complex{0});
+    for (size_type l = 0; l < left; ++l)
+    {
+        for (size_type s = 0; s < 2; ++s)
+        {
+            Complex* dst = theta_.data() + (l * 2 + s) * 2 * right;
+            for (size_type k = 0; k < mid; ++k)
+            {
+                Complex const av = a.data[(l * 2 + s) * mid + k];
+                if (av == Complex{0})
+                {
+                    continue;
+                }
+                Complex const* src = b.data.data() + k * 2 * right;
+                for (size_type tr = 0; tr < 2 * right; ++tr)
+                {
+                    dst[tr] += av * src[tr];
+                }
+            }
+        }
+    }
+
+    // Apply the gate to the physical indices
+    for (size_type l = 0; l < left; ++l)
+    {
+        Complex* block = theta_.data() + l * 4 * right;
+        for (size_type r = 0; r < right; ++r)
+        {
+            Complex v[4];
+            for (int st = 0; st < 4; ++st)
+            {
+                v[st] = block[st * right + r];
+            }
+            for (int st = 0; st < 4; ++st)
+            {
+                block[st * right + r] = m[st * 4] * v[0] + m[st * 4 + 1] * v[1]
+                                        + m[st * 4 + 2] * v[2]
+                                        + m[st * 4 + 3] * v[3];
+            }
+        }
+    }
+
+    // Split and truncate
+    detail::svd(left * 2, 2 * right, theta_.data(), svd_);
+    double discarded{0};
+    size_type const keep
+        = num_kept(svd_.s,
+                   options_.max_bond,
+                   std::max(options_.truncation_threshold, roundoff_weight),
+                   &discarded);
+    discarded_weight_ += discarded;
+    max_bond_dimension_ = std::max(max_bond_dimension_, keep);
+
+    a.right = keep;
+    a.data.resize(left * 2 * keep);
+    for (size_type row = 0; row < left * 2; ++row)
+    {
+        for (size_type j = 0; j < keep; ++j)
+        {
+            a.data[row * keep + j] = svd_.u[row * svd_.rank + j];
+        }
+    }
+
+    // Renormalize the kept singular values
+    double norm = 0;
+    for (size_type j = 0; j < keep; ++j)
+    {
+        norm += svd_.s[j] * svd_.s[j];
+    }
+    norm = 1 / std::sqrt(norm);
+    b.left = keep;
+    b.data.resize(keep * 2 * right);
+    for (size_type j = 0; j < keep; ++j)
+    {
+        double const s = svd_.s[j] * norm;
+        for (size_type tr = 0; tr < 2 * right; ++tr)
+        {
+            b.data[j * 2 * right + tr] = s * svd_.vh[j * 2 * right + tr];
+        }
+    }
+    center_ = i + 1;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply exp(-i theta/2 P) with an optional control qubit.
+ *
+ * Strings of more than two operators (or two with a control) are rotated to
+ * the Z basis, and a CNOT ladder computes their parity onto the last qubit
+ * for a Z rotation.
+ */
+void MpsQuantum::rotate(PauliTargets const& targets,
+                        double theta,
+                        size_type control)
+{
+    QIREE_VALIDATE(std::none_of(targets.begin(),
+                                targets.end(),
+                                [control](auto const& t) {
+                                    return t.first == control;
+                                }),
+                   << "target is also a control qubit");
+
+    Complex const c = std::cos(theta / 2);
+    Complex const s = -imag * std::sin(theta / 2);
+    if (targets.empty())
+    {
+        // Global phase, or a phase on the control
+        if (control != no_control)
+        {
+            this->apply({1, 0, 0, c + s}, control);
+        }
+        else if (num_qubits_ > 0)
+        {
+            this->apply({c + s, 0, 0, c + s}, 0);
+        }
+        return;
+    }
+    if (targets.size() == 1)
+    {
+        Matrix2 m = pauli_matrix(targets.front().second);
+        for (int i = 0; i < 4; ++i)
+        {
+            m[i] = c * identity_matrix[i] + s * m[i];
+        }
+        return this->apply(m, control, targets.front().first);
+    }
+    if (targets.size() == 2 && control == no_control)
+    {
+        Matrix4 m = kron(pauli_matrix(targets[0].second),
+                         pauli_matrix(targets[1].second));
+        for (int i = 0; i < 16; ++i)
+        {
+            m[i] *= s;
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            m[i * 5] += c;
+        }
+        return this->apply(m, targets[0].first, targets[1].first);
+    }
+
+    for (auto [a, p] : targets)
+    {
+        this->apply(to_z_basis(p, false), a);
+    }
+    size_type const last = targets.back().first;
+    for (size_type i = 0; i + 1 < targets.size(); ++i)
+    {
+        this->apply(x_matrix, targets[i].first, last);
+    }
+    this->apply(Matrix2{c + s, 0, 0, c - s}, control, last);
+    for (size_type i = targets.size() - 1; i-- > 0;)
+    {
+        this->apply(x_matrix, targets[i].first, last);
+    }
+    for (auto [a, p] : targets)
+    {
+        this->apply(to_z_basis(p, true), a);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Move the orthogonality center to a qubit.
+ *
+ * Each step splits the center tensor with a singular value decomposition,
+ * leaving an isometry behind and absorbing the remaining factor into the
+ * neighbor. Singular values at the round-off level are dropped, which
+ * shrinks bonds that measurements have disentangled.
+ */
+void MpsQuantum::move_center(size_type target)
+{
+    double discarded{0};
+    while (center_ < target)
+    {
+        Site& a = sites_[center_];
+        Site& b = sites_[center_ + 1];
+        size_type const rows = a.left * 2;
+        size_type const mid = a.right;
+        size_type const cols = 2 * b.right;
+        detail::svd(rows, mid, a.data.data(), svd_);
+        size_type const keep
+            = num_kept(svd_.s, svd_.rank, roundoff_weight, &discarded);
+
+        a.right = keep;
+        a.data.resize(rows * keep);
+        for (size_type row = 0; row < rows; ++row)
+        {
+            for (size_type j = 0; j < keep; ++j)
+            {
+                a.data[row * keep + j] = svd_.u[row * svd_.rank + j];
+            }
+        }
+
+        // Multiply S V^H into the next tensor
+        theta_.assign(keep * cols, Complex{0});
+        for (size_type j = 0; j < keep; ++j)
+        {
+            for (size_type k = 0; k < mid; ++k)
+            {
+                Complex const f = svd_.s[j] * svd_.vh[j * mid + k];
+                Complex const* src = b.data.data() + k * cols;
+                Complex* dst = theta_.data() + j * cols;
+                for (size_type c = 0; c < cols; ++c)
+                {
+                    dst[c] += f * src[c];
+                }
+            }
+        }
+        b.left = keep;
+        b.data.assign(theta_.begin(), theta_.end());
+        ++center_;
+    }
+    while (center_ > target)
+    {
+        Site& a = sites_[center_];
+        Site& b = sites_[center_ - 1];
+        size_type const rows = b.left * 2;
+        size_type const mid = a.left;
+        size_type const cols = 2 * a.right;
+        detail::svd(mid, cols, a.data.data(), svd_);
+        size_type const keep
+            = num_kept(svd_.s, svd_.rank, roundoff_weight, &discarded);
+
+        a.left = keep;
+        a.data.assign(svd_.vh.begin(), svd_.vh.begin() + keep * cols);
+
+        // Multiply U S into the previous tensor
+        theta_.assign(rows * keep, Complex{0});
+        for (size_type row = 0; row < rows; ++row)
+        {
+            Complex* dst = theta_.data() + row * keep;
+            for (size_type k = 0; k < mid; ++k)
+            {
+                Complex const bv = b.data[row * mid + k];
+                for (size_type j = 0; j < keep; ++j)
+                {
+                    dst[j] += bv * svd_.u[k * svd_.rank + j] * svd_.s[j];
+                }
+            }
+        }
+        b.right = keep;
+        b.data.assign(theta_.begin(), theta_.end());
+        --center_;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Sample a Z-basis measurement and collapse the state.
+ *
+ * With the orthogonality center on the measured qubit, the outcome
+ * probabilities are the squared norms of its two slices.
+ */
+QState MpsQuantum::measure_z(size_type a)
+{
+    this->move_center(a);
+    Site& site = sites_[a];
+    size_type const slice = site.right;
+    double prob[2] = {0, 0};
+    for (size_type l = 0; l < site.left; ++l)
+    {
+        for (size_type s = 0; s < 2; ++s)
+        {
+            Complex const* v = site.data.data() + (l * 2 + s) * slice;
+            for (size_type r = 0; r < slice; ++r)
+            {
+                prob[s] += std::norm(v[r]);
+            }
+        }
+    }
+    double const total = prob[0] + prob[1];
+    std::uniform_real_distribution<double> sample_uniform;
+    bool const one = sample_uniform(rng_) * total < prob[1];
+
+    // Project onto the outcome and renormalize
+    double const scale = 1 / std::sqrt(prob[one]);
+    for (size_type l = 0; l < site.left; ++l)
+    {
+        Complex* v = site.data.data() + l * 2 * slice;
+        for (size_type r = 0; r < slice; ++r)
+        {
+            v[r] = one ? Complex{0} : v[r] * scale;
+            v[slice + r] = one ? v[slice + r] * scale : Complex{0};
+        }
+    }
+    return one ? QState::one : QState::zero;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Store a measurement in a new result.
+ */
+Result MpsQuantum::push_result(QState value)
+{
+    return detail::push_result(value, results_);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,214 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/MpsQuantum.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <array>
+#include <complex>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "qiree/Macros.hh"
+#include "qiree/QuantumNotImpl.hh"
+#include "qiree/Types.hh"
+
+#include "detail/Svd.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Simulate QIR programs with a matrix product state.
+ *
+ * The state of \em n qubits is a chain of tensors, one per qubit, connected
+ * by bonds whose dimension grows with the entanglement between the two halves
+ * of the chain. Programs on many qubits with mostly nearest-neighbor gates
+ * (1D circuits, shallow circuits, GHZ-like states) have small bonds and can
+ * be simulated far beyond the reach of a state vector.
+ *
+ * Single-qubit gates update one tensor. A two-qubit gate on neighboring
+ * qubits contracts their tensors, applies the gate, and splits the result
+ * with a singular value decomposition; gates on distant qubits first move
+ * one qubit next to the other with a network of adjacent swaps and then move
+ * it back. The state is kept in mixed canonical form so that measurements
+ * only need the tensor of the measured qubit and each split truncates
+ * optimally.
+ *
+ * Each split keeps at most \c max_bond singular values and drops the
+ * smallest ones as long as their total squared weight is at most
+ * \c truncation_threshold . The squared weights dropped during an execution
+ * are summed by \c discarded_weight , which bounds the infidelity of the
+ * final state to first order: zero means the simulation was exact.
+ *
+ * Gates with more than one control qubit (other than the Toffoli gate, which
+ * is decomposed) are not supported. Like \c StateVectorQuantum , each
+ * execution is one shot and measurements are sampled as they occur.
+ */
+class MpsQuantum final : virtual public QuantumNotImpl
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using Complex = std::complex<double>;
+    using VecComplex = std::vector<Complex>;
+    //!@}
+
+    //! Construction options
+    struct Options
+    {
+        //! Seed for measurement sampling
+        std::uint64_t seed{std::mt19937_64::default_seed};
+        //! Maximum number of qubits
+        size_type max_qubits{1024};
+        //! Maximum bond dimension between neighboring qubits
+        size_type max_bond{64};
+        //! Maximum squared weight discarded when splitting a tensor
+        double truncation_threshold{1e-12};
+    };
+
+  public:
+    // Construct with default options
+    MpsQuantum();
+
+    // Construct with options
+    explicit MpsQuantum(Options const& opts);
+
+    QIREE_DELETE_COPY_MOVE(MpsQuantum);
+
+    //!@{
+    //! \name Accessors
+    size_type num_qubits() const { return num_qubits_; }
+    size_type num_results() const { return results_.size(); }
+    Options const& options() const { return options_; }
+    //!@}
+
+    //! Total squared weight discarded by truncation since set-up
+    double discarded_weight() const { return discarded_weight_; }
+
+    //! Largest bond dimension reached since set-up
+    size_type max_bond_dimension() const { return max_bond_dimension_; }
+
+    // Dimension of the bond between qubit i and i + 1
+    size_type bond_dimension(size_type i) const;
+
+    // Reseed the random number generator
+    void seed(std::uint64_t value);
+
+    // Amplitude of a basis state (qubit i is bit i of the index)
+    Complex amplitude(std::uint64_t index) const;
+
+    //!@{
+    //! \name Quantum interface
+    void set_up(EntryPointAttrs const&) final;
+    void tear_down() final;
+    //!@}
+
+    //!@{
+    //! \name Measurements
+    Result m(Qubit) final;
+    Result measure(Array, Array) final;
+    Result mresetz(Qubit) final;
+    void mz(Qubit, Result) final;
+    QState read_result(Result) final;
+    //!@}
+
+    //!@{
+    //! \name Gates
+    void ccx(Qubit, Qubit, Qubit) final;
+    void cnot(Qubit, Qubit) final;
+    void cx(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
+    void cz(Qubit, Qubit) final;
+    void exp_adj(Array, double, Array) final;
+    void exp(Array, double, Array) final;
+    void exp(Array, Tuple) final;
+    void exp_adj(Array, Tuple) final;
+    void h(Qubit) final;
+    void h(Array, Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    void r(Array, Tuple) final;
+    void r_adj(Array, Tuple) final;
+    void reset(Qubit) final;
+    void rx(double, Qubit) final;
+    void rx(Array, Tuple) final;
+    void rxx(double, Qubit, Qubit) final;
+    void ry(double, Qubit) final;
+    void ry(Array, Tuple) final;
+    void ryy(double, Qubit, Qubit) final;
+    void rz(double, Qubit) final;
+    void rz(Array, Tuple) final;
+    void rzz(double, Qubit, Qubit) final;
+    void s_adj(Qubit) final;
+    void s(Qubit) final;
+    void s(Array, Qubit) final;
+    void s_adj(Array, Qubit) final;
+    void swap(Qubit, Qubit) final;
+    void t_adj(Qubit) final;
+    void t(Qubit) final;
+    void t(Array, Qubit) final;
+    void t_adj(Array, Qubit) final;
+    void x(Qubit) final;
+    void x(Array, Qubit) final;
+    void y(Qubit) final;
+    void y(Array, Qubit) final;
+    void z(Qubit) final;
+    void z(Array, Qubit) final;
+    //!@}
+
+  private:
+    //! Row-major single-qubit unitary
+    using Matrix2 = std::array<Complex, 4>;
+    //! Row-major two-qubit unitary (the first qubit is the high bit)
+    using Matrix4 = std::array<Complex, 16>;
+    //! Qubits and non-identity operators of a Pauli string
+    using PauliTargets = std::vector<std::pair<size_type, Pauli>>;
+
+    //! Tensor of one qubit, indexed by (left bond, qubit, right bond)
+    struct Site
+    {
+        size_type left{1};
+        size_type right{1};
+        VecComplex data;
+    };
+
+    //! Qubit index for an uncontrolled gate
+    static constexpr size_type no_control = static_cast<size_type>(-1);
+
+    Options options_;
+    std::mt19937_64 rng_;
+    size_type num_qubits_{0};
+    std::vector<Site> sites_;
+    size_type center_{0};
+    std::vector<QState> results_;
+    double discarded_weight_{0};
+    size_type max_bond_dimension_{1};
+
+    // Scratch space
+    detail::SvdResult svd_;
+    VecComplex theta_;
+    std::vector<Qubit> qubit_buf_;
+    std::vector<Pauli> pauli_buf_;
+
+    size_type index(Qubit q) const;
+    size_type read_control(Array controls);
+    PauliTargets pauli_targets(Array paulis, Array qubits);
+
+    void apply(Matrix2 const& m, size_type a);
+    void apply(Matrix2 const& m, size_type control, size_type a);
+    void apply(Matrix4 const& m, size_type a, size_type b);
+    void apply_adjacent(Matrix4 const& m, size_type i);
+    void rotate(PauliTargets const& targets, double theta, size_type control);
+    void move_center(size_type i);
+    QState measure_z(size_type a);
+    Result push_result(QState);
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,230 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/NoiseModel.cc
+//---------------------------------------------------------------------------//
+#include "NoiseModel.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#include "qiree_config.h"
+
+#include "qiree/Assert.hh"
+#include "qiree/Macros.hh"
+
+#if QIREE_USE_JSON
+#    include <nlohmann/json.hpp>
+#endif
+
+using namespace std::string_view_literals;
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+// Gates that can have noise
+constexpr std::string_view gate_names[] = {
+    "ccx"sv,
+    "cnot"sv,
+    "cy"sv,
+    "cz"sv,
+    "exp"sv,
+    "h"sv,
+    "r"sv,
+    "reset"sv,
+    "rx"sv,
+    "rxx"sv,
+    "ry"sv,
+    "ryy"sv,
+    "rz"sv,
+    "rzz"sv,
+    "s"sv,
+    "swap"sv,
+    "t"sv,
+    "x"sv,
+    "y"sv,
+    "z"sv,
+};
+
+//---------------------------------------------------------------------------//
+bool is_probability(double value)
+{
+    return value >= 0 && value <= 1;
+}
+
+//---------------------------------------------------------------------------//
+void validate(NoiseModel::Channels const& channels, std::string_view gate)
+{
+    QIREE_VALIDATE(is_probability(channels.depolarizing),
+                   << "invalid depolarizing probability "
+                   << channels.depolarizing << " for " << gate);
+    QIREE_VALIDATE(is_probability(channels.amplitude_damping),
+                   << "invalid amplitude damping probability "
+                   << channels.amplitude_damping << " for " << gate);
+}
+
+#if QIREE_USE_JSON
+//---------------------------------------------------------------------------//
+using Json = nlohmann::json;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the probabilities in a JSON object.
+ *
+ * Each key must name a member, and omitted members keep their value.
+ */
+using Member = std::pair<std::string_view, double*>;
+
+template<std::size_t N>
+void read_probabilities(Json const& obj,
+                        std::string_view where,
+                        Member const (&members)[N])
+{
+    QIREE_VALIDATE(obj.is_object(),
+                   << "expected an object for " << where << " in noise model");
+    for (auto const& [key, value] : obj.items())
+    {
+        auto iter = std::find_if(
+            std::begin(members), std::end(members), [&key = key](auto& m) {
+                return m.first == key;
+            });
+        QIREE_VALIDATE(iter != std::end(members),
+                       << "unknown key '" << key << "' for " << where
+                       << " in noise model");
+        QIREE_VALIDATE(value.is_number(),
+                       << "expected a number for '" << key << "' of "
+                       << where << " in noise model");
+        *iter->second = value.template get<double>();
+    }
+}
+
+//---------------------------------------------------------------------------//
+NoiseModel::Channels read_channels(Json const& obj, std::string_view where)
+{
+    NoiseModel::Channels result;
+    read_probabilities(obj,
+                       where,
+                       {{"depolarizing"sv, &result.depolarizing},
+                        {"amplitude_damping"sv, &result.amplitude_damping}});
+    return result;
+}
+#endif
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the channels applied after a gate.
+ */
+auto NoiseModel::channels(std::string_view gate) const -> Channels const&
+{
+    auto iter = gates.find(gate);
+    return iter != gates.end() ? iter->second : default_gate;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Check that all probabilities are valid and all gates are known.
+ */
+void validate(NoiseModel const& model)
+{
+    validate(model.default_gate, "default gate");
+    for (auto const& [name, channels] : model.gates)
+    {
+        QIREE_VALIDATE(std::find(std::begin(gate_names),
+                                 std::end(gate_names),
+                                 name)
+                           != std::end(gate_names),
+                       << "unknown gate '" << name << "' in noise model");
+        validate(channels, name);
+    }
+    QIREE_VALIDATE(is_probability(model.readout.zero_to_one)
+                       && is_probability(model.readout.one_to_zero),
+                   << "invalid readout error probabilities");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read a noise model from a JSON stream.
+ *
+ * The document is an object with optional \c default (channels for gates that
+ * aren't listed), \c gates (channels keyed by gate name), and \c readout
+ * members:
+ * \code{.json}
+   {
+     "default": {"depolarizing": 1e-3},
+     "gates": {
+       "cnot": {"depolarizing": 1e-2, "amplitude_damping": 2e-3}
+     },
+     "readout": {"zero_to_one": 0.01, "one_to_zero": 0.03}
+   }
+ * \endcode
+ * Unknown keys are errors so that misspelled channels aren't ignored.
+ */
+NoiseModel load_noise_model(std::istream& is)
+{
+#if QIREE_USE_JSON
+    Json const doc = Json::parse(is, nullptr, /* allow_exceptions = */ false);
+    QIREE_VALIDATE(!doc.is_discarded(),
+                   << "failed to parse JSON noise model");
+    QIREE_VALIDATE(doc.is_object(), << "noise model must be a JSON object");
+
+    NoiseModel result;
+    for (auto const& [key, value] : doc.items())
+    {
+        if (key == "default")
+        {
+            result.default_gate = read_channels(value, "default gate");
+        }
+        else if (key == "gates")
+        {
+            QIREE_VALIDATE(value.is_object(),
+                           << "expected an object for gates in noise model");
+            for (auto const& [name, channels] : value.items())
+            {
+                result.gates[name] = read_channels(channels, name);
+            }
+        }
+        else if (key == "readout")
+        {
+            read_probabilities(
+                value,
+                "readout",
+                {{"zero_to_one"sv, &result.readout.zero_to_one},
+                 {"one_to_zero"sv, &result.readout.one_to_zero}});
+        }
+        else
+        {
+            QIREE_VALIDATE(false,
+                           << "unknown key '" << key << "' in noise model");
+        }
+    }
+    validate(result);
+    return result;
+#else
+    QIREE_DISCARD(is);
+    QIREE_NOT_CONFIGURED("JSON");
+#endif
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read a noise model from a JSON file.
+ */
+NoiseModel load_noise_model(std::string const& filename)
+{
+    std::ifstream infile(filename);
+    QIREE_VALIDATE(infile,
+                   << "failed to open noise model '" << filename << "'");
+    return load_noise_model(infile);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,105 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/NoiseModel.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Errors of a noisy quantum device.
+ *
+ * After each gate, every qubit it acts on (including control qubits) is
+ * independently depolarized and then damped:
+ * - depolarizing with probability \em p replaces the qubit's state with
+ *   \f$ (1 - p)\rho + \frac{p}{3}(X\rho X + Y\rho Y + Z\rho Z) \f$;
+ * - amplitude damping with probability \f$ \gamma \f$ decays \f$|1\rangle\f$
+ *   to \f$|0\rangle\f$.
+ *
+ * Gates are named as in the QIR quantum instruction set, without the
+ * \c __body suffix: \c h , \c cnot , \c rx , etc. Controlled and adjoint
+ * variants use the noise of their base gate, and \c cx shares the noise of
+ * \c cnot . Gates that aren't listed use the default channels.
+ *
+ * Readout errors flip the classical outcome of each Z measurement with a
+ * probability that depends on the measured state, after the qubit has
+ * collapsed.
+ */
+struct NoiseModel
+{
+    //! Channels applied to each qubit of a gate
+    struct Channels
+    {
+        double depolarizing{0};
+        double amplitude_damping{0};
+
+        //! Whether any error can occur
+        explicit operator bool() const
+        {
+            return depolarizing > 0 || amplitude_damping > 0;
+        }
+    };
+
+    //! Probabilities of misreading a measured state
+    struct Readout
+    {
+        double zero_to_one{0};  //!< Reading 1 for |0>
+        double one_to_zero{0};  //!< Reading 0 for |1>
+
+        //! Whether any error can occur
+        explicit operator bool() const
+        {
+            return zero_to_one > 0 || one_to_zero > 0;
+        }
+    };
+
+    Channels default_gate;
+    std::map<std::string, Channels, std::less<>> gates;
+    Readout readout;
+
+    // Get the channels applied after a gate
+    Channels const& channels(std::string_view gate) const;
+
+    //! Whether any error can occur
+    explicit operator bool() const
+    {
+        if (default_gate || readout)
+        {
+            return true;
+        }
+        for (auto const& [name, channels] : gates)
+        {
+            if (channels)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Check that all probabilities are valid
+void validate(NoiseModel const& model);
+
+// Read a noise model from a JSON stream
+NoiseModel load_noise_model(std::istream& is);
+
+// Read a noise model from a JSON file
+NoiseModel load_noise_model(std::string const& filename);
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
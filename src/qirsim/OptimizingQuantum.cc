@@ -0,0 +1,322 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/OptimizingQuantum.cc
+//---------------------------------------------------------------------------//
+#include "OptimizingQuantum.hh"
+
+#include "StateVectorQuantum.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the interface that executes optimized instructions.
+ */
+OptimizingQuantum::OptimizingQuantum(QuantumInterface& target)
+    : OptimizingQuantum{target, CircuitOptimizer::Options{}}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with a target and optimization options.
+ */
+OptimizingQuantum::OptimizingQuantum(QuantumInterface& target,
+                                     CircuitOptimizer::Options const& opts)
+    : target_{target}
+    , statevector_{dynamic_cast<StateVectorQuantum*>(&target)}
+    , optimize_{opts}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare the recorder and the target for an entry point.
+ */
+void OptimizingQuantum::set_up(EntryPointAttrs const& attrs)
+{
+    rec_.set_up(attrs);
+    target_.set_up(attrs);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute the remaining instructions and complete the execution.
+ */
+void OptimizingQuantum::tear_down()
+{
+    this->flush();
+    rec_.tear_down();
+    target_.tear_down();
+}
+
+//---------------------------------------------------------------------------//
+// MEASUREMENTS
+//---------------------------------------------------------------------------//
+
+Result OptimizingQuantum::m(Qubit q)
+{
+    return rec_.m(q);
+}
+
+Result OptimizingQuantum::measure(Array paulis, Array qubits)
+{
+    return rec_.measure(paulis, qubits);
+}
+
+Result OptimizingQuantum::mresetz(Qubit q)
+{
+    return rec_.mresetz(q);
+}
+
+void OptimizingQuantum::mz(Qubit q, Result r)
+{
+    rec_.mz(q, r);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute the pending instructions and read a result from the target.
+ */
+QState OptimizingQuantum::read_result(Result r)
+{
+    this->flush();
+    return target_.read_result(r);
+}
+
+//---------------------------------------------------------------------------//
+// GATES
+//---------------------------------------------------------------------------//
+
+void OptimizingQuantum::ccx(Qubit q1, Qubit q2, Qubit q3)
+{
+    rec_.ccx(q1, q2, q3);
+}
+
+void OptimizingQuantum::cnot(Qubit q1, Qubit q2)
+{
+    rec_.cnot(q1, q2);
+}
+
+void OptimizingQuantum::cx(Qubit q1, Qubit q2)
+{
+    rec_.cx(q1, q2);
+}
+
+void OptimizingQuantum::cy(Qubit q1, Qubit q2)
+{
+    rec_.cy(q1, q2);
+}
+
+void OptimizingQuantum::cz(Qubit q1, Qubit q2)
+{
+    rec_.cz(q1, q2);
+}
+
+void OptimizingQuantum::exp_adj(Array paulis, double theta, Array qubits)
+{
+    rec_.exp_adj(paulis, theta, qubits);
+}
+
+void OptimizingQuantum::exp(Array paulis, double theta, Array qubits)
+{
+    rec_.exp(paulis, theta, qubits);
+}
+
+void OptimizingQuantum::exp(Array ctls, Tuple args)
+{
+    rec_.exp(ctls, args);
+}
+
+void OptimizingQuantum::exp_adj(Array ctls, Tuple args)
+{
+    rec_.exp_adj(ctls, args);
+}
+
+void OptimizingQuantum::h(Qubit q)
+{
+    rec_.h(q);
+}
+
+void OptimizingQuantum::h(Array ctls, Qubit q)
+{
+    rec_.h(ctls, q);
+}
+
+void OptimizingQuantum::r_adj(Pauli p, double theta, Qubit q)
+{
+    rec_.r_adj(p, theta, q);
+}
+
+void OptimizingQuantum::r(Pauli p, double theta, Qubit q)
+{
+    rec_.r(p, theta, q);
+}
+
+void OptimizingQuantum::r(Array ctls, Tuple args)
+{
+    rec_.r(ctls, args);
+}
+
+void OptimizingQuantum::r_adj(Array ctls, Tuple args)
+{
+    rec_.r_adj(ctls, args);
+}
+
+void OptimizingQuantum::reset(Qubit q)
+{
+    rec_.reset(q);
+}
+
+void OptimizingQuantum::rx(double theta, Qubit q)
+{
+    rec_.rx(theta, q);
+}
+
+void OptimizingQuantum::rx(Array ctls, Tuple args)
+{
+    rec_.rx(ctls, args);
+}
+
+void OptimizingQuantum::rxx(double theta, Qubit q1, Qubit q2)
+{
+    rec_.rxx(theta, q1, q2);
+}
+
+void OptimizingQuantum::ry(double theta, Qubit q)
+{
+    rec_.ry(theta, q);
+}
+
+void OptimizingQuantum::ry(Array ctls, Tuple args)
+{
+    rec_.ry(ctls, args);
+}
+
+void OptimizingQuantum::ryy(double theta, Qubit q1, Qubit q2)
+{
+    rec_.ryy(theta, q1, q2);
+}
+
+void OptimizingQuantum::rz(double theta, Qubit q)
+{
+    rec_.rz(theta, q);
+}
+
+void OptimizingQuantum::rz(Array ctls, Tuple args)
+{
+    rec_.rz(ctls, args);
+}
+
+void OptimizingQuantum::rzz(double theta, Qubit q1, Qubit q2)
+{
+    rec_.rzz(theta, q1, q2);
+}
+
+void OptimizingQuantum::s_adj(Qubit q)
+{
+    rec_.s_adj(q);
+}
+
+void OptimizingQuantum::s(Qubit q)
+{
+    rec_.s(q);
+}
+
+void OptimizingQuantum::s(Array ctls, Qubit q)
+{
+    rec_.s(ctls, q);
+}
+
+void OptimizingQuantum::s_adj(Array ctls, Qubit q)
+{
+    rec_.s_adj(ctls, q);
+}
+
+void OptimizingQuantum::swap(Qubit q1, Qubit q2)
+{
+    rec_.swap(q1, q2);
+}
+
+void OptimizingQuantum::t_adj(Qubit q)
+{
+    rec_.t_adj(q);
+}
+
+void OptimizingQuantum::t(Qubit q)
+{
+    rec_.t(q);
+}
+
+void OptimizingQuantum::t(Array ctls, Qubit q)
+{
+    rec_.t(ctls, q);
+}
+
+void OptimizingQuantum::t_adj(Array ctls, Qubit q)
+{
+    rec_.t_adj(ctls, q);
+}
+
+void OptimizingQuantum::x(Qubit q)
+{
+    rec_.x(q);
+}
+
+void OptimizingQuantum::x(Array ctls, Qubit q)
+{
+    rec_.x(ctls, q);
+}
+
+void OptimizingQuantum::y(Qubit q)
+{
+    rec_.y(q);
+}
+
+void OptimizingQuantum::y(Array ctls, Qubit q)
+{
+    rec_.y(ctls, q);
+}
+
+void OptimizingQuantum::z(Qubit q)
+{
+    rec_.z(q);
+}
+
+void OptimizingQuantum::z(Array ctls, Qubit q)
+{
+    rec_.z(ctls, q);
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Optimize the pending instructions and apply them to the target.
+ *
+ * The state vector simulator applies the whole circuit with gate fusion;
+ * other targets receive the instructions one at a time.
+ */
+void OptimizingQuantum::flush()
+{
+    if (rec_.circuit().empty())
+    {
+        return;
+    }
+    optimize_(rec_.circuit(), &optimized_);
+    if (statevector_)
+    {
+        statevector_->apply(optimized_);
+    }
+    else
+    {
+        replay(optimized_, target_);
+    }
+    rec_.clear_circuit();
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
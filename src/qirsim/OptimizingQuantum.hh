@@ -0,0 +1,131 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/OptimizingQuantum.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include "qiree/Circuit.hh"
+#include "qiree/CircuitOptimizer.hh"
+#include "qiree/Macros.hh"
+#include "qiree/QuantumInterface.hh"
+#include "qiree/QuantumNotImpl.hh"
+#include "qiree/Types.hh"
+
+#include "CircuitRecorder.hh"
+
+namespace qiree
+{
+class StateVectorQuantum;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Optimize quantum instructions before passing them to another interface.
+ *
+ * Instructions are recorded into a circuit until a result is read or the
+ * execution ends. The pending circuit is then optimized with a
+ * \c CircuitOptimizer and replayed on the target, so programs may still
+ * branch on measurements. Results of \c m , \c measure , and \c mresetz are
+ * numbered after the entry point's required results, which matches the
+ * simulators in this package. A \c StateVectorQuantum target applies each
+ * optimized circuit directly, fusing its gates into dense operators.
+ *
+ * \code
+    StateVectorQuantum sim;
+    OptimizingQuantum opt{sim};
+    HistogramRuntime rt{opt};
+    execute(opt, rt);
+    opt.optimizer().print_counts(std::cerr);
+   \endcode
+ */
+class OptimizingQuantum final : virtual public QuantumNotImpl
+{
+  public:
+    // Construct with the interface that executes optimized instructions
+    explicit OptimizingQuantum(QuantumInterface& target);
+
+    // Construct with a target and optimization options
+    OptimizingQuantum(QuantumInterface& target,
+                      CircuitOptimizer::Options const& opts);
+
+    QIREE_DELETE_COPY_MOVE(OptimizingQuantum);
+
+    //!@{
+    //! \name Accessors
+    //! Optimizer with the operation counts of every replayed circuit
+    CircuitOptimizer const& optimizer() const { return optimize_; }
+    //!@}
+
+    //!@{
+    //! \name Quantum interface
+    void set_up(EntryPointAttrs const&) final;
+    void tear_down() final;
+    //!@}
+
+    //!@{
+    //! \name Measurements
+    Result m(Qubit) final;
+    Result measure(Array, Array) final;
+    Result mresetz(Qubit) final;
+    void mz(Qubit, Result) final;
+    QState read_result(Result) final;
+    //!@}
+
+    //!@{
+    //! \name Gates
+    void ccx(Qubit, Qubit, Qubit) final;
+    void cnot(Qubit, Qubit) final;
+    void cx(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
+    void cz(Qubit, Qubit) final;
+    void exp_adj(Array, double, Array) final;
+    void exp(Array, double, Array) final;
+    void exp(Array, Tuple) final;
+    void exp_adj(Array, Tuple) final;
+    void h(Qubit) final;
+    void h(Array, Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    void r(Array, Tuple) final;
+    void r_adj(Array, Tuple) final;
+    void reset(Qubit) final;
+    void rx(double, Qubit) final;
+    void rx(Array, Tuple) final;
+    void rxx(double, Qubit, Qubit) final;
+    void ry(double, Qubit) final;
+    void ry(Array, Tuple) final;
+    void ryy(double, Qubit, Qubit) final;
+    void rz(double, Qubit) final;
+    void rz(Array, Tuple) final;
+    void rzz(double, Qubit, Qubit) final;
+    void s_adj(Qubit) final;
+    void s(Qubit) final;
+    void s(Array, Qubit) final;
+    void s_adj(Array, Qubit) final;
+    void swap(Qubit, Qubit) final;
+    void t_adj(Qubit) final;
+    void t(Qubit) final;
+    void t(Array, Qubit) final;
+    void t_adj(Array, Qubit) final;
+    void x(Qubit) final;
+    void x(Array, Qubit) final;
+    void y(Qubit) final;
+    void y(Array, Qubit) final;
+    void z(Qubit) final;
+    void z(Array, Qubit) final;
+    //!@}
+
+  private:
+    QuantumInterface& target_;
+    StateVectorQuantum* statevector_{nullptr};
+    CircuitRecorder rec_;
+    CircuitOptimizer optimize_;
+    Circuit optimized_;
+
+    void flush();
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
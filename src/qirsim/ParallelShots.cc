@@ -0,0 +1,120 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/ParallelShots.cc
+//---------------------------------------------------------------------------//
+#include "ParallelShots.hh"
+
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "qiree/Assert.hh"
+
+namespace qiree
+{
+namespace detail
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Join a set of threads when leaving scope.
+ */
+struct ThreadJoiner
+{
+    std::vector<std::thread> threads;
+
+    ~ThreadJoiner()
+    {
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+    }
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Call a function on contiguous ranges of tasks from several threads.
+ *
+ * The function is called with the thread index and the range of tasks
+ * [begin, end) assigned to it. The first exception thrown by any thread is
+ * rethrown after all threads have finished.
+ */
+void for_each_thread(
+    size_type num_tasks,
+    size_type num_threads,
+    std::function<void(size_type, size_type, size_type)> const& apply)
+{
+    QIREE_EXPECT(num_threads > 0);
+
+    std::vector<std::exception_ptr> errors(num_threads);
+    auto run = [&](size_type thread) {
+        try
+        {
+            apply(thread,
+                  num_tasks * thread / num_threads,
+                  num_tasks * (thread + 1) / num_threads);
+        }
+        catch (...)
+        {
+            errors[thread] = std::current_exception();
+        }
+    };
+
+    // The calling thread does the first share of the work. Started threads
+    // are joined even if launching another one throws.
+    {
+        ThreadJoiner workers;
+        workers.threads.reserve(num_threads - 1);
+        for (size_type t = 1; t < num_threads; ++t)
+        {
+            workers.threads.emplace_back(run, t);
+        }
+        run(0);
+    }
+
+    for (auto const& e : errors)
+    {
+        if (e)
+        {
+            std::rethrow_exception(e);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+
+//---------------------------------------------------------------------------//
+/*!
+ * Derive an independent random number seed for a stream.
+ *
+ * This applies the SplitMix64 finalizer to the seed offset by the stream
+ * index, so that nearby seeds and streams give uncorrelated generators.
+ */
+std::uint64_t stream_seed(std::uint64_t seed, size_type stream)
+{
+    std::uint64_t z = seed + (stream + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the number of hardware threads.
+ */
+size_type default_num_threads()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,104 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/ParallelShots.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "qiree/Types.hh"
+
+#include "HistogramRuntime.hh"
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+// Call a function on contiguous ranges of tasks from several threads
+void for_each_thread(
+    size_type num_tasks,
+    size_type num_threads,
+    std::function<void(size_type, size_type, size_type)> const& apply);
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Derive an independent random number seed for a stream
+std::uint64_t stream_seed(std::uint64_t seed, size_type stream);
+
+// Get the number of hardware threads
+size_type default_num_threads();
+
+//---------------------------------------------------------------------------//
+/*!
+ * Run shots of a program in parallel and accumulate them into a histogram.
+ *
+ * Each thread owns a simulator constructed from the given options, with a
+ * seed derived from the thread index (see \c stream_seed ), and its own
+ * runtime. Every shot executes the compiled program, so measurements are
+ * sampled as they occur and programs may branch on their results. The shots
+ * are divided into contiguous ranges, so the counts are reproducible for a
+ * given seed and number of threads. Per-thread histograms are merged into
+ * the result in thread order.
+ *
+ * The executor is called with a thread's simulator and runtime, so it can be
+ * an \c Executor or a \c DirectExecutor . Several threads may call it at
+ * once since interfaces are activated per thread. Simulators that
+ * parallelize gates internally should use a single thread for programs with
+ * many qubits.
+ *
+ * \code
+    Executor execute{Module{"teleport.ll"}};
+    StateVectorQuantum sim;
+    HistogramRuntime histogram{sim};
+    run_parallel_shots<StateVectorQuantum>(
+        execute, StateVectorQuantum::Options{}, 1024, 8, histogram);
+   \endcode
+ */
+template<class QI, class E>
+void run_parallel_shots(E const& execute,
+                        typename QI::Options const& opts,
+                        size_type num_shots,
+                        size_type num_threads,
+                        HistogramRuntime& result)
+{
+    num_threads = std::max<size_type>(1, std::min(num_threads, num_shots));
+
+    std::vector<std::unique_ptr<QI>> sims(num_threads);
+    std::vector<std::unique_ptr<HistogramRuntime>> runtimes(num_threads);
+    detail::for_each_thread(
+        num_shots,
+        num_threads,
+        [&](size_type thread, size_type begin, size_type end) {
+            auto thread_opts = opts;
+            thread_opts.seed = stream_seed(opts.seed, thread);
+            sims[thread] = std::make_unique<QI>(thread_opts);
+            runtimes[thread]
+                = std::make_unique<HistogramRuntime>(*sims[thread]);
+            for (size_type i = begin; i < end; ++i)
+            {
+                execute(*sims[thread], *runtimes[thread]);
+                runtimes[thread]->end_shot();
+            }
+        });
+
+    for (auto const& rt : runtimes)
+    {
+        result.merge(*rt);
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
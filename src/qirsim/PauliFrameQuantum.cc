@@ -0,0 +1,748 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/PauliFrameQuantum.cc
+//---------------------------------------------------------------------------//
+#include "PauliFrameQuantum.hh"
+
+#include <algorithm>
+#include <utility>
+
+#include "qiree/Assert.hh"
+
+#include "detail/BitUtils.hh"
+#include "detail/CliffordUtils.hh"
+#include "detail/QirArgs.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+using Word = PauliFrameQuantum::Word;
+using detail::quarter_turns;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Check that a noise model only has Pauli channels.
+ */
+void validate_pauli_channels(NoiseModel const& model)
+{
+    bool damped = model.default_gate.amplitude_damping > 0;
+    for (auto const& [name, channels] : model.gates)
+    {
+        damped = damped || channels.amplitude_damping > 0;
+    }
+    QIREE_VALIDATE(!damped,
+                   << "amplitude damping is not a Pauli channel (use the "
+                      "density matrix simulator)");
+}
+
+//---------------------------------------------------------------------------//
+QIRSIM_TARGET_CLONES void
+xor_words(Word const* src, Word* dst, size_type num_words)
+{
+    for (size_type i = 0; i < num_words; ++i)
+    {
+        dst[i] ^= src[i];
+    }
+}
+
+//---------------------------------------------------------------------------//
+QIRSIM_TARGET_CLONES void swap_words(Word* a, Word* b, size_type num_words)
+{
+    for (size_type i = 0; i < num_words; ++i)
+    {
+        std::swap(a[i], b[i]);
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with default options.
+ */
+PauliFrameQuantum::PauliFrameQuantum() : PauliFrameQuantum{Options{}} {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with options.
+ */
+PauliFrameQuantum::PauliFrameQuantum(Options const& opts)
+    : options_{opts}
+    , reference_{StabilizerQuantum::Options{opts.seed, opts.max_qubits}}
+    , rng_{~opts.seed}
+{
+    QIREE_VALIDATE(options_.batch_words > 0,
+                   << "Pauli frame batches must have at least one word");
+    validate(options_.noise);
+    validate_pauli_channels(options_.noise);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Reseed the random number generators.
+ */
+void PauliFrameQuantum::seed(std::uint64_t value)
+{
+    reference_.seed(value);
+    rng_.seed(~value);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Sample the measurement results of many shots.
+ *
+ * The recorded program is propagated in as many batches as needed, and the
+ * packed results are written to \c result . The results read by the runtime
+ * are resampled afterward.
+ */
+void PauliFrameQuantum::sample(size_type num_shots, MeasurementRecord& result)
+{
+    size_type const num_results = this->num_results();
+    size_type const batch_words = options_.batch_words;
+
+    result.num_shots = num_shots;
+    result.num_results = num_results;
+    result.words_per_result = (num_shots + 63) / 64;
+    result.bits.assign(num_results * result.words_per_result, 0);
+
+    for (size_type word = 0; word < result.words_per_result;
+         word += batch_words)
+    {
+        this->sample_batch();
+        size_type const count
+            = std::min(batch_words, result.words_per_result - word);
+        for (size_type r = 0; r < num_results; ++r)
+        {
+            std::copy_n(record_.begin() + r * batch_words,
+                        count,
+                        result.bits.begin() + r * result.words_per_result
+                            + word);
+        }
+    }
+
+    if (num_shots % 64 != 0)
+    {
+        // Clear the bits of shots past the end
+        Word const mask = (Word{1} << (num_shots % 64)) - 1;
+        for (size_type r = 0; r < num_results; ++r)
+        {
+            result.bits[(r + 1) * result.words_per_result - 1] &= mask;
+        }
+    }
+    shot_ = this->batch_size();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Make the results of the next shot available to read.
+ *
+ * A new batch is sampled when the results of the current one are exhausted.
+ */
+void PauliFrameQuantum::next_shot()
+{
+    ++shot_;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare the all-zero state and an empty recording for an entry point.
+ */
+void PauliFrameQuantum::set_up(EntryPointAttrs const& attrs)
+{
+    reference_.set_up(attrs);
+    num_qubits_ = attrs.required_num_qubits;
+    ops_.clear();
+    pauli_pool_.clear();
+
+    size_type const batch_words = options_.batch_words;
+    x_.assign(num_qubits_ * batch_words, 0);
+    z_.assign(num_qubits_ * batch_words, 0);
+    mask_.assign(2 * batch_words, 0);
+    record_.clear();
+    sampled_ = false;
+    shot_ = this->batch_size();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete an execution.
+ */
+void PauliFrameQuantum::tear_down()
+{
+    reference_.tear_down();
+}
+
+//---------------------------------------------------------------------------//
+// MEASUREMENTS
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis into a new result.
+ */
+Result PauliFrameQuantum::m(Qubit q)
+{
+    auto a = this->index(q);
+    auto result = reference_.m(q);
+    this->record_measure_z(a, result);
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a joint Pauli observable into a new result.
+ *
+ * Readout errors only apply to single-qubit Z measurements.
+ */
+Result PauliFrameQuantum::measure(Array paulis, Array qubits)
+{
+    auto result = reference_.measure(paulis, qubits);
+
+    detail::read_paulis(paulis, pauli_buf_);
+    detail::read_qubits(qubits, qubit_buf_);
+    Op op{OpKind::measure_pauli};
+    op.a = pauli_pool_.size();
+    op.result = result.value;
+    op.reference = reference_.read_result(result) == QState::one;
+    for (size_type i = 0; i < qubit_buf_.size(); ++i)
+    {
+        if (pauli_buf_[i] != Pauli::i)
+        {
+            pauli_pool_.push_back({this->index(qubit_buf_[i]), pauli_buf_[i]});
+        }
+    }
+    op.b = pauli_pool_.size() - op.a;
+    this->record(op);
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a new result and reset it.
+ */
+Result PauliFrameQuantum::mresetz(Qubit q)
+{
+    auto a = this->index(q);
+    auto result = reference_.mresetz(q);
+    this->record_measure_z(a, result);
+    this->record({OpKind::reset, false, a});
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis and store the result.
+ */
+void PauliFrameQuantum::mz(Qubit q, Result r)
+{
+    auto a = this->index(q);
+    reference_.mz(q, r);
+    this->record_measure_z(a, r);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the value of a result in the current shot.
+ *
+ * The first read samples a batch of shots and ends the recording.
+ */
+QState PauliFrameQuantum::read_result(Result r)
+{
+    QIREE_VALIDATE(r.value < this->num_results(),
+                   << "result " << r.value << " is out of range");
+    if (shot_ >= this->batch_size())
+    {
+        this->sample_batch();
+        shot_ = 0;
+    }
+    Word const w = record_[r.value * options_.batch_words + shot_ / 64];
+    return (w >> (shot_ % 64)) & 1 ? QState::one : QState::zero;
+}
+
+//---------------------------------------------------------------------------//
+// CLIFFORD GATES
+//---------------------------------------------------------------------------//
+
+void PauliFrameQuantum::cnot(Qubit c, Qubit t)
+{
+    reference_.cnot(c, t);
+    auto a = this->index(c);
+    auto b = this->index(t);
+    this->record({OpKind::cnot, false, a, b});
+    this->noise("cnot", a, b);
+}
+
+void PauliFrameQuantum::cx(Qubit c, Qubit t)
+{
+    this->cnot(c, t);
+}
+
+//! CY = S CX S^dagger
+void PauliFrameQuantum::cy(Qubit c, Qubit t)
+{
+    reference_.cy(c, t);
+    auto a = this->index(c);
+    auto b = this->index(t);
+    this->record({OpKind::s, false, b});
+    this->record({OpKind::cnot, false, a, b});
+    this->record({OpKind::s, false, b});
+    this->noise("cy", a, b);
+}
+
+void PauliFrameQuantum::cz(Qubit c, Qubit t)
+{
+    reference_.cz(c, t);
+    auto a = this->index(c);
+    auto b = this->index(t);
+    this->record({OpKind::cz, false, a, b});
+    this->noise("cz", a, b);
+}
+
+void PauliFrameQuantum::h(Qubit q)
+{
+    reference_.h(q);
+    auto a = this->index(q);
+    this->record({OpKind::h, false, a});
+    this->noise("h", a);
+}
+
+void PauliFrameQuantum::r_adj(Pauli p, double theta, Qubit q)
+{
+    this->r(p, -theta, q);
+}
+
+void PauliFrameQuantum::r(Pauli p, double theta, Qubit q)
+{
+    reference_.r(p, theta, q);
+    auto a = this->index(q);
+    this->record_rotation(p, quarter_turns(theta), a);
+    this->noise("r", a);
+}
+
+void PauliFrameQuantum::reset(Qubit q)
+{
+    reference_.reset(q);
+    auto a = this->index(q);
+    this->record({OpKind::reset, false, a});
+    this->noise("reset", a);
+}
+
+void PauliFrameQuantum::rx(double theta, Qubit q)
+{
+    reference_.rx(theta, q);
+    auto a = this->index(q);
+    this->record_rotation(Pauli::x, quarter_turns(theta), a);
+    this->noise("rx", a);
+}
+
+void PauliFrameQuantum::ry(double theta, Qubit q)
+{
+    reference_.ry(theta, q);
+    auto a = this->index(q);
+    this->record_rotation(Pauli::y, quarter_turns(theta), a);
+    this->noise("ry", a);
+}
+
+void PauliFrameQuantum::rz(double theta, Qubit q)
+{
+    reference_.rz(theta, q);
+    auto a = this->index(q);
+    this->record_rotation(Pauli::z, quarter_turns(theta), a);
+    this->noise("rz", a);
+}
+
+//! S and its adjoint differ by a Pauli Z, which commutes with the frame
+void PauliFrameQuantum::s_adj(Qubit q)
+{
+    reference_.s_adj(q);
+    auto a = this->index(q);
+    this->record({OpKind::s, false, a});
+    this->noise("s", a);
+}
+
+void PauliFrameQuantum::s(Qubit q)
+{
+    reference_.s(q);
+    auto a = this->index(q);
+    this->record({OpKind::s, false, a});
+    this->noise("s", a);
+}
+
+void PauliFrameQuantum::swap(Qubit q1, Qubit q2)
+{
+    reference_.swap(q1, q2);
+    auto a = this->index(q1);
+    auto b = this->index(q2);
+    this->record({OpKind::swap, false, a, b});
+    this->noise("swap", a, b);
+}
+
+//! Pauli gates only change the reference
+void PauliFrameQuantum::x(Qubit q)
+{
+    reference_.x(q);
+    this->noise("x", this->index(q));
+}
+
+void PauliFrameQuantum::x(Array ctls, Qubit q)
+{
+    reference_.x(ctls, q);
+    detail::read_qubits(ctls, qubit_buf_);
+    auto b = this->index(q);
+    if (qubit_buf_.empty())
+    {
+        return this->noise("x", b);
+    }
+    auto a = this->index(qubit_buf_.front());
+    this->record({OpKind::cnot, false, a, b});
+    this->noise("x", a, b);
+}
+
+void PauliFrameQuantum::y(Qubit q)
+{
+    reference_.y(q);
+    this->noise("y", this->index(q));
+}
+
+void PauliFrameQuantum::y(Array ctls, Qubit q)
+{
+    reference_.y(ctls, q);
+    detail::read_qubits(ctls, qubit_buf_);
+    auto b = this->index(q);
+    if (qubit_buf_.empty())
+    {
+        return this->noise("y", b);
+    }
+    auto a = this->index(qubit_buf_.front());
+    this->record({OpKind::s, false, b});
+    this->record({OpKind::cnot, false, a, b});
+    this->record({OpKind::s, false, b});
+    this->noise("y", a, b);
+}
+
+void PauliFrameQuantum::z(Qubit q)
+{
+    reference_.z(q);
+    this->noise("z", this->index(q));
+}
+
+void PauliFrameQuantum::z(Array ctls, Qubit q)
+{
+    reference_.z(ctls, q);
+    detail::read_qubits(ctls, qubit_buf_);
+    auto b = this->index(q);
+    if (qubit_buf_.empty())
+    {
+        return this->noise("z", b);
+    }
+    auto a = this->index(qubit_buf_.front());
+    this->record({OpKind::cz, false, a, b});
+    this->noise("z", a, b);
+}
+
+//---------------------------------------------------------------------------//
+// NON-CLIFFORD GATES
+//---------------------------------------------------------------------------//
+// The reference simulator rejects these
+
+void PauliFrameQuantum::ccx(Qubit c1, Qubit c2, Qubit t)
+{
+    reference_.ccx(c1, c2, t);
+}
+
+void PauliFrameQuantum::h(Array ctls, Qubit q)
+{
+    reference_.h(ctls, q);
+}
+
+void PauliFrameQuantum::s(Array ctls, Qubit q)
+{
+    reference_.s(ctls, q);
+}
+
+void PauliFrameQuantum::s_adj(Array ctls, Qubit q)
+{
+    reference_.s_adj(ctls, q);
+}
+
+void PauliFrameQuantum::t_adj(Qubit q)
+{
+    reference_.t_adj(q);
+}
+
+void PauliFrameQuantum::t(Qubit q)
+{
+    reference_.t(q);
+}
+
+void PauliFrameQuantum::t(Array ctls, Qubit q)
+{
+    reference_.t(ctls, q);
+}
+
+void PauliFrameQuantum::t_adj(Array ctls, Qubit q)
+{
+    reference_.t_adj(ctls, q);
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the index of a qubit.
+ */
+size_type PauliFrameQuantum::index(Qubit q) const
+{
+    return detail::qubit_index(q, num_qubits_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Append an operation to the recorded program.
+ */
+void PauliFrameQuantum::record(Op const& op)
+{
+    QIREE_VALIDATE(!sampled_,
+                   << "quantum operations after reading a result cannot be "
+                      "sampled with Pauli frames (the program must not "
+                      "depend on measurement results)");
+    ops_.push_back(op);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record the depolarizing noise of a gate on one qubit.
+ */
+void PauliFrameQuantum::noise(std::string_view gate, size_type a)
+{
+    double const p = options_.noise.channels(gate).depolarizing;
+    if (p > 0)
+    {
+        Op op{OpKind::depolarize, false, a};
+        op.probability = p;
+        this->record(op);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record the depolarizing noise of a gate on each of two qubits.
+ */
+void PauliFrameQuantum::noise(std::string_view gate,
+                              size_type a,
+                              size_type b)
+{
+    this->noise(gate, a);
+    this->noise(gate, b);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record the frame update of a rotation by quarter turns.
+ *
+ * Half turns are Pauli gates and don't change the frame, and rotating by
+ * three quarter turns updates the frame like a single quarter turn.
+ */
+void PauliFrameQuantum::record_rotation(Pauli p, int turns, size_type a)
+{
+    if (turns % 2 == 0 || p == Pauli::i)
+    {
+        return;
+    }
+    switch (p)
+    {
+        case Pauli::x:
+            return this->record({OpKind::sx, false, a});
+        case Pauli::y:
+            return this->record({OpKind::h, false, a});
+        case Pauli::z:
+            return this->record({OpKind::s, false, a});
+        default:
+            QIREE_ASSERT_UNREACHABLE();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record a Z measurement and its reference outcome.
+ */
+void PauliFrameQuantum::record_measure_z(size_type a, Result r)
+{
+    Op op{OpKind::measure_z, false, a};
+    op.result = r.value;
+    op.reference = reference_.read_result(r) == QState::one;
+    this->record(op);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Propagate a batch of frames through the recorded program.
+ */
+void PauliFrameQuantum::sample_batch()
+{
+    sampled_ = true;
+    size_type const nw = options_.batch_words;
+    record_.assign(this->num_results() * nw, 0);
+
+    // Frames of |0> are random Z stabilizers
+    std::fill(x_.begin(), x_.end(), Word{0});
+    this->randomize(z_.data(), z_.size());
+
+    auto const& readout = options_.noise.readout;
+    Word* const flip_01 = mask_.data();
+    Word* const flip_10 = mask_.data() + nw;
+
+    for (Op const& op : ops_)
+    {
+        switch (op.kind)
+        {
+            case OpKind::h:
+                swap_words(this->x_frame(op.a), this->z_frame(op.a), nw);
+                break;
+            case OpKind::s:
+                xor_words(this->x_frame(op.a), this->z_frame(op.a), nw);
+                break;
+            case OpKind::sx:
+                xor_words(this->z_frame(op.a), this->x_frame(op.a), nw);
+                break;
+            case OpKind::cnot:
+                xor_words(this->x_frame(op.a), this->x_frame(op.b), nw);
+                xor_words(this->z_frame(op.b), this->z_frame(op.a), nw);
+                break;
+            case OpKind::cz:
+                xor_words(this->x_frame(op.a), this->z_frame(op.b), nw);
+                xor_words(this->x_frame(op.b), this->z_frame(op.a), nw);
+                break;
+            case OpKind::swap:
+                swap_words(this->x_frame(op.a), this->x_frame(op.b), nw);
+                swap_words(this->z_frame(op.a), this->z_frame(op.b), nw);
+                break;
+            case OpKind::measure_z: {
+                Word* out = record_.data() + op.result * nw;
+                Word const ref = op.reference ? ~Word{0} : Word{0};
+                Word const* x = this->x_frame(op.a);
+                for (size_type i = 0; i < nw; ++i)
+                {
+                    out[i] = x[i] ^ ref;
+                }
+                if (readout)
+                {
+                    this->sample_bernoulli(readout.zero_to_one, flip_01);
+                    this->sample_bernoulli(readout.one_to_zero, flip_10);
+                    for (size_type i = 0; i < nw; ++i)
+                    {
+                        out[i] ^= (~out[i] & flip_01[i])
+                                  | (out[i] & flip_10[i]);
+                    }
+                }
+                this->randomize(this->z_frame(op.a), nw);
+                break;
+            }
+            case OpKind::measure_pauli: {
+                Word* out = record_.data() + op.result * nw;
+                std::fill(out, out + nw, op.reference ? ~Word{0} : Word{0});
+                auto const* begin = pauli_pool_.data() + op.a;
+                for (auto const* t = begin; t != begin + op.b; ++t)
+                {
+                    // Flip if the frame anticommutes with the target Pauli
+                    if (t->second != Pauli::x)
+                    {
+                        xor_words(this->x_frame(t->first), out, nw);
+                    }
+                    if (t->second != Pauli::z)
+                    {
+                        xor_words(this->z_frame(t->first), out, nw);
+                    }
+                }
+                // Multiply half the frames by the measured observable
+                this->randomize(flip_01, nw);
+                for (auto const* t = begin; t != begin + op.b; ++t)
+                {
+                    if (t->second != Pauli::z)
+                    {
+                        xor_words(flip_01, this->x_frame(t->first), nw);
+                    }
+                    if (t->second != Pauli::x)
+                    {
+                        xor_words(flip_01, this->z_frame(t->first), nw);
+                    }
+                }
+                break;
+            }
+            case OpKind::reset:
+                std::fill_n(this->x_frame(op.a), nw, Word{0});
+                this->randomize(this->z_frame(op.a), nw);
+                break;
+            case OpKind::depolarize: {
+                this->sample_bernoulli(op.probability, flip_01);
+                Word* x = this->x_frame(op.a);
+                Word* z = this->z_frame(op.a);
+                std::uniform_int_distribution<int> sample_pauli(1, 3);
+                for (size_type i = 0; i < nw; ++i)
+                {
+                    for (Word m = flip_01[i]; m; m &= m - 1)
+                    {
+                        // 1, 2, 3 for X, Z, Y
+                        Word const bit = m & (~m + 1);
+                        int const pauli = sample_pauli(rng_);
+                        x[i] ^= (pauli & 1) ? bit : 0;
+                        z[i] ^= (pauli & 2) ? bit : 0;
+                    }
+                }
+                break;
+            }
+            default:
+                QIREE_ASSERT_UNREACHABLE();
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Set each bit of a batch independently with a probability.
+ *
+ * Rare events skip to the next set bit with a geometric distribution, so
+ * small error probabilities cost little more than clearing the words.
+ */
+void PauliFrameQuantum::sample_bernoulli(double probability, Word* result)
+{
+    size_type const nw = options_.batch_words;
+    if (probability >= 1)
+    {
+        std::fill_n(result, nw, ~Word{0});
+        return;
+    }
+    std::fill_n(result, nw, Word{0});
+    if (probability <= 0)
+    {
+        return;
+    }
+    std::geometric_distribution<size_type> sample_skip(probability);
+    size_type const num_bits = 64 * nw;
+    for (size_type i = 0; i < num_bits; ++i)
+    {
+        size_type const skip = sample_skip(rng_);
+        if (skip >= num_bits - i)
+        {
+            break;
+        }
+        i += skip;
+        result[i / 64] |= Word{1} << (i % 64);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Fill words with uniformly random bits.
+ */
+void PauliFrameQuantum::randomize(Word* result, size_type num_words)
+{
+    std::generate_n(result, num_words, [this] { return rng_(); });
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,245 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/PauliFrameQuantum.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "qiree/Macros.hh"
+#include "qiree/QuantumNotImpl.hh"
+#include "qiree/Types.hh"
+
+#include "NoiseModel.hh"
+#include "StabilizerQuantum.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Measurement results of many shots packed one bit per shot.
+ *
+ * The results are stored result-major: the outcome of shot \em s for result
+ * \em r is bit <em>s</em> % 64 of word
+ * <em>r</em> * \c words_per_result + <em>s</em> / 64. Bits past the last shot
+ * are zero.
+ */
+struct MeasurementRecord
+{
+    using Word = std::uint64_t;
+
+    size_type num_shots{0};
+    size_type num_results{0};
+    size_type words_per_result{0};
+    std::vector<Word> bits;
+
+    //! Outcome of a result in a shot
+    bool get(size_type shot, size_type result) const
+    {
+        return (bits[result * words_per_result + shot / 64] >> (shot % 64))
+               & 1;
+    }
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Sample many shots of a noisy Clifford program by propagating Pauli frames.
+ *
+ * An execution of the program records its Clifford operations while a
+ * stabilizer tableau simulates them without noise to obtain one \em reference
+ * sample of its measurements. Shots are then sampled in batches of
+ * 64 × \c batch_words without executing the program again: each shot tracks
+ * the Pauli error (its \em frame) by which its state differs from the
+ * reference, and since Clifford gates map Paulis to Paulis, propagating a
+ * frame through a gate is a few bitwise operations. The frames of a batch are
+ * packed one bit per shot, so every operation updates 64 shots per word in
+ * vectorizable loops.
+ *
+ * A measurement outcome is the reference outcome flipped if the frame
+ * anticommutes with the measured observable. Frames start with random Z
+ * components, and a measurement randomizes the component that doesn't affect
+ * its eigenstates, which makes outcomes that are random in the reference
+ * random in each shot. Depolarizing noise after gates inserts random Paulis
+ * into the frames, and readout errors flip the recorded Z outcomes. Amplitude
+ * damping is not a Pauli channel and is rejected.
+ *
+ * The program's operations must not depend on its measurement results: once a
+ * result is read, the first batch is sampled and further operations are
+ * errors. The runtime reads the results of the first sampled shot, and
+ * \c next_shot moves to the following shot as with
+ * \c StateVectorQuantum::resample . Alternatively, \c sample produces the
+ * results of any number of shots in packed form.
+ */
+class PauliFrameQuantum final : virtual public QuantumNotImpl
+{
+  public:
+    //! Construction options
+    struct Options
+    {
+        //! Seed for the reference sample and frame sampling
+        std::uint64_t seed{std::mt19937_64::default_seed};
+        //! Maximum number of qubits
+        size_type max_qubits{1 << 16};
+        //! Number of 64-bit words of shots propagated together
+        size_type batch_words{4};
+        //! Errors applied after gates and measurements
+        NoiseModel noise;
+    };
+
+    using Word = std::uint64_t;
+
+  public:
+    // Construct with default options
+    PauliFrameQuantum();
+
+    // Construct with options
+    explicit PauliFrameQuantum(Options const& opts);
+
+    QIREE_DELETE_COPY_MOVE(PauliFrameQuantum);
+
+    //!@{
+    //! \name Accessors
+    size_type num_qubits() const { return num_qubits_; }
+    size_type num_results() const { return reference_.num_results(); }
+    size_type num_operations() const { return ops_.size(); }
+    Options const& options() const { return options_; }
+    //!@}
+
+    //! Number of shots propagated together
+    size_type batch_size() const { return 64 * options_.batch_words; }
+
+    // Reseed the random number generators
+    void seed(std::uint64_t value);
+
+    // Sample the measurement results of many shots
+    void sample(size_type num_shots, MeasurementRecord& result);
+
+    // Make the results of the next shot available to read
+    void next_shot();
+
+    //!@{
+    //! \name Quantum interface
+    void set_up(EntryPointAttrs const&) final;
+    void tear_down() final;
+    //!@}
+
+    //!@{
+    //! \name Measurements
+    Result m(Qubit) final;
+    Result measure(Array, Array) final;
+    Result mresetz(Qubit) final;
+    void mz(Qubit, Result) final;
+    QState read_result(Result) final;
+    //!@}
+
+    //!@{
+    //! \name Clifford gates
+    void cnot(Qubit, Qubit) final;
+    void cx(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
+    void cz(Qubit, Qubit) final;
+    void h(Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    void reset(Qubit) final;
+    void rx(double, Qubit) final;
+    void ry(double, Qubit) final;
+    void rz(double, Qubit) final;
+    void s_adj(Qubit) final;
+    void s(Qubit) final;
+    void swap(Qubit, Qubit) final;
+    void x(Qubit) final;
+    void x(Array, Qubit) final;
+    void y(Qubit) final;
+    void y(Array, Qubit) final;
+    void z(Qubit) final;
+    void z(Array, Qubit) final;
+    //!@}
+
+    //!@{
+    //! \name Non-Clifford gates
+    void ccx(Qubit, Qubit, Qubit) final;
+    void h(Array, Qubit) final;
+    void s(Array, Qubit) final;
+    void s_adj(Array, Qubit) final;
+    void t_adj(Qubit) final;
+    void t(Qubit) final;
+    void t(Array, Qubit) final;
+    void t_adj(Array, Qubit) final;
+    //!@}
+
+    using QuantumNotImpl::r;
+    using QuantumNotImpl::r_adj;
+    using QuantumNotImpl::rx;
+    using QuantumNotImpl::ry;
+    using QuantumNotImpl::rz;
+
+  private:
+    //! Frame update of a recorded operation
+    enum class OpKind : std::uint8_t
+    {
+        h,  //!< Exchange X and Z components
+        s,  //!< Z ^= X (phase gate or Z quarter turn)
+        sx,  //!< X ^= Z (X quarter turn)
+        cnot,
+        cz,
+        swap,
+        measure_z,  //!< Record the X component and randomize Z
+        measure_pauli,  //!< Record the anticommutation with a Pauli string
+        reset,  //!< Clear X and randomize Z
+        depolarize,  //!< Insert random Paulis
+    };
+
+    //! Recorded operation
+    struct Op
+    {
+        OpKind kind;
+        bool reference{false};  //!< Reference outcome of a measurement
+        size_type a{0};  //!< Qubit, or start of a measured Pauli string
+        size_type b{0};  //!< Qubit, or length of a measured Pauli string
+        size_type result{0};  //!< Measured result
+        double probability{0};  //!< Depolarizing probability
+    };
+
+    Options options_;
+    StabilizerQuantum reference_;
+    std::mt19937_64 rng_;
+    size_type num_qubits_{0};
+
+    // Recorded program
+    std::vector<Op> ops_;
+    std::vector<std::pair<size_type, Pauli>> pauli_pool_;
+
+    // Frames and measurement records of the current batch
+    std::vector<Word> x_;
+    std::vector<Word> z_;
+    std::vector<Word> record_;
+    std::vector<Word> mask_;
+    bool sampled_{false};
+    size_type shot_{0};
+
+    // Scratch space for reading QIR arrays
+    std::vector<Qubit> qubit_buf_;
+    std::vector<Pauli> pauli_buf_;
+
+    size_type index(Qubit q) const;
+    Word* x_frame(size_type q) { return x_.data() + q * options_.batch_words; }
+    Word* z_frame(size_type q) { return z_.data() + q * options_.batch_words; }
+    void record(Op const& op);
+    void noise(std::string_view gate, size_type a);
+    void noise(std::string_view gate, size_type a, size_type b);
+    void record_rotation(Pauli p, int turns, size_type a);
+    void record_measure_z(size_type a, Result r);
+    void sample_batch();
+    void sample_bernoulli(double probability, Word* result);
+    void randomize(Word* result, size_type num_words);
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
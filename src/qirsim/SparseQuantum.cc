@@ -0,0 +1,717 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/SparseQuantum.cc
+//---------------------------------------------------------------------------//
+#include "SparseQuantum.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "qiree/Assert.hh"
+
+#include "detail/BitUtils.hh"
+#include "detail/QirArgs.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+using Complex = SparseQuantum::Complex;
+
+constexpr double sqrt_half = 0.70710678118654752440;
+constexpr Complex imag{0, 1};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Phase of a Pauli string acting on a basis state.
+ */
+Complex pauli_phase(detail::PauliString const& p, std::uint64_t k)
+{
+    static Complex const powers[] = {1, imag, -1, -imag};
+    int n = detail::popcount(p.x & p.z) + 2 * detail::parity(k & p.z);
+    return powers[n % 4];
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with default options.
+ */
+SparseQuantum::SparseQuantum() : SparseQuantum{Options{}} {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with options.
+ */
+SparseQuantum::SparseQuantum(Options const& opts)
+    : options_{opts}, rng_{opts.seed}
+{
+    QIREE_VALIDATE(options_.max_qubits < 64,
+                   << "sparse simulator is limited to 63 qubits");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Reseed the random number generator.
+ */
+void SparseQuantum::seed(std::uint64_t value)
+{
+    rng_.seed(value);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Amplitude of a basis state.
+ */
+auto SparseQuantum::amplitude(Key index) const -> Complex
+{
+    return state_.find(index);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Probability of measuring a qubit in |1> without collapsing the state.
+ */
+double SparseQuantum::probability_one(Qubit q) const
+{
+    auto bit = QubitMask{1} << this->index(q);
+    double total{0};
+    double one{0};
+    state_.for_each([&](Key k, Complex a) {
+        total += std::norm(a);
+        if (k & bit)
+        {
+            one += std::norm(a);
+        }
+    });
+    return one / total;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare the all-zero state for an entry point.
+ */
+void SparseQuantum::set_up(EntryPointAttrs const& attrs)
+{
+    QIREE_VALIDATE(attrs.required_num_qubits <= options_.max_qubits,
+                   << "entry point requires " << attrs.required_num_qubits
+                   << " qubits but the sparse simulator is limited to "
+                   << options_.max_qubits);
+
+    num_qubits_ = attrs.required_num_qubits;
+    state_.clear();
+    state_[0] = 1;
+    peak_support_ = 1;
+    results_.assign(attrs.required_num_results, QState::zero);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete an execution.
+ *
+ * The state and results are kept for inspection until the next set-up.
+ */
+void SparseQuantum::tear_down() {}
+
+//---------------------------------------------------------------------------//
+// MEASUREMENTS
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis into a new result.
+ */
+Result SparseQuantum::m(Qubit q)
+{
+    return this->push_result(this->sample(q));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a joint Pauli observable into a new result.
+ *
+ * The result is zero for the +1 eigenvalue.
+ */
+Result SparseQuantum::measure(Array paulis, Array qubits)
+{
+    auto p = detail::pauli_string(
+        paulis, qubits, num_qubits_, pauli_buf_, qubit_buf_);
+
+    // <psi|P|psi> only has contributions from pairs of stored states
+    double total{0};
+    Complex expectation{0};
+    state_.for_each([&](Key k, Complex a) {
+        total += std::norm(a);
+        expectation += std::conj(state_.find(k ^ p.x)) * pauli_phase(p, k)
+                       * a;
+    });
+    double const prob_minus
+        = std::clamp(0.5 * (1 - expectation.real() / total), 0.0, 1.0);
+    std::uniform_real_distribution<double> sample_uniform;
+    bool const minus = sample_uniform(rng_) < prob_minus;
+
+    // Project onto the eigenspace with (1 +- P) / 2 and renormalize
+    this->apply_pauli_sum(p, 0.5, minus ? -0.5 : 0.5, 0, "measure.body");
+    this->normalize();
+    return this->push_result(minus ? QState::one : QState::zero);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a new result and reset it.
+ */
+Result SparseQuantum::mresetz(Qubit q)
+{
+    auto result = this->sample(q);
+    if (result == QState::one)
+    {
+        this->apply_x(this->index(q), 0);
+    }
+    return this->push_result(result);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis and store the result.
+ */
+void SparseQuantum::mz(Qubit q, Result r)
+{
+    if (r.value >= results_.size())
+    {
+        results_.resize(r.value + 1, QState::zero);
+    }
+    results_[r.value] = this->sample(q);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the value of a measured result.
+ */
+QState SparseQuantum::read_result(Result r)
+{
+    QIREE_VALIDATE(r.value < results_.size(),
+                   << "result " << r.value << " is out of range");
+    return results_[r.value];
+}
+
+//---------------------------------------------------------------------------//
+// GATES
+//---------------------------------------------------------------------------//
+
+void SparseQuantum::ccx(Qubit c1, Qubit c2, Qubit t)
+{
+    QIREE_VALIDATE(c1.value != c2.value, << "duplicate control qubit");
+    auto mask = (QubitMask{1} << this->index(c1))
+                | (QubitMask{1} << this->index(c2));
+    QIREE_VALIDATE(!(mask & (QubitMask{1} << this->index(t))),
+                   << "target is also a control qubit");
+    this->apply_x(this->index(t), mask);
+}
+
+void SparseQuantum::cnot(Qubit c, Qubit t)
+{
+    QIREE_VALIDATE(c.value != t.value, << "target is also a control qubit");
+    this->apply_x(this->index(t), QubitMask{1} << this->index(c));
+}
+
+void SparseQuantum::cx(Qubit c, Qubit t)
+{
+    this->cnot(c, t);
+}
+
+void SparseQuantum::cy(Qubit c, Qubit t)
+{
+    QIREE_VALIDATE(c.value != t.value, << "target is also a control qubit");
+    this->apply(
+        {0, -imag, imag, 0}, t, QubitMask{1} << this->index(c), "cy.body");
+}
+
+void SparseQuantum::cz(Qubit c, Qubit t)
+{
+    QIREE_VALIDATE(c.value != t.value, << "target is also a control qubit");
+    this->apply_diagonal(1, -1, t, QubitMask{1} << this->index(c));
+}
+
+//! Apply exp(-i theta P)
+void SparseQuantum::exp_adj(Array paulis, double theta, Array qubits)
+{
+    auto p = detail::pauli_string(
+        paulis, qubits, num_qubits_, pauli_buf_, qubit_buf_);
+    this->rotate(p, 2 * theta, 0, "exp.adj");
+}
+
+//! Apply exp(i theta P)
+void SparseQuantum::exp(Array paulis, double theta, Array qubits)
+{
+    auto p = detail::pauli_string(
+        paulis, qubits, num_qubits_, pauli_buf_, qubit_buf_);
+    this->rotate(p, -2 * theta, 0, "exp.body");
+}
+
+void SparseQuantum::exp(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<detail::ExpArgs>(args);
+    auto p = detail::pauli_string(
+        a.paulis, a.qubits, num_qubits_, pauli_buf_, qubit_buf_);
+    auto mask = detail::read_controls(ctls, num_qubits_, qubit_buf_);
+    QIREE_VALIDATE(!(mask & (p.x | p.z)), << "target is also a control qubit");
+    this->rotate(p, -2 * a.theta, mask, "exp.ctl");
+}
+
+void SparseQuantum::exp_adj(Array ctls, Tuple args)
+{
+    auto a = detail::tuple_args<detail::ExpArgs>(args);
+    a.theta = -a.theta;
+    this->exp(ctls, &a);
+}
+
+void SparseQuantum::h(Qubit q)
+{
+    this->apply({sqrt_half, sqrt_half, sqrt_half, -sqrt_half}, q, 0, "h.body");
+}
+
+void SparseQuantum::h(Array ctls, Qubit q)
+{
+    this->apply({sqrt_half, sqrt_half, sqrt_half, -sqrt_half},
+                q,
+                detail::control_mask(ctls, q, num_qubits_, qubit_buf_),
+                "h.ctl");
+}
+
+void SparseQuantum::r_adj(Pauli p, double theta, Qubit q)
+{
+    PauliString ps;
+    ps.push_back(p, this->index(q));
+    this->rotate(ps, -theta, 0, "r.adj");
+}
+
+//! Apply exp(-i theta/2 P), which is a global phase for the identity
+void SparseQuantum::r(Pauli p, double theta, Qubit q)
+{
+    PauliString ps;
+    ps.push_back(p, this->index(q));
+    this->rotate(ps, theta, 0, "r.body");
+}
+
+void SparseQuantum::r(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<detail::PauliRotationArgs>(args);
+    PauliString ps;
+    ps.push_back(a.pauli, this->index(a.qubit));
+    auto mask = detail::control_mask(ctls, a.qubit, num_qubits_, qubit_buf_);
+    this->rotate(ps, a.theta, mask, "r.ctl");
+}
+
+void SparseQuantum::r_adj(Array ctls, Tuple args)
+{
+    auto a = detail::tuple_args<detail::PauliRotationArgs>(args);
+    a.theta = -a.theta;
+    this->r(ctls, &a);
+}
+
+//! Reset a qubit to |0> by measuring it
+void SparseQuantum::reset(Qubit q)
+{
+    if (this->sample(q) == QState::one)
+    {
+        this->apply_x(this->index(q), 0);
+    }
+}
+
+void SparseQuantum::rx(double theta, Qubit q)
+{
+    Complex c = std::cos(theta / 2);
+    Complex s = -imag * std::sin(theta / 2);
+    this->apply({c, s, s, c}, q, 0, "rx.body");
+}
+
+void SparseQuantum::rx(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    Complex c = std::cos(a.theta / 2);
+    Complex s = -imag * std::sin(a.theta / 2);
+    auto mask = detail::control_mask(ctls, a.qubit, num_qubits_, qubit_buf_);
+    this->apply({c, s, s, c}, a.qubit, mask, "rx.ctl");
+}
+
+void SparseQuantum::rxx(double theta, Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in rxx");
+    PauliString ps;
+    ps.push_back(Pauli::x, this->index(q1));
+    ps.push_back(Pauli::x, this->index(q2));
+    this->rotate(ps, theta, 0, "rxx.body");
+}
+
+void SparseQuantum::ry(double theta, Qubit q)
+{
+    double c = std::cos(theta / 2);
+    double s = std::sin(theta / 2);
+    this->apply({c, -s, s, c}, q, 0, "ry.body");
+}
+
+void SparseQuantum::ry(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    double c = std::cos(a.theta / 2);
+    double s = std::sin(a.theta / 2);
+    auto mask = detail::control_mask(ctls, a.qubit, num_qubits_, qubit_buf_);
+    this->apply({c, -s, s, c}, a.qubit, mask, "ry.ctl");
+}
+
+void SparseQuantum::ryy(double theta, Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in ryy");
+    PauliString ps;
+    ps.push_back(Pauli::y, this->index(q1));
+    ps.push_back(Pauli::y, this->index(q2));
+    this->rotate(ps, theta, 0, "ryy.body");
+}
+
+void SparseQuantum::rz(double theta, Qubit q)
+{
+    this->apply_diagonal(
+        std::polar(1.0, -theta / 2), std::polar(1.0, theta / 2), q, 0);
+}
+
+void SparseQuantum::rz(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    auto mask = detail::control_mask(ctls, a.qubit, num_qubits_, qubit_buf_);
+    this->apply_diagonal(std::polar(1.0, -a.theta / 2),
+                         std::polar(1.0, a.theta / 2),
+                         a.qubit,
+                         mask);
+}
+
+void SparseQuantum::rzz(double theta, Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in rzz");
+    PauliString ps;
+    ps.push_back(Pauli::z, this->index(q1));
+    ps.push_back(Pauli::z, this->index(q2));
+    this->rotate(ps, theta, 0, "rzz.body");
+}
+
+void SparseQuantum::s_adj(Qubit q)
+{
+    this->apply_diagonal(1, -imag, q, 0);
+}
+
+void SparseQuantum::s(Qubit q)
+{
+    this->apply_diagonal(1, imag, q, 0);
+}
+
+void SparseQuantum::s(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, imag, q, mask);
+}
+
+void SparseQuantum::s_adj(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, -imag, q, mask);
+}
+
+void SparseQuantum::swap(Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in swap");
+    auto a = QubitMask{1} << this->index(q1);
+    auto b = QubitMask{1} << this->index(q2);
+    this->permute([a, b](Key k) {
+        return (!(k & a) != !(k & b)) ? k ^ (a | b) : k;
+    });
+}
+
+void SparseQuantum::t_adj(Qubit q)
+{
+    this->apply_diagonal(1, Complex{sqrt_half, -sqrt_half}, q, 0);
+}
+
+void SparseQuantum::t(Qubit q)
+{
+    this->apply_diagonal(1, Complex{sqrt_half, sqrt_half}, q, 0);
+}
+
+void SparseQuantum::t(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, Complex{sqrt_half, sqrt_half}, q, mask);
+}
+
+void SparseQuantum::t_adj(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, Complex{sqrt_half, -sqrt_half}, q, mask);
+}
+
+void SparseQuantum::x(Qubit q)
+{
+    this->apply_x(this->index(q), 0);
+}
+
+void SparseQuantum::x(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_x(this->index(q), mask);
+}
+
+void SparseQuantum::y(Qubit q)
+{
+    this->apply({0, -imag, imag, 0}, q, 0, "y.body");
+}
+
+void SparseQuantum::y(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply({0, -imag, imag, 0}, q, mask, "y.ctl");
+}
+
+void SparseQuantum::z(Qubit q)
+{
+    this->apply_diagonal(1, -1, q, 0);
+}
+
+void SparseQuantum::z(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, -1, q, mask);
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the bit index of a qubit.
+ */
+size_type SparseQuantum::index(Qubit q) const
+{
+    return detail::qubit_index(q, num_qubits_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a single-qubit unitary.
+ *
+ * Each stored amplitude contributes to the basis states of the matrix
+ * column it selects, skipping zero entries so that permutation-like gates
+ * don't grow the support.
+ */
+void SparseQuantum::apply(Matrix2 const& m,
+                          Qubit target,
+                          QubitMask controls,
+                          char const* instr)
+{
+    auto bit = QubitMask{1} << this->index(target);
+    this->transform(
+        [&](Key k, Complex a) {
+            if ((k & controls) != controls)
+            {
+                next_[k] += a;
+                return;
+            }
+            size_type const col = (k & bit) ? 1 : 0;
+            if (m[col] != Complex{0})
+            {
+                next_[k & ~bit] += m[col] * a;
+            }
+            if (m[2 + col] != Complex{0})
+            {
+                next_[k | bit] += m[2 + col] * a;
+            }
+        },
+        instr);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a diagonal single-qubit unitary in place.
+ */
+void SparseQuantum::apply_diagonal(Complex d0,
+                                   Complex d1,
+                                   Qubit target,
+                                   QubitMask controls)
+{
+    auto bit = QubitMask{1} << this->index(target);
+    state_.for_each([&](Key k, Complex& a) {
+        if ((k & controls) == controls)
+        {
+            a *= (k & bit) ? d1 : d0;
+        }
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a (multiply controlled) X gate.
+ */
+void SparseQuantum::apply_x(size_type target, QubitMask controls)
+{
+    auto bit = QubitMask{1} << target;
+    this->permute([bit, controls](Key k) {
+        return (k & controls) == controls ? k ^ bit : k;
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Replace the state with alpha * psi + beta * P psi.
+ *
+ * A diagonal Pauli string whose factors \f$ \alpha \pm \beta \f$ are both
+ * nonzero is applied in place.
+ */
+void SparseQuantum::apply_pauli_sum(PauliString const& p,
+                                    Complex alpha,
+                                    Complex beta,
+                                    QubitMask controls,
+                                    char const* instr)
+{
+    if (p.x == 0 && alpha + beta != Complex{0} && alpha - beta != Complex{0})
+    {
+        state_.for_each([&](Key k, Complex& a) {
+            if ((k & controls) == controls)
+            {
+                a *= alpha + beta * pauli_phase(p, k);
+            }
+        });
+        return;
+    }
+
+    this->transform(
+        [&](Key k, Complex a) {
+            if ((k & controls) != controls)
+            {
+                next_[k] += a;
+                return;
+            }
+            if (alpha != Complex{0})
+            {
+                next_[k] += alpha * a;
+            }
+            if (beta != Complex{0})
+            {
+                next_[k ^ p.x] += beta * pauli_phase(p, k) * a;
+            }
+        },
+        instr);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply exp(-i theta/2 P).
+ */
+void SparseQuantum::rotate(PauliString const& p,
+                           double theta,
+                           QubitMask controls,
+                           char const* instr)
+{
+    this->apply_pauli_sum(p,
+                          std::cos(theta / 2),
+                          -imag * std::sin(theta / 2),
+                          controls,
+                          instr);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Build the next state from the stored amplitudes and replace the current
+ * one.
+ *
+ * The scatter function accumulates the contributions of a basis state and
+ * its amplitude into \c next_ . Amplitudes that cancel are dropped, and the
+ * support is checked against the limit.
+ */
+template<class F>
+void SparseQuantum::transform(F&& scatter, char const* instr)
+{
+    next_.clear();
+    next_.reserve(state_.size());
+    state_.for_each(scatter);
+
+    state_.clear();
+    double const threshold = options_.prune_threshold;
+    next_.for_each([this, threshold](Key k, Complex a) {
+        if (std::norm(a) > threshold)
+        {
+            state_[k] = a;
+        }
+    });
+
+    peak_support_ = std::max(peak_support_, state_.size());
+    QIREE_VALIDATE(state_.size() <= options_.max_support,
+                   << "sparse state has " << state_.size()
+                   << " nonzero amplitudes after quantum instruction '"
+                   << instr << "', exceeding the limit of "
+                   << options_.max_support
+                   << " (use the statevector or mps backend for programs "
+                      "with dense superpositions)");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Move each amplitude to a new basis state.
+ *
+ * The map must be a bijection, so the support is unchanged.
+ */
+template<class F>
+void SparseQuantum::permute(F&& map)
+{
+    next_.clear();
+    next_.reserve(state_.size());
+    state_.for_each([this, &map](Key k, Complex a) { next_[map(k)] = a; });
+    std::swap(state_, next_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Rescale the state to unit norm.
+ */
+void SparseQuantum::normalize()
+{
+    double total{0};
+    state_.for_each([&total](Key, Complex a) { total += std::norm(a); });
+    double const factor = 1 / std::sqrt(total);
+    state_.for_each([factor](Key, Complex& a) { a *= factor; });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Sample a Z-basis measurement and collapse the state.
+ */
+QState SparseQuantum::sample(Qubit q)
+{
+    auto bit = QubitMask{1} << this->index(q);
+    double const prob_one = std::clamp(this->probability_one(q), 0.0, 1.0);
+    std::uniform_real_distribution<double> sample_uniform;
+    bool const one = sample_uniform(rng_) < prob_one;
+
+    this->transform(
+        [&](Key k, Complex a) {
+            if (static_cast<bool>(k & bit) == one)
+            {
+                next_[k] = a;
+            }
+        },
+        "mz.body");
+    this->normalize();
+    return one ? QState::one : QState::zero;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Store a measurement in a new result.
+ */
+Result SparseQuantum::push_result(QState value)
+{
+    return detail::push_result(value, results_);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,197 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/SparseQuantum.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "qiree/Macros.hh"
+#include "qiree/QuantumNotImpl.hh"
+#include "qiree/Types.hh"
+
+#include "detail/AmplitudeMap.hh"
+#include "detail/StateVectorKernels.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Simulate QIR programs by storing only the nonzero amplitudes.
+ *
+ * Oracles and other programs on many qubits often keep a handful of basis
+ * states in superposition. This simulator stores the amplitudes of those
+ * states in an open-addressing hash map keyed by the basis state index (bit
+ * \em i is qubit \em i), so memory and time scale with the number of nonzero
+ * amplitudes (the \em support) rather than \f$ 2^n \f$, for up to 63 qubits.
+ *
+ * Diagonal gates scale amplitudes in place. Other gates build a new map by
+ * scattering each amplitude to the one or two basis states it contributes
+ * to, dropping amplitudes whose squared magnitude falls below a threshold so
+ * that cancellations shrink the support. If the support grows past a limit,
+ * the operation raises a \c RuntimeError suggesting a dense simulator.
+ *
+ * Like \c StateVectorQuantum , measurements are sampled as they occur and
+ * each execution is one shot.
+ */
+class SparseQuantum final : virtual public QuantumNotImpl
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using Complex = detail::Complex;
+    using Key = detail::AmplitudeMap::Key;
+    //!@}
+
+    //! Construction options
+    struct Options
+    {
+        //! Seed for measurement sampling
+        std::uint64_t seed{std::mt19937_64::default_seed};
+        //! Maximum number of qubits
+        size_type max_qubits{63};
+        //! Maximum number of nonzero amplitudes
+        size_type max_support{size_type{1} << 24};
+        //! Squared magnitude below which amplitudes are dropped
+        double prune_threshold{1e-24};
+    };
+
+  public:
+    // Construct with default options
+    SparseQuantum();
+
+    // Construct with options
+    explicit SparseQuantum(Options const& opts);
+
+    QIREE_DELETE_COPY_MOVE(SparseQuantum);
+
+    //!@{
+    //! \name Accessors
+    size_type num_qubits() const { return num_qubits_; }
+    size_type num_results() const { return results_.size(); }
+    Options const& options() const { return options_; }
+    //! Number of nonzero amplitudes
+    size_type support() const { return state_.size(); }
+    //! Largest support during the current execution
+    size_type peak_support() const { return peak_support_; }
+    //!@}
+
+    // Reseed the random number generator
+    void seed(std::uint64_t value);
+
+    // Amplitude of a basis state
+    Complex amplitude(Key index) const;
+
+    // Probability of measuring a qubit in |1> without collapsing the state
+    double probability_one(Qubit) const;
+
+    //!@{
+    //! \name Quantum interface
+    void set_up(EntryPointAttrs const&) final;
+    void tear_down() final;
+    //!@}
+
+    //!@{
+    //! \name Measurements
+    Result m(Qubit) final;
+    Result measure(Array, Array) final;
+    Result mresetz(Qubit) final;
+    void mz(Qubit, Result) final;
+    QState read_result(Result) final;
+    //!@}
+
+    //!@{
+    //! \name Gates
+    void ccx(Qubit, Qubit, Qubit) final;
+    void cnot(Qubit, Qubit) final;
+    void cx(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
+    void cz(Qubit, Qubit) final;
+    void exp_adj(Array, double, Array) final;
+    void exp(Array, double, Array) final;
+    void exp(Array, Tuple) final;
+    void exp_adj(Array, Tuple) final;
+    void h(Qubit) final;
+    void h(Array, Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    void r(Array, Tuple) final;
+    void r_adj(Array, Tuple) final;
+    void reset(Qubit) final;
+    void rx(double, Qubit) final;
+    void rx(Array, Tuple) final;
+    void rxx(double, Qubit, Qubit) final;
+    void ry(double, Qubit) final;
+    void ry(Array, Tuple) final;
+    void ryy(double, Qubit, Qubit) final;
+    void rz(double, Qubit) final;
+    void rz(Array, Tuple) final;
+    void rzz(double, Qubit, Qubit) final;
+    void s_adj(Qubit) final;
+    void s(Qubit) final;
+    void s(Array, Qubit) final;
+    void s_adj(Array, Qubit) final;
+    void swap(Qubit, Qubit) final;
+    void t_adj(Qubit) final;
+    void t(Qubit) final;
+    void t(Array, Qubit) final;
+    void t_adj(Array, Qubit) final;
+    void x(Qubit) final;
+    void x(Array, Qubit) final;
+    void y(Qubit) final;
+    void y(Array, Qubit) final;
+    void z(Qubit) final;
+    void z(Array, Qubit) final;
+    //!@}
+
+  private:
+    using QubitMask = detail::QubitMask;
+    using Matrix2 = detail::Matrix2;
+    using PauliString = detail::PauliString;
+
+    Options options_;
+    std::mt19937_64 rng_;
+    size_type num_qubits_{0};
+    size_type peak_support_{0};
+    detail::AmplitudeMap state_;
+    detail::AmplitudeMap next_;
+    std::vector<QState> results_;
+
+    // Scratch space for reading QIR arrays
+    std::vector<Qubit> qubit_buf_;
+    std::vector<Pauli> pauli_buf_;
+
+    size_type index(Qubit q) const;
+
+    void apply(Matrix2 const& m,
+               Qubit target,
+               QubitMask controls,
+               char const* instr);
+    void
+    apply_diagonal(Complex d0, Complex d1, Qubit target, QubitMask controls);
+    void apply_x(size_type target, QubitMask controls);
+    void apply_pauli_sum(PauliString const& p,
+                         Complex alpha,
+                         Complex beta,
+                         QubitMask controls,
+                         char const* instr);
+    void rotate(PauliString const& p,
+                double theta,
+                QubitMask controls,
+                char const* instr);
+    template<class F>
+    void transform(F&& scatter, char const* instr);
+    template<class F>
+    void permute(F&& map);
+    void normalize();
+    QState sample(Qubit);
+    Result push_result(QState);
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,727 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/StabilizerQuantum.cc
+//---------------------------------------------------------------------------//
+#include "StabilizerQuantum.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "qiree_config.h"
+
+#include "qiree/Assert.hh"
+
+#include "detail/BitUtils.hh"
+#include "detail/CliffordUtils.hh"
+#include "detail/QirArgs.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+using Word = std::uint64_t;
+using detail::quarter_turns;
+using detail::validate_clifford;
+
+// Minimum number of qubits to multiply generators in parallel
+constexpr size_type parallel_threshold = 512;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Multiply a Pauli string into another, returning the phase exponent.
+ *
+ * The result is the power of \em i (mod 4) from multiplying the unsigned
+ * operators on each qubit, and the destination is replaced by the product.
+ */
+QIRSIM_TARGET_CLONES int multiply_pauli(Word const* src_x,
+                                        Word const* src_z,
+                                        Word* dst_x,
+                                        Word* dst_z,
+                                        size_type num_words)
+{
+    int result = 0;
+    for (size_type j = 0; j < num_words; ++j)
+    {
+        Word const x1 = src_x[j];
+        Word const z1 = src_z[j];
+        Word const x2 = dst_x[j];
+        Word const z2 = dst_z[j];
+        // Y*Z, X*Y, Z*X give +i; Y*X, X*Z, Z*Y give -i
+        Word const plus = (x1 & z1 & ~x2 & z2) | (x1 & ~z1 & x2 & z2)
+                          | (~x1 & z1 & x2 & ~z2);
+        Word const minus = (x1 & z1 & x2 & ~z2) | (x1 & ~z1 & ~x2 & z2)
+                           | (~x1 & z1 & x2 & z2);
+        result += detail::popcount(plus) - detail::popcount(minus);
+        dst_x[j] = x1 ^ x2;
+        dst_z[j] = z1 ^ z2;
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with default options.
+ */
+StabilizerQuantum::StabilizerQuantum() : StabilizerQuantum{Options{}} {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with options.
+ */
+StabilizerQuantum::StabilizerQuantum(Options const& opts)
+    : options_{opts}, rng_{opts.seed}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Reseed the random number generator.
+ */
+void StabilizerQuantum::seed(std::uint64_t value)
+{
+    rng_.seed(value);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a stabilizer generator as a signed Pauli string, e.g. "+XZ".
+ *
+ * Character \em j after the sign is the operator on qubit \em j .
+ */
+std::string StabilizerQuantum::stabilizer(size_type i) const
+{
+    QIREE_EXPECT(i < num_qubits_);
+    size_type const row = num_qubits_ + i;
+    std::string result(1, sign_[row] ? '-' : '+');
+    for (size_type j = 0; j < num_qubits_; ++j)
+    {
+        Word const mask = Word{1} << (j % 64);
+        bool const x = x_row(row)[j / 64] & mask;
+        bool const z = z_row(row)[j / 64] & mask;
+        result.push_back(x ? (z ? 'Y' : 'X') : (z ? 'Z' : 'I'));
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare the all-zero state for an entry point.
+ */
+void StabilizerQuantum::set_up(EntryPointAttrs const& attrs)
+{
+    QIREE_VALIDATE(attrs.required_num_qubits <= options_.max_qubits,
+                   << "entry point requires " << attrs.required_num_qubits
+                   << " qubits but the stabilizer simulator is limited to "
+                   << options_.max_qubits);
+
+    num_qubits_ = attrs.required_num_qubits;
+    num_words_ = (num_qubits_ + 63) / 64;
+    size_type const num_rows = 2 * num_qubits_ + 1;
+    x_.assign(num_rows * num_words_, 0);
+    z_.assign(num_rows * num_words_, 0);
+    sign_.assign(num_rows, 0);
+    for (size_type i = 0; i < num_qubits_; ++i)
+    {
+        x_row(i)[i / 64] = Word{1} << (i % 64);
+        z_row(num_qubits_ + i)[i / 64] = Word{1} << (i % 64);
+    }
+    results_.assign(attrs.required_num_results, QState::zero);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete an execution.
+ */
+void StabilizerQuantum::tear_down() {}
+
+//---------------------------------------------------------------------------//
+// MEASUREMENTS
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis into a new result.
+ */
+Result StabilizerQuantum::m(Qubit q)
+{
+    return this->push_result(this->measure_z(this->index(q)));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a joint Pauli observable into a new result.
+ *
+ * The observable is rotated to a Z string and its parity computed onto one
+ * qubit, which is measured before undoing the rotation.
+ */
+Result StabilizerQuantum::measure(Array paulis, Array qubits)
+{
+    detail::read_paulis(paulis, pauli_buf_);
+    detail::read_qubits(qubits, qubit_buf_);
+    QIREE_VALIDATE(pauli_buf_.size() == qubit_buf_.size(),
+                   << "mismatched Pauli and qubit array sizes ("
+                   << pauli_buf_.size() << " != " << qubit_buf_.size()
+                   << ")");
+
+    std::vector<std::pair<size_type, Pauli>> targets;
+    for (size_type i = 0; i < qubit_buf_.size(); ++i)
+    {
+        auto a = this->index(qubit_buf_[i]);
+        QIREE_VALIDATE(std::none_of(targets.begin(),
+                                    targets.end(),
+                                    [a](auto const& t) { return t.first == a; }),
+                       << "duplicate qubit " << a << " in Pauli string");
+        if (pauli_buf_[i] != Pauli::i)
+        {
+            targets.push_back({a, pauli_buf_[i]});
+        }
+    }
+    if (targets.empty())
+    {
+        return this->push_result(QState::zero);
+    }
+
+    for (auto [a, p] : targets)
+    {
+        if (p == Pauli::y)
+        {
+            this->apply_s_adj(a);
+        }
+        if (p != Pauli::z)
+        {
+            this->apply_h(a);
+        }
+    }
+    size_type const last = targets.back().first;
+    for (size_type i = 0; i + 1 < targets.size(); ++i)
+    {
+        this->apply_cnot(targets[i].first, last);
+    }
+    auto result = this->measure_z(last);
+    for (size_type i = 0; i + 1 < targets.size(); ++i)
+    {
+        this->apply_cnot(targets[i].first, last);
+    }
+    for (auto [a, p] : targets)
+    {
+        if (p != Pauli::z)
+        {
+            this->apply_h(a);
+        }
+        if (p == Pauli::y)
+        {
+            this->apply_s(a);
+        }
+    }
+    return this->push_result(result);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a new result and reset it.
+ */
+Result StabilizerQuantum::mresetz(Qubit q)
+{
+    auto a = this->index(q);
+    auto result = this->measure_z(a);
+    if (result == QState::one)
+    {
+        this->apply_pauli(a, Pauli::x);
+    }
+    return this->push_result(result);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis and store the result.
+ */
+void StabilizerQuantum::mz(Qubit q, Result r)
+{
+    if (r.value >= results_.size())
+    {
+        results_.resize(r.value + 1, QState::zero);
+    }
+    results_[r.value] = this->measure_z(this->index(q));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the value of a measured result.
+ */
+QState StabilizerQuantum::read_result(Result r)
+{
+    QIREE_VALIDATE(r.value < results_.size(),
+                   << "result " << r.value << " is out of range");
+    return results_[r.value];
+}
+
+//---------------------------------------------------------------------------//
+// CLIFFORD GATES
+//---------------------------------------------------------------------------//
+
+void StabilizerQuantum::cnot(Qubit c, Qubit t)
+{
+    QIREE_VALIDATE(c.value != t.value, << "target is also a control qubit");
+    this->apply_cnot(this->index(c), this->index(t));
+}
+
+void StabilizerQuantum::cx(Qubit c, Qubit t)
+{
+    this->cnot(c, t);
+}
+
+//! CY = S CX S^dagger
+void StabilizerQuantum::cy(Qubit c, Qubit t)
+{
+    QIREE_VALIDATE(c.value != t.value, << "target is also a control qubit");
+    auto b = this->index(t);
+    this->apply_s_adj(b);
+    this->apply_cnot(this->index(c), b);
+    this->apply_s(b);
+}
+
+void StabilizerQuantum::cz(Qubit c, Qubit t)
+{
+    QIREE_VALIDATE(c.value != t.value, << "target is also a control qubit");
+    this->apply_cz(this->index(c), this->index(t));
+}
+
+void StabilizerQuantum::h(Qubit q)
+{
+    this->apply_h(this->index(q));
+}
+
+void StabilizerQuantum::r_adj(Pauli p, double theta, Qubit q)
+{
+    this->r(p, -theta, q);
+}
+
+void StabilizerQuantum::r(Pauli p, double theta, Qubit q)
+{
+    validate_clifford(quarter_turns(theta) >= 0, "r.body");
+    this->apply_rotation(p, theta, this->index(q));
+}
+
+void StabilizerQuantum::reset(Qubit q)
+{
+    auto a = this->index(q);
+    if (this->measure_z(a) == QState::one)
+    {
+        this->apply_pauli(a, Pauli::x);
+    }
+}
+
+void StabilizerQuantum::rx(double theta, Qubit q)
+{
+    validate_clifford(quarter_turns(theta) >= 0, "rx.body");
+    this->apply_rotation(Pauli::x, theta, this->index(q));
+}
+
+void StabilizerQuantum::ry(double theta, Qubit q)
+{
+    validate_clifford(quarter_turns(theta) >= 0, "ry.body");
+    this->apply_rotation(Pauli::y, theta, this->index(q));
+}
+
+void StabilizerQuantum::rz(double theta, Qubit q)
+{
+    validate_clifford(quarter_turns(theta) >= 0, "rz.body");
+    this->apply_rotation(Pauli::z, theta, this->index(q));
+}
+
+void StabilizerQuantum::s_adj(Qubit q)
+{
+    this->apply_s_adj(this->index(q));
+}
+
+void StabilizerQuantum::s(Qubit q)
+{
+    this->apply_s(this->index(q));
+}
+
+//! Exchange the tableau columns of two qubits
+void StabilizerQuantum::swap(Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in swap");
+    auto a = this->index(q1);
+    auto b = this->index(q2);
+    Word const mask_a = Word{1} << (a % 64);
+    Word const mask_b = Word{1} << (b % 64);
+    for (auto* bits : {&x_, &z_})
+    {
+        for (size_type row = 0; row < 2 * num_qubits_; ++row)
+        {
+            Word* w = bits->data() + row * num_words_;
+            bool const bit_a = w[a / 64] & mask_a;
+            bool const bit_b = w[b / 64] & mask_b;
+            if (bit_a != bit_b)
+            {
+                w[a / 64] ^= mask_a;
+                w[b / 64] ^= mask_b;
+            }
+        }
+    }
+}
+
+void StabilizerQuantum::x(Qubit q)
+{
+    this->apply_pauli(this->index(q), Pauli::x);
+}
+
+void StabilizerQuantum::x(Array ctls, Qubit q)
+{
+    detail::read_qubits(ctls, qubit_buf_);
+    validate_clifford(qubit_buf_.size() <= 1, "x.ctl");
+    if (qubit_buf_.empty())
+    {
+        return this->x(q);
+    }
+    this->cnot(qubit_buf_.front(), q);
+}
+
+void StabilizerQuantum::y(Qubit q)
+{
+    this->apply_pauli(this->index(q), Pauli::y);
+}
+
+void StabilizerQuantum::y(Array ctls, Qubit q)
+{
+    detail::read_qubits(ctls, qubit_buf_);
+    validate_clifford(qubit_buf_.size() <= 1, "y.ctl");
+    if (qubit_buf_.empty())
+    {
+        return this->y(q);
+    }
+    this->cy(qubit_buf_.front(), q);
+}
+
+void StabilizerQuantum::z(Qubit q)
+{
+    this->apply_pauli(this->index(q), Pauli::z);
+}
+
+void StabilizerQuantum::z(Array ctls, Qubit q)
+{
+    detail::read_qubits(ctls, qubit_buf_);
+    validate_clifford(qubit_buf_.size() <= 1, "z.ctl");
+    if (qubit_buf_.empty())
+    {
+        return this->z(q);
+    }
+    this->cz(qubit_buf_.front(), q);
+}
+
+//---------------------------------------------------------------------------//
+// NON-CLIFFORD GATES
+//---------------------------------------------------------------------------//
+
+void StabilizerQuantum::ccx(Qubit, Qubit, Qubit)
+{
+    validate_clifford(false, "ccx.body");
+}
+
+void StabilizerQuantum::h(Array, Qubit)
+{
+    validate_clifford(false, "h.ctl");
+}
+
+void StabilizerQuantum::s(Array, Qubit)
+{
+    validate_clifford(false, "s.ctl");
+}
+
+void StabilizerQuantum::s_adj(Array, Qubit)
+{
+    validate_clifford(false, "s.ctladj");
+}
+
+void StabilizerQuantum::t_adj(Qubit)
+{
+    validate_clifford(false, "t.adj");
+}
+
+void StabilizerQuantum::t(Qubit)
+{
+    validate_clifford(false, "t.body");
+}
+
+void StabilizerQuantum::t(Array, Qubit)
+{
+    validate_clifford(false, "t.ctl");
+}
+
+void StabilizerQuantum::t_adj(Array, Qubit)
+{
+    validate_clifford(false, "t.ctladj");
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the column index of a qubit.
+ */
+size_type StabilizerQuantum::index(Qubit q) const
+{
+    return detail::qubit_index(q, num_qubits_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Conjugate by a Hadamard: X <-> Z, Y -> -Y.
+ */
+void StabilizerQuantum::apply_h(size_type a)
+{
+    size_type const w = a / 64;
+    Word const mask = Word{1} << (a % 64);
+    for (size_type row = 0; row < 2 * num_qubits_; ++row)
+    {
+        Word& x = x_row(row)[w];
+        Word& z = z_row(row)[w];
+        bool const xa = x & mask;
+        bool const za = z & mask;
+        sign_[row] ^= xa & za;
+        if (xa != za)
+        {
+            x ^= mask;
+            z ^= mask;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Conjugate by a phase gate: X -> Y, Y -> -X.
+ */
+void StabilizerQuantum::apply_s(size_type a)
+{
+    size_type const w = a / 64;
+    Word const mask = Word{1} << (a % 64);
+    for (size_type row = 0; row < 2 * num_qubits_; ++row)
+    {
+        Word const x = x_row(row)[w] & mask;
+        Word& z = z_row(row)[w];
+        sign_[row] ^= (x && (z & mask));
+        z ^= x;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Conjugate by an inverse phase gate: X -> -Y, Y -> X.
+ */
+void StabilizerQuantum::apply_s_adj(size_type a)
+{
+    size_type const w = a / 64;
+    Word const mask = Word{1} << (a % 64);
+    for (size_type row = 0; row < 2 * num_qubits_; ++row)
+    {
+        Word const x = x_row(row)[w] & mask;
+        Word& z = z_row(row)[w];
+        sign_[row] ^= (x && !(z & mask));
+        z ^= x;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Conjugate by a controlled NOT.
+ */
+void StabilizerQuantum::apply_cnot(size_type control, size_type target)
+{
+    size_type const wc = control / 64;
+    size_type const wt = target / 64;
+    Word const mc = Word{1} << (control % 64);
+    Word const mt = Word{1} << (target % 64);
+    for (size_type row = 0; row < 2 * num_qubits_; ++row)
+    {
+        Word* x = x_row(row);
+        Word* z = z_row(row);
+        bool const xc = x[wc] & mc;
+        bool const zc = z[wc] & mc;
+        bool const xt = x[wt] & mt;
+        bool const zt = z[wt] & mt;
+        sign_[row] ^= xc & zt & (xt == zc);
+        if (xc)
+        {
+            x[wt] ^= mt;
+        }
+        if (zt)
+        {
+            z[wc] ^= mc;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Conjugate by a controlled Z.
+ */
+void StabilizerQuantum::apply_cz(size_type control, size_type target)
+{
+    this->apply_h(target);
+    this->apply_cnot(control, target);
+    this->apply_h(target);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Conjugate by a Pauli operator, which flips anticommuting generators.
+ */
+void StabilizerQuantum::apply_pauli(size_type a, Pauli p)
+{
+    size_type const w = a / 64;
+    Word const mask = Word{1} << (a % 64);
+    // Z anticommutes with X components, X with Z components, Y with both
+    bool const check_x = (p == Pauli::z || p == Pauli::y);
+    bool const check_z = (p == Pauli::x || p == Pauli::y);
+    for (size_type row = 0; row < 2 * num_qubits_; ++row)
+    {
+        bool const x = x_row(row)[w] & mask;
+        bool const z = z_row(row)[w] & mask;
+        sign_[row] ^= (check_x && x) != (check_z && z);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply exp(-i theta/2 P) for a multiple of pi/2, up to a global phase.
+ */
+void StabilizerQuantum::apply_rotation(Pauli p, double theta, size_type a)
+{
+    int const turns = quarter_turns(theta);
+    QIREE_ASSERT(turns >= 0);
+    if (p == Pauli::i || turns == 0)
+    {
+        return;
+    }
+    if (turns == 2)
+    {
+        // Rotation by pi is the Pauli operator
+        return this->apply_pauli(a, p);
+    }
+
+    // Rotate the axis to Z, apply S or S^dagger, and rotate back
+    if (p == Pauli::y)
+    {
+        this->apply_s_adj(a);
+    }
+    if (p != Pauli::z)
+    {
+        this->apply_h(a);
+    }
+    if (turns == 1)
+    {
+        this->apply_s(a);
+    }
+    else
+    {
+        this->apply_s_adj(a);
+    }
+    if (p != Pauli::z)
+    {
+        this->apply_h(a);
+    }
+    if (p == Pauli::y)
+    {
+        this->apply_s(a);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis and update the tableau.
+ */
+QState StabilizerQuantum::measure_z(size_type a)
+{
+    size_type const n = num_qubits_;
+    size_type const w = a / 64;
+    Word const mask = Word{1} << (a % 64);
+    auto has_x = [&](size_type row) { return (x_row(row)[w] & mask) != 0; };
+
+    // Find a stabilizer that anticommutes with Z_a
+    size_type p = n;
+    while (p < 2 * n && !has_x(p))
+    {
+        ++p;
+    }
+
+    if (p == 2 * n)
+    {
+        // Outcome is determined: accumulate the product of the stabilizers
+        // that correspond to destabilizers anticommuting with Z_a
+        size_type const scratch = 2 * n;
+        std::fill_n(x_row(scratch), num_words_, Word{0});
+        std::fill_n(z_row(scratch), num_words_, Word{0});
+        sign_[scratch] = 0;
+        for (size_type i = 0; i < n; ++i)
+        {
+            if (has_x(i))
+            {
+                this->rowsum(scratch, i + n);
+            }
+        }
+        return sign_[scratch] ? QState::one : QState::zero;
+    }
+
+    // Outcome is random: make all other generators commute with Z_a. The
+    // destabilizer paired with the stabilizer is skipped since it anticommutes
+    // with it and is overwritten below.
+    auto const num_rows = static_cast<std::int64_t>(2 * n);
+#if QIREE_USE_OpenMP
+#    pragma omp parallel for schedule(static) if (n >= parallel_threshold)
+#endif
+    for (std::int64_t i = 0; i < num_rows; ++i)
+    {
+        auto row = static_cast<size_type>(i);
+        if (row != p && row != p - n && has_x(row))
+        {
+            this->rowsum(row, p);
+        }
+    }
+
+    // Replace the destabilizer with the old stabilizer, and the stabilizer
+    // with +-Z_a
+    std::copy_n(x_row(p), num_words_, x_row(p - n));
+    std::copy_n(z_row(p), num_words_, z_row(p - n));
+    sign_[p - n] = sign_[p];
+    std::fill_n(x_row(p), num_words_, Word{0});
+    std::fill_n(z_row(p), num_words_, Word{0});
+    z_row(p)[w] = mask;
+
+    std::uniform_int_distribution<int> sample_bit(0, 1);
+    sign_[p] = static_cast<std::uint8_t>(sample_bit(rng_));
+    return sign_[p] ? QState::one : QState::zero;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Multiply generator \c src into \c dst, tracking the sign.
+ */
+void StabilizerQuantum::rowsum(size_type dst, size_type src)
+{
+    int phase = multiply_pauli(
+        x_row(src), z_row(src), x_row(dst), z_row(dst), num_words_);
+    phase += 2 * (sign_[dst] + sign_[src]);
+    phase = ((phase % 4) + 4) % 4;
+    QIREE_ASSERT(phase == 0 || phase == 2);
+    sign_[dst] = (phase == 2);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Store a measurement in a new result.
+ */
+Result StabilizerQuantum::push_result(QState value)
+{
+    return detail::push_result(value, results_);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,824 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/StateVectorQuantum.cc
+//---------------------------------------------------------------------------//
+#include "StateVectorQuantum.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "qiree/Assert.hh"
+
+#include "detail/QirArgs.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+using Complex = StateVectorQuantum::Complex;
+
+constexpr double sqrt_half = 0.70710678118654752440;
+constexpr Complex imag{0, 1};
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with default options.
+ */
+StateVectorQuantum::StateVectorQuantum() : StateVectorQuantum{Options{}} {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with options.
+ */
+StateVectorQuantum::StateVectorQuantum(Options const& opts)
+    : options_{opts}, rng_{opts.seed}
+{
+    QIREE_VALIDATE(options_.max_qubits < 64,
+                   << "state vector simulator is limited to 63 qubits");
+    QIREE_VALIDATE(options_.fusion_qubits <= detail::max_dense_qubits,
+                   << "fused gates are limited to " << detail::max_dense_qubits
+                   << " qubits");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Reseed the random number generator.
+ */
+void StateVectorQuantum::seed(std::uint64_t value)
+{
+    rng_.seed(value);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Probability of measuring a qubit in |1> without collapsing the state.
+ */
+double StateVectorQuantum::probability_one(Qubit q) const
+{
+    return detail::probability_one(
+        {const_cast<Complex*>(state_.data()), state_.size()}, this->index(q));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record Z measurements and sample them when results are read.
+ *
+ * While enabled, \c mz leaves the state unchanged, so the program must not
+ * apply any operation after its first measurement. All deferred results are
+ * sampled together from the state when one of them is first read.
+ */
+void StateVectorQuantum::defer_measurements(bool value)
+{
+    defer_ = value;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Sample new values for deferred measurements from the current state.
+ *
+ * The cumulative distribution of the state is built once per execution, so
+ * each additional shot costs a binary search and a short scan.
+ */
+void StateVectorQuantum::resample()
+{
+    if (!sampler_)
+    {
+        sampler_ = detail::BasisSampler{this->ref()};
+    }
+    size_type const index = sampler_(rng_);
+    for (auto const& [r, target] : deferred_)
+    {
+        results_[r.value] = (index >> target) & 1 ? QState::one : QState::zero;
+    }
+    stale_ = false;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute subsequent shots as branches of a measurement tree.
+ *
+ * Call \c next_branch before each execution until it returns false. Each
+ * execution represents \c branch_shots identical shots.
+ */
+void StateVectorQuantum::start_branching(size_type num_shots)
+{
+    QIREE_VALIDATE(!defer_,
+                   << "cannot branch on measurements that are deferred");
+    branching_ = true;
+    enumerate_ = false;
+    pending_.clear();
+    current_ = {};
+    replay_length_ = 0;
+    num_replayed_ = 0;
+    if (num_shots > 0)
+    {
+        Branch root;
+        root.num_shots = num_shots;
+        pending_.push_back(std::move(root));
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute subsequent shots as every branch of the measurement tree.
+ *
+ * Call \c next_branch before each execution until it returns false. Each
+ * execution has a distinct sequence of measurement outcomes, and occurs with
+ * probability \c branch_probability . Branches whose probability is no more
+ * than the threshold are skipped, and their total probability is accumulated
+ * in \c pruned_probability . This includes the branch being executed: if its
+ * probability drops to the threshold, the rest of the execution is not
+ * simulated and its probability becomes zero. Outcomes with a conditional
+ * probability below \f$10^{-12}\f$ are attributed to round-off and also
+ * skipped.
+ */
+void StateVectorQuantum::start_enumeration(double prune_threshold)
+{
+    QIREE_VALIDATE(prune_threshold >= 0 && prune_threshold < 1,
+                   << "invalid pruning threshold " << prune_threshold);
+    this->start_branching(1);
+    enumerate_ = true;
+    prune_threshold_ = prune_threshold;
+    pruned_probability_ = 0;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare the next pending branch, returning false when all are done.
+ *
+ * Branches are executed depth first, so the number of saved states is at most
+ * the number of measurements in a shot.
+ */
+bool StateVectorQuantum::next_branch()
+{
+    QIREE_VALIDATE(num_replayed_ == replay_length_,
+                   << "execution ended after replaying " << num_replayed_
+                   << " of " << replay_length_
+                   << " measurements: the program must be deterministic "
+                      "given its measurement outcomes");
+    if (pending_.empty())
+    {
+        branching_ = false;
+        enumerate_ = false;
+        current_ = {};
+        replay_length_ = 0;
+        num_replayed_ = 0;
+        return false;
+    }
+
+    current_ = std::move(pending_.back());
+    pending_.pop_back();
+    replay_length_ = current_.outcomes.size();
+    num_replayed_ = 0;
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply the operations of a circuit with gate fusion.
+ *
+ * Consecutive gates on at most \c Options::fusion_qubits qubits are
+ * multiplied into dense operators that are applied in one sweep of the
+ * state. Measurements and resets are applied as their QIR instructions
+ * would be, so they may be deferred or branch, and Pauli measurements store
+ * their result at the index recorded in the circuit. Gates are skipped
+ * while replaying a branch, as for individual instructions.
+ */
+void StateVectorQuantum::apply(Circuit const& circuit)
+{
+    QIREE_VALIDATE(circuit.num_qubits() <= num_qubits_,
+                   << "circuit requires " << circuit.num_qubits()
+                   << " qubits but the entry point has " << num_qubits_);
+
+    if (state_.empty())
+    {
+        detail::fuse_gates(circuit, 0, &fused_);
+    }
+    else if (options_.fusion_qubits == 0)
+    {
+        detail::fuse_gates_min_cost(circuit, num_qubits_, &fused_);
+    }
+    else
+    {
+        detail::fuse_gates(circuit, options_.fusion_qubits, &fused_);
+    }
+
+    for (auto const& step : fused_.steps)
+    {
+        if (step.num_qubits > 0)
+        {
+            detail::apply_dense(this->ref(),
+                                fused_.qubits.data() + step.qubit_offset,
+                                step.num_qubits,
+                                fused_.matrices.data() + step.matrix_offset);
+            continue;
+        }
+
+        auto const op = circuit[step.begin];
+        Qubit const q{op.targets[0]};
+        switch (op.op)
+        {
+            case GateOp::measure_z:
+                this->mz(q, op.result);
+                break;
+            case GateOp::measure_pauli: {
+                PauliString p;
+                for (size_type k = 0; k < op.num_targets; ++k)
+                {
+                    p.push_back(op.paulis[k], op.targets[k]);
+                }
+                if (op.result.value >= results_.size())
+                {
+                    results_.resize(op.result.value + 1, QState::zero);
+                }
+                results_[op.result.value] = this->sample(p);
+                break;
+            }
+            case GateOp::reset:
+                this->reset(q);
+                break;
+            default:
+                detail::apply_operation(this->ref(), op);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare the all-zero state for an entry point.
+ */
+void StateVectorQuantum::set_up(EntryPointAttrs const& attrs)
+{
+    QIREE_VALIDATE(attrs.required_num_qubits <= options_.max_qubits,
+                   << "entry point requires " << attrs.required_num_qubits
+                   << " qubits but the state vector simulator is limited to "
+                   << options_.max_qubits);
+
+    num_qubits_ = attrs.required_num_qubits;
+    if (num_replayed_ < replay_length_)
+    {
+        // Skip gates until the saved state is restored
+        state_.clear();
+    }
+    else
+    {
+        state_.assign(size_type{1} << num_qubits_, Complex{0});
+        state_.front() = 1;
+    }
+    results_.assign(attrs.required_num_results, QState::zero);
+    stale_ = false;
+    deferred_.clear();
+    sampler_ = {};
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete an execution.
+ *
+ * The state and results are kept for inspection until the next set-up.
+ */
+void StateVectorQuantum::tear_down() {}
+
+//---------------------------------------------------------------------------//
+// MEASUREMENTS
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis into a new result.
+ */
+Result StateVectorQuantum::m(Qubit q)
+{
+    return this->push_result(this->sample(q));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a joint Pauli observable into a new result.
+ *
+ * The result is zero for the +1 eigenvalue.
+ */
+Result StateVectorQuantum::measure(Array paulis, Array qubits)
+{
+    auto p = detail::pauli_string(
+        paulis, qubits, num_qubits_, pauli_buf_, qubit_buf_);
+    return this->push_result(this->sample(p));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a new result and reset it.
+ */
+Result StateVectorQuantum::mresetz(Qubit q)
+{
+    auto result = this->sample(q);
+    if (result == QState::one)
+    {
+        detail::apply_x(this->ref(), this->index(q), 0);
+    }
+    return this->push_result(result);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit in the Z basis and store the result.
+ */
+void StateVectorQuantum::mz(Qubit q, Result r)
+{
+    if (r.value >= results_.size())
+    {
+        results_.resize(r.value + 1, QState::zero);
+    }
+    if (defer_)
+    {
+        deferred_.push_back({r, this->index(q)});
+        stale_ = true;
+        return;
+    }
+    results_[r.value] = this->sample(q);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the value of a measured result.
+ */
+QState StateVectorQuantum::read_result(Result r)
+{
+    QIREE_VALIDATE(r.value < results_.size(),
+                   << "result " << r.value << " is out of range");
+    if (stale_)
+    {
+        this->resample();
+    }
+    return results_[r.value];
+}
+
+//---------------------------------------------------------------------------//
+// GATES
+//---------------------------------------------------------------------------//
+
+void StateVectorQuantum::ccx(Qubit c1, Qubit c2, Qubit t)
+{
+    QIREE_VALIDATE(c1.value != c2.value, << "duplicate control qubit");
+    auto mask = (QubitMask{1} << this->index(c1))
+                | (QubitMask{1} << this->index(c2));
+    QIREE_VALIDATE(!(mask & (QubitMask{1} << this->index(t))),
+                   << "target is also a control qubit");
+    detail::apply_x(this->ref(), this->index(t), mask);
+}
+
+void StateVectorQuantum::cnot(Qubit c, Qubit t)
+{
+    QIREE_VALIDATE(c.value != t.value, << "target is also a control qubit");
+    detail::apply_x(
+        this->ref(), this->index(t), QubitMask{1} << this->index(c));
+}
+
+void StateVectorQuantum::cx(Qubit c, Qubit t)
+{
+    this->cnot(c, t);
+}
+
+void StateVectorQuantum::cy(Qubit c, Qubit t)
+{
+    QIREE_VALIDATE(c.value != t.value, << "target is also a control qubit");
+    this->apply({0, -imag, imag, 0}, t, QubitMask{1} << this->index(c));
+}
+
+void StateVectorQuantum::cz(Qubit c, Qubit t)
+{
+    QIREE_VALIDATE(c.value != t.value, << "target is also a control qubit");
+    this->apply_diagonal(1, -1, t, QubitMask{1} << this->index(c));
+}
+
+//! Apply exp(-i theta P)
+void StateVectorQuantum::exp_adj(Array paulis, double theta, Array qubits)
+{
+    this->exp(paulis, -theta, qubits);
+}
+
+//! Apply exp(i theta P)
+void StateVectorQuantum::exp(Array paulis, double theta, Array qubits)
+{
+    auto p = detail::pauli_string(
+        paulis, qubits, num_qubits_, pauli_buf_, qubit_buf_);
+    this->rotate(p, -2 * theta, 0);
+}
+
+void StateVectorQuantum::exp(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<detail::ExpArgs>(args);
+    auto p = detail::pauli_string(
+        a.paulis, a.qubits, num_qubits_, pauli_buf_, qubit_buf_);
+    auto mask = detail::read_controls(ctls, num_qubits_, qubit_buf_);
+    QIREE_VALIDATE(!(mask & (p.x | p.z)), << "target is also a control qubit");
+    this->rotate(p, -2 * a.theta, mask);
+}
+
+void StateVectorQuantum::exp_adj(Array ctls, Tuple args)
+{
+    auto a = detail::tuple_args<detail::ExpArgs>(args);
+    a.theta = -a.theta;
+    this->exp(ctls, &a);
+}
+
+void StateVectorQuantum::h(Qubit q)
+{
+    this->apply({sqrt_half, sqrt_half, sqrt_half, -sqrt_half}, q, 0);
+}
+
+void StateVectorQuantum::h(Array ctls, Qubit q)
+{
+    this->apply({sqrt_half, sqrt_half, sqrt_half, -sqrt_half},
+                q,
+                detail::control_mask(ctls, q, num_qubits_, qubit_buf_));
+}
+
+void StateVectorQuantum::r_adj(Pauli p, double theta, Qubit q)
+{
+    this->r(p, -theta, q);
+}
+
+//! Apply exp(-i theta/2 P), which is a global phase for the identity
+void StateVectorQuantum::r(Pauli p, double theta, Qubit q)
+{
+    PauliString ps;
+    ps.push_back(p, this->index(q));
+    this->rotate(ps, theta, 0);
+}
+
+void StateVectorQuantum::r(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<detail::PauliRotationArgs>(args);
+    PauliString ps;
+    ps.push_back(a.pauli, this->index(a.qubit));
+    auto mask = detail::control_mask(ctls, a.qubit, num_qubits_, qubit_buf_);
+    this->rotate(ps, a.theta, mask);
+}
+
+void StateVectorQuantum::r_adj(Array ctls, Tuple args)
+{
+    auto a = detail::tuple_args<detail::PauliRotationArgs>(args);
+    a.theta = -a.theta;
+    this->r(ctls, &a);
+}
+
+//! Reset a qubit to |0> by measuring it
+void StateVectorQuantum::reset(Qubit q)
+{
+    if (this->sample(q) == QState::one)
+    {
+        detail::apply_x(this->ref(), this->index(q), 0);
+    }
+}
+
+void StateVectorQuantum::rx(double theta, Qubit q)
+{
+    Complex c = std::cos(theta / 2);
+    Complex s = -imag * std::sin(theta / 2);
+    this->apply({c, s, s, c}, q, 0);
+}
+
+void StateVectorQuantum::rx(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    Complex c = std::cos(a.theta / 2);
+    Complex s = -imag * std::sin(a.theta / 2);
+    auto mask = detail::control_mask(ctls, a.qubit, num_qubits_, qubit_buf_);
+    this->apply({c, s, s, c}, a.qubit, mask);
+}
+
+void StateVectorQuantum::rxx(double theta, Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in rxx");
+    PauliString ps;
+    ps.push_back(Pauli::x, this->index(q1));
+    ps.push_back(Pauli::x, this->index(q2));
+    this->rotate(ps, theta, 0);
+}
+
+void StateVectorQuantum::ry(double theta, Qubit q)
+{
+    double c = std::cos(theta / 2);
+    double s = std::sin(theta / 2);
+    this->apply({c, -s, s, c}, q, 0);
+}
+
+void StateVectorQuantum::ry(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    double c = std::cos(a.theta / 2);
+    double s = std::sin(a.theta / 2);
+    auto mask = detail::control_mask(ctls, a.qubit, num_qubits_, qubit_buf_);
+    this->apply({c, -s, s, c}, a.qubit, mask);
+}
+
+void StateVectorQuantum::ryy(double theta, Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in ryy");
+    PauliString ps;
+    ps.push_back(Pauli::y, this->index(q1));
+    ps.push_back(Pauli::y, this->index(q2));
+    this->rotate(ps, theta, 0);
+}
+
+void StateVectorQuantum::rz(double theta, Qubit q)
+{
+    this->apply_diagonal(
+        std::polar(1.0, -theta / 2), std::polar(1.0, theta / 2), q, 0);
+}
+
+void StateVectorQuantum::rz(Array ctls, Tuple args)
+{
+    auto const& a = detail::tuple_args<RotationArgs>(args);
+    auto mask = detail::control_mask(ctls, a.qubit, num_qubits_, qubit_buf_);
+    this->apply_diagonal(std::polar(1.0, -a.theta / 2),
+                         std::polar(1.0, a.theta / 2),
+                         a.qubit,
+                         mask);
+}
+
+void StateVectorQuantum::rzz(double theta, Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in rzz");
+    PauliString ps;
+    ps.push_back(Pauli::z, this->index(q1));
+    ps.push_back(Pauli::z, this->index(q2));
+    this->rotate(ps, theta, 0);
+}
+
+void StateVectorQuantum::s_adj(Qubit q)
+{
+    this->apply_diagonal(1, -imag, q, 0);
+}
+
+void StateVectorQuantum::s(Qubit q)
+{
+    this->apply_diagonal(1, imag, q, 0);
+}
+
+void StateVectorQuantum::s(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, imag, q, mask);
+}
+
+void StateVectorQuantum::s_adj(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, -imag, q, mask);
+}
+
+void StateVectorQuantum::swap(Qubit q1, Qubit q2)
+{
+    QIREE_VALIDATE(q1.value != q2.value, << "duplicate qubit in swap");
+    detail::apply_swap(this->ref(), this->index(q1), this->index(q2), 0);
+}
+
+void StateVectorQuantum::t_adj(Qubit q)
+{
+    this->apply_diagonal(1, Complex{sqrt_half, -sqrt_half}, q, 0);
+}
+
+void StateVectorQuantum::t(Qubit q)
+{
+    this->apply_diagonal(1, Complex{sqrt_half, sqrt_half}, q, 0);
+}
+
+void StateVectorQuantum::t(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, Complex{sqrt_half, sqrt_half}, q, mask);
+}
+
+void StateVectorQuantum::t_adj(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, Complex{sqrt_half, -sqrt_half}, q, mask);
+}
+
+void StateVectorQuantum::x(Qubit q)
+{
+    detail::apply_x(this->ref(), this->index(q), 0);
+}
+
+void StateVectorQuantum::x(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    detail::apply_x(this->ref(), this->index(q), mask);
+}
+
+void StateVectorQuantum::y(Qubit q)
+{
+    this->apply({0, -imag, imag, 0}, q, 0);
+}
+
+void StateVectorQuantum::y(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply({0, -imag, imag, 0}, q, mask);
+}
+
+void StateVectorQuantum::z(Qubit q)
+{
+    this->apply_diagonal(1, -1, q, 0);
+}
+
+void StateVectorQuantum::z(Array ctls, Qubit q)
+{
+    auto mask = detail::control_mask(ctls, q, num_qubits_, qubit_buf_);
+    this->apply_diagonal(1, -1, q, mask);
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the bit index of a qubit.
+ */
+size_type StateVectorQuantum::index(Qubit q) const
+{
+    return detail::qubit_index(q, num_qubits_);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a single-qubit unitary.
+ */
+void StateVectorQuantum::apply(Matrix2 const& m,
+                               Qubit target,
+                               QubitMask controls)
+{
+    detail::apply_matrix(this->ref(), this->index(target), m, controls);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a diagonal single-qubit unitary.
+ */
+void StateVectorQuantum::apply_diagonal(Complex d0,
+                                        Complex d1,
+                                        Qubit target,
+                                        QubitMask controls)
+{
+    detail::apply_diagonal(this->ref(), this->index(target), d0, d1, controls);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply exp(-i theta/2 P).
+ */
+void StateVectorQuantum::rotate(PauliString const& p,
+                                double theta,
+                                QubitMask controls)
+{
+    detail::apply_pauli_sum(this->ref(),
+                            p,
+                            std::cos(theta / 2),
+                            -imag * std::sin(theta / 2),
+                            controls);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Sample a Z-basis measurement and collapse the state.
+ */
+QState StateVectorQuantum::sample(Qubit q)
+{
+    auto target = this->index(q);
+    bool const one = this->choose(
+        [&] { return detail::probability_one(this->ref(), target); },
+        [target](detail::StateRef psi, bool one, double probability) {
+            detail::collapse(psi, target, one, probability);
+        });
+    return one ? QState::one : QState::zero;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Sample a joint Pauli measurement and collapse the state.
+ *
+ * The outcome is one for the -1 eigenvalue.
+ */
+QState StateVectorQuantum::sample(PauliString const& p)
+{
+    bool const minus = this->choose(
+        [&] { return 0.5 * (1 - detail::pauli_expectation(this->ref(), p)); },
+        [&p](detail::StateRef psi, bool minus, double probability) {
+            // Project onto the eigenspace with (1 +- P) / 2 and renormalize
+            detail::apply_pauli_sum(psi, p, 0.5, minus ? -0.5 : 0.5, 0);
+            detail::scale(psi, 1 / std::sqrt(probability));
+        });
+    return minus ? QState::one : QState::zero;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Choose a measurement outcome and collapse the state.
+ *
+ * The probability function is only called if the state is being simulated,
+ * and the collapse function projects a state onto an outcome with the given
+ * probability. While replaying a branch, the recorded outcome is returned
+ * and the saved state is restored after the last one. While branching, the
+ * shots of the current branch are divided between the outcomes, or when
+ * enumerating, both outcomes are explored unless they are unlikely. A pruned
+ * branch clears the state so that the rest of its execution is skipped.
+ */
+template<class P, class C>
+bool StateVectorQuantum::choose(P&& get_prob_one, C&& collapse)
+{
+    if (num_replayed_ < replay_length_)
+    {
+        bool const one = current_.outcomes[num_replayed_++];
+        if (num_replayed_ == replay_length_)
+        {
+            state_ = std::move(current_.state);
+        }
+        return one;
+    }
+    if (branching_ && state_.empty())
+    {
+        // Branch was pruned
+        return false;
+    }
+
+    double const prob_one = std::clamp(get_prob_one(), 0.0, 1.0);
+    bool one{false};
+    if (!branching_)
+    {
+        std::uniform_real_distribution<double> sample_uniform;
+        one = sample_uniform(rng_) < prob_one;
+    }
+    else
+    {
+        // Continue with the more likely outcome and save the other
+        Branch other;
+        bool save{false};
+        if (enumerate_)
+        {
+            one = prob_one > 0.5;
+        }
+        else
+        {
+            std::binomial_distribution<size_type> sample_binomial{
+                current_.num_shots, prob_one};
+            size_type const num_one = sample_binomial(rng_);
+            one = 2 * num_one > current_.num_shots;
+            other.num_shots = one ? current_.num_shots - num_one : num_one;
+            current_.num_shots -= other.num_shots;
+            save = other.num_shots > 0;
+        }
+        other.probability = current_.probability
+                            * (one ? 1 - prob_one : prob_one);
+        if (enumerate_)
+        {
+            // Also skip outcomes that are only possible due to round-off
+            constexpr double roundoff = 1e-12;
+            save = other.probability > prune_threshold_
+                   && std::min(prob_one, 1 - prob_one) > roundoff;
+            if (!save)
+            {
+                pruned_probability_ += other.probability;
+            }
+        }
+        if (save)
+        {
+            other.outcomes = current_.outcomes;
+            other.outcomes.push_back(!one);
+            other.state = state_;
+            collapse(detail::StateRef{other.state.data(), other.state.size()},
+                     !one,
+                     one ? 1 - prob_one : prob_one);
+            pending_.push_back(std::move(other));
+        }
+        current_.outcomes.push_back(one);
+        current_.probability *= one ? prob_one : 1 - prob_one;
+        if (enumerate_ && current_.probability <= prune_threshold_)
+        {
+            // Abandon the rest of this branch too
+            pruned_probability_ += current_.probability;
+            current_.probability = 0;
+            state_.clear();
+            return one;
+        }
+    }
+    collapse(this->ref(), one, one ? prob_one : 1 - prob_one);
+    return one;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Store a measurement in a new result.
+ */
+Result StateVectorQuantum::push_result(QState value)
+{
+    return detail::push_result(value, results_);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
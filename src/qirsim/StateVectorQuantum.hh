@@ -0,0 +1,258 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/StateVectorQuantum.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "qiree/Circuit.hh"
+#include "qiree/Macros.hh"
+#include "qiree/QuantumNotImpl.hh"
+#include "qiree/Types.hh"
+
+#include "detail/BasisSampler.hh"
+#include "detail/GateFusion.hh"
+#include "detail/StateVectorKernels.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Simulate QIR instructions on a dense state vector.
+ *
+ * Each call to \c set_up prepares the all-zero state for the number of qubits
+ * required by the entry point, and gates are applied immediately. Measurements
+ * sample from the state (using the simulator's random number generator) and
+ * collapse it, so one execution corresponds to one shot; the result values are
+ * available to the runtime through \c read_result .
+ *
+ * If a program's only measurements are \c mz at the end (see
+ * \c Module::has_terminal_measurements ), deferred measurement lets many shots
+ * be drawn from a single execution: \c mz then records which qubit each
+ * result measures without collapsing the state, the results are sampled
+ * together from the final state when first read, and \c resample draws the
+ * results of another shot.
+ *
+ * For programs with mid-circuit measurements, branching executes each
+ * distinct measurement history once rather than once per shot. The shots of
+ * an execution are split binomially between the outcomes of each
+ * measurement: the execution continues with the more likely outcome, and the
+ * state for the other outcome is saved as a pending branch. A later execution
+ * of that branch replays the recorded outcomes with an empty state, so the
+ * gates before the branch point are skipped, and then resumes from the saved
+ * state. See \c run_branching_shots . Enumeration instead explores every
+ * outcome with a nonnegligible probability to compute the exact distribution
+ * of a program's outputs (see \c enumerate_branches ).
+ *
+ * Qubit \em i is bit \em i of the basis state index. Gates loop over the
+ * affected amplitude pairs with kernels that the compiler vectorizes, and that
+ * run in parallel with OpenMP for large states.
+ *
+ * Each gate sweeps the whole state, so large simulations are limited by
+ * memory bandwidth. A recorded \c Circuit can instead be applied with
+ * \c apply , which fuses runs of consecutive gates on a few qubits into dense
+ * operators that each take a single sweep. The number of qubits per fused
+ * operator is an option, or is chosen by a cost model that weighs the sweeps
+ * saved against the extra arithmetic of larger operators.
+ */
+class StateVectorQuantum final : virtual public QuantumNotImpl
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using Complex = detail::Complex;
+    using VecComplex = std::vector<Complex>;
+    //!@}
+
+    //! Construction options
+    struct Options
+    {
+        //! Seed for measurement sampling
+        std::uint64_t seed{std::mt19937_64::default_seed};
+        //! Maximum number of qubits (16 * 2^n bytes of memory)
+        size_type max_qubits{28};
+        //! Maximum qubits per fused gate when applying a circuit (zero to
+        //! choose with a cost model)
+        size_type fusion_qubits{0};
+    };
+
+  public:
+    // Construct with default options
+    StateVectorQuantum();
+
+    // Construct with options
+    explicit StateVectorQuantum(Options const& opts);
+
+    QIREE_DELETE_COPY_MOVE(StateVectorQuantum);
+
+    //!@{
+    //! \name Accessors
+    size_type num_qubits() const { return num_qubits_; }
+    size_type num_results() const { return results_.size(); }
+    VecComplex const& state() const { return state_; }
+    //!@}
+
+    // Reseed the random number generator
+    void seed(std::uint64_t value);
+
+    // Probability of measuring a qubit in |1> without collapsing the state
+    double probability_one(Qubit) const;
+
+    // Record Z measurements and sample them when results are read
+    void defer_measurements(bool value);
+
+    //! Whether Z measurements are deferred
+    bool deferred_measurements() const { return defer_; }
+
+    // Sample new values for deferred measurements from the current state
+    void resample();
+
+    // Execute subsequent shots as branches of a measurement tree
+    void start_branching(size_type num_shots);
+
+    // Execute subsequent shots as every branch of the measurement tree
+    void start_enumeration(double prune_threshold);
+
+    // Prepare the next pending branch, returning false when all are done
+    bool next_branch();
+
+    //! Number of shots represented by the current branch
+    size_type branch_shots() const { return current_.num_shots; }
+
+    //! Probability of the current branch's measurement outcomes
+    double branch_probability() const { return current_.probability; }
+
+    //! Total probability of branches skipped during enumeration
+    double pruned_probability() const { return pruned_probability_; }
+
+    // Apply the operations of a circuit with gate fusion
+    void apply(Circuit const& circuit);
+
+    //! Gate fusion used by the last circuit
+    detail::FusedCircuit const& fused() const { return fused_; }
+
+    //!@{
+    //! \name Quantum interface
+    void set_up(EntryPointAttrs const&) final;
+    void tear_down() final;
+    //!@}
+
+    //!@{
+    //! \name Measurements
+    Result m(Qubit) final;
+    Result measure(Array, Array) final;
+    Result mresetz(Qubit) final;
+    void mz(Qubit, Result) final;
+    QState read_result(Result) final;
+    //!@}
+
+    //!@{
+    //! \name Gates
+    void ccx(Qubit, Qubit, Qubit) final;
+    void cnot(Qubit, Qubit) final;
+    void cx(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
+    void cz(Qubit, Qubit) final;
+    void exp_adj(Array, double, Array) final;
+    void exp(Array, double, Array) final;
+    void exp(Array, Tuple) final;
+    void exp_adj(Array, Tuple) final;
+    void h(Qubit) final;
+    void h(Array, Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    void r(Array, Tuple) final;
+    void r_adj(Array, Tuple) final;
+    void reset(Qubit) final;
+    void rx(double, Qubit) final;
+    void rx(Array, Tuple) final;
+    void rxx(double, Qubit, Qubit) final;
+    void ry(double, Qubit) final;
+    void ry(Array, Tuple) final;
+    void ryy(double, Qubit, Qubit) final;
+    void rz(double, Qubit) final;
+    void rz(Array, Tuple) final;
+    void rzz(double, Qubit, Qubit) final;
+    void s_adj(Qubit) final;
+    void s(Qubit) final;
+    void s(Array, Qubit) final;
+    void s_adj(Array, Qubit) final;
+    void swap(Qubit, Qubit) final;
+    void t_adj(Qubit) final;
+    void t(Qubit) final;
+    void t(Array, Qubit) final;
+    void t_adj(Array, Qubit) final;
+    void x(Qubit) final;
+    void x(Array, Qubit) final;
+    void y(Qubit) final;
+    void y(Array, Qubit) final;
+    void z(Qubit) final;
+    void z(Array, Qubit) final;
+    //!@}
+
+  private:
+    using QubitMask = detail::QubitMask;
+    using Matrix2 = detail::Matrix2;
+    using PauliString = detail::PauliString;
+
+    Options options_;
+    std::mt19937_64 rng_;
+    size_type num_qubits_{0};
+    VecComplex state_;
+    std::vector<QState> results_;
+
+    // Deferred measurements
+    bool defer_{false};
+    bool stale_{false};
+    std::vector<std::pair<Result, size_type>> deferred_;
+    detail::BasisSampler sampler_;
+
+    //! Measurement history and the state after its last measurement
+    struct Branch
+    {
+        std::vector<bool> outcomes;
+        VecComplex state;
+        size_type num_shots{0};
+        double probability{1};
+    };
+
+    // Branching execution
+    bool branching_{false};
+    bool enumerate_{false};
+    double prune_threshold_{0};
+    double pruned_probability_{0};
+    std::vector<Branch> pending_;
+    Branch current_;
+    size_type replay_length_{0};
+    size_type num_replayed_{0};
+
+    // Scratch space for reading QIR arrays
+    std::vector<Qubit> qubit_buf_;
+    std::vector<Pauli> pauli_buf_;
+
+    // Fused gates of the last circuit
+    detail::FusedCircuit fused_;
+
+    detail::StateRef ref() { return {state_.data(), state_.size()}; }
+    size_type index(Qubit q) const;
+
+    void apply(Matrix2 const& m, Qubit target, QubitMask controls);
+    void
+    apply_diagonal(Complex d0, Complex d1, Qubit target, QubitMask controls);
+    void rotate(PauliString const& p, double theta, QubitMask controls);
+    QState sample(Qubit);
+    QState sample(PauliString const& p);
+    template<class P, class C>
+    bool choose(P&& get_prob_one, C&& collapse);
+    Result push_result(QState);
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
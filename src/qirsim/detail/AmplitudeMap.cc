@@ -0,0 +1,66 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/AmplitudeMap.cc
+//---------------------------------------------------------------------------//
+#include "AmplitudeMap.hh"
+
+#include <algorithm>
+#include <utility>
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Remove all amplitudes without releasing memory.
+ */
+void AmplitudeMap::clear()
+{
+    std::fill(keys_.begin(), keys_.end(), empty_key);
+    size_ = 0;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Allocate space for a number of amplitudes.
+ *
+ * The capacity grows to a power of two at least twice the count, and stored
+ * amplitudes are rehashed into the new slots.
+ */
+void AmplitudeMap::reserve(size_type count)
+{
+    size_type capacity = 16;
+    int shift = 60;
+    while (capacity < 2 * count)
+    {
+        capacity *= 2;
+        --shift;
+    }
+    if (capacity <= keys_.size())
+    {
+        return;
+    }
+
+    std::vector<Key> keys(capacity, empty_key);
+    std::vector<Complex> values(capacity);
+    std::swap(keys, keys_);
+    std::swap(values, values_);
+    size_ = 0;
+    mask_ = capacity - 1;
+    shift_ = shift;
+    for (size_type i = 0; i < keys.size(); ++i)
+    {
+        if (keys[i] != empty_key)
+        {
+            (*this)[keys[i]] = values[i];
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
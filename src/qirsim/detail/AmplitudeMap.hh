@@ -0,0 +1,143 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/AmplitudeMap.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "qiree/Types.hh"
+
+#include "StateVectorKernels.hh"
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Open-addressing hash map from basis state indices to amplitudes.
+ *
+ * Keys and values are stored in two flat arrays whose capacity is a power of
+ * two at least twice the number of entries. A key is placed by Fibonacci
+ * hashing and collisions probe the following slots, so lookups touch
+ * consecutive memory. The all-ones index marks an empty slot and can't be
+ * stored, which limits keys to 63 qubits.
+ *
+ * Entries are never erased: simulators build a new map for each operation
+ * that moves amplitudes, so clearing is the only way to remove them.
+ */
+class AmplitudeMap
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using Key = std::uint64_t;
+    //!@}
+
+    //! Marker of an empty slot
+    static constexpr Key empty_key = ~Key{0};
+
+  public:
+    //! Number of stored amplitudes
+    size_type size() const { return size_; }
+
+    //! Number of slots
+    size_type capacity() const { return keys_.size(); }
+
+    // Remove all amplitudes without releasing memory
+    void clear();
+
+    // Allocate space for a number of amplitudes
+    void reserve(size_type count);
+
+    //! Get the amplitude of a basis state, inserting zero if absent
+    Complex& operator[](Key key)
+    {
+        if (2 * (size_ + 1) > keys_.size())
+        {
+            this->reserve(size_ + 1);
+        }
+        size_type i = this->slot(key);
+        while (keys_[i] != key)
+        {
+            if (keys_[i] == empty_key)
+            {
+                keys_[i] = key;
+                values_[i] = 0;
+                ++size_;
+                break;
+            }
+            i = (i + 1) & mask_;
+        }
+        return values_[i];
+    }
+
+    //! Get the amplitude of a basis state, which is zero if absent
+    Complex find(Key key) const
+    {
+        if (keys_.empty())
+        {
+            return 0;
+        }
+        for (size_type i = this->slot(key);; i = (i + 1) & mask_)
+        {
+            if (keys_[i] == key)
+            {
+                return values_[i];
+            }
+            if (keys_[i] == empty_key)
+            {
+                return 0;
+            }
+        }
+    }
+
+    //! Call a function with each basis state and amplitude
+    template<class F>
+    void for_each(F&& apply) const
+    {
+        for (size_type i = 0; i < keys_.size(); ++i)
+        {
+            if (keys_[i] != empty_key)
+            {
+                apply(keys_[i], values_[i]);
+            }
+        }
+    }
+
+    //! Call a function with each basis state and mutable amplitude
+    template<class F>
+    void for_each(F&& apply)
+    {
+        for (size_type i = 0; i < keys_.size(); ++i)
+        {
+            if (keys_[i] != empty_key)
+            {
+                apply(keys_[i], values_[i]);
+            }
+        }
+    }
+
+  private:
+    std::vector<Key> keys_;
+    std::vector<Complex> values_;
+    size_type size_{0};
+    size_type mask_{0};
+    int shift_{64};
+
+    //! Home slot of a key
+    size_type slot(Key key) const
+    {
+        return static_cast<size_type>((key * 0x9e3779b97f4a7c15ull) >> shift_)
+               & mask_;
+    }
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
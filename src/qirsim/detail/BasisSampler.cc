@@ -0,0 +1,78 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/BasisSampler.cc
+//---------------------------------------------------------------------------//
+#include "BasisSampler.hh"
+
+#include <algorithm>
+#include <complex>
+#include <numeric>
+
+#include "qiree/Assert.hh"
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Construct from a state vector.
+ */
+BasisSampler::BasisSampler(StateRef psi)
+    : psi_{psi}, block_size_{std::min(psi.size, block_size)}
+{
+    QIREE_EXPECT(psi.size > 0);
+    cdf_.resize(psi.size / block_size_);
+    block_probabilities(psi_, block_size_, cdf_.data());
+    std::partial_sum(cdf_.begin(), cdf_.end(), cdf_.begin());
+    QIREE_VALIDATE(cdf_.back() > 0, << "cannot sample from a zero state");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Find the basis state at a cumulative probability.
+ *
+ * The result is the first state whose cumulative probability exceeds the
+ * given value. Round-off at the end of a block falls back to the last state
+ * in the block with a nonzero amplitude.
+ */
+size_type BasisSampler::find(double u) const
+{
+    auto iter = std::upper_bound(cdf_.begin(), cdf_.end(), u);
+    if (iter == cdf_.end())
+    {
+        // Round-off: use the last block with a nonzero probability
+        iter = std::lower_bound(cdf_.begin(), cdf_.end(), cdf_.back());
+    }
+    size_type const block = iter - cdf_.begin();
+    if (block > 0)
+    {
+        u -= cdf_[block - 1];
+    }
+
+    size_type const begin = block * block_size_;
+    size_type const end = begin + block_size_;
+    size_type result = begin;
+    double accum = 0;
+    for (size_type k = begin; k < end; ++k)
+    {
+        double const p = std::norm(psi_.data[k]);
+        if (p > 0)
+        {
+            result = k;
+            accum += p;
+            if (accum > u)
+            {
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
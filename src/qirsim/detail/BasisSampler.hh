@@ -0,0 +1,68 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/BasisSampler.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include "qiree/Types.hh"
+
+#include "StateVectorKernels.hh"
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Sample basis states from the squared amplitudes of a state vector.
+ *
+ * Construction sums the probability of each block of consecutive basis
+ * states into a cumulative distribution (one pass over the state). Each
+ * sample binary searches the blocks and then scans the amplitudes of one
+ * block, so the extra memory is a small fraction of the state and sampling
+ * costs at most a block's worth of work regardless of the number of qubits.
+ *
+ * The state must outlive the sampler and not change while it's used.
+ */
+class BasisSampler
+{
+  public:
+    //! Number of amplitudes summed into one block of the distribution
+    static constexpr size_type block_size = 1024;
+
+  public:
+    //! Construct without a state
+    BasisSampler() = default;
+
+    // Construct from a state vector
+    explicit BasisSampler(StateRef psi);
+
+    //! Sample a basis state index
+    template<class Engine>
+    size_type operator()(Engine& rng) const
+    {
+        std::uniform_real_distribution<double> sample_uniform{0, cdf_.back()};
+        return this->find(sample_uniform(rng));
+    }
+
+    // Find the basis state at a cumulative probability
+    size_type find(double u) const;
+
+    //! Whether the sampler has been constructed from a state
+    explicit operator bool() const { return !cdf_.empty(); }
+
+  private:
+    StateRef psi_;
+    size_type block_size_{0};
+    std::vector<double> cdf_;
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
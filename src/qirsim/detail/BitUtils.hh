@@ -0,0 +1,63 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/BitUtils.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+
+/*!
+ * \def QIRSIM_TARGET_CLONES
+ *
+ * Compile a kernel for several x86 vector extensions, selecting the best one
+ * for the host CPU when the library is loaded.
+ */
+#if defined(__x86_64__) && defined(__ELF__) \
+    && (defined(__clang__) ? __clang_major__ >= 14 : defined(__GNUC__))
+#    define QIRSIM_TARGET_CLONES \
+        __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#    define QIRSIM_TARGET_CLONES
+#endif
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Number of set bits.
+ */
+inline int popcount(std::uint64_t v)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(v);
+#else
+    int result = 0;
+    for (; v; v &= v - 1)
+    {
+        ++result;
+    }
+    return result;
+#endif
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether an odd number of bits are set.
+ */
+inline bool parity(std::uint64_t v)
+{
+#if defined(__GNUC__)
+    return __builtin_parityll(v);
+#else
+    return popcount(v) % 2;
+#endif
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
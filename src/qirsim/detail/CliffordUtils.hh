@@ -0,0 +1,48 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/CliffordUtils.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cmath>
+
+#include "qiree/Assert.hh"
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Check that an instruction can be simulated with the stabilizer formalism.
+ */
+inline void validate_clifford(bool is_clifford, char const* instr)
+{
+    QIREE_VALIDATE(is_clifford,
+                   << "quantum instruction '" << instr
+                   << "' is not a Clifford operation (use a state vector "
+                      "simulator for non-Clifford programs)");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the number of quarter turns in a rotation angle, or -1 if not Clifford.
+ */
+inline int quarter_turns(double theta)
+{
+    constexpr double half_pi = 1.57079632679489661923;
+    double const turns = theta / half_pi;
+    double const rounded = std::round(turns);
+    if (std::fabs(turns - rounded) > 1e-9)
+    {
+        return -1;
+    }
+    return static_cast<int>(std::fmod(rounded, 4.0) + 4) % 4;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -0,0 +1,378 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/GateFusion.cc
+//---------------------------------------------------------------------------//
+#include "GateFusion.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+#include "qiree/Assert.hh"
+
+#include "BitUtils.hh"
+
+namespace qiree
+{
+namespace detail
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+constexpr double sqrt_half = 0.70710678118654752440;
+constexpr Complex imag{0, 1};
+
+//! Bytes read and written for each amplitude in a sweep of the state
+constexpr double sweep_bytes = 2 * sizeof(Complex);
+
+//! Floating point operations in a complex multiply-add
+constexpr double madd_flops = 8;
+
+//! Flops per byte of sweep traffic at which the dense kernel takes as long
+//! as a sweep, measured for states in main memory
+constexpr double memory_balance = 1;
+
+//! Flops per byte at which the dense kernel matches a sweep in cache
+constexpr double cache_balance = 0.75;
+
+//! State size above which sweeps are limited by main memory bandwidth
+constexpr double cache_bytes = 32 * 1024 * 1024;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the mask of qubits that an operation acts on.
+ */
+QubitMask operand_mask(Circuit::OperationRef const& op)
+{
+    QubitMask result{0};
+    for (size_type k = 0; k < op.num_controls; ++k)
+    {
+        result |= QubitMask{1} << op.controls[k];
+    }
+    for (size_type k = 0; k < op.num_targets; ++k)
+    {
+        result |= QubitMask{1} << op.targets[k];
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add a step that applies a single operation.
+ */
+void push_unfused(size_type i, FusedCircuit* result)
+{
+    FusedCircuit::Step step;
+    step.begin = i;
+    step.end = i + 1;
+    result->steps.push_back(step);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add a step that applies a range of gates as one dense operator.
+ *
+ * The operator is built by applying the gates to every column of the
+ * identity at once: column \em c of an operator on \em q qubits starts at
+ * \f$ c 2^q \f$ in a state of \f$ 2q \f$ qubits, so the gates act on the
+ * low (local) qubits and leave the column index alone. The result is
+ * transposed into a row-major matrix.
+ */
+void push_fused(Circuit const& circuit,
+                size_type begin,
+                size_type end,
+                QubitMask mask,
+                std::vector<Complex>* work,
+                FusedCircuit* result)
+{
+    FusedCircuit::Step step;
+    step.begin = begin;
+    step.end = end;
+    step.num_qubits = popcount(mask);
+    step.qubit_offset = result->qubits.size();
+    step.matrix_offset = result->matrices.size();
+
+    // Map the qubits of the block to local indices in increasing order
+    std::array<Circuit::Index, 64> local{};
+    for (size_type q = 0; mask >> q; ++q)
+    {
+        if ((mask >> q) & 1)
+        {
+            local[q] = result->qubits.size() - step.qubit_offset;
+            result->qubits.push_back(q);
+        }
+    }
+
+    size_type const dim = size_type{1} << step.num_qubits;
+    work->assign(dim * dim, Complex{0});
+    for (size_type c = 0; c < dim; ++c)
+    {
+        (*work)[c * dim + c] = 1;
+    }
+    std::array<Circuit::Index, max_dense_qubits> controls;
+    std::array<Circuit::Index, max_dense_qubits> targets;
+    for (size_type i = begin; i < end; ++i)
+    {
+        auto op = circuit[i];
+        for (size_type k = 0; k < op.num_controls; ++k)
+        {
+            controls[k] = local[op.controls[k]];
+        }
+        for (size_type k = 0; k < op.num_targets; ++k)
+        {
+            targets[k] = local[op.targets[k]];
+        }
+        op.controls = controls.data();
+        op.targets = targets.data();
+        apply_operation({work->data(), work->size()}, op);
+    }
+
+    for (size_type r = 0; r < dim; ++r)
+    {
+        for (size_type c = 0; c < dim; ++c)
+        {
+            result->matrices.push_back((*work)[c * dim + r]);
+        }
+    }
+    result->steps.push_back(step);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether a circuit operation is a unitary gate.
+ */
+bool is_unitary(GateOp op)
+{
+    return op != GateOp::measure_z && op != GateOp::measure_pauli
+           && op != GateOp::reset && op != GateOp::size_;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a unitary circuit operation to a state vector.
+ *
+ * Qubit \em i of the circuit is bit \em i of the basis state index.
+ */
+void apply_operation(StateRef psi, Circuit::OperationRef const& op)
+{
+    QIREE_EXPECT(is_unitary(op.op));
+    QubitMask controls{0};
+    for (size_type k = 0; k < op.num_controls; ++k)
+    {
+        controls |= QubitMask{1} << op.controls[k];
+    }
+    size_type const target = op.targets[0];
+    QIREE_EXPECT(!(controls & (QubitMask{1} << target)));
+
+    double const half = op.theta / 2;
+    switch (op.op)
+    {
+        case GateOp::h:
+            apply_matrix(psi,
+                         target,
+                         {sqrt_half, sqrt_half, sqrt_half, -sqrt_half},
+                         controls);
+            break;
+        case GateOp::x:
+            apply_x(psi, target, controls);
+            break;
+        case GateOp::y:
+            apply_matrix(psi, target, {0, -imag, imag, 0}, controls);
+            break;
+        case GateOp::z:
+            apply_diagonal(psi, target, 1, -1, controls);
+            break;
+        case GateOp::s:
+            apply_diagonal(psi, target, 1, imag, controls);
+            break;
+        case GateOp::s_adj:
+            apply_diagonal(psi, target, 1, -imag, controls);
+            break;
+        case GateOp::t:
+            apply_diagonal(
+                psi, target, 1, Complex{sqrt_half, sqrt_half}, controls);
+            break;
+        case GateOp::t_adj:
+            apply_diagonal(
+                psi, target, 1, Complex{sqrt_half, -sqrt_half}, controls);
+            break;
+        case GateOp::rx: {
+            Complex c = std::cos(half);
+            Complex s = -imag * std::sin(half);
+            apply_matrix(psi, target, {c, s, s, c}, controls);
+            break;
+        }
+        case GateOp::ry: {
+            double c = std::cos(half);
+            double s = std::sin(half);
+            apply_matrix(psi, target, {c, -s, s, c}, controls);
+            break;
+        }
+        case GateOp::rz:
+            apply_diagonal(psi,
+                           target,
+                           std::polar(1.0, -half),
+                           std::polar(1.0, half),
+                           controls);
+            break;
+        case GateOp::rxx:
+        case GateOp::ryy:
+        case GateOp::rzz:
+        case GateOp::pauli_rotation: {
+            Pauli const pair = op.op == GateOp::rxx   ? Pauli::x
+                               : op.op == GateOp::ryy ? Pauli::y
+                                                      : Pauli::z;
+            PauliString p;
+            for (size_type k = 0; k < op.num_targets; ++k)
+            {
+                p.push_back(op.op == GateOp::pauli_rotation ? op.paulis[k]
+                                                            : pair,
+                            op.targets[k]);
+            }
+            apply_pauli_sum(
+                psi, p, std::cos(half), -imag * std::sin(half), controls);
+            break;
+        }
+        case GateOp::swap:
+            apply_swap(psi, target, op.targets[1], controls);
+            break;
+        default:
+            QIREE_ASSERT_UNREACHABLE();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Fuse consecutive gates that act on at most a given number of qubits.
+ *
+ * Gates are added to a block until the next gate would increase the number
+ * of qubits the block acts on past the maximum. Blocks of more than one gate
+ * become dense operators; measurements, resets, single gates, and gates on
+ * too many qubits are applied by themselves. A maximum of zero applies every
+ * operation separately.
+ */
+void fuse_gates(Circuit const& circuit,
+                size_type max_qubits,
+                FusedCircuit* result)
+{
+    QIREE_EXPECT(max_qubits <= max_dense_qubits);
+    QIREE_EXPECT(circuit.num_qubits() <= 64);
+    QIREE_EXPECT(result);
+
+    result->clear();
+    std::vector<Complex> work;
+    size_type begin = 0;
+    QubitMask block{0};
+    auto close_block = [&](size_type end) {
+        if (end - begin == 1)
+        {
+            push_unfused(begin, result);
+        }
+        else if (end - begin > 1)
+        {
+            push_fused(circuit, begin, end, block, &work, result);
+        }
+        begin = end;
+        block = 0;
+    };
+
+    for (size_type i = 0; i < circuit.size(); ++i)
+    {
+        QubitMask const mask = operand_mask(circuit[i]);
+        size_type const num_qubits = popcount(mask);
+        if (!is_unitary(circuit.op(i)) || num_qubits > max_qubits)
+        {
+            close_block(i);
+            push_unfused(i, result);
+            begin = i + 1;
+            continue;
+        }
+        if (static_cast<size_type>(popcount(block | mask)) > max_qubits)
+        {
+            close_block(i);
+        }
+        block |= mask;
+    }
+    close_block(circuit.size());
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Estimated time to apply fused gates, in sweeps of the state vector.
+ *
+ * Applying one gate costs a sweep, which reads and writes every amplitude
+ * and is limited by memory bandwidth. A dense operator on \em q qubits does
+ * \f$ 2^q \f$ complex multiply-adds per amplitude in its sweep, so it costs
+ * more than one sweep once its arithmetic intensity exceeds the balance at
+ * which the dense kernel keeps up with memory. The kernel gathers scattered
+ * amplitudes, so this balance is low: a fused operator on three qubits
+ * costs about two sweeps. Sweeps of a state in cache are cheaper still,
+ * which favors smaller operators. Building the operator applies each of its
+ * gates to \f$ 4^q \f$ amplitudes, which matters only for small states.
+ * Measurements and resets cost the same with or without fusion and aren't
+ * counted.
+ */
+double fusion_cost(Circuit const& circuit,
+                   FusedCircuit const& fused,
+                   size_type num_qubits)
+{
+    double const size = std::ldexp(1.0, num_qubits);
+    double const balance = size * sizeof(Complex) > cache_bytes
+                               ? memory_balance
+                               : cache_balance;
+    double result = 0;
+    for (auto const& step : fused.steps)
+    {
+        if (step.num_qubits == 0)
+        {
+            result += is_unitary(circuit.op(step.begin)) ? 1 : 0;
+            continue;
+        }
+        double const dim = std::ldexp(1.0, step.num_qubits);
+        double const intensity = madd_flops * dim / sweep_bytes;
+        result += std::max(1.0, intensity / balance);
+        result += (step.end - step.begin) * dim * dim / size;
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Fuse gates with the block size that has the lowest estimated cost.
+ *
+ * Every block size up to the largest dense operator is tried, including no
+ * fusion, and the smallest block size with the lowest cost is kept. Returns
+ * the chosen maximum number of qubits per block.
+ */
+size_type fuse_gates_min_cost(Circuit const& circuit,
+                              size_type num_qubits,
+                              FusedCircuit* result)
+{
+    QIREE_EXPECT(result);
+    FusedCircuit candidate;
+    size_type best{0};
+    double best_cost{0};
+    for (size_type k = 0; k <= max_dense_qubits; ++k)
+    {
+        fuse_gates(circuit, k, &candidate);
+        double const cost = fusion_cost(circuit, candidate, num_qubits);
+        if (k == 0 || cost < best_cost)
+        {
+            std::swap(*result, candidate);
+            best = k;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
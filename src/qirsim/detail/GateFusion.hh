@@ -0,0 +1,82 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/GateFusion.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <vector>
+
+#include "qiree/Circuit.hh"
+#include "qiree/Types.hh"
+
+#include "StateVectorKernels.hh"
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Circuit operations grouped into sweeps of a state vector.
+ *
+ * Each step is either a range of consecutive gates fused into a dense
+ * operator on a few qubits, or a single operation of the circuit that is
+ * applied by itself (\c num_qubits is zero). The qubits and row-major
+ * matrices of the fused steps are packed into shared arrays.
+ */
+struct FusedCircuit
+{
+    //! Operations applied in one sweep of the state
+    struct Step
+    {
+        size_type begin{0};  //!< First operation in the circuit
+        size_type end{0};  //!< One past the last operation
+        size_type num_qubits{0};  //!< Qubits of a fused operator
+        size_type qubit_offset{0};  //!< Start of the qubits
+        size_type matrix_offset{0};  //!< Start of the matrix
+    };
+
+    std::vector<Step> steps;
+    std::vector<size_type> qubits;
+    std::vector<Complex> matrices;
+
+    //! Remove all steps
+    void clear()
+    {
+        steps.clear();
+        qubits.clear();
+        matrices.clear();
+    }
+};
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Whether a circuit operation is a unitary gate
+bool is_unitary(GateOp);
+
+// Apply a unitary circuit operation to a state vector
+void apply_operation(StateRef psi, Circuit::OperationRef const& op);
+
+// Fuse consecutive gates that act on at most a given number of qubits
+void fuse_gates(Circuit const& circuit,
+                size_type max_qubits,
+                FusedCircuit* result);
+
+// Estimated time to apply fused gates, in sweeps of the state vector
+double fusion_cost(Circuit const& circuit,
+                   FusedCircuit const& fused,
+                   size_type num_qubits);
+
+// Fuse gates with the block size that has the lowest estimated cost
+size_type fuse_gates_min_cost(Circuit const& circuit,
+                              size_type num_qubits,
+                              FusedCircuit* result);
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -0,0 +1,190 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/QirArgs.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "qiree/Assert.hh"
+#include "qiree/MemManager.hh"
+#include "qiree/Types.hh"
+
+#include "StateVectorKernels.hh"
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Arguments to a controlled Pauli rotation.
+ *
+ * This is the layout of the QIR tuple <tt>{ i2, double, %Qubit* }</tt>.
+ */
+struct PauliRotationArgs
+{
+    Pauli pauli;
+    double theta;
+    Qubit qubit;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Arguments to a controlled Pauli exponential.
+ *
+ * This is the layout of the QIR tuple <tt>{ %Array*, double, %Array* }</tt>.
+ */
+struct ExpArgs
+{
+    Array paulis;
+    double theta;
+    Array qubits;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the elements of a QIR array of qubits.
+ */
+inline void read_qubits(Array arr, std::vector<Qubit>& result)
+{
+    QIREE_EXPECT(arr);
+    QIREE_EXPECT(MemManager::array_get_elem_size(arr) == sizeof(Qubit));
+
+    auto size = MemManager::array_get_size_1d(arr);
+    result.resize(size);
+    if (size > 0)
+    {
+        std::memcpy(result.data(),
+                    MemManager::array_get_element_ptr_1d(arr, 0),
+                    size * sizeof(Qubit));
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the elements of a QIR array of Paulis.
+ *
+ * QIR stores each \c i2 Pauli value in a byte.
+ */
+inline void read_paulis(Array arr, std::vector<Pauli>& result)
+{
+    QIREE_EXPECT(arr);
+    QIREE_EXPECT(MemManager::array_get_elem_size(arr) == sizeof(Pauli));
+
+    auto size = MemManager::array_get_size_1d(arr);
+    result.resize(size);
+    for (std::uint64_t i = 0; i < size; ++i)
+    {
+        auto value = *static_cast<pauli_type const*>(
+            MemManager::array_get_element_ptr_1d(arr, i));
+        result[i] = static_cast<Pauli>(value & 0b11);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the bit index of a qubit, checking that the entry point allocated it.
+ */
+inline size_type qubit_index(Qubit q, size_type num_qubits)
+{
+    QIREE_VALIDATE(q.value < num_qubits,
+                   << "qubit " << q.value << " is out of range (entry point "
+                   << "requires " << num_qubits << " qubits)");
+    return q.value;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the mask of qubits in a QIR array.
+ *
+ * The qubits are left in the scratch buffer.
+ */
+inline QubitMask
+read_controls(Array controls, size_type num_qubits, std::vector<Qubit>& buf)
+{
+    read_qubits(controls, buf);
+    QubitMask result{0};
+    for (auto q : buf)
+    {
+        result |= QubitMask{1} << qubit_index(q, num_qubits);
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the mask of control qubits for a single-qubit gate.
+ */
+inline QubitMask control_mask(Array controls,
+                              Qubit target,
+                              size_type num_qubits,
+                              std::vector<Qubit>& buf)
+{
+    QubitMask result = read_controls(controls, num_qubits, buf);
+    QIREE_VALIDATE(!(result & (QubitMask{1} << target.value)),
+                   << "target is also a control qubit");
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Build a Pauli string from QIR arrays of operators and qubits.
+ *
+ * The operators and qubits are left in the scratch buffers.
+ */
+inline PauliString pauli_string(Array paulis,
+                                Array qubits,
+                                size_type num_qubits,
+                                std::vector<Pauli>& pauli_buf,
+                                std::vector<Qubit>& qubit_buf)
+{
+    read_paulis(paulis, pauli_buf);
+    read_qubits(qubits, qubit_buf);
+    QIREE_VALIDATE(pauli_buf.size() == qubit_buf.size(),
+                   << "mismatched Pauli and qubit array sizes ("
+                   << pauli_buf.size() << " != " << qubit_buf.size() << ")");
+
+    PauliString result;
+    QubitMask seen{0};
+    for (size_type i = 0; i < pauli_buf.size(); ++i)
+    {
+        auto bit = QubitMask{1} << qubit_index(qubit_buf[i], num_qubits);
+        QIREE_VALIDATE(!(seen & bit),
+                       << "duplicate qubit " << qubit_buf[i].value
+                       << " in Pauli string");
+        seen |= bit;
+        result.push_back(pauli_buf[i], qubit_buf[i].value);
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Store a measurement in a new result.
+ */
+inline Result push_result(QState value, std::vector<QState>& results)
+{
+    results.push_back(value);
+    return Result{results.size() - 1};
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a tuple's arguments.
+ */
+template<class T>
+T const& tuple_args(Tuple t)
+{
+    QIREE_EXPECT(t);
+    return *static_cast<T const*>(t);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -0,0 +1,624 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/StateVectorKernels.cc
+//---------------------------------------------------------------------------//
+#include "StateVectorKernels.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+#include "qiree_config.h"
+
+#include "qiree/Assert.hh"
+
+#include "BitUtils.hh"
+
+namespace qiree
+{
+namespace detail
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+// Number of loop iterations per thread work unit
+constexpr size_type chunk_size = size_type{1} << 14;
+
+// Minimum number of iterations to run in parallel
+constexpr size_type parallel_threshold = size_type{1} << 16;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Multiply complex numbers without the NaN checks that prevent vectorization.
+ */
+inline Complex mul(Complex a, Complex b)
+{
+    return {a.real() * b.real() - a.imag() * b.imag(),
+            a.real() * b.imag() + a.imag() * b.real()};
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Squared magnitude of a complex number.
+ */
+inline double norm(Complex a)
+{
+    return a.real() * a.real() + a.imag() * a.imag();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Insert a zero bit into an index at the given position.
+ */
+inline size_type insert_zero(size_type i, size_type bit)
+{
+    size_type const low = (size_type{1} << bit) - 1;
+    return ((i & ~low) << 1) | (i & low);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get i to the power of the number of Y operators in a Pauli string.
+ */
+Complex y_phase(PauliString const& p)
+{
+    int const num_y = popcount(p.x & p.z);
+    constexpr Complex powers[] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+    return powers[num_y % 4];
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Call a function on contiguous ranges of [0, n), in parallel if large.
+ */
+template<class F>
+void for_each_range(size_type n, F&& apply)
+{
+#if QIREE_USE_OpenMP
+    if (n >= parallel_threshold)
+    {
+        size_type const num_chunks = (n + chunk_size - 1) / chunk_size;
+#    pragma omp parallel for schedule(static)
+        for (size_type c = 0; c < num_chunks; ++c)
+        {
+            apply(c * chunk_size, std::min(n, (c + 1) * chunk_size));
+        }
+        return;
+    }
+#endif
+    apply(size_type{0}, n);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Sum the results of a function on contiguous ranges of [0, n).
+ */
+template<class F>
+double sum_ranges(size_type n, F&& apply)
+{
+#if QIREE_USE_OpenMP
+    if (n >= parallel_threshold)
+    {
+        size_type const num_chunks = (n + chunk_size - 1) / chunk_size;
+        double result = 0;
+#    pragma omp parallel for schedule(static) reduction(+ : result)
+        for (size_type c = 0; c < num_chunks; ++c)
+        {
+            result += apply(c * chunk_size, std::min(n, (c + 1) * chunk_size));
+        }
+        return result;
+    }
+#endif
+    return apply(size_type{0}, n);
+}
+
+//---------------------------------------------------------------------------//
+// RANGE KERNELS
+//---------------------------------------------------------------------------//
+
+QIRSIM_TARGET_CLONES void matrix_range(Complex* psi,
+                                       size_type begin,
+                                       size_type end,
+                                       size_type target,
+                                       Matrix2 const& m,
+                                       QubitMask controls)
+{
+    size_type const bit = size_type{1} << target;
+    for (size_type i = begin; i < end; ++i)
+    {
+        size_type const k0 = insert_zero(i, target);
+        if ((k0 & controls) != controls)
+        {
+            continue;
+        }
+        size_type const k1 = k0 | bit;
+        Complex const a = psi[k0];
+        Complex const b = psi[k1];
+        psi[k0] = mul(m[0], a) + mul(m[1], b);
+        psi[k1] = mul(m[2], a) + mul(m[3], b);
+    }
+}
+
+QIRSIM_TARGET_CLONES void matrix4_range(Complex* psi,
+                                        size_type begin,
+                                        size_type end,
+                                        size_type a,
+                                        size_type b,
+                                        Matrix4 const& m)
+{
+    size_type const a_bit = size_type{1} << a;
+    size_type const b_bit = size_type{1} << b;
+    for (size_type i = begin; i < end; ++i)
+    {
+        size_type const k = insert_zero(insert_zero(i, std::min(a, b)),
+                                        std::max(a, b));
+        size_type const idx[4] = {k, k | b_bit, k | a_bit, k | a_bit | b_bit};
+        Complex const v[4]
+            = {psi[idx[0]], psi[idx[1]], psi[idx[2]], psi[idx[3]]};
+        for (int r = 0; r < 4; ++r)
+        {
+            psi[idx[r]] = mul(m[4 * r], v[0]) + mul(m[4 * r + 1], v[1])
+                          + mul(m[4 * r + 2], v[2]) + mul(m[4 * r + 3], v[3]);
+        }
+    }
+}
+
+template<size_type N>
+QIRSIM_TARGET_CLONES void dense_range(Complex* psi,
+                                      size_type begin,
+                                      size_type end,
+                                      size_type const* sorted,
+                                      size_type const* offsets,
+                                      Complex const* m)
+{
+    constexpr size_type dim = size_type{1} << N;
+
+    // Store columns of the operator contiguously, split into real and
+    // imaginary parts, so that the product vectorizes over rows
+    double mr[dim * dim];
+    double mi[dim * dim];
+    for (size_type r = 0; r < dim; ++r)
+    {
+        for (size_type c = 0; c < dim; ++c)
+        {
+            mr[c * dim + r] = m[r * dim + c].real();
+            mi[c * dim + r] = m[r * dim + c].imag();
+        }
+    }
+    size_type off[dim];
+    std::copy(offsets, offsets + dim, off);
+
+    for (size_type i = begin; i < end; ++i)
+    {
+        size_type k = i;
+        for (size_type j = 0; j < N; ++j)
+        {
+            k = insert_zero(k, sorted[j]);
+        }
+        double re[dim] = {};
+        double im[dim] = {};
+        for (size_type c = 0; c < dim; ++c)
+        {
+            Complex const a = psi[k | off[c]];
+            for (size_type r = 0; r < dim; ++r)
+            {
+                double const mre = mr[c * dim + r];
+                double const mim = mi[c * dim + r];
+                re[r] += mre * a.real() - mim * a.imag();
+                im[r] += mre * a.imag() + mim * a.real();
+            }
+        }
+        for (size_type r = 0; r < dim; ++r)
+        {
+            psi[k | off[r]] = {re[r], im[r]};
+        }
+    }
+}
+
+QIRSIM_TARGET_CLONES void diagonal_range(Complex* psi,
+                                         size_type begin,
+                                         size_type end,
+                                         size_type target,
+                                         Complex d0,
+                                         Complex d1,
+                                         QubitMask controls)
+{
+    size_type const bit = size_type{1} << target;
+    for (size_type k = begin; k < end; ++k)
+    {
+        Complex d = (k & bit) ? d1 : d0;
+        if ((k & controls) != controls)
+        {
+            d = 1;
+        }
+        psi[k] = mul(psi[k], d);
+    }
+}
+
+QIRSIM_TARGET_CLONES void x_range(Complex* psi,
+                                  size_type begin,
+                                  size_type end,
+                                  size_type target,
+                                  QubitMask controls)
+{
+    size_type const bit = size_type{1} << target;
+    for (size_type i = begin; i < end; ++i)
+    {
+        size_type const k0 = insert_zero(i, target);
+        if ((k0 & controls) == controls)
+        {
+            std::swap(psi[k0], psi[k0 | bit]);
+        }
+    }
+}
+
+QIRSIM_TARGET_CLONES void swap_range(Complex* psi,
+                                     size_type begin,
+                                     size_type end,
+                                     size_type lo,
+                                     size_type hi,
+                                     QubitMask controls)
+{
+    size_type const lo_bit = size_type{1} << lo;
+    size_type const hi_bit = size_type{1} << hi;
+    for (size_type i = begin; i < end; ++i)
+    {
+        size_type const k = insert_zero(insert_zero(i, lo), hi);
+        if ((k & controls) == controls)
+        {
+            std::swap(psi[k | lo_bit], psi[k | hi_bit]);
+        }
+    }
+}
+
+QIRSIM_TARGET_CLONES void pauli_diagonal_range(Complex* psi,
+                                               size_type begin,
+                                               size_type end,
+                                               QubitMask z,
+                                               Complex plus,
+                                               Complex minus,
+                                               QubitMask controls)
+{
+    for (size_type k = begin; k < end; ++k)
+    {
+        Complex d = parity(k & z) ? minus : plus;
+        if ((k & controls) != controls)
+        {
+            d = 1;
+        }
+        psi[k] = mul(psi[k], d);
+    }
+}
+
+QIRSIM_TARGET_CLONES void pauli_pair_range(Complex* psi,
+                                           size_type begin,
+                                           size_type end,
+                                           size_type pivot,
+                                           PauliString const& p,
+                                           Complex alpha,
+                                           Complex beta,
+                                           QubitMask controls)
+{
+    for (size_type i = begin; i < end; ++i)
+    {
+        size_type const k0 = insert_zero(i, pivot);
+        if ((k0 & controls) != controls)
+        {
+            continue;
+        }
+        size_type const k1 = k0 ^ p.x;
+        Complex const b0 = parity(k0 & p.z) ? -beta : beta;
+        Complex const b1 = parity(k1 & p.z) ? -beta : beta;
+        Complex const a0 = psi[k0];
+        Complex const a1 = psi[k1];
+        psi[k0] = mul(alpha, a0) + mul(b1, a1);
+        psi[k1] = mul(alpha, a1) + mul(b0, a0);
+    }
+}
+
+QIRSIM_TARGET_CLONES void
+scale_range(Complex* psi, size_type begin, size_type end, double factor)
+{
+    for (size_type k = begin; k < end; ++k)
+    {
+        psi[k] *= factor;
+    }
+}
+
+QIRSIM_TARGET_CLONES double probability_one_range(Complex const* psi,
+                                                  size_type begin,
+                                                  size_type end,
+                                                  size_type target)
+{
+    size_type const bit = size_type{1} << target;
+    double result = 0;
+    for (size_type i = begin; i < end; ++i)
+    {
+        result += norm(psi[insert_zero(i, target) | bit]);
+    }
+    return result;
+}
+
+QIRSIM_TARGET_CLONES double
+norm_range(Complex const* psi, size_type begin, size_type end)
+{
+    double result = 0;
+    for (size_type k = begin; k < end; ++k)
+    {
+        result += norm(psi[k]);
+    }
+    return result;
+}
+
+QIRSIM_TARGET_CLONES void collapse_range(Complex* psi,
+                                         size_type begin,
+                                         size_type end,
+                                         size_type target,
+                                         bool one,
+                                         double factor)
+{
+    size_type const bit = size_type{1} << target;
+    for (size_type k = begin; k < end; ++k)
+    {
+        psi[k] *= (static_cast<bool>(k & bit) == one) ? factor : 0.0;
+    }
+}
+
+QIRSIM_TARGET_CLONES double expectation_range(Complex const* psi,
+                                              size_type begin,
+                                              size_type end,
+                                              PauliString const& p,
+                                              Complex phase)
+{
+    double result = 0;
+    for (size_type k = begin; k < end; ++k)
+    {
+        Complex const c = parity(k & p.z) ? -phase : phase;
+        result += (mul(std::conj(psi[k ^ p.x]), mul(c, psi[k]))).real();
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a single-qubit unitary.
+ */
+void apply_matrix(StateRef psi,
+                  size_type target,
+                  Matrix2 const& m,
+                  QubitMask controls)
+{
+    QIREE_EXPECT(psi.size != 1);
+    for_each_range(psi.size / 2, [&](size_type begin, size_type end) {
+        matrix_range(psi.data, begin, end, target, m, controls);
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a two-qubit operator.
+ *
+ * Qubit \c a is the high bit of the matrix index and \c b the low bit. The
+ * operator need not be unitary: this also applies superoperators of
+ * single-qubit channels to a vectorized density matrix.
+ */
+void apply_matrix4(StateRef psi, size_type a, size_type b, Matrix4 const& m)
+{
+    QIREE_EXPECT(a != b);
+    QIREE_EXPECT(psi.size != 1 && psi.size != 2);
+    for_each_range(psi.size / 4, [&](size_type begin, size_type end) {
+        matrix4_range(psi.data, begin, end, a, b, m);
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a dense operator on up to five qubits.
+ *
+ * The row-major matrix has \f$ 2^n \f$ rows for \em n targets, and bit \em j
+ * of its row and column indices is qubit \c targets[j] . Each group of
+ * amplitudes that the operator mixes is gathered, multiplied, and scattered
+ * in a single pass over the state, so a block of fused gates costs one sweep
+ * of memory rather than one per gate.
+ */
+void apply_dense(StateRef psi,
+                 size_type const* targets,
+                 size_type num_targets,
+                 Complex const* m)
+{
+    QIREE_EXPECT(num_targets > 0 && num_targets <= max_dense_qubits);
+    size_type const dim = size_type{1} << num_targets;
+    QIREE_EXPECT(psi.size == 0 || psi.size >= dim);
+
+    // Offset of each local basis state, and the targets in increasing order
+    // for inserting zeros into the loop index
+    size_type offsets[size_type{1} << max_dense_qubits];
+    size_type sorted[max_dense_qubits];
+    for (size_type l = 0; l < dim; ++l)
+    {
+        offsets[l] = 0;
+        for (size_type j = 0; j < num_targets; ++j)
+        {
+            offsets[l] |= ((l >> j) & 1) << targets[j];
+        }
+    }
+    std::copy(targets, targets + num_targets, sorted);
+    std::sort(sorted, sorted + num_targets);
+    QIREE_EXPECT(std::adjacent_find(sorted, sorted + num_targets)
+                 == sorted + num_targets);
+
+    // Instantiate for each size so that the compiler unrolls the products
+    auto apply = [&](auto n) {
+        for_each_range(psi.size / dim, [&](size_type begin, size_type end) {
+            dense_range<decltype(n)::value>(
+                psi.data, begin, end, sorted, offsets, m);
+        });
+    };
+    switch (num_targets)
+    {
+        // clang-format off
+        case 1: apply(std::integral_constant<size_type, 1>{}); break;
+        case 2: apply(std::integral_constant<size_type, 2>{}); break;
+        case 3: apply(std::integral_constant<size_type, 3>{}); break;
+        case 4: apply(std::integral_constant<size_type, 4>{}); break;
+        case 5: apply(std::integral_constant<size_type, 5>{}); break;
+        // clang-format on
+        default:
+            QIREE_ASSERT_UNREACHABLE();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a diagonal single-qubit operator.
+ */
+void apply_diagonal(StateRef psi,
+                    size_type target,
+                    Complex d0,
+                    Complex d1,
+                    QubitMask controls)
+{
+    for_each_range(psi.size, [&](size_type begin, size_type end) {
+        diagonal_range(psi.data, begin, end, target, d0, d1, controls);
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a (multiply controlled) X gate.
+ */
+void apply_x(StateRef psi, size_type target, QubitMask controls)
+{
+    QIREE_EXPECT(psi.size != 1);
+    for_each_range(psi.size / 2, [&](size_type begin, size_type end) {
+        x_range(psi.data, begin, end, target, controls);
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Exchange two qubits.
+ */
+void apply_swap(StateRef psi, size_type a, size_type b, QubitMask controls)
+{
+    QIREE_EXPECT(a != b);
+    QIREE_EXPECT(psi.size != 1 && psi.size != 2);
+    for_each_range(psi.size / 4, [&](size_type begin, size_type end) {
+        swap_range(
+            psi.data, begin, end, std::min(a, b), std::max(a, b), controls);
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Replace the state with alpha * psi + beta * P psi.
+ *
+ * With \f$ \alpha = \cos\theta \f$ and \f$ \beta = i \sin\theta \f$ this
+ * applies \f$ e^{i\theta P} \f$; with \f$ \alpha = \beta = 1/2 \f$ it
+ * projects onto the +1 eigenspace of \em P .
+ */
+void apply_pauli_sum(StateRef psi,
+                     PauliString const& p,
+                     Complex alpha,
+                     Complex beta,
+                     QubitMask controls)
+{
+    beta *= y_phase(p);
+    if (p.x == 0)
+    {
+        for_each_range(psi.size, [&](size_type begin, size_type end) {
+            pauli_diagonal_range(
+                psi.data, begin, end, p.z, alpha + beta, alpha - beta, controls);
+        });
+        return;
+    }
+
+    // Pair each state with a zero in the lowest flipped qubit with its partner
+    size_type pivot = 0;
+    while (!(p.x & (QubitMask{1} << pivot)))
+    {
+        ++pivot;
+    }
+    for_each_range(psi.size / 2, [&](size_type begin, size_type end) {
+        pauli_pair_range(
+            psi.data, begin, end, pivot, p, alpha, beta, controls);
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Multiply every amplitude by a real factor.
+ */
+void scale(StateRef psi, double factor)
+{
+    for_each_range(psi.size, [&](size_type begin, size_type end) {
+        scale_range(psi.data, begin, end, factor);
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Probability of measuring a qubit in |1>.
+ */
+double probability_one(StateRef psi, size_type target)
+{
+    QIREE_EXPECT(psi.size >= 2);
+    return sum_ranges(psi.size / 2, [&](size_type begin, size_type end) {
+        return probability_one_range(psi.data, begin, end, target);
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Total probability of each block of consecutive basis states.
+ *
+ * The block size must be a power of two no larger than the parallel chunk
+ * size, so that chunks contain whole blocks.
+ */
+void block_probabilities(StateRef psi, size_type block_size, double* result)
+{
+    QIREE_EXPECT(block_size > 0 && (block_size & (block_size - 1)) == 0);
+    QIREE_EXPECT(block_size <= chunk_size && psi.size % block_size == 0);
+    for_each_range(psi.size, [&](size_type begin, size_type end) {
+        for (size_type k = begin; k < end; k += block_size)
+        {
+            result[k / block_size] = norm_range(psi.data, k, k + block_size);
+        }
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Project a qubit onto a measured state and renormalize.
+ */
+void collapse(StateRef psi, size_type target, bool one, double probability)
+{
+    QIREE_EXPECT(probability > 0);
+    double const factor = 1 / std::sqrt(probability);
+    for_each_range(psi.size, [&](size_type begin, size_type end) {
+        collapse_range(psi.data, begin, end, target, one, factor);
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Expectation value of a Pauli string.
+ */
+double pauli_expectation(StateRef psi, PauliString const& p)
+{
+    Complex const phase = y_phase(p);
+    return sum_ranges(psi.size, [&](size_type begin, size_type end) {
+        return expectation_range(psi.data, begin, end, p, phase);
+    });
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
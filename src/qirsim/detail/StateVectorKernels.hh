@@ -0,0 +1,138 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/StateVectorKernels.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <array>
+#include <complex>
+#include <cstdint>
+
+#include "qiree/Types.hh"
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+// TYPES
+//---------------------------------------------------------------------------//
+
+using Complex = std::complex<double>;
+
+//! Bit mask of qubits (bit i is qubit i)
+using QubitMask = std::uint64_t;
+
+//! Row-major single-qubit unitary
+using Matrix2 = std::array<Complex, 4>;
+
+//! Row-major two-qubit operator (the first qubit is the high bit)
+using Matrix4 = std::array<Complex, 16>;
+
+//! Maximum number of qubits of a dense operator
+constexpr size_type max_dense_qubits = 5;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Tensor product of Pauli operators.
+ *
+ * Qubits in \c x have an X or Y operator, and those in \c z have a Z or Y:
+ * \f[
+   P|k\rangle = i^{n_Y} (-1)^{|k \wedge z|} |k \oplus x\rangle .
+ * \f]
+ */
+struct PauliString
+{
+    QubitMask x{0};
+    QubitMask z{0};
+
+    //! Add an operator on a qubit
+    void push_back(Pauli p, size_type qubit)
+    {
+        QubitMask bit = QubitMask{1} << qubit;
+        if (p == Pauli::x || p == Pauli::y)
+        {
+            x |= bit;
+        }
+        if (p == Pauli::z || p == Pauli::y)
+        {
+            z |= bit;
+        }
+    }
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * State vector with \c size amplitudes indexed by little-endian basis state.
+ *
+ * Operations whose controls (a mask of qubits that must all be |1>) aren't
+ * satisfied leave the amplitude unchanged. Gates applied to an empty state do
+ * nothing, which lets a simulator skip over operations whose result is
+ * already known.
+ */
+struct StateRef
+{
+    Complex* data{nullptr};
+    size_type size{0};
+};
+
+//---------------------------------------------------------------------------//
+// KERNELS
+//---------------------------------------------------------------------------//
+
+// Apply a single-qubit unitary
+void apply_matrix(StateRef psi,
+                  size_type target,
+                  Matrix2 const& m,
+                  QubitMask controls);
+
+// Apply a two-qubit operator
+void apply_matrix4(StateRef psi, size_type a, size_type b, Matrix4 const& m);
+
+// Apply a dense operator on up to five qubits
+void apply_dense(StateRef psi,
+                 size_type const* targets,
+                 size_type num_targets,
+                 Complex const* m);
+
+// Apply a diagonal single-qubit operator
+void apply_diagonal(StateRef psi,
+                    size_type target,
+                    Complex d0,
+                    Complex d1,
+                    QubitMask controls);
+
+// Apply a (multiply controlled) X gate
+void apply_x(StateRef psi, size_type target, QubitMask controls);
+
+// Exchange two qubits
+void apply_swap(StateRef psi, size_type a, size_type b, QubitMask controls);
+
+// Replace the state with alpha * psi + beta * P psi
+void apply_pauli_sum(StateRef psi,
+                     PauliString const& p,
+                     Complex alpha,
+                     Complex beta,
+                     QubitMask controls);
+
+// Multiply every amplitude by a real factor
+void scale(StateRef psi, double factor);
+
+// Probability of measuring a qubit in |1>
+double probability_one(StateRef psi, size_type target);
+
+// Total probability of each block of consecutive basis states
+void block_probabilities(StateRef psi, size_type block_size, double* result);
+
+// Project a qubit onto a measured state and renormalize
+void collapse(StateRef psi, size_type target, bool one, double probability);
+
+// Expectation value of a Pauli string
+double pauli_expectation(StateRef psi, PauliString const& p);
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -0,0 +1,208 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/Svd.cc
+//---------------------------------------------------------------------------//
+#include "Svd.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "qiree/Assert.hh"
+
+namespace qiree
+{
+namespace detail
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+using Complex = std::complex<double>;
+
+// Sweeps after which the rotations are only reducing round-off
+constexpr int max_sweeps = 64;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a plane rotation to two columns.
+ *
+ * The second column is first multiplied by the conjugate phase of the
+ * columns' inner product so that the rotation is real.
+ */
+void rotate_columns(
+    Complex* p, Complex* q, size_type size, double c, double s, Complex phase)
+{
+    for (size_type i = 0; i < size; ++i)
+    {
+        Complex const x = p[i];
+        Complex const y = q[i] * std::conj(phase);
+        p[i] = c * x - s * y;
+        q[i] = s * x + c * y;
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Decompose a row-major matrix.
+ *
+ * This uses one-sided Jacobi rotations (Hestenes' method) on the columns of
+ * the matrix or, if it is wide, of its conjugate transpose: pairs of columns
+ * are rotated until all are mutually orthogonal, and the rotations accumulate
+ * into the right singular vectors. The method is simple and accurate for the
+ * small matrices of tensor network simulation; its cost is
+ * \f$ O(m n^2) \f$ per sweep with a handful of sweeps.
+ */
+void svd(size_type rows, size_type cols, Complex const* a, SvdResult& result)
+{
+    QIREE_EXPECT(rows > 0 && cols > 0);
+
+    // Store the tall matrix B (A or its conjugate transpose) by column
+    bool const wide = rows < cols;
+    size_type const m = wide ? cols : rows;
+    size_type const n = wide ? rows : cols;
+    std::vector<Complex> w(m * n);
+    for (size_type i = 0; i < rows; ++i)
+    {
+        for (size_type j = 0; j < cols; ++j)
+        {
+            Complex const value = a[i * cols + j];
+            if (wide)
+            {
+                w[i * m + j] = std::conj(value);
+            }
+            else
+            {
+                w[j * m + i] = value;
+            }
+        }
+    }
+    std::vector<Complex> v(n * n, Complex{0});
+    for (size_type j = 0; j < n; ++j)
+    {
+        v[j * n + j] = 1;
+    }
+
+    // Orthogonalize pairs of columns of B, accumulating V
+    double const tolerance = m * std::numeric_limits<double>::epsilon();
+    std::vector<double> norms(n);
+    auto update_norms = [&] {
+        for (size_type j = 0; j < n; ++j)
+        {
+            double sum = 0;
+            for (size_type i = 0; i < m; ++i)
+            {
+                sum += std::norm(w[j * m + i]);
+            }
+            norms[j] = sum;
+        }
+    };
+    for (int sweep = 0; sweep < max_sweeps; ++sweep)
+    {
+        // Squared column norms are updated by each rotation and recomputed
+        // every sweep to limit the accumulated round-off
+        update_norms();
+        double const negligible
+            = tolerance * tolerance
+              * *std::max_element(norms.begin(), norms.end());
+        bool rotated = false;
+        for (size_type p = 0; p + 1 < n; ++p)
+        {
+            for (size_type q = p + 1; q < n; ++q)
+            {
+                Complex* wp = w.data() + p * m;
+                Complex* wq = w.data() + q * m;
+                Complex gamma = 0;
+                for (size_type i = 0; i < m; ++i)
+                {
+                    gamma += std::conj(wp[i]) * wq[i];
+                }
+                // Skip orthogonal pairs and columns at the round-off level
+                double const g = std::abs(gamma);
+                if (g <= tolerance * std::sqrt(norms[p] * norms[q])
+                    || std::min(norms[p], norms[q]) <= negligible)
+                {
+                    continue;
+                }
+                rotated = true;
+
+                double const zeta = (norms[q] - norms[p]) / (2 * g);
+                double const t = std::copysign(1.0, zeta)
+                                 / (std::fabs(zeta) + std::hypot(1.0, zeta));
+                double const c = 1 / std::hypot(1.0, t);
+                double const s = c * t;
+                Complex const phase = std::polar(1.0, std::arg(gamma));
+                rotate_columns(wp, wq, m, c, s, phase);
+                rotate_columns(
+                    v.data() + p * n, v.data() + q * n, n, c, s, phase);
+                norms[p] -= t * g;
+                norms[q] += t * g;
+            }
+        }
+        if (!rotated)
+        {
+            break;
+        }
+    }
+
+    // Singular values are the column norms of B V, sorted in decreasing order
+    update_norms();
+    std::vector<double> sigma(n);
+    for (size_type j = 0; j < n; ++j)
+    {
+        sigma[j] = std::sqrt(norms[j]);
+    }
+    std::vector<size_type> order(n);
+    std::iota(order.begin(), order.end(), size_type{0});
+    std::stable_sort(order.begin(), order.end(), [&sigma](auto i, auto j) {
+        return sigma[i] > sigma[j];
+    });
+
+    // B = U_B S V^H, so A = U_B S V^H or, if wide, V S U_B^H
+    size_type const k = n;
+    result.rank = k;
+    result.s.resize(k);
+    result.u.assign(rows * k, Complex{0});
+    result.vh.assign(k * cols, Complex{0});
+    for (size_type jj = 0; jj < k; ++jj)
+    {
+        size_type const j = order[jj];
+        double const s = sigma[j];
+        double const inv_s = s > 0 ? 1 / s : 0;
+        result.s[jj] = s;
+        Complex const* wj = w.data() + j * m;
+        Complex const* vj = v.data() + j * n;
+        if (wide)
+        {
+            for (size_type i = 0; i < rows; ++i)
+            {
+                result.u[i * k + jj] = vj[i];
+            }
+            for (size_type i = 0; i < cols; ++i)
+            {
+                result.vh[jj * cols + i] = std::conj(wj[i]) * inv_s;
+            }
+        }
+        else
+        {
+            for (size_type i = 0; i < rows; ++i)
+            {
+                result.u[i * k + jj] = wj[i] * inv_s;
+            }
+            for (size_type i = 0; i < cols; ++i)
+            {
+                result.vh[jj * cols + i] = std::conj(vj[i]);
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
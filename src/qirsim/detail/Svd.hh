@@ -0,0 +1,47 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/Svd.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <complex>
+#include <vector>
+
+#include "qiree/Types.hh"
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Singular value decomposition of a complex matrix.
+ *
+ * A row-major \em m by \em n matrix is factored as
+ * \f$ A = U \Sigma V^\dagger \f$ with \em k = min(\em m, \em n) singular
+ * values in decreasing order. \c u is row-major \em m by \em k with
+ * orthonormal columns and \c vh is row-major \em k by \em n with orthonormal
+ * rows, except that singular vectors for singular values at the round-off
+ * level may be zero or not orthogonal to the others.
+ */
+struct SvdResult
+{
+    size_type rank{0};
+    std::vector<std::complex<double>> u;
+    std::vector<double> s;
+    std::vector<std::complex<double>> vh;
+};
+
+//---------------------------------------------------------------------------//
+// Decompose a row-major matrix
+void svd(size_type rows,
+         size_type cols,
+         std::complex<double> const* a,
+         SvdResult& result);
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
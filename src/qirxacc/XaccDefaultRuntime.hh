@@ -8,7 +8,7 @@
 #pragma once
 
 #include "qiree/RuntimeInterface.hh"
-#include "qirxacc/MemManager.hh"
+#include "qiree/MemManager.hh"
 #include "qirxacc/XaccQuantum.hh"
 
 namespace qiree
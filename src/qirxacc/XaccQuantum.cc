@@ -16,7 +16,7 @@
 #include <xacc/xacc_service.hpp>
 
 #include "qiree/Assert.hh"
-#include "qirxacc/MemManager.hh"
+#include "qiree/MemManager.hh"
 
 using xacc::constants::pi;
 
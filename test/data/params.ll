@@ -0,0 +1,51 @@
+; ModuleID = 'params'
+source_filename = "params"
+
+%Qubit = type opaque
+%Result = type opaque
+
+; Rotate a qubit 'n' times and return the number of gates plus the result
+define i64 @rotate(i64 %n, double %theta) #0 {
+entry:
+  br label %loop
+
+loop:                                        ; preds = %loop, %entry
+  %i = phi i64 [ 0, %entry ], [ %next, %loop ]
+  call void @__quantum__qis__rx__body(double %theta, %Qubit* null)
+  %next = add i64 %i, 1
+  %done = icmp sge i64 %next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:                                        ; preds = %loop
+  call void @__quantum__qis__mz__body(%Qubit* null, %Result* null)
+  %bit = call i1 @__quantum__qis__read_result__body(%Result* null)
+  %ext = zext i1 %bit to i64
+  %result = add i64 %next, %ext
+  ret i64 %result
+}
+
+; Classical function of a single-precision argument
+define double @half(float %x) #0 {
+  %d = fpext float %x to double
+  %y = fmul double %d, 5.000000e-01
+  ret double %y
+}
+
+; Straight-line program with a return value
+define i32 @answer() #0 {
+  call void @__quantum__qis__h__body(%Qubit* null)
+  ret i32 42
+}
+
+; Unsupported argument type
+define void @pointer(i8* %p) #0 {
+  ret void
+}
+
+declare void @__quantum__qis__h__body(%Qubit*)
+declare void @__quantum__qis__rx__body(double, %Qubit*)
+declare void @__quantum__qis__mz__body(%Qubit*, %Result* writeonly) #1
+declare i1 @__quantum__qis__read_result__body(%Result*)
+
+attributes #0 = { "EntryPoint" "num_required_qubits"="1" "num_required_results"="1"}
+attributes #1 = { "irreversible" }
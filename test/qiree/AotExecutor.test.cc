@@ -0,0 +1,160 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/AotExecutor.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/AotExecutor.hh"
+
+#include <filesystem>
+
+#include "QuantumTestImpl.hh"
+#include "qiree/AotCompiler.hh"
+#include "qiree/Assert.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree/QuantumNotImpl.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class AotExecutorTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override
+    {
+        auto const* info
+            = ::testing::UnitTest::GetInstance()->current_test_info();
+        directory_ = std::filesystem::absolute(std::string("aot-")
+                                               + info->name());
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(directory_); }
+
+    //! Compile a test file to a library in the test directory
+    std::string compile(std::string const& filename)
+    {
+        auto library = (directory_ / (filename + ".so")).string();
+        AotCompiler compile_lib{this->options};
+        compile_lib(Module{this->test_data_path(filename)}, library);
+        return library;
+    }
+
+    //! Run with the test interface
+    template<class E>
+    static std::string run(E const& execute)
+    {
+        TestResult tr;
+        QuantumTestImpl quantum_impl(&tr);
+        ResultTestImpl result_impl(&tr);
+        execute(quantum_impl, result_impl);
+        return tr.commands.str();
+    }
+
+    //! Run with the JIT for comparison
+    std::string run_jit(std::string const& filename)
+    {
+        Executor::Options opts;
+        opts.static_replay = false;
+        return run(Executor{Module{this->test_data_path(filename)}, opts});
+    }
+
+    AotCompiler::Options options;
+    std::filesystem::path directory_;
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(AotExecutorTest, same_as_jit)
+{
+    for (char const* filename : {"bell.ll",
+                                 "labeled.ll",
+                                 "loop.ll",
+                                 "multiple.ll",
+                                 "pyqir_several_gates.ll",
+                                 "rotation.ll",
+                                 "teleport.ll",
+                                 "unreachable.ll"})
+    {
+        for (auto level :
+             {AotCompiler::OptLevel::O0, AotCompiler::OptLevel::O2})
+        {
+            this->options.opt_level = level;
+            AotExecutor execute{this->compile(filename)};
+            EXPECT_EQ(this->run_jit(filename), run(execute))
+                << filename << " at " << to_cstring(level);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(AotExecutorTest, attributes)
+{
+    AotExecutor execute{this->compile("bell.ll")};
+    EntryPointAttrs const& attrs = execute.entry_point_attrs();
+    EXPECT_EQ(2, attrs.required_num_qubits);
+    EXPECT_EQ(2, attrs.required_num_results);
+    EXPECT_EQ("", attrs.output_labeling_schema);
+    EXPECT_EQ("custom", attrs.qir_profiles);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(AotExecutorTest, object_file)
+{
+    auto object_file = (directory_ / "bell.o").string();
+    auto library = (directory_ / "libbell.so").string();
+    AotCompiler compile_lib;
+    compile_lib.compile(Module{this->test_data_path("bell.ll")}, object_file);
+    EXPECT_TRUE(std::filesystem::exists(object_file));
+    compile_lib.link(object_file, library);
+
+    AotExecutor execute{library};
+    EXPECT_EQ(this->run_jit("bell.ll"), run(execute));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(AotExecutorTest, exception)
+{
+    // Quantum interface that fails on every instruction
+    class QuantumFailImpl final : public QuantumNotImpl
+    {
+      public:
+        void set_up(EntryPointAttrs const&) final {}
+        void tear_down() final {}
+    };
+
+    AotExecutor execute{this->compile("loop.ll")};
+    TestResult tr;
+    QuantumFailImpl fail_impl;
+    ResultTestImpl result_impl(&tr);
+
+    // Exception propagates through the compiled library
+    EXPECT_THROW(execute(fail_impl, result_impl), DebugError);
+
+    // Executor is usable afterward
+    QuantumTestImpl quantum_impl(&tr);
+    EXPECT_NO_THROW(execute(quantum_impl, result_impl));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(AotExecutorTest, errors)
+{
+    // Reachable function isn't implemented
+    auto path = (directory_ / "unreachable.o").string();
+    Module helper{this->test_data_path("unreachable.ll"),
+                  "unreachable_helper"};
+    EXPECT_THROW(AotCompiler{}.compile(std::move(helper), path), DebugError);
+
+    // Not a shared library
+    EXPECT_THROW(AotExecutor{this->test_data_path("bell.ll")}, RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
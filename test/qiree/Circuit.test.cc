@@ -0,0 +1,95 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/Circuit.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/Circuit.hh"
+
+#include <vector>
+
+#include "qiree/Types.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+using VecIndex = Circuit::VecIndex;
+
+class CircuitTest : public ::qiree::test::Test
+{
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(CircuitTest, operations)
+{
+    Circuit c;
+    EXPECT_TRUE(c.empty());
+    c.push_back({GateOp::h, {}, {0}});
+    c.push_back({GateOp::x, {0, 2}, {1}});
+    c.push_back({GateOp::rzz, {}, {3, 1}, {}, 0.25});
+    c.push_back({GateOp::pauli_rotation,
+                 {4},
+                 {0, 2},
+                 {Pauli::x, Pauli::y},
+                 -1.5});
+    c.push_back({GateOp::measure_z, {}, {1}, {}, 0, Result{7}});
+    c.push_back({GateOp::measure_pauli, {}, {0}, {Pauli::z}, 0, Result{8}});
+    EXPECT_EQ(6, c.size());
+    EXPECT_EQ(11, c.num_operands());
+    EXPECT_EQ(5, c.num_qubits());
+
+    auto op = c[1];
+    EXPECT_EQ(GateOp::x, op.op);
+    EXPECT_EQ(VecIndex({0, 2}),
+              VecIndex(op.controls, op.controls + op.num_controls));
+    EXPECT_EQ(VecIndex({1}), VecIndex(op.targets, op.targets + op.num_targets));
+    EXPECT_EQ(nullptr, op.paulis);
+
+    op = c[2];
+    EXPECT_EQ(0, op.num_controls);
+    EXPECT_EQ(VecIndex({3, 1}),
+              VecIndex(op.targets, op.targets + op.num_targets));
+    EXPECT_EQ(0.25, op.theta);
+
+    op = c[3];
+    EXPECT_EQ(GateOp::pauli_rotation, op.op);
+    EXPECT_EQ(4, op.controls[0]);
+    ASSERT_EQ(2, op.num_targets);
+    EXPECT_EQ(Pauli::x, op.paulis[0]);
+    EXPECT_EQ(Pauli::y, op.paulis[1]);
+    EXPECT_EQ(-1.5, op.theta);
+
+    EXPECT_EQ(7, c[4].result.value);
+    EXPECT_EQ(8, c[5].result.value);
+    EXPECT_EQ(Pauli::z, c[5].paulis[0]);
+
+    // Views can be copied between circuits
+    Circuit copy;
+    for (size_type i = 0; i < c.size(); ++i)
+    {
+        copy.append(c[i]);
+    }
+    EXPECT_EQ(c.num_operands(), copy.num_operands());
+    EXPECT_EQ(-1.5, copy[3].theta);
+    EXPECT_EQ(Pauli::y, copy[3].paulis[1]);
+
+    auto counts = c.count_ops();
+    EXPECT_EQ(1, counts[static_cast<int>(GateOp::x)]);
+    EXPECT_EQ(0, counts[static_cast<int>(GateOp::swap)]);
+    EXPECT_STREQ("pauli_rotation", to_cstring(GateOp::pauli_rotation));
+
+    c.clear();
+    EXPECT_TRUE(c.empty());
+    EXPECT_EQ(0, c.num_qubits());
+    c.push_back({GateOp::ry, {}, {2}, {}, 0.5});
+    EXPECT_EQ(0.5, c[0].theta);
+    EXPECT_EQ(3, c.num_qubits());
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
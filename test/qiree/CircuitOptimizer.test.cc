@@ -0,0 +1,180 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/CircuitOptimizer.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/CircuitOptimizer.hh"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "qiree/Types.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+constexpr double pi = 3.141592653589793;
+
+class CircuitOptimizerTest : public ::qiree::test::Test
+{
+  protected:
+    //! Optimize the input and return the opcodes of the result
+    std::vector<GateOp> optimize()
+    {
+        optimize_(input, &output);
+        std::vector<GateOp> result;
+        for (size_type i = 0; i < output.size(); ++i)
+        {
+            result.push_back(output.op(i));
+        }
+        input.clear();
+        return result;
+    }
+
+    Circuit input;
+    Circuit output;
+    CircuitOptimizer optimize_;
+};
+
+using VecOp = std::vector<GateOp>;
+
+//---------------------------------------------------------------------------//
+TEST_F(CircuitOptimizerTest, cancel)
+{
+    // Cancellation cascades once inner pairs are removed
+    input.push_back({GateOp::h, {}, {0}});
+    input.push_back({GateOp::x, {}, {0}});
+    input.push_back({GateOp::x, {}, {0}});
+    input.push_back({GateOp::h, {}, {0}});
+    input.push_back({GateOp::s, {}, {1}});
+    input.push_back({GateOp::s_adj, {}, {1}});
+    input.push_back({GateOp::t_adj, {}, {1}});
+    input.push_back({GateOp::t, {}, {1}});
+    input.push_back({GateOp::swap, {}, {0, 1}});
+    input.push_back({GateOp::swap, {}, {1, 0}});
+    EXPECT_EQ(VecOp{}, this->optimize());
+
+    // CNOT pairs cancel, and X commutes with a CNOT target
+    input.push_back({GateOp::x, {}, {1}});
+    input.push_back({GateOp::x, {0}, {1}});
+    input.push_back({GateOp::x, {}, {1}});
+    input.push_back({GateOp::x, {2, 0}, {1}});
+    input.push_back({GateOp::x, {0, 2}, {1}});
+    EXPECT_EQ(VecOp{GateOp::x}, this->optimize());
+    EXPECT_EQ(1, output[0].num_controls);
+
+    // Z commutes with controls but not with H
+    input.push_back({GateOp::z, {}, {0}});
+    input.push_back({GateOp::x, {0}, {1}});
+    input.push_back({GateOp::z, {}, {0}});
+    input.push_back({GateOp::h, {}, {1}});
+    input.push_back({GateOp::z, {}, {1}});
+    input.push_back({GateOp::h, {}, {1}});
+    input.push_back({GateOp::z, {}, {1}});
+    EXPECT_EQ((VecOp{GateOp::x, GateOp::h, GateOp::z, GateOp::h, GateOp::z}),
+              this->optimize());
+
+    // Operations on other qubits are transparent but measurements aren't
+    input.push_back({GateOp::h, {}, {0}});
+    input.push_back({GateOp::h, {}, {1}});
+    input.push_back({GateOp::measure_z, {}, {1}, {}, 0, Result{0}});
+    input.push_back({GateOp::h, {}, {0}});
+    input.push_back({GateOp::h, {}, {1}});
+    EXPECT_EQ((VecOp{GateOp::h, GateOp::measure_z, GateOp::h}),
+              this->optimize());
+    EXPECT_EQ(0, output[1].result.value);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(CircuitOptimizerTest, merge)
+{
+    // Rotations merge across a CNOT control
+    input.push_back({GateOp::rz, {}, {0}, {}, 0.5});
+    input.push_back({GateOp::x, {0}, {1}});
+    input.push_back({GateOp::rz, {}, {0}, {}, 0.25});
+    input.push_back({GateOp::rzz, {}, {0, 1}, {}, 0.125});
+    input.push_back({GateOp::rzz, {}, {1, 0}, {}, 0.5});
+    EXPECT_EQ((VecOp{GateOp::rz, GateOp::x, GateOp::rzz}), this->optimize());
+    EXPECT_DOUBLE_EQ(0.75, output[0].theta);
+    EXPECT_DOUBLE_EQ(0.625, output[2].theta);
+
+    // Opposite rotations vanish past operations on other qubits
+    input.push_back({GateOp::rx, {}, {0}, {}, 1.0});
+    input.push_back({GateOp::ry, {}, {1}, {}, 0.5});
+    input.push_back({GateOp::rx, {}, {0}, {}, -1.0});
+    input.push_back({GateOp::ry, {}, {0}, {}, 0.5});
+    input.push_back({GateOp::pauli_rotation,
+                     {},
+                     {0, 1},
+                     {Pauli::x, Pauli::z},
+                     0.5});
+    input.push_back({GateOp::pauli_rotation,
+                     {},
+                     {0, 1},
+                     {Pauli::x, Pauli::z},
+                     -0.5});
+    EXPECT_EQ((VecOp{GateOp::ry, GateOp::ry}), this->optimize());
+    EXPECT_EQ(1, output[0].targets[0]);
+    EXPECT_EQ(0, output[1].targets[0]);
+
+    // Different Paulis don't merge
+    input.push_back({GateOp::pauli_rotation, {}, {0}, {Pauli::x}, 0.5});
+    input.push_back({GateOp::pauli_rotation, {}, {0}, {Pauli::y}, 0.5});
+    EXPECT_EQ(2, this->optimize().size());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(CircuitOptimizerTest, identity)
+{
+    // Full turns are a global phase without controls
+    input.push_back({GateOp::rz, {}, {0}, {}, 2 * pi});
+    input.push_back({GateOp::rxx, {}, {0, 1}, {}, -4 * pi});
+    input.push_back({GateOp::pauli_rotation, {}, {0}, {Pauli::i}, 0.3});
+    input.push_back({GateOp::ry, {}, {0}, {}, 0.0});
+    EXPECT_EQ(VecOp{}, this->optimize());
+
+    // Controlled full turns are a relative phase
+    input.push_back({GateOp::rz, {1}, {0}, {}, 2 * pi});
+    input.push_back({GateOp::pauli_rotation, {1}, {0}, {Pauli::i}, 0.3});
+    input.push_back({GateOp::rz, {1}, {0}, {}, 2 * pi});
+    EXPECT_EQ((VecOp{GateOp::pauli_rotation}), this->optimize());
+    EXPECT_DOUBLE_EQ(0.3, output[0].theta);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(CircuitOptimizerTest, counts)
+{
+    input.push_back({GateOp::h, {}, {0}});
+    input.push_back({GateOp::h, {}, {0}});
+    input.push_back({GateOp::x, {}, {0}});
+    this->optimize();
+    input.push_back({GateOp::x, {}, {0}});
+    this->optimize();
+
+    auto const& before = optimize_.counts_before();
+    auto const& after = optimize_.counts_after();
+    ASSERT_EQ(static_cast<size_type>(GateOp::size_), before.size());
+    EXPECT_EQ(2, before[static_cast<int>(GateOp::h)]);
+    EXPECT_EQ(0, after[static_cast<int>(GateOp::h)]);
+    EXPECT_EQ(2, before[static_cast<int>(GateOp::x)]);
+    EXPECT_EQ(2, after[static_cast<int>(GateOp::x)]);
+
+    std::ostringstream os;
+    optimize_.print_counts(os);
+    EXPECT_EQ(R"(operation           before     after
+h                        2         0
+x                        2         2
+total                    4         2
+)",
+              os.str());
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
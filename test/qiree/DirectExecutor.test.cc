@@ -0,0 +1,167 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/DirectExecutor.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/DirectExecutor.hh"
+
+#include <cstdint>
+
+#include "QuantumTestImpl.hh"
+#include "qiree/Assert.hh"
+#include "qiree/QuantumNotImpl.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Count gates with inline implementations.
+ *
+ * Like the XACC interface, this derives virtually from \c QuantumNotImpl.
+ */
+class QuantumCountImpl final : virtual public QuantumNotImpl
+{
+  public:
+    using QuantumNotImpl::cnot;
+    using QuantumNotImpl::h;
+
+    void set_up(EntryPointAttrs const&) final { num_gates = 0; }
+    void tear_down() final {}
+
+    void h(Qubit) final { ++num_gates; }
+    void cnot(Qubit, Qubit) final { ++num_gates; }
+    void mz(Qubit, Result) final {}
+    QState read_result(Result) final { return QState::zero; }
+
+    size_type num_gates{0};
+};
+
+//---------------------------------------------------------------------------//
+
+class DirectExecutorTest : public ::qiree::test::Test
+{
+  protected:
+    using DirectTestExecutor = DirectExecutor<QuantumTestImpl, ResultTestImpl>;
+
+    //! Run with the virtual and direct executors
+    std::pair<std::string, std::string> run(std::string const& filename)
+    {
+        std::pair<std::string, std::string> result;
+        {
+            Executor execute{Module{this->test_data_path(filename)},
+                             this->options};
+            TestResult tr;
+            QuantumTestImpl quantum_impl(&tr);
+            ResultTestImpl result_impl(&tr);
+            execute(quantum_impl, result_impl);
+            result.first = tr.commands.str();
+        }
+        {
+            DirectTestExecutor execute{Module{this->test_data_path(filename)},
+                                       this->options};
+            TestResult tr;
+            QuantumTestImpl quantum_impl(&tr);
+            ResultTestImpl result_impl(&tr);
+            execute(quantum_impl, result_impl);
+            result.second = tr.commands.str();
+        }
+        return result;
+    }
+
+    Executor::Options options;
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(DirectExecutorTest, same_as_virtual)
+{
+    for (auto engine : {Executor::Engine::mcjit, Executor::Engine::orc_lazy})
+    {
+        this->options.engine = engine;
+        for (bool static_replay : {false, true})
+        {
+            this->options.static_replay = static_replay;
+            for (char const* filename : {"bell.ll", "loop.ll", "labeled.ll"})
+            {
+                auto [expected, actual] = this->run(filename);
+                EXPECT_EQ(expected, actual)
+                    << filename << " with " << to_cstring(engine)
+                    << (static_replay ? " (static)" : "");
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(DirectExecutorTest, mixed)
+{
+    // Alternate between virtual and direct executions
+    DirectExecutor<QuantumCountImpl, RuntimeInterface> direct_execute{
+        Module{this->test_data_path("loop.ll")}};
+    Executor virtual_execute{Module{this->test_data_path("bell.ll")}};
+
+    TestResult tr;
+    ResultTestImpl result_impl(&tr);
+    QuantumCountImpl count_impl;
+    QuantumTestImpl quantum_impl(&tr);
+    virtual_execute(quantum_impl, result_impl);
+    direct_execute(count_impl, result_impl);
+    EXPECT_EQ(5, count_impl.num_gates);
+    virtual_execute(quantum_impl, result_impl);
+    EXPECT_EQ(R"(
+set_up(q=2, r=2)
+h(Q{0})
+cnot(Q{0}, Q{1})
+mz(Q{0},R{0})
+mz(Q{1},R{1})
+array_record_output(2)
+result_record_output(R{0})
+result_record_output(R{1})
+tear_down
+array_record_output(1)
+result_record_output(R{0})
+set_up(q=2, r=2)
+h(Q{0})
+cnot(Q{0}, Q{1})
+mz(Q{0},R{0})
+mz(Q{1},R{1})
+array_record_output(2)
+result_record_output(R{0})
+result_record_output(R{1})
+tear_down
+)",
+              tr.commands.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(DirectExecutorTest, entry_point)
+{
+    using Signature = std::int64_t(std::int64_t, double);
+    Module mod{this->test_data_path("params.ll"), "rotate"};
+    DirectTestExecutor execute{std::move(mod)};
+    auto rotate = execute.entry_point<Signature>();
+
+    TestResult tr;
+    QuantumTestImpl quantum_impl(&tr);
+    ResultTestImpl result_impl(&tr);
+    EXPECT_EQ(3, rotate(quantum_impl, result_impl, 3, 0.5));
+    EXPECT_EQ(R"(
+set_up(q=1, r=1)
+rx(0.5, Q{0})
+rx(0.5, Q{0})
+rx(0.5, Q{0})
+mz(Q{0},R{0})
+read_result(R{0})
+tear_down
+)",
+              tr.commands.str());
+    EXPECT_THROW(execute.entry_point<void()>(), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
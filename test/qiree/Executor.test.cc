@@ -7,9 +7,15 @@
 //---------------------------------------------------------------------------//
 #include "qiree/Executor.hh"
 
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "QuantumTestImpl.hh"
 #include "qiree/Assert.hh"
 #include "qiree/Module.hh"
+#include "qiree/QuantumNotImpl.hh"
 #include "qiree_test.hh"
 
 namespace qiree
@@ -26,6 +32,8 @@ class ExecutorTest : public ::qiree::test::Test
     TestResult run(std::string const& filename);
     TestResult run(std::string const& filename, std::string const& entry);
 
+    Executor::Options options;
+
   private:
     TestResult run_impl(Module&& m);
 };
@@ -47,7 +55,7 @@ ExecutorTest::run(std::string const& filename, std::string const& entry)
 TestResult ExecutorTest::run_impl(Module&& m)
 {
     QIREE_EXPECT(m);
-    Executor execute(std::move(m));
+    Executor execute(std::move(m), this->options);
 
     // Run with the test interface
     TestResult tr;
@@ -206,6 +214,436 @@ tear_down
     // cout << result.commands.str();
 }
 
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, mcjit)
+{
+    this->options.engine = Executor::Engine::mcjit;
+    this->options.static_replay = false;
+    auto result = this->run("bell.ll");
+    EXPECT_EQ(R"(
+set_up(q=2, r=2)
+h(Q{0})
+cnot(Q{0}, Q{1})
+mz(Q{0},R{0})
+mz(Q{1},R{1})
+array_record_output(2)
+result_record_output(R{0})
+result_record_output(R{1})
+tear_down
+)",
+              result.commands.str());
+
+    result = this->run("loop.ll", "main");
+    EXPECT_EQ(R"(
+set_up(q=1, r=1)
+h(Q{0})
+h(Q{0})
+h(Q{0})
+h(Q{0})
+h(Q{0})
+mz(Q{0},R{0})
+array_record_output(1)
+result_record_output(R{0})
+tear_down
+)",
+              result.commands.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, unreachable)
+{
+    this->options.static_replay = false;
+
+    // Only functions reachable from the entry point are compiled
+    auto result = this->run("unreachable.ll");
+    EXPECT_EQ(R"(
+set_up(q=1, r=1)
+h(Q{0})
+mz(Q{0},R{0})
+array_record_output(1)
+result_record_output(R{0})
+tear_down
+)",
+              result.commands.str());
+
+    // MCJIT compiles the whole module, including the unavailable function
+    this->options.engine = Executor::Engine::mcjit;
+    EXPECT_THROW(this->run("unreachable.ll"), DebugError);
+
+    // ...unless its body is never loaded from bitcode
+    Executor execute{
+        Module::from_file_lazy(this->test_data_path("unreachable.bc")),
+        this->options};
+    TestResult tr;
+    QuantumTestImpl quantum_impl(&tr);
+    ResultTestImpl result_impl(&tr);
+    execute(quantum_impl, result_impl);
+    EXPECT_EQ(result.commands.str(), tr.commands.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, exception)
+{
+    // Quantum interface that fails on every instruction
+    class QuantumFailImpl final : public QuantumNotImpl
+    {
+      public:
+        void set_up(EntryPointAttrs const&) final {}
+        void tear_down() final {}
+    };
+
+    this->options.static_replay = false;
+    for (auto engine : {Executor::Engine::mcjit, Executor::Engine::orc_lazy})
+    {
+        this->options.engine = engine;
+        Executor execute{Module{this->test_data_path("bell.ll")},
+                         this->options};
+        TestResult tr;
+        QuantumFailImpl fail_impl;
+        ResultTestImpl result_impl(&tr);
+
+        // Exception propagates through the JIT-compiled code
+        EXPECT_THROW(execute(fail_impl, result_impl), DebugError)
+            << to_cstring(engine);
+
+        // Executor is usable afterward
+        QuantumTestImpl quantum_impl(&tr);
+        EXPECT_NO_THROW(execute(quantum_impl, result_impl))
+            << to_cstring(engine);
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, static_replay)
+{
+    auto is_static = [this](std::string const& filename) {
+        Executor execute{Module{this->test_data_path(filename)},
+                         this->options};
+        return execute.static_replay();
+    };
+
+    // Straight-line programs are replayed
+    EXPECT_TRUE(is_static("minimal.ll"));
+    EXPECT_TRUE(is_static("bell.ll"));
+    EXPECT_TRUE(is_static("labeled.ll"));
+    EXPECT_TRUE(is_static("unreachable.ll"));
+    // Calls to classical functions require the JIT
+    EXPECT_FALSE(is_static("multiple.ll"));
+    // Classical control flow requires the JIT
+    EXPECT_FALSE(is_static("teleport.ll"));
+    {
+        Executor execute{Module{this->test_data_path("loop.ll"), "main"},
+                         this->options};
+        EXPECT_FALSE(execute.static_replay());
+    }
+    {
+        // ...unless the optimizer removes it
+        this->options.opt_level = Executor::OptLevel::O2;
+        Executor execute{Module{this->test_data_path("loop.ll"), "main"},
+                         this->options};
+        EXPECT_TRUE(execute.static_replay());
+        this->options.opt_level = Executor::OptLevel::O0;
+    }
+
+    auto result = this->run("labeled.ll");
+    EXPECT_EQ(R"(
+set_up(q=2, r=2)
+initialize()
+h(Q{0})
+rx(0.523599, Q{1})
+cnot(Q{0}, Q{1})
+mz(Q{0},R{0})
+mz(Q{1},R{1})
+array_record_output(2, arr)
+result_record_output(R{0}, r0)
+result_record_output(R{1}, r1)
+tear_down
+)",
+              result.commands.str());
+
+    // Output is the same when compiled
+    this->options.static_replay = false;
+    EXPECT_FALSE(is_static("labeled.ll"));
+    EXPECT_EQ(result.commands.str(),
+              this->run("labeled.ll").commands.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, optimize)
+{
+    std::vector<std::string> const filenames{
+        "bell.ll", "rotation.ll", "teleport.ll", "unreachable.ll"};
+
+    // Get reference output from the unoptimized module
+    std::vector<std::string> expected;
+    for (auto const& f : filenames)
+    {
+        expected.push_back(this->run(f).commands.str());
+    }
+    std::string expected_loop = this->run("loop.ll", "main").commands.str();
+
+    for (auto level : {Executor::OptLevel::O1,
+                       Executor::OptLevel::O2,
+                       Executor::OptLevel::O3})
+    {
+        for (bool inaccessible : {false, true})
+        {
+            this->options.opt_level = level;
+            this->options.qis_inaccessible_memory = inaccessible;
+            for (std::size_t i = 0; i < filenames.size(); ++i)
+            {
+                EXPECT_EQ(expected[i], this->run(filenames[i]).commands.str())
+                    << filenames[i] << " at " << to_cstring(level)
+                    << (inaccessible ? " with inaccessible QIS" : "");
+            }
+            EXPECT_EQ(expected_loop,
+                      this->run("loop.ll", "main").commands.str());
+        }
+    }
+
+    // Optimization time is recorded
+    this->options.opt_level = Executor::OptLevel::O2;
+    Executor execute{Module{this->test_data_path("bell.ll")}, this->options};
+    EXPECT_LT(0, execute.timing().optimize);
+    EXPECT_LT(0, execute.timing().build);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, entry_point)
+{
+    for (auto engine : {Executor::Engine::mcjit, Executor::Engine::orc_lazy})
+    {
+        this->options.engine = engine;
+        Executor execute{Module{this->test_data_path("params.ll"), "rotate"},
+                         this->options};
+        EXPECT_EQ("i64(i64, double)", to_string(execute.entry_signature()));
+        EXPECT_FALSE(execute.static_replay());
+
+        TestResult tr;
+        QuantumTestImpl quantum_impl(&tr);
+        ResultTestImpl result_impl(&tr);
+
+        // Call repeatedly with different arguments
+        auto rotate = execute.entry_point<std::int64_t(std::int64_t, double)>();
+        EXPECT_EQ(2, rotate(quantum_impl, result_impl, 2, 0.5));
+        EXPECT_EQ(1, rotate(quantum_impl, result_impl, 1, 0.25));
+        EXPECT_EQ(R"(
+set_up(q=1, r=1)
+rx(0.5, Q{0})
+rx(0.5, Q{0})
+mz(Q{0},R{0})
+read_result(R{0})
+tear_down
+set_up(q=1, r=1)
+rx(0.25, Q{0})
+mz(Q{0},R{0})
+read_result(R{0})
+tear_down
+)",
+                  tr.commands.str())
+            << to_cstring(engine);
+
+        // Signature must match exactly
+        EXPECT_THROW(execute.entry_point<std::int64_t(int, double)>(),
+                     RuntimeError);
+        EXPECT_THROW(execute.entry_point<void(std::int64_t, double)>(),
+                     RuntimeError);
+        EXPECT_THROW(execute.entry_point<void()>(), RuntimeError);
+
+        // Arguments are required
+        EXPECT_THROW(execute(quantum_impl, result_impl), RuntimeError);
+    }
+
+    {
+        Executor execute{Module{this->test_data_path("params.ll"), "half"},
+                         this->options};
+        auto half = execute.entry_point<double(float)>();
+        TestResult tr;
+        QuantumTestImpl quantum_impl(&tr);
+        ResultTestImpl result_impl(&tr);
+        EXPECT_DOUBLE_EQ(1.5, half(quantum_impl, result_impl, 3.0f));
+    }
+
+    // Straight-line programs with a return value aren't replayed
+    {
+        Executor execute{Module{this->test_data_path("params.ll"), "answer"},
+                         this->options};
+        EXPECT_FALSE(execute.static_replay());
+        auto answer = execute.entry_point<std::int32_t()>();
+        TestResult tr;
+        QuantumTestImpl quantum_impl(&tr);
+        ResultTestImpl result_impl(&tr);
+        EXPECT_EQ(42, answer(quantum_impl, result_impl));
+
+        // Return value is ignored without arguments
+        execute(quantum_impl, result_impl);
+        EXPECT_EQ(R"(
+set_up(q=1, r=1)
+h(Q{0})
+tear_down
+set_up(q=1, r=1)
+h(Q{0})
+tear_down
+)",
+                  tr.commands.str());
+    }
+
+    // Replayed programs can't be called natively
+    {
+        Executor execute{Module{this->test_data_path("bell.ll")},
+                         this->options};
+        ASSERT_TRUE(execute.static_replay());
+        EXPECT_THROW(execute.entry_point<void()>(), RuntimeError);
+    }
+    this->options.static_replay = false;
+    {
+        Executor execute{Module{this->test_data_path("bell.ll")},
+                         this->options};
+        auto bell = execute.entry_point<void()>();
+        EXPECT_EQ(this->run("bell.ll").commands.str(), [&bell] {
+            TestResult tr;
+            QuantumTestImpl quantum_impl(&tr);
+            ResultTestImpl result_impl(&tr);
+            bell(quantum_impl, result_impl);
+            return tr.commands.str();
+        }());
+    }
+
+    // Pointer arguments are unsupported
+    EXPECT_THROW(
+        Executor(Module{this->test_data_path("params.ll"), "pointer"}),
+        RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, reentrant)
+{
+    // Interface that runs a different program while applying an H gate
+    class NestingImpl final : public QuantumNotImpl
+    {
+      public:
+        NestingImpl(Executor const& inner, TestResult* tr)
+            : inner_{inner}, tr_{tr}
+        {
+        }
+
+        void set_up(EntryPointAttrs const&) final
+        {
+            tr_->commands << "outer set_up\n";
+        }
+        void tear_down() final { tr_->commands << "outer tear_down\n"; }
+        void h(Qubit q) final
+        {
+            QuantumTestImpl quantum_impl(tr_);
+            ResultTestImpl result_impl(tr_);
+            inner_(quantum_impl, result_impl);
+            tr_->commands << "outer h(Q{" << q.value << "})\n";
+        }
+        void cnot(Qubit, Qubit) final { tr_->commands << "outer cnot\n"; }
+        void mz(Qubit, Result) final { tr_->commands << "outer mz\n"; }
+
+      private:
+        Executor const& inner_;
+        TestResult* tr_;
+    };
+
+    this->options.static_replay = false;
+    for (auto engine : {Executor::Engine::mcjit, Executor::Engine::orc_lazy})
+    {
+        this->options.engine = engine;
+        Executor inner{Module{this->test_data_path("minimal.ll")},
+                       this->options};
+        Executor outer{Module{this->test_data_path("bell.ll")},
+                       this->options};
+
+        TestResult tr;
+        NestingImpl nesting_impl(inner, &tr);
+        ResultTestImpl result_impl(&tr);
+        outer(nesting_impl, result_impl);
+        EXPECT_EQ(R"(outer set_up
+
+set_up(q=0, r=0)
+tear_down
+outer h(Q{0})
+outer cnot
+outer mz
+outer mz
+array_record_output(2)
+result_record_output(R{0})
+result_record_output(R{1})
+outer tear_down
+)",
+                  tr.commands.str())
+            << to_cstring(engine);
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, multithread)
+{
+    constexpr int num_threads = 8;
+    constexpr int num_repeats = 10;
+    std::vector<std::string> const filenames{
+        "bell.ll", "rotation.ll", "teleport.ll"};
+
+    for (auto engine : {Executor::Engine::mcjit, Executor::Engine::orc_lazy})
+    {
+        this->options.engine = engine;
+
+        // Get reference output by running serially
+        std::vector<std::string> expected;
+        for (auto const& f : filenames)
+        {
+            expected.push_back(this->run(f).commands.str());
+        }
+
+        // Build executors shared among threads (nothing is compiled yet for
+        // the lazy engine)
+        std::vector<std::unique_ptr<Executor>> shared;
+        for (auto const& f : filenames)
+        {
+            shared.push_back(std::make_unique<Executor>(
+                Module{this->test_data_path(f)}, this->options));
+        }
+
+        // Each thread alternates between a shared executor and one of its own
+        std::vector<std::vector<std::string>> actual(num_threads);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t)
+        {
+            threads.emplace_back([&, t] {
+                auto idx = t % filenames.size();
+                Executor own{Module{this->test_data_path(filenames[idx])},
+                             this->options};
+                for (int i = 0; i < num_repeats; ++i)
+                {
+                    TestResult tr;
+                    QuantumTestImpl quantum_impl(&tr);
+                    ResultTestImpl result_impl(&tr);
+                    Executor const& execute = (i % 2 == 0) ? *shared[idx]
+                                                           : own;
+                    execute(quantum_impl, result_impl);
+                    actual[t].push_back(tr.commands.str());
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (int t = 0; t < num_threads; ++t)
+        {
+            ASSERT_EQ(num_repeats, actual[t].size());
+            for (auto const& result : actual[t])
+            {
+                EXPECT_EQ(expected[t % filenames.size()], result)
+                    << to_cstring(engine) << " thread " << t;
+            }
+        }
+    }
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace test
 }  // namespace qiree
@@ -7,6 +7,10 @@
 //---------------------------------------------------------------------------//
 #include "qiree/Module.hh"
 
+#include <fstream>
+#include <sstream>
+
+#include "qiree/Assert.hh"
 #include "qiree_test.hh"
 
 namespace qiree
@@ -19,6 +23,15 @@ class ModuleTest : public ::qiree::test::Test
 {
   protected:
     void SetUp() override {}
+
+    std::string read_file(std::string const& filename)
+    {
+        std::ifstream infile{this->test_data_path(filename),
+                             std::ios::binary};
+        std::ostringstream os;
+        os << infile.rdbuf();
+        return os.str();
+    }
 };
 
 //---------------------------------------------------------------------------//
@@ -87,6 +100,27 @@ TEST_F(ModuleTest, bell)
     EXPECT_EQ(0, flags.qir_minor_version);
     EXPECT_FALSE(flags.dynamic_qubit_management);
     EXPECT_FALSE(flags.dynamic_result_management);
+
+    // Test quantum instructions
+    EXPECT_EQ((std::vector<std::string>{"cnot__body", "h__body", "mz__body"}),
+              m.load_qis_functions());
+    EXPECT_TRUE(m.has_terminal_measurements());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ModuleTest, terminal_measurements)
+{
+    for (char const* filename : {"labeled.ll", "rotation.ll", "bell_ccx.ll"})
+    {
+        Module m(this->test_data_path(filename));
+        EXPECT_TRUE(m.has_terminal_measurements()) << filename;
+    }
+    // Mid-circuit measurement, reset, and branching on results
+    for (char const* filename : {"teleport.ll", "loop.ll"})
+    {
+        Module m(this->test_data_path(filename));
+        EXPECT_FALSE(m.has_terminal_measurements()) << filename;
+    }
 }
 
 //---------------------------------------------------------------------------//
@@ -109,6 +143,51 @@ TEST_F(ModuleTest, several_gates)
     EXPECT_FALSE(flags.dynamic_result_management);
 }
 
+//---------------------------------------------------------------------------//
+TEST_F(ModuleTest, from_buffer)
+{
+    std::string const contents = this->read_file("bell.ll");
+    {
+        // Buffer is not null-terminated
+        std::string const padded = contents + "garbage";
+        Module m = Module::from_buffer(
+            std::string_view{padded}.substr(0, contents.size()), "bell");
+        EXPECT_TRUE(m);
+        EXPECT_EQ(2, m.load_entry_point_attrs().required_num_qubits);
+        EXPECT_EQ(1, m.load_module_flags().qir_major_version);
+    }
+    {
+        Module m = Module::from_buffer(this->read_file("unreachable.bc"),
+                                       "unreachable",
+                                       "main");
+        EXPECT_TRUE(m);
+        EXPECT_EQ(1, m.load_entry_point_attrs().required_num_qubits);
+        EXPECT_TRUE(m.is_straight_line());
+    }
+
+    EXPECT_THROW(Module::from_buffer("not IR", "bad"), RuntimeError);
+    EXPECT_THROW(Module::from_buffer(contents, "bell", "missing"),
+                 RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ModuleTest, from_file_lazy)
+{
+    for (char const* filename : {"unreachable.bc", "unreachable.ll"})
+    {
+        Module m = Module::from_file_lazy(this->test_data_path(filename));
+        EXPECT_TRUE(m) << filename;
+        auto attrs = m.load_entry_point_attrs();
+        EXPECT_EQ(1, attrs.required_num_qubits) << filename;
+        EXPECT_EQ("custom", attrs.qir_profiles) << filename;
+        EXPECT_EQ(1, m.load_module_flags().qir_major_version) << filename;
+        EXPECT_TRUE(m.is_straight_line()) << filename;
+    }
+
+    EXPECT_THROW(Module::from_file_lazy(this->test_data_path("nonexistent.bc")),
+                 RuntimeError);
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace test
 }  // namespace qiree
@@ -0,0 +1,160 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ModuleCache.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/ModuleCache.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
+#include "QuantumTestImpl.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class ModuleCacheTest : public ::qiree::test::Test
+{
+  protected:
+    std::string run(Module&& m)
+    {
+        Executor execute(std::move(m));
+        TestResult tr;
+        QuantumTestImpl quantum_impl(&tr);
+        ResultTestImpl result_impl(&tr);
+        execute(quantum_impl, result_impl);
+        return tr.commands.str();
+    }
+
+    std::string run(std::string const& filename)
+    {
+        return this->run(Module{this->test_data_path(filename)});
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(ModuleCacheTest, reuse)
+{
+    ModuleCache load_module;
+    EXPECT_EQ(ModuleCache::default_memory_budget, load_module.memory_budget());
+    EXPECT_EQ(0, load_module.size());
+
+    auto const filename = this->test_data_path("bell.ll");
+    auto const expected = this->run("bell.ll");
+    EXPECT_EQ(expected, this->run(load_module(filename)));
+    EXPECT_EQ(0, load_module.hits());
+    EXPECT_EQ(1, load_module.misses());
+    EXPECT_EQ(1, load_module.size());
+    EXPECT_LT(0, load_module.memory_usage());
+
+    // Later copies are independent and reconstructed from the cache
+    Module first = load_module(filename);
+    Module second = load_module(filename);
+    EXPECT_EQ(expected, this->run(std::move(second)));
+    EXPECT_EQ(expected, this->run(std::move(first)));
+    EXPECT_EQ(2, load_module.hits());
+    EXPECT_EQ(1, load_module.misses());
+
+    // Entry points are found by name in the cached module
+    auto const loop_expected
+        = this->run(Module{this->test_data_path("loop.ll"), "main"});
+    for (int i = 0; i < 2; ++i)
+    {
+        EXPECT_EQ(loop_expected,
+                  this->run(load_module(this->test_data_path("loop.ll"),
+                                        "main")));
+    }
+    EXPECT_EQ(3, load_module.hits());
+    EXPECT_EQ(2, load_module.misses());
+    EXPECT_EQ(2, load_module.size());
+    EXPECT_THROW(load_module(this->test_data_path("loop.ll"), "nonexistent"),
+                 RuntimeError);
+
+    load_module.clear();
+    EXPECT_EQ(0, load_module.size());
+    EXPECT_EQ(0, load_module.memory_usage());
+    EXPECT_EQ(expected, this->run(load_module(filename)));
+    EXPECT_EQ(3, load_module.misses());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ModuleCacheTest, modified)
+{
+    namespace fs = std::filesystem;
+    fs::path const filename = "modulecache-modified.ll";
+    fs::copy_file(this->test_data_path("bell.ll"),
+                  filename,
+                  fs::copy_options::overwrite_existing);
+
+    ModuleCache load_module;
+    EXPECT_EQ(this->run("bell.ll"), this->run(load_module(filename)));
+
+    // Replace the file with a different program and a later timestamp
+    auto const mtime = fs::last_write_time(filename);
+    fs::copy_file(this->test_data_path("rotation.ll"),
+                  filename,
+                  fs::copy_options::overwrite_existing);
+    fs::last_write_time(filename, mtime + std::chrono::seconds(1));
+
+    EXPECT_EQ(this->run("rotation.ll"), this->run(load_module(filename)));
+    EXPECT_EQ(0, load_module.hits());
+    EXPECT_EQ(2, load_module.misses());
+    EXPECT_EQ(1, load_module.size());
+
+    fs::remove(filename);
+    EXPECT_THROW(load_module(filename), RuntimeError);
+    EXPECT_EQ(3, load_module.misses());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ModuleCacheTest, eviction)
+{
+    auto const bell = this->test_data_path("bell.ll");
+    auto const rotation = this->test_data_path("rotation.ll");
+
+    // Measure the size of each module
+    size_type bell_size{0};
+    size_type rotation_size{0};
+    {
+        ModuleCache load_module;
+        load_module(bell);
+        bell_size = load_module.memory_usage();
+        load_module(rotation);
+        rotation_size = load_module.memory_usage() - bell_size;
+    }
+
+    // Only one module fits
+    ModuleCache load_module{std::max(bell_size, rotation_size)};
+    load_module(bell);
+    load_module(bell);
+    EXPECT_EQ(1, load_module.hits());
+    load_module(rotation);
+    EXPECT_EQ(1, load_module.size());
+    EXPECT_EQ(rotation_size, load_module.memory_usage());
+
+    // Least recently used module was evicted
+    load_module(bell);
+    EXPECT_EQ(1, load_module.hits());
+    EXPECT_EQ(3, load_module.misses());
+    EXPECT_EQ(bell_size, load_module.memory_usage());
+
+    // Nothing fits
+    ModuleCache no_cache{0};
+    no_cache(bell);
+    no_cache(bell);
+    EXPECT_EQ(0, no_cache.hits());
+    EXPECT_EQ(0, no_cache.size());
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,103 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ObjectCache.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/ObjectCache.hh"
+
+#include <filesystem>
+
+#include "QuantumTestImpl.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class ObjectCacheTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override
+    {
+        auto const* info
+            = ::testing::UnitTest::GetInstance()->current_test_info();
+        directory_ = std::string("objcache-") + info->name();
+        std::filesystem::remove_all(directory_);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(directory_); }
+
+    std::string run(std::string const& filename, Executor::Options const& opts)
+    {
+        Executor execute(Module(this->test_data_path(filename)), opts);
+        TestResult tr;
+        QuantumTestImpl quantum_impl(&tr);
+        ResultTestImpl result_impl(&tr);
+        execute(quantum_impl, result_impl);
+        return tr.commands.str();
+    }
+
+    std::string directory_;
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(ObjectCacheTest, mcjit)
+{
+    Executor::Options opts;
+    opts.engine = Executor::Engine::mcjit;
+    opts.static_replay = false;
+    opts.object_cache = std::make_shared<ObjectCache>(directory_);
+    EXPECT_EQ(directory_, opts.object_cache->directory());
+    EXPECT_TRUE(std::filesystem::is_directory(directory_));
+
+    // First run compiles the whole module
+    auto expected = this->run("bell.ll", opts);
+    EXPECT_EQ(0, opts.object_cache->hits());
+    EXPECT_EQ(1, opts.object_cache->misses());
+
+    // Second run loads it
+    EXPECT_EQ(expected, this->run("bell.ll", opts));
+    EXPECT_EQ(1, opts.object_cache->hits());
+    EXPECT_EQ(1, opts.object_cache->misses());
+
+    // A new cache in the same directory sees the saved object
+    opts.object_cache = std::make_shared<ObjectCache>(directory_);
+    EXPECT_EQ(expected, this->run("bell.ll", opts));
+    EXPECT_EQ(1, opts.object_cache->hits());
+    EXPECT_EQ(0, opts.object_cache->misses());
+
+    // A different module is compiled
+    this->run("rotation.ll", opts);
+    EXPECT_EQ(1, opts.object_cache->hits());
+    EXPECT_EQ(1, opts.object_cache->misses());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ObjectCacheTest, orc_lazy)
+{
+    Executor::Options opts;
+    opts.engine = Executor::Engine::orc_lazy;
+    opts.object_cache = std::make_shared<ObjectCache>(directory_);
+
+    // Each lazily compiled function (plus stubs) is an object
+    auto expected = this->run("loop.ll", opts);
+    auto num_compiled = opts.object_cache->misses();
+    EXPECT_EQ(0, opts.object_cache->hits());
+    EXPECT_LT(0, num_compiled);
+
+    // No code generation the second time
+    opts.object_cache = std::make_shared<ObjectCache>(directory_);
+    EXPECT_EQ(expected, this->run("loop.ll", opts));
+    EXPECT_EQ(num_compiled, opts.object_cache->hits());
+    EXPECT_EQ(0, opts.object_cache->misses());
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,131 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/Backend.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/Backend.hh"
+
+#include <type_traits>
+
+#include "qiree/Assert.hh"
+#include "qiree/Module.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class BackendTest : public ::qiree::test::Test
+{
+  protected:
+    std::string classify(char const* filename)
+    {
+        Module mod{this->test_data_path(filename)};
+        return to_cstring(classify_gate_set(mod.load_qis_functions()));
+    }
+
+    Backend select(char const* filename)
+    {
+        return select_backend(Module{this->test_data_path(filename)});
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(BackendTest, classify)
+{
+    EXPECT_STREQ("classical Clifford", to_cstring(classify_gate_set({})));
+    EXPECT_STREQ("classical Clifford",
+                 to_cstring(classify_gate_set({"cnot__body", "x__body"})));
+    EXPECT_STREQ("classical",
+                 to_cstring(classify_gate_set({"ccx__body", "x__body"})));
+    EXPECT_STREQ("Clifford",
+                 to_cstring(classify_gate_set({"h__body", "x__body"})));
+    EXPECT_STREQ("universal",
+                 to_cstring(classify_gate_set({"ccx__body", "h__body"})));
+    EXPECT_STREQ("universal", to_cstring(classify_gate_set({"t__body"})));
+
+    EXPECT_EQ("Clifford", this->classify("bell.ll"));
+    EXPECT_EQ("Clifford", this->classify("teleport.ll"));
+    EXPECT_EQ("universal", this->classify("bell_ccx.ll"));
+    EXPECT_EQ("universal", this->classify("rotation.ll"));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(BackendTest, select)
+{
+    EXPECT_EQ(Backend::stabilizer, this->select("bell.ll"));
+    EXPECT_EQ(Backend::stabilizer, this->select("teleport.ll"));
+    EXPECT_EQ(Backend::statevector, this->select("rotation.ll"));
+
+    GateSet classical;
+    classical.clifford = false;
+    EXPECT_EQ(Backend::classical, select_backend(classical, 10000));
+    EXPECT_EQ(Backend::classical, select_backend(GateSet{}, 10000));
+    EXPECT_EQ(Backend::stabilizer,
+              select_backend(GateSet{false, true}, 10000));
+
+    // Too many qubits for a non-Clifford program
+    EXPECT_THROW(select_backend(GateSet{false, false}, 100), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(BackendTest, visit)
+{
+    SimulatorOptions opts;
+    opts.max_qubits = 4;
+    opts.max_bond = 8;
+    opts.max_support = 100;
+    opts.noise.readout.zero_to_one = 0.25;
+    for (auto backend : {Backend::statevector,
+                         Backend::stabilizer,
+                         Backend::mps,
+                         Backend::density,
+                         Backend::frame,
+                         Backend::classical,
+                         Backend::sparse})
+    {
+        auto name = visit_simulator(backend, opts, [](auto& sim) {
+            using QI = std::remove_reference_t<decltype(sim)>;
+            EntryPointAttrs attrs;
+            attrs.required_num_qubits = 5;
+            EXPECT_THROW(sim.set_up(attrs), RuntimeError);
+            if constexpr (std::is_same_v<QI, MpsQuantum>)
+            {
+                EXPECT_EQ(8, sim.options().max_bond);
+                EXPECT_EQ(MpsQuantum::Options{}.truncation_threshold,
+                          sim.options().truncation_threshold);
+                return "mps";
+            }
+            if constexpr (std::is_same_v<QI, DensityMatrixQuantum>)
+            {
+                EXPECT_EQ(0.25, sim.options().noise.readout.zero_to_one);
+                return "density";
+            }
+            if constexpr (std::is_same_v<QI, PauliFrameQuantum>)
+            {
+                EXPECT_EQ(0.25, sim.options().noise.readout.zero_to_one);
+                return "frame";
+            }
+            if constexpr (std::is_same_v<QI, ClassicalBitQuantum>)
+            {
+                return "classical";
+            }
+            if constexpr (std::is_same_v<QI, SparseQuantum>)
+            {
+                EXPECT_EQ(100, sim.options().max_support);
+                return "sparse";
+            }
+            return std::is_same_v<QI, StabilizerQuantum> ? "stabilizer"
+                                                           : "statevector";
+        });
+        EXPECT_STREQ(to_cstring(backend), name);
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,155 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/BranchingShots.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/BranchingShots.hh"
+
+#include <cmath>
+#include <sstream>
+
+#include "qiree/DirectExecutor.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class BranchingShotsTest : public ::qiree::test::Test
+{
+  protected:
+    static constexpr size_type num_shots = 1024;
+
+    size_type run(char const* filename)
+    {
+        DirectExecutor<StateVectorQuantum, HistogramRuntime> execute{
+            Module{this->test_data_path(filename)}};
+        size_type num_executions
+            = run_branching_shots(execute, sim, rt, num_shots);
+        EXPECT_EQ(num_shots, rt.num_shots());
+        EXPECT_EQ(1, rt.groups().size());
+        return num_executions;
+    }
+
+    size_type exact(char const* filename, double prune_threshold)
+    {
+        DirectExecutor<StateVectorQuantum, HistogramRuntime> execute{
+            Module{this->test_data_path(filename)}};
+        size_type num_executions
+            = enumerate_branches(execute, sim, rt, prune_threshold);
+        EXPECT_EQ(0, rt.num_shots());
+        EXPECT_EQ(1, rt.groups().size());
+        EXPECT_NEAR(
+            1, rt.total_probability() + sim.pruned_probability(), 1e-12);
+        return num_executions;
+    }
+
+    StateVectorQuantum sim;
+    HistogramRuntime rt{sim};
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(BranchingShotsTest, teleport)
+{
+    // Resets and the final measurement are deterministic
+    EXPECT_EQ(4, this->run("teleport.ll"));
+
+    auto const& counts = rt.groups().front().counts;
+    EXPECT_EQ(4, counts.size());
+    for (auto const& [bits, count] : counts)
+    {
+        EXPECT_EQ('0', bits[2]) << bits;
+        EXPECT_LT(num_shots / 8, count) << bits;
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(BranchingShotsTest, terminal)
+{
+    EXPECT_EQ(2, this->run("bell.ll"));
+    auto const& counts = rt.groups().front().counts;
+    EXPECT_EQ(2, counts.size());
+    EXPECT_EQ(num_shots, counts.at("00") + counts.at("11"));
+    EXPECT_LT(num_shots / 4, counts.at("00"));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(BranchingShotsTest, executor)
+{
+    // The JIT executor dispatches through the quantum interface
+    Executor execute{Module{this->test_data_path("teleport.ll")}};
+    EXPECT_EQ(4, run_branching_shots(execute, sim, rt, num_shots));
+    EXPECT_EQ(num_shots, rt.num_shots());
+    EXPECT_EQ(4, rt.groups().front().counts.size());
+
+    HistogramRuntime exact_rt{sim};
+    EXPECT_EQ(4, enumerate_branches(execute, sim, exact_rt, 0));
+    EXPECT_NEAR(1, exact_rt.total_probability(), 1e-12);
+    EXPECT_EQ(4, exact_rt.groups().front().probabilities.size());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(BranchingShotsTest, exact_teleport)
+{
+    EXPECT_EQ(4, this->exact("teleport.ll", 0));
+    EXPECT_NEAR(0, sim.pruned_probability(), 1e-12);
+
+    std::ostringstream os;
+    rt.print_probabilities(os);
+    EXPECT_EQ(R"(array <null> length 3 distinct results 4
+array <null> result 000 probability 0.25
+array <null> result 010 probability 0.25
+array <null> result 100 probability 0.25
+array <null> result 110 probability 0.25
+)",
+              os.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(BranchingShotsTest, exact_pruned)
+{
+    // Entangled rotation: sin^2(theta / 2) with theta = pi / 6
+    double const s2 = std::pow(std::sin(0.5235987755982988 / 2), 2);
+    EXPECT_EQ(4, this->exact("labeled.ll", 0));
+    auto const& probs = rt.groups().front().probabilities;
+    ASSERT_EQ(4, probs.size());
+    EXPECT_NEAR(0.5 * (1 - s2), probs.at("00"), 1e-12);
+    EXPECT_NEAR(0.5 * s2, probs.at("01"), 1e-12);
+    EXPECT_NEAR(0.5 * s2, probs.at("10"), 1e-12);
+    EXPECT_NEAR(0.5 * (1 - s2), probs.at("11"), 1e-12);
+
+    // Unlikely outcomes of the second measurement are skipped
+    HistogramRuntime pruned_rt{sim};
+    DirectExecutor<StateVectorQuantum, HistogramRuntime> execute{
+        Module{this->test_data_path("labeled.ll")}};
+    EXPECT_EQ(2, enumerate_branches(execute, sim, pruned_rt, 0.1));
+    EXPECT_NEAR(s2, sim.pruned_probability(), 1e-12);
+    EXPECT_NEAR(1 - s2, pruned_rt.total_probability(), 1e-12);
+    EXPECT_EQ(2, pruned_rt.groups().front().probabilities.size());
+
+    // The likely outcomes of the second measurement are also below this
+    // threshold, so both executions are abandoned
+    HistogramRuntime abandoned_rt{sim};
+    EXPECT_EQ(2, enumerate_branches(execute, sim, abandoned_rt, 0.49));
+    EXPECT_NEAR(1, sim.pruned_probability(), 1e-12);
+    EXPECT_EQ(0, abandoned_rt.total_probability());
+    EXPECT_EQ(0, abandoned_rt.groups().front().probabilities.size());
+
+    // Both outcomes of the first measurement are pruned
+    HistogramRuntime root_rt{sim};
+    EXPECT_EQ(1, enumerate_branches(execute, sim, root_rt, 0.6));
+    EXPECT_NEAR(1, sim.pruned_probability(), 1e-12);
+    EXPECT_EQ(0, root_rt.total_probability());
+
+    EXPECT_THROW(sim.start_enumeration(1.0), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
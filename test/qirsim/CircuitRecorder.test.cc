@@ -0,0 +1,173 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/CircuitRecorder.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/CircuitRecorder.hh"
+
+#include <complex>
+#include <random>
+
+#include "QuantumTestBase.hh"
+#include "qiree/Assert.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree/QuantumTestImpl.hh"
+#include "qiree/Types.hh"
+#include "qirsim/StateVectorQuantum.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+constexpr double pi = 3.141592653589793;
+
+class CircuitRecorderTest : public QuantumTestBase
+{
+  protected:
+    //! Compare two state vectors
+    static void expect_state(StateVectorQuantum const& expected,
+                             StateVectorQuantum const& actual)
+    {
+        auto const& a = expected.state();
+        auto const& b = actual.state();
+        ASSERT_EQ(a.size(), b.size());
+        for (size_type k = 0; k < a.size(); ++k)
+        {
+            EXPECT_NEAR(a[k].real(), b[k].real(), 1e-12) << k;
+            EXPECT_NEAR(a[k].imag(), b[k].imag(), 1e-12) << k;
+        }
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(CircuitRecorderTest, record)
+{
+    CircuitRecorder rec;
+    rec.set_up(attrs(4, 1));
+    rec.ccx(Q{0}, Q{1}, Q{2});
+    rec.cnot(Q{3}, Q{0});
+    rec.r(Pauli::y, 0.5, Q{1});
+    rec.r_adj(Pauli::i, 0.5, Q{1});
+    rec.exp(make_array({Pauli::x, Pauli::z}), 0.25, make_array({Q{2}, Q{0}}));
+    RotationArgs rot{1.5, Q{3}};
+    rec.rz(make_array({Q{0}, Q{1}}), &rot);
+    auto r1 = rec.measure(make_array({Pauli::y}), make_array({Q{2}}));
+    auto r2 = rec.mresetz(Q{3});
+    rec.mz(Q{0}, R{0});
+
+    EXPECT_EQ(1, r1.value);
+    EXPECT_EQ(2, r2.value);
+    EXPECT_EQ(3, rec.num_results());
+
+    auto const& c = rec.circuit();
+    ASSERT_EQ(10, c.size());
+    static GateOp const expected_ops[] = {GateOp::x,
+                                          GateOp::x,
+                                          GateOp::ry,
+                                          GateOp::pauli_rotation,
+                                          GateOp::pauli_rotation,
+                                          GateOp::rz,
+                                          GateOp::measure_pauli,
+                                          GateOp::measure_z,
+                                          GateOp::reset,
+                                          GateOp::measure_z};
+    for (size_type i = 0; i < c.size(); ++i)
+    {
+        EXPECT_EQ(expected_ops[i], c.op(i)) << i;
+    }
+    EXPECT_EQ(2, c[0].num_controls);
+    EXPECT_EQ(2, c[0].targets[0]);
+    EXPECT_EQ(-0.5, c[3].theta);
+    EXPECT_EQ(Pauli::i, c[3].paulis[0]);
+    EXPECT_EQ(-0.5, c[4].theta);
+    EXPECT_EQ(Pauli::z, c[4].paulis[1]);
+    EXPECT_EQ(2, c[5].num_controls);
+    EXPECT_EQ(1.5, c[5].theta);
+    EXPECT_EQ(1, c[6].result.value);
+    EXPECT_EQ(0, c[9].result.value);
+
+    // Circuits can't branch
+    EXPECT_THROW(rec.read_result(R{0}), RuntimeError);
+    EXPECT_THROW(rec.x(Q{4}), RuntimeError);
+
+    // Setting up clears the circuit
+    rec.set_up(attrs(1, 0));
+    EXPECT_TRUE(rec.circuit().empty());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(CircuitRecorderTest, replay)
+{
+    constexpr size_type num_qubits = 4;
+    std::mt19937 rng(12345);
+
+    CircuitRecorder rec;
+    StateVectorQuantum direct;
+    StateVectorQuantum replayed;
+    for (int circuit = 0; circuit < 10; ++circuit)
+    {
+        rec.set_up(attrs(num_qubits, 0));
+        direct.set_up(attrs(num_qubits, 0));
+        for (int i = 0; i < 40; ++i)
+        {
+            this->apply_random_gate(
+                GateSet::multi_controlled, num_qubits, rng, rec, direct);
+        }
+        replayed.set_up(attrs(num_qubits, 0));
+        replay(rec.circuit(), replayed);
+        expect_state(direct, replayed);
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(CircuitRecorderTest, replay_decomposed)
+{
+    // Operations that have no direct QIS instruction
+    Circuit c;
+    c.push_back({GateOp::x, {}, {0}});
+    c.push_back({GateOp::x, {}, {1}});
+    c.push_back({GateOp::swap, {0}, {1, 2}});
+    c.push_back({GateOp::rzz, {2}, {0, 1}, {}, pi});
+    c.push_back({GateOp::measure_z, {}, {2}, {}, 0, R{0}});
+
+    StateVectorQuantum sim;
+    sim.set_up(attrs(3, 1));
+    replay(c, sim);
+    // |011> -> |101> with phase exp(-i pi/2 Z0 Z1) = i since Z0 Z1 = -1
+    auto amp = sim.state()[0b101];
+    EXPECT_NEAR(0, amp.real(), 1e-12);
+    EXPECT_NEAR(1, amp.imag(), 1e-12);
+    EXPECT_EQ(QState::one, sim.read_result(R{0}));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(CircuitRecorderTest, executor)
+{
+    // Record a whole program through the executor with a runtime that
+    // doesn't read results
+    Executor execute{Module{this->test_data_path("bell.ll")}};
+    CircuitRecorder rec;
+    TestResult tr;
+    ResultTestImpl rt{&tr};
+    execute(rec, rt);
+    auto const& c = rec.circuit();
+    ASSERT_EQ(4, c.size());
+    EXPECT_EQ(GateOp::h, c.op(0));
+    EXPECT_EQ(GateOp::x, c.op(1));
+    EXPECT_EQ(1, c[1].num_controls);
+    EXPECT_EQ(GateOp::measure_z, c.op(3));
+    EXPECT_EQ(1, c[3].result.value);
+
+    // Programs that branch on results can't be recorded
+    Executor branching{Module{this->test_data_path("teleport.ll")}};
+    EXPECT_THROW(branching(rec, rt), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
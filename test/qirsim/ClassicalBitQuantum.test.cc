@@ -0,0 +1,184 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/ClassicalBitQuantum.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/ClassicalBitQuantum.hh"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "QuantumTestBase.hh"
+#include "qiree/Assert.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree/Types.hh"
+#include "qirsim/HistogramRuntime.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+constexpr double pi = 3.141592653589793;
+
+class ClassicalBitQuantumTest : public QuantumTestBase
+{
+  protected:
+    //! Get the message of a runtime error
+    template<class F>
+    static std::string error_message(F&& apply)
+    {
+        try
+        {
+            apply();
+        }
+        catch (RuntimeError const& e)
+        {
+            return e.what();
+        }
+        return {};
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(ClassicalBitQuantumTest, ripple_adder)
+{
+    // Add two random n-bit numbers on thousands of qubits: qubits [0, n) hold
+    // a, [n, 2n) hold b, [2n, 3n] the carries, and (3n, 4n] the sum
+    constexpr size_type n = 1000;
+    auto a = [](size_type i) { return Q{i}; };
+    auto b = [](size_type i) { return Q{n + i}; };
+    auto c = [](size_type i) { return Q{2 * n + i}; };
+    auto s = [](size_type i) { return Q{3 * n + 1 + i}; };
+
+    std::mt19937 rng(12345);
+    std::vector<bool> a_bits(n), b_bits(n);
+    ClassicalBitQuantum sim;
+    sim.set_up(attrs(4 * n + 1, n + 1));
+    for (size_type i = 0; i < n; ++i)
+    {
+        a_bits[i] = rng() & 1;
+        b_bits[i] = rng() & 1;
+        if (a_bits[i])
+        {
+            sim.x(a(i));
+        }
+        if (b_bits[i])
+        {
+            sim.x(b(i));
+        }
+    }
+    for (size_type i = 0; i < n; ++i)
+    {
+        // s = a ^ b ^ c, and the majority carry is ab ^ ac ^ bc
+        sim.cnot(a(i), s(i));
+        sim.cnot(b(i), s(i));
+        sim.cnot(c(i), s(i));
+        sim.ccx(a(i), b(i), c(i + 1));
+        sim.ccx(a(i), c(i), c(i + 1));
+        sim.x(make_array({b(i), c(i)}), c(i + 1));
+    }
+    for (size_type i = 0; i < n; ++i)
+    {
+        sim.mz(s(i), R{i});
+    }
+    sim.mz(c(n), R{n});
+
+    bool carry = false;
+    for (size_type i = 0; i < n; ++i)
+    {
+        bool const sum = a_bits[i] ^ b_bits[i] ^ carry;
+        carry = (a_bits[i] + b_bits[i] + carry) >= 2;
+        ASSERT_EQ(sum ? QState::one : QState::zero, sim.read_result(R{i}))
+            << "bit " << i;
+        // Inputs are unchanged
+        EXPECT_EQ(a_bits[i], sim.is_one(a(i)));
+        EXPECT_EQ(b_bits[i], sim.is_one(b(i)));
+    }
+    EXPECT_EQ(carry ? QState::one : QState::zero, sim.read_result(R{n}));
+    EXPECT_EQ((4 * n + 1 + 63) / 64, sim.state().size());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ClassicalBitQuantumTest, gates)
+{
+    ClassicalBitQuantum sim;
+    sim.set_up(attrs(4, 0));
+
+    // Phases are ignored, and Y and half-turn rotations flip
+    sim.h(make_array({Q{1}}), Q{0});
+    sim.z(Q{0});
+    sim.s(Q{0});
+    sim.t_adj(Q{0});
+    sim.rz(0.123, Q{0});
+    sim.cz(Q{0}, Q{1});
+    sim.rzz(0.5, Q{0}, Q{1});
+    sim.t(make_array({Q{1}, Q{2}}), Q{0});
+    EXPECT_EQ(std::vector<ClassicalBitQuantum::Word>{0}, sim.state());
+
+    sim.y(Q{0});
+    sim.rx(pi, Q{1});
+    sim.ry(-3 * pi, Q{2});
+    sim.r(Pauli::x, 2 * pi, Q{3});
+    EXPECT_EQ(std::vector<ClassicalBitQuantum::Word>{0b0111}, sim.state());
+
+    sim.swap(Q{2}, Q{3});
+    sim.cy(Q{3}, Q{0});
+    sim.x(make_array({Q{0}, Q{1}}), Q{2});
+    EXPECT_EQ(std::vector<ClassicalBitQuantum::Word>{0b1010}, sim.state());
+
+    // Z strings measure parity, and resets clear qubits
+    auto parity = sim.measure(make_array({Pauli::z, Pauli::i, Pauli::z}),
+                              make_array({Q{1}, Q{2}, Q{3}}));
+    EXPECT_EQ(QState::zero, sim.read_result(parity));
+    auto r = sim.mresetz(Q{3});
+    EXPECT_EQ(QState::one, sim.read_result(r));
+    sim.reset(Q{1});
+    EXPECT_EQ(QState::zero, sim.read_result(sim.m(Q{1})));
+    EXPECT_EQ(std::vector<ClassicalBitQuantum::Word>{0}, sim.state());
+    EXPECT_EQ(3, sim.num_results());
+    EXPECT_EQ(19, sim.num_operations());
+
+    EXPECT_THROW(sim.x(Q{4}), RuntimeError);
+    EXPECT_THROW(sim.cnot(Q{1}, Q{1}), RuntimeError);
+    EXPECT_THROW(sim.x(make_array({Q{2}}), Q{2}), RuntimeError);
+    EXPECT_THROW(sim.read_result(R{3}), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ClassicalBitQuantumTest, superposition)
+{
+    ClassicalBitQuantum sim;
+    sim.set_up(attrs(2, 0));
+    sim.x(Q{0});
+
+    // The first operation that would create a superposition is reported
+    auto msg = error_message([&] { sim.h(make_array({Q{0}}), Q{1}); });
+    EXPECT_NE(std::string::npos, msg.find("'h.ctl' (operation 2 "))
+        << msg;
+    EXPECT_THROW(sim.h(Q{0}), RuntimeError);
+    EXPECT_THROW(sim.rx(pi / 2, Q{0}), RuntimeError);
+    EXPECT_THROW(sim.ry(0.1, Q{0}), RuntimeError);
+    EXPECT_THROW(sim.measure(make_array({Pauli::x}), make_array({Q{0}})),
+                 RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ClassicalBitQuantumTest, executor)
+{
+    // Non-classical programs fail at their first Hadamard
+    Executor execute{Module{this->test_data_path("bell.ll")}};
+    ClassicalBitQuantum sim;
+    HistogramRuntime rt{sim};
+    auto msg = error_message([&] { execute(sim, rt); });
+    EXPECT_NE(std::string::npos, msg.find("'h.body' (operation 1 ")) << msg;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
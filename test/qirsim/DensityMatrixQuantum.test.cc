@@ -0,0 +1,284 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/DensityMatrixQuantum.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/DensityMatrixQuantum.hh"
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <sstream>
+
+#include "qiree_config.h"
+
+#include "QuantumTestBase.hh"
+#include "qiree/Assert.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree/Types.hh"
+#include "qirsim/HistogramRuntime.hh"
+#include "qirsim/NoiseModel.hh"
+#include "qirsim/StateVectorQuantum.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+class DensityMatrixQuantumTest : public QuantumTestBase
+{
+  protected:
+    using Options = DensityMatrixQuantum::Options;
+
+    //! Compare the density matrix with the projector onto a state vector
+    static void expect_state(StateVectorQuantum const& expected,
+                             DensityMatrixQuantum const& actual)
+    {
+        auto const& psi = expected.state();
+        for (size_type r = 0; r < psi.size(); ++r)
+        {
+            for (size_type c = 0; c < psi.size(); ++c)
+            {
+                auto rho = actual.element(r, c);
+                auto expected_rho = psi[r] * std::conj(psi[c]);
+                EXPECT_NEAR(expected_rho.real(), rho.real(), 1e-12)
+                    << r << ", " << c;
+                EXPECT_NEAR(expected_rho.imag(), rho.imag(), 1e-12)
+                    << r << ", " << c;
+            }
+        }
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(DensityMatrixQuantumTest, bell)
+{
+    DensityMatrixQuantum sim;
+    int num_ones = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        sim.set_up(attrs(2, 2));
+        sim.h(Q{0});
+        sim.cnot(Q{0}, Q{1});
+        EXPECT_NEAR(0.5, sim.element(0, 3).real(), 1e-12);
+        EXPECT_NEAR(1, sim.purity(), 1e-12);
+
+        // Joint measurements of a Bell state are deterministic
+        auto xx = sim.measure(make_array({Pauli::x, Pauli::x}),
+                              make_array({Q{1}, Q{0}}));
+        auto yy = sim.measure(make_array({Pauli::y, Pauli::y}),
+                              make_array({Q{0}, Q{1}}));
+        EXPECT_EQ(QState::zero, sim.read_result(xx));
+        EXPECT_EQ(QState::one, sim.read_result(yy));
+
+        sim.mz(Q{0}, R{0});
+        sim.mz(Q{1}, R{1});
+        EXPECT_EQ(sim.read_result(R{0}), sim.read_result(R{1}));
+        num_ones += (sim.read_result(R{0}) == QState::one);
+    }
+    EXPECT_LT(25, num_ones);
+    EXPECT_GT(75, num_ones);
+
+    EXPECT_THROW(sim.h(Q{2}), RuntimeError);
+    EXPECT_THROW(sim.read_result(R{5}), RuntimeError);
+    EXPECT_THROW(sim.element(4, 0), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(DensityMatrixQuantumTest, random_circuits)
+{
+    constexpr size_type num_qubits = 4;
+    std::mt19937 rng(12345);
+
+    DensityMatrixQuantum dm;
+    StateVectorQuantum sv;
+    for (int circuit = 0; circuit < 10; ++circuit)
+    {
+        dm.set_up(attrs(num_qubits, 0));
+        sv.set_up(attrs(num_qubits, 0));
+        for (int i = 0; i < 40; ++i)
+        {
+            this->apply_random_gate(
+                GateSet::multi_controlled, num_qubits, rng, dm, sv);
+        }
+        expect_state(sv, dm);
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(DensityMatrixQuantumTest, depolarizing)
+{
+    constexpr double p = 0.3;
+    Options opts;
+    opts.noise.gates["x"].depolarizing = p;
+    opts.noise.gates["cnot"].depolarizing = p;
+    DensityMatrixQuantum sim{opts};
+    sim.set_up(attrs(2, 0));
+
+    // X and Y errors flip the qubit
+    sim.x(Q{0});
+    EXPECT_NEAR(1 - 2 * p / 3, sim.probability_one(Q{0}), 1e-12);
+    EXPECT_NEAR(0, sim.probability_one(Q{1}), 1e-12);
+    EXPECT_NEAR(1, std::real(sim.element(0, 0) + sim.element(1, 1)), 1e-12);
+
+    // Both qubits of a two-qubit gate are depolarized
+    sim.set_up(attrs(2, 0));
+    sim.cnot(Q{0}, Q{1});
+    EXPECT_NEAR(2 * p / 3, sim.probability_one(Q{0}), 1e-12);
+    EXPECT_NEAR(2 * p / 3, sim.probability_one(Q{1}), 1e-12);
+    EXPECT_LT(sim.purity(), 1 - 1e-3);
+
+    // Fully depolarizing leaves the maximally mixed state
+    opts.noise.default_gate.depolarizing = 0.75;
+    DensityMatrixQuantum mixed{opts};
+    mixed.set_up(attrs(1, 0));
+    mixed.h(Q{0});
+    EXPECT_NEAR(0.5, mixed.purity(), 1e-12);
+    EXPECT_NEAR(0, std::abs(mixed.element(0, 1)), 1e-12);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(DensityMatrixQuantumTest, amplitude_damping)
+{
+    constexpr double gamma = 0.2;
+    Options opts;
+    opts.noise.default_gate.amplitude_damping = gamma;
+    DensityMatrixQuantum sim{opts};
+    sim.set_up(attrs(1, 0));
+
+    sim.x(Q{0});
+    EXPECT_NEAR(1 - gamma, sim.probability_one(Q{0}), 1e-12);
+
+    // Coherences decay by the square root
+    sim.set_up(attrs(1, 0));
+    sim.h(Q{0});
+    EXPECT_NEAR(gamma / 2 + 0.5, sim.element(0, 0).real(), 1e-12);
+    EXPECT_NEAR(0.5 * std::sqrt(1 - gamma), sim.element(0, 1).real(), 1e-12);
+    EXPECT_NEAR(0.5 * std::sqrt(1 - gamma), sim.element(1, 0).real(), 1e-12);
+
+    // Invalid probabilities
+    opts.noise.default_gate.amplitude_damping = 1.5;
+    EXPECT_THROW(DensityMatrixQuantum{opts}, RuntimeError);
+    opts.noise.default_gate.amplitude_damping = 0;
+    opts.noise.gates["hadamard"] = {};
+    EXPECT_THROW(DensityMatrixQuantum{opts}, RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(DensityMatrixQuantumTest, reset)
+{
+    DensityMatrixQuantum sim;
+    sim.set_up(attrs(2, 0));
+    sim.h(Q{0});
+    sim.cnot(Q{0}, Q{1});
+
+    // Resetting half of a Bell pair leaves the other half mixed
+    sim.reset(Q{0});
+    EXPECT_NEAR(0, sim.probability_one(Q{0}), 1e-12);
+    EXPECT_NEAR(0.5, sim.element(0, 0).real(), 1e-12);
+    EXPECT_NEAR(0.5, sim.element(2, 2).real(), 1e-12);
+    EXPECT_NEAR(0.5, sim.purity(), 1e-12);
+
+    auto r = sim.mresetz(Q{1});
+    EXPECT_NEAR(1, sim.element(0, 0).real(), 1e-12);
+    EXPECT_EQ(0, r.value);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(DensityMatrixQuantumTest, readout)
+{
+    Options opts;
+    opts.noise.readout.zero_to_one = 0.25;
+    opts.noise.readout.one_to_zero = 1;
+    DensityMatrixQuantum sim{opts};
+
+    int num_ones = 0;
+    for (int i = 0; i < 400; ++i)
+    {
+        sim.set_up(attrs(2, 2));
+        sim.x(Q{1});
+        sim.mz(Q{0}, R{0});
+        sim.mz(Q{1}, R{1});
+        num_ones += (sim.read_result(R{0}) == QState::one);
+        EXPECT_EQ(QState::zero, sim.read_result(R{1}));
+
+        // The state collapses to the true outcome
+        EXPECT_NEAR(1, sim.probability_one(Q{1}), 1e-12);
+    }
+    EXPECT_LT(70, num_ones);
+    EXPECT_GT(130, num_ones);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(DensityMatrixQuantumTest, executor)
+{
+    // The simulator can be used through the dynamically dispatched interface
+    Executor execute{Module{this->test_data_path("bell.ll")}};
+    Options opts;
+    opts.noise.gates["cnot"].depolarizing = 0.3;
+    DensityMatrixQuantum sim{opts};
+    HistogramRuntime rt{sim};
+    for (int i = 0; i < 256; ++i)
+    {
+        execute(sim, rt);
+        rt.end_shot();
+    }
+
+    ASSERT_EQ(1, rt.groups().size());
+    auto const& counts = rt.groups().front().counts;
+    EXPECT_EQ(4, counts.size());
+    EXPECT_LT(64, counts.at("00"));
+    EXPECT_LT(64, counts.at("11"));
+}
+
+//---------------------------------------------------------------------------//
+#if !QIREE_USE_JSON
+#    define NoiseModelJsonTest DISABLED_NoiseModelJsonTest
+#endif
+using NoiseModelJsonTest = DensityMatrixQuantumTest;
+
+TEST_F(NoiseModelJsonTest, load)
+{
+    std::istringstream is{R"json({
+        "default": {"depolarizing": 1e-3},
+        "gates": {
+            "cnot": {"depolarizing": 1e-2, "amplitude_damping": 2e-3},
+            "h": {}
+        },
+        "readout": {"zero_to_one": 0.01, "one_to_zero": 0.03}
+    })json"};
+    NoiseModel model = load_noise_model(is);
+    EXPECT_EQ(1e-3, model.default_gate.depolarizing);
+    EXPECT_EQ(0, model.default_gate.amplitude_damping);
+    EXPECT_EQ(1e-2, model.channels("cnot").depolarizing);
+    EXPECT_EQ(2e-3, model.channels("cnot").amplitude_damping);
+    EXPECT_FALSE(model.channels("h"));
+    EXPECT_EQ(1e-3, model.channels("rx").depolarizing);
+    EXPECT_EQ(0.01, model.readout.zero_to_one);
+    EXPECT_EQ(0.03, model.readout.one_to_zero);
+    EXPECT_TRUE(model);
+
+    for (char const* bad : {
+             "not json",
+             "[]",
+             R"({"default": {"depolarising": 0.1}})",
+             R"({"gates": {"cnot": {"depolarizing": "high"}}})",
+             R"({"gates": {"cnto": {"depolarizing": 0.1}}})",
+             R"({"readout": {"zero_to_one": 2}})",
+             R"({"crosstalk": {}})",
+         })
+    {
+        std::istringstream bad_is{bad};
+        EXPECT_THROW(load_noise_model(bad_is), RuntimeError) << bad;
+    }
+    EXPECT_THROW(load_noise_model(std::string{"nonexistent.json"}),
+                 RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
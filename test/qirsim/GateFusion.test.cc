@@ -0,0 +1,289 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/GateFusion.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/detail/GateFusion.hh"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "qiree/Types.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace detail
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+constexpr double pi = 3.141592653589793;
+
+class GateFusionTest : public ::qiree::test::Test
+{
+  protected:
+    using VecComplex = std::vector<Complex>;
+
+    //! Create a normalized random state
+    VecComplex random_state(size_type num_qubits)
+    {
+        std::normal_distribution<double> sample;
+        VecComplex result(size_type{1} << num_qubits);
+        double norm = 0;
+        for (auto& amp : result)
+        {
+            amp = {sample(rng_), sample(rng_)};
+            norm += std::norm(amp);
+        }
+        for (auto& amp : result)
+        {
+            amp /= std::sqrt(norm);
+        }
+        return result;
+    }
+
+    //! Apply fused gates to a state
+    static void apply(Circuit const& c, FusedCircuit const& f, VecComplex* psi)
+    {
+        StateRef ref{psi->data(), psi->size()};
+        for (auto const& step : f.steps)
+        {
+            if (step.num_qubits > 0)
+            {
+                apply_dense(ref,
+                            f.qubits.data() + step.qubit_offset,
+                            step.num_qubits,
+                            f.matrices.data() + step.matrix_offset);
+            }
+            else
+            {
+                apply_operation(ref, c[step.begin]);
+            }
+        }
+    }
+
+    static void expect_state(VecComplex const& expected,
+                             VecComplex const& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_type i = 0; i < expected.size(); ++i)
+        {
+            EXPECT_NEAR(expected[i].real(), actual[i].real(), 1e-12) << i;
+            EXPECT_NEAR(expected[i].imag(), actual[i].imag(), 1e-12) << i;
+        }
+    }
+
+    std::mt19937 rng_{12345};
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(GateFusionTest, dense)
+{
+    // Targets in any order match the two-qubit kernel
+    Matrix4 m;
+    std::uniform_real_distribution<double> sample(-1, 1);
+    for (auto& v : m)
+    {
+        v = {sample(rng_), sample(rng_)};
+    }
+    auto expected = this->random_state(4);
+    auto actual = expected;
+    apply_matrix4({expected.data(), expected.size()}, 3, 1, m);
+    size_type const targets[] = {1, 3};
+    apply_dense({actual.data(), actual.size()}, targets, 2, m.data());
+    expect_state(expected, actual);
+
+    // An empty state is unchanged
+    apply_dense({}, targets, 2, m.data());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(GateFusionTest, blocks)
+{
+    Circuit c;
+    c.push_back({GateOp::h, {}, {0}});
+    c.push_back({GateOp::h, {}, {1}});
+    c.push_back({GateOp::x, {0}, {1}});
+    c.push_back({GateOp::h, {}, {2}});
+    c.push_back({GateOp::measure_z, {}, {0}, {}, 0, Result{0}});
+    c.push_back({GateOp::x, {}, {0}});
+    c.push_back({GateOp::x, {1, 2}, {0}});
+    c.push_back({GateOp::z, {}, {2}});
+
+    // Blocks end at measurements and when a gate adds too many qubits
+    FusedCircuit f;
+    fuse_gates(c, 2, &f);
+    ASSERT_EQ(6, f.steps.size());
+    EXPECT_EQ(0, f.steps[0].begin);
+    EXPECT_EQ(3, f.steps[0].end);
+    EXPECT_EQ(2, f.steps[0].num_qubits);
+    EXPECT_EQ((std::vector<size_type>{0, 1}), f.qubits);
+    EXPECT_EQ(16, f.matrices.size());
+    for (size_type i = 1; i < f.steps.size(); ++i)
+    {
+        EXPECT_EQ(i + 2, f.steps[i].begin);
+        EXPECT_EQ(0, f.steps[i].num_qubits);
+    }
+
+    // Toffoli and the following gate fuse with three qubits
+    fuse_gates(c, 3, &f);
+    ASSERT_EQ(3, f.steps.size());
+    EXPECT_EQ(4, f.steps[0].end);
+    EXPECT_EQ(3, f.steps[2].num_qubits);
+    EXPECT_EQ(5, f.steps[2].begin);
+
+    // No fusion
+    fuse_gates(c, 0, &f);
+    EXPECT_EQ(c.size(), f.steps.size());
+    EXPECT_TRUE(f.qubits.empty());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(GateFusionTest, random_circuits)
+{
+    constexpr size_type num_qubits = 7;
+    std::uniform_int_distribution<Circuit::Index> sample_qubit(
+        0, num_qubits - 1);
+    std::uniform_int_distribution<int> sample_gate(0, 15);
+    std::uniform_real_distribution<double> sample_angle(-pi, pi);
+
+    for (int trial = 0; trial < 8; ++trial)
+    {
+        Circuit c;
+        for (int i = 0; i < 80; ++i)
+        {
+            Circuit::Index a = sample_qubit(rng_);
+            Circuit::Index b = (a + 1 + sample_qubit(rng_) % (num_qubits - 1))
+                               % num_qubits;
+            double theta = sample_angle(rng_);
+            int g = sample_gate(rng_);
+            if (g < 15)
+            {
+                // Gates on nearby qubits make fusion likely
+                b = (a + 1) % num_qubits;
+            }
+            switch (g)
+            {
+                case 0:
+                    c.push_back({GateOp::h, {}, {a}});
+                    break;
+                case 1:
+                    c.push_back({GateOp::x, {b}, {a}});
+                    break;
+                case 2:
+                    c.push_back({GateOp::y, {}, {a}});
+                    break;
+                case 3:
+                    c.push_back({GateOp::s, {}, {a}});
+                    break;
+                case 4:
+                    c.push_back({GateOp::t_adj, {b}, {a}});
+                    break;
+                case 5:
+                    c.push_back({GateOp::rx, {}, {a}, {}, theta});
+                    break;
+                case 6:
+                    c.push_back({GateOp::ry, {b}, {a}, {}, theta});
+                    break;
+                case 7:
+                    c.push_back({GateOp::rz, {}, {a}, {}, theta});
+                    break;
+                case 8:
+                    c.push_back({GateOp::rxx, {}, {a, b}, {}, theta});
+                    break;
+                case 9:
+                    c.push_back({GateOp::ryy, {}, {a, b}, {}, theta});
+                    break;
+                case 10:
+                    c.push_back({GateOp::rzz, {}, {a, b}, {}, theta});
+                    break;
+                case 11:
+                    c.push_back({GateOp::pauli_rotation,
+                                 {},
+                                 {a, b},
+                                 {Pauli::y, Pauli::x},
+                                 theta});
+                    break;
+                case 12:
+                    c.push_back({GateOp::swap, {}, {a, b}});
+                    break;
+                case 13:
+                    c.push_back({GateOp::z, {b}, {a}});
+                    break;
+                case 14:
+                    c.push_back({GateOp::x, {}, {a}});
+                    break;
+                default:
+                    // Distant qubits
+                    c.push_back({GateOp::x, {b}, {a}});
+            }
+        }
+
+        auto const initial = this->random_state(num_qubits);
+        auto expected = initial;
+        for (size_type i = 0; i < c.size(); ++i)
+        {
+            apply_operation({expected.data(), expected.size()}, c[i]);
+        }
+
+        FusedCircuit f;
+        for (size_type k = 1; k <= max_dense_qubits; ++k)
+        {
+            fuse_gates(c, k, &f);
+            EXPECT_LE(f.steps.size(), c.size());
+            auto actual = initial;
+            this->apply(c, f, &actual);
+            expect_state(expected, actual);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(GateFusionTest, cost)
+{
+    // Layers of single-qubit rotations and CNOT ladders
+    Circuit c;
+    for (int layer = 0; layer < 4; ++layer)
+    {
+        for (Circuit::Index q = 0; q < 8; ++q)
+        {
+            c.push_back({GateOp::ry, {}, {q}, {}, 0.1 * (q + 1)});
+        }
+        for (Circuit::Index q = 0; q + 1 < 8; ++q)
+        {
+            c.push_back({GateOp::x, {q}, {q + 1}});
+        }
+    }
+
+    // Unfused gates each take a sweep
+    FusedCircuit f;
+    fuse_gates(c, 0, &f);
+    EXPECT_DOUBLE_EQ(c.size(), fusion_cost(c, f, 30));
+
+    // Large states in main memory fuse the layers
+    FusedCircuit best;
+    size_type k = fuse_gates_min_cost(c, 30, &best);
+    EXPECT_GE(k, 2);
+    for (size_type j = 0; j <= max_dense_qubits; ++j)
+    {
+        fuse_gates(c, j, &f);
+        EXPECT_LE(fusion_cost(c, best, 30), fusion_cost(c, f, 30)) << j;
+    }
+    EXPECT_LT(best.steps.size(), c.size() * 3 / 4);
+
+    // Building an operator costs more than applying gates to a tiny state
+    c.clear();
+    c.push_back({GateOp::h, {}, {0}});
+    c.push_back({GateOp::h, {}, {1}});
+    EXPECT_EQ(0, fuse_gates_min_cost(c, 2, &best));
+    EXPECT_EQ(2, best.steps.size());
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace detail
+}  // namespace qiree
@@ -0,0 +1,225 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/HistogramRuntime.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/HistogramRuntime.hh"
+
+#include <sstream>
+
+#include "qiree/Assert.hh"
+#include "qiree/DirectExecutor.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qirsim/StateVectorQuantum.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class HistogramRuntimeTest : public ::qiree::test::Test
+{
+  protected:
+    static constexpr int num_shots = 256;
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(HistogramRuntimeTest, bell)
+{
+    Executor execute{Module{this->test_data_path("bell.ll")}};
+    StateVectorQuantum sim;
+    HistogramRuntime rt{sim};
+    for (int i = 0; i < num_shots; ++i)
+    {
+        execute(sim, rt);
+        rt.end_shot();
+    }
+    EXPECT_EQ(num_shots, rt.num_shots());
+
+    ASSERT_EQ(1, rt.groups().size());
+    auto const& group = rt.groups().front();
+    EXPECT_EQ(HistogramRuntime::GroupType::array, group.type);
+    EXPECT_EQ("<null>", group.tag);
+    EXPECT_EQ(2, group.length);
+    ASSERT_EQ(2, group.counts.size());
+    auto zeros = group.counts.at("00");
+    auto ones = group.counts.at("11");
+    EXPECT_EQ(num_shots, zeros + ones);
+    EXPECT_LT(num_shots / 4, zeros);
+    EXPECT_LT(num_shots / 4, ones);
+
+    std::ostringstream os;
+    rt.print_tuples(os);
+    EXPECT_EQ("array <null> length 2 distinct results 2\n"
+              "array <null> result 00 count "
+                  + std::to_string(zeros)
+                  + "\n"
+                    "array <null> result 11 count "
+                  + std::to_string(ones) + "\n",
+              os.str());
+
+    os.str({});
+    rt.print_results(os);
+    std::string result_counts = ": {0: " + std::to_string(zeros)
+                                + ", 1: " + std::to_string(ones) + "}\n";
+    EXPECT_EQ("array <null> length 2\n"
+              "result 0 experiment <null>"
+                  + result_counts + "result 1 experiment <null>"
+                  + result_counts,
+              os.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(HistogramRuntimeTest, teleport)
+{
+    // Direct dispatch to the simulator and runtime
+    DirectExecutor<StateVectorQuantum, HistogramRuntime> execute{
+        Module{this->test_data_path("teleport.ll")}};
+    StateVectorQuantum sim;
+    HistogramRuntime rt{sim};
+    for (int i = 0; i < num_shots; ++i)
+    {
+        execute(sim, rt);
+        rt.end_shot();
+    }
+
+    // The teleported |0> is always measured as zero
+    ASSERT_EQ(1, rt.groups().size());
+    auto const& counts = rt.groups().front().counts;
+    EXPECT_EQ(4, counts.size());
+    for (auto const& [bits, count] : counts)
+    {
+        EXPECT_EQ('0', bits[2]) << bits;
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(HistogramRuntimeTest, sample_once)
+{
+    Module mod{this->test_data_path("labeled.ll")};
+    ASSERT_TRUE(mod.has_terminal_measurements());
+    DirectExecutor<StateVectorQuantum, HistogramRuntime> execute{
+        std::move(mod)};
+    StateVectorQuantum sim;
+    HistogramRuntime rt{sim};
+    EXPECT_THROW(rt.repeat_shot(), RuntimeError);
+
+    // Execute once and sample the other shots from the final state
+    sim.defer_measurements(true);
+    execute(sim, rt);
+    rt.end_shot();
+    for (int i = 1; i < num_shots; ++i)
+    {
+        sim.resample();
+        rt.repeat_shot();
+    }
+    EXPECT_EQ(num_shots, rt.num_shots());
+
+    ASSERT_EQ(1, rt.groups().size());
+    auto const& group = rt.groups().front();
+    EXPECT_EQ("arr", group.tag);
+    EXPECT_EQ((std::vector<std::string>{"r0", "r1"}), group.result_tags);
+    size_type total{0};
+    for (auto const& [bits, count] : group.counts)
+    {
+        total += count;
+    }
+    EXPECT_EQ(num_shots, total);
+    EXPECT_EQ(4, group.counts.size());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(HistogramRuntimeTest, structure)
+{
+    StateVectorQuantum sim;
+    HistogramRuntime rt{sim};
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 1;
+    attrs.required_num_results = 1;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        sim.set_up(attrs);
+        sim.x(Qubit{0});
+        sim.mz(Qubit{0}, Result{0});
+        rt.tuple_record_output(0, "empty");
+        rt.result_record_output(Result{0}, "bare");
+        rt.tuple_record_output(2, "pair");
+        rt.result_record_output(Result{0}, "first");
+        rt.result_record_output(Result{0}, "second");
+        rt.end_shot();
+    }
+
+    std::ostringstream os;
+    rt.print_tuples(os);
+    EXPECT_EQ(R"(tuple empty length 0 distinct results 1
+tuple empty result  count 2
+result bare length 1 distinct results 1
+result bare result 1 count 2
+tuple pair length 2 distinct results 1
+tuple pair result 11 count 2
+)",
+              os.str());
+    os.str({});
+    rt.print_results(os);
+    EXPECT_EQ(R"(tuple empty length 0
+result 0 experiment bare: {0: 0, 1: 2}
+tuple pair length 2
+result 0 experiment first: {0: 0, 1: 2}
+result 0 experiment second: {0: 0, 1: 2}
+)",
+              os.str());
+
+    // Outputs must match previous shots
+    EXPECT_THROW(rt.array_record_output(2, nullptr), RuntimeError);
+    rt.tuple_record_output(0, "empty");
+    EXPECT_THROW(rt.end_shot(), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(HistogramRuntimeTest, merge)
+{
+    StateVectorQuantum sim;
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 1;
+    attrs.required_num_results = 1;
+    auto record = [&](HistogramRuntime& rt, bool one, char const* tag) {
+        sim.set_up(attrs);
+        if (one)
+        {
+            sim.x(Qubit{0});
+        }
+        sim.mz(Qubit{0}, Result{0});
+        rt.array_record_output(1, tag);
+        rt.result_record_output(Result{0}, nullptr);
+        rt.end_shot();
+    };
+
+    HistogramRuntime merged{sim};
+    HistogramRuntime first{sim};
+    record(first, false, "a");
+    record(first, true, "a");
+    HistogramRuntime second{sim};
+    record(second, true, "a");
+
+    merged.merge(first);
+    merged.merge(second);
+    merged.merge(HistogramRuntime{sim});
+    EXPECT_EQ(3, merged.num_shots());
+    ASSERT_EQ(1, merged.groups().size());
+    EXPECT_EQ((HistogramRuntime::Counts{{"0", 1}, {"1", 2}}),
+              merged.groups().front().counts);
+
+    HistogramRuntime other{sim};
+    record(other, true, "b");
+    EXPECT_THROW(merged.merge(other), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
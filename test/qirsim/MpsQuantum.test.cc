@@ -0,0 +1,217 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/MpsQuantum.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/MpsQuantum.hh"
+
+#include <complex>
+#include <random>
+
+#include "QuantumTestBase.hh"
+#include "qiree/Assert.hh"
+#include "qiree/DirectExecutor.hh"
+#include "qiree/Module.hh"
+#include "qiree/Types.hh"
+#include "qirsim/HistogramRuntime.hh"
+#include "qirsim/StateVectorQuantum.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+constexpr double pi = 3.141592653589793;
+constexpr double sqrt_half = 0.70710678118654752440;
+
+class MpsQuantumTest : public QuantumTestBase
+{
+  protected:
+    //! Compare the MPS amplitudes with a state vector
+    static void
+    expect_state(StateVectorQuantum const& expected, MpsQuantum const& actual)
+    {
+        auto const& psi = expected.state();
+        for (size_type i = 0; i < psi.size(); ++i)
+        {
+            auto amp = actual.amplitude(i);
+            EXPECT_NEAR(psi[i].real(), amp.real(), 1e-10) << i;
+            EXPECT_NEAR(psi[i].imag(), amp.imag(), 1e-10) << i;
+        }
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(MpsQuantumTest, bell)
+{
+    MpsQuantum sim;
+    sim.set_up(attrs(2, 2));
+    EXPECT_EQ(2, sim.num_qubits());
+    EXPECT_EQ(1, sim.bond_dimension(0));
+
+    sim.h(Q{0});
+    sim.cnot(Q{0}, Q{1});
+    EXPECT_EQ(2, sim.bond_dimension(0));
+    EXPECT_NEAR(sqrt_half, sim.amplitude(0).real(), 1e-12);
+    EXPECT_NEAR(0, std::abs(sim.amplitude(1)), 1e-12);
+    EXPECT_NEAR(sqrt_half, sim.amplitude(3).real(), 1e-12);
+
+    sim.mz(Q{0}, R{0});
+    sim.mz(Q{1}, R{1});
+    EXPECT_EQ(sim.read_result(R{0}), sim.read_result(R{1}));
+    EXPECT_EQ(1, sim.bond_dimension(0));
+    EXPECT_EQ(0, sim.discarded_weight());
+
+    // Joint measurements of a Bell state are deterministic
+    int num_ones = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        sim.set_up(attrs(2, 0));
+        sim.h(Q{0});
+        sim.cnot(Q{0}, Q{1});
+        auto zz = sim.measure(make_array({Pauli::z, Pauli::z}),
+                              make_array({Q{0}, Q{1}}));
+        auto xx = sim.measure(make_array({Pauli::x, Pauli::x}),
+                              make_array({Q{1}, Q{0}}));
+        EXPECT_EQ(QState::zero, sim.read_result(zz));
+        EXPECT_EQ(QState::zero, sim.read_result(xx));
+        num_ones += (sim.read_result(sim.m(Q{0})) == QState::one);
+    }
+    EXPECT_LT(25, num_ones);
+    EXPECT_GT(75, num_ones);
+
+    EXPECT_THROW(sim.h(Q{2}), RuntimeError);
+    EXPECT_THROW(sim.read_result(R{5}), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(MpsQuantumTest, random_circuits)
+{
+    constexpr size_type num_qubits = 6;
+    std::mt19937 rng(12345);
+
+    MpsQuantum::Options opts;
+    opts.truncation_threshold = 0;
+    MpsQuantum mps{opts};
+    StateVectorQuantum sv;
+    for (int circuit = 0; circuit < 10; ++circuit)
+    {
+        mps.set_up(attrs(num_qubits, 0));
+        sv.set_up(attrs(num_qubits, 0));
+        for (int i = 0; i < 60; ++i)
+        {
+            this->apply_random_gate(
+                GateSet::universal, num_qubits, rng, mps, sv);
+        }
+        expect_state(sv, mps);
+        EXPECT_LT(mps.discarded_weight(), 1e-20);
+        EXPECT_GE(8, mps.max_bond_dimension());
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(MpsQuantumTest, wide_ghz)
+{
+    // Far beyond the state vector simulator but with a bond dimension of 2
+    constexpr size_type num_qubits = 80;
+    MpsQuantum sim;
+    for (int shot = 0; shot < 10; ++shot)
+    {
+        sim.set_up(attrs(num_qubits, num_qubits));
+        sim.h(Q{0});
+        for (size_type i = 0; i + 1 < num_qubits; ++i)
+        {
+            sim.cnot(Q{i}, Q{i + 1});
+        }
+        // Long-range gate requires a swap network
+        sim.cz(Q{0}, Q{num_qubits - 1});
+        EXPECT_EQ(2, sim.max_bond_dimension());
+
+        for (size_type i = 0; i < num_qubits; ++i)
+        {
+            sim.mz(Q{i}, R{i});
+        }
+        for (size_type i = 1; i < num_qubits; ++i)
+        {
+            ASSERT_EQ(sim.read_result(R{0}), sim.read_result(R{i})) << i;
+        }
+        EXPECT_LT(sim.discarded_weight(), 1e-20);
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(MpsQuantumTest, truncation)
+{
+    MpsQuantum::Options opts;
+    opts.max_bond = 1;
+    MpsQuantum sim{opts};
+    sim.set_up(attrs(2, 0));
+
+    // An unequal superposition loses its smaller Schmidt component
+    sim.ry(pi / 3, Q{0});
+    sim.cnot(Q{0}, Q{1});
+    EXPECT_EQ(1, sim.bond_dimension(0));
+    EXPECT_NEAR(0.25, sim.discarded_weight(), 1e-12);
+    EXPECT_NEAR(1, std::abs(sim.amplitude(0)), 1e-12);
+
+    opts.truncation_threshold = 1;
+    EXPECT_THROW(MpsQuantum{opts}, RuntimeError);
+    opts.truncation_threshold = 0;
+    opts.max_bond = 0;
+    EXPECT_THROW(MpsQuantum{opts}, RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(MpsQuantumTest, reset)
+{
+    MpsQuantum sim;
+    for (int i = 0; i < 20; ++i)
+    {
+        sim.set_up(attrs(3, 0));
+        sim.h(Q{0});
+        sim.cnot(Q{0}, Q{2});
+        auto r = sim.mresetz(Q{0});
+        EXPECT_NEAR(0, std::abs(sim.amplitude(1)), 1e-12);
+        sim.reset(Q{2});
+        EXPECT_NEAR(1, std::abs(sim.amplitude(0)), 1e-12);
+        EXPECT_EQ(0, r.value);
+    }
+
+    // Multiply controlled gates other than the Toffoli are not supported
+    sim.set_up(attrs(4, 0));
+    EXPECT_THROW(sim.z(make_array({Q{0}, Q{1}}), Q{2}), RuntimeError);
+    EXPECT_THROW(sim.h(make_array({Q{0}}), Q{0}), RuntimeError);
+    sim.x(Q{0});
+    sim.x(Q{1});
+    sim.x(make_array({Q{0}, Q{1}}), Q{3});
+    EXPECT_NEAR(1, std::abs(sim.amplitude(0b1011)), 1e-12);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(MpsQuantumTest, teleport)
+{
+    DirectExecutor<MpsQuantum, HistogramRuntime> execute{
+        Module{this->test_data_path("teleport.ll")}};
+    MpsQuantum sim;
+    HistogramRuntime rt{sim};
+    for (int i = 0; i < 64; ++i)
+    {
+        execute(sim, rt);
+        rt.end_shot();
+    }
+
+    ASSERT_EQ(1, rt.groups().size());
+    auto const& counts = rt.groups().front().counts;
+    EXPECT_EQ(4, counts.size());
+    for (auto const& [bits, count] : counts)
+    {
+        EXPECT_EQ('0', bits[2]) << bits;
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,129 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/OptimizingQuantum.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/OptimizingQuantum.hh"
+
+#include <complex>
+#include <random>
+
+#include "QuantumTestBase.hh"
+#include "qiree/DirectExecutor.hh"
+#include "qiree/Module.hh"
+#include "qiree/Types.hh"
+#include "qirsim/HistogramRuntime.hh"
+#include "qirsim/StateVectorQuantum.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+class OptimizingQuantumTest : public QuantumTestBase
+{
+  protected:
+    //! Compare two state vectors up to a global phase
+    static void expect_state(StateVectorQuantum const& expected,
+                             StateVectorQuantum const& actual)
+    {
+        auto const& a = expected.state();
+        auto const& b = actual.state();
+        ASSERT_EQ(a.size(), b.size());
+        std::complex<double> overlap{0};
+        for (size_type k = 0; k < a.size(); ++k)
+        {
+            overlap += std::conj(a[k]) * b[k];
+        }
+        EXPECT_NEAR(1, std::abs(overlap), 1e-10);
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(OptimizingQuantumTest, random_circuits)
+{
+    // Quarter-turn rotations on few qubits produce many redundant gates
+    constexpr size_type num_qubits = 3;
+    std::mt19937 rng(54321);
+
+    StateVectorQuantum direct;
+    StateVectorQuantum target;
+    OptimizingQuantum opt{target};
+    for (int circuit = 0; circuit < 20; ++circuit)
+    {
+        direct.set_up(attrs(num_qubits, 1));
+        opt.set_up(attrs(num_qubits, 1));
+        for (int i = 0; i < 60; ++i)
+        {
+            this->apply_random_gate(
+                GateSet::quarter_turns, num_qubits, rng, direct, opt);
+        }
+        opt.tear_down();
+        expect_state(direct, target);
+    }
+
+    auto const& before = opt.optimizer().counts_before();
+    auto const& after = opt.optimizer().counts_after();
+    size_type total_before{0};
+    size_type total_after{0};
+    for (size_type i = 0; i < before.size(); ++i)
+    {
+        total_before += before[i];
+        total_after += after[i];
+    }
+    EXPECT_EQ(20 * 60, total_before);
+    EXPECT_LT(total_after, total_before);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(OptimizingQuantumTest, branching)
+{
+    // Reading a result executes the pending gates first
+    StateVectorQuantum target;
+    OptimizingQuantum opt{target};
+    opt.set_up(attrs(2, 1));
+    opt.h(Q{0});
+    opt.x(Q{1});
+    opt.h(Q{0});
+    opt.mz(Q{1}, R{0});
+    EXPECT_EQ(QState::one, opt.read_result(R{0}));
+    opt.x(Q{1});
+    R r = opt.mresetz(Q{0});
+    EXPECT_EQ(1, r.value);
+    EXPECT_EQ(QState::zero, opt.read_result(r));
+    opt.tear_down();
+
+    auto const& after = opt.optimizer().counts_after();
+    EXPECT_EQ(0, after[static_cast<int>(GateOp::h)]);
+    EXPECT_EQ(2, after[static_cast<int>(GateOp::x)]);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(OptimizingQuantumTest, teleport)
+{
+    // Feed-forward programs execute with direct dispatch
+    DirectExecutor<OptimizingQuantum, HistogramRuntime> execute{
+        Module{this->test_data_path("teleport.ll")}};
+    StateVectorQuantum sim;
+    OptimizingQuantum opt{sim};
+    HistogramRuntime rt{opt};
+    for (int i = 0; i < 64; ++i)
+    {
+        execute(opt, rt);
+        rt.end_shot();
+    }
+
+    // The teleported |0> is always measured as zero
+    ASSERT_EQ(1, rt.groups().size());
+    for (auto const& [bits, count] : rt.groups().front().counts)
+    {
+        EXPECT_EQ('0', bits[2]) << bits;
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,137 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/ParallelShots.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/ParallelShots.hh"
+
+#include <set>
+
+#include "qiree/Assert.hh"
+#include "qiree/DirectExecutor.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qirsim/StabilizerQuantum.hh"
+#include "qirsim/StateVectorQuantum.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class ParallelShotsTest : public ::qiree::test::Test
+{
+  protected:
+    static constexpr size_type num_shots = 256;
+
+    template<class QI>
+    HistogramRuntime::Counts
+    run(char const* filename, size_type num_threads, std::uint64_t seed)
+    {
+        DirectExecutor<QI, HistogramRuntime> execute{
+            Module{this->test_data_path(filename)}};
+        typename QI::Options opts;
+        opts.seed = seed;
+        QI sim{opts};
+        HistogramRuntime rt{sim};
+        run_parallel_shots<QI>(execute, opts, num_shots, num_threads, rt);
+        EXPECT_EQ(num_shots, rt.num_shots());
+        EXPECT_EQ(1, rt.groups().size());
+        return rt.groups().front().counts;
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(ParallelShotsTest, stream_seed)
+{
+    std::set<std::uint64_t> seeds;
+    for (std::uint64_t seed : {0, 1, 2})
+    {
+        for (size_type stream = 0; stream < 4; ++stream)
+        {
+            seeds.insert(stream_seed(seed, stream));
+        }
+    }
+    EXPECT_EQ(12, seeds.size());
+    EXPECT_EQ(stream_seed(1, 2), stream_seed(1, 2));
+    EXPECT_LE(1, default_num_threads());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ParallelShotsTest, teleport)
+{
+    // Measurements are fed forward in every thread
+    auto counts = this->run<StateVectorQuantum>("teleport.ll", 4, 12345);
+    EXPECT_EQ(4, counts.size());
+    for (auto const& [bits, count] : counts)
+    {
+        EXPECT_EQ('0', bits[2]) << bits;
+        EXPECT_LT(num_shots / 8, count) << bits;
+    }
+
+    // Results are reproducible for a given seed and thread count
+    EXPECT_EQ(counts, this->run<StateVectorQuantum>("teleport.ll", 4, 12345));
+
+    auto stab_counts = this->run<StabilizerQuantum>("teleport.ll", 3, 1);
+    EXPECT_EQ(4, stab_counts.size());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ParallelShotsTest, executor)
+{
+    // The JIT executor dispatches through each thread's interfaces
+    Executor execute{Module{this->test_data_path("teleport.ll")}};
+    StateVectorQuantum::Options opts;
+    opts.seed = 12345;
+    StateVectorQuantum sim{opts};
+    HistogramRuntime rt{sim};
+    run_parallel_shots<StateVectorQuantum>(execute, opts, num_shots, 4, rt);
+    EXPECT_EQ(num_shots, rt.num_shots());
+    ASSERT_EQ(1, rt.groups().size());
+    auto const& counts = rt.groups().front().counts;
+    EXPECT_EQ(4, counts.size());
+    for (auto const& [bits, count] : counts)
+    {
+        EXPECT_EQ('0', bits[2]) << bits;
+    }
+
+    // The JIT and direct executors sample the same shots for a given seed
+    EXPECT_EQ(counts, this->run<StateVectorQuantum>("teleport.ll", 4, 12345));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ParallelShotsTest, more_threads_than_shots)
+{
+    DirectExecutor<StateVectorQuantum, HistogramRuntime> execute{
+        Module{this->test_data_path("bell.ll")}};
+    StateVectorQuantum sim;
+    HistogramRuntime rt{sim};
+    StateVectorQuantum::Options opts;
+    run_parallel_shots<StateVectorQuantum>(execute, opts, 3, 16, rt);
+    EXPECT_EQ(3, rt.num_shots());
+    run_parallel_shots<StateVectorQuantum>(execute, opts, 0, 16, rt);
+    EXPECT_EQ(3, rt.num_shots());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ParallelShotsTest, error)
+{
+    DirectExecutor<StateVectorQuantum, HistogramRuntime> execute{
+        Module{this->test_data_path("teleport.ll")}};
+    StateVectorQuantum::Options opts;
+    opts.max_qubits = 2;
+    StateVectorQuantum sim;
+    HistogramRuntime rt{sim};
+    EXPECT_THROW(
+        run_parallel_shots<StateVectorQuantum>(execute, opts, 16, 4, rt),
+        RuntimeError);
+    EXPECT_EQ(0, rt.num_shots());
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,281 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/PauliFrameQuantum.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/PauliFrameQuantum.hh"
+
+#include <random>
+
+#include "QuantumTestBase.hh"
+#include "qiree/Assert.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree/Types.hh"
+#include "qirsim/DensityMatrixQuantum.hh"
+#include "qirsim/HistogramRuntime.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+constexpr double half_pi = 1.5707963267948966;
+
+class PauliFrameQuantumTest : public QuantumTestBase
+{
+  protected:
+    using Options = PauliFrameQuantum::Options;
+
+    //! Fraction of shots in which a result is one
+    static double
+    fraction_one(MeasurementRecord const& record, size_type result)
+    {
+        size_type count = 0;
+        for (size_type s = 0; s < record.num_shots; ++s)
+        {
+            count += record.get(s, result);
+        }
+        return static_cast<double>(count) / record.num_shots;
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(PauliFrameQuantumTest, ghz)
+{
+    constexpr size_type num_qubits = 100;
+    PauliFrameQuantum sim;
+    sim.set_up(attrs(num_qubits, num_qubits));
+    sim.h(Q{0});
+    for (size_type i = 1; i < num_qubits; ++i)
+    {
+        sim.cnot(Q{i - 1}, Q{i});
+    }
+    for (size_type i = 0; i < num_qubits; ++i)
+    {
+        sim.mz(Q{i}, R{i});
+    }
+    EXPECT_EQ(2 * num_qubits, sim.num_operations());
+    EXPECT_EQ(num_qubits, sim.num_results());
+
+    MeasurementRecord record;
+    sim.sample(1000, record);
+    EXPECT_EQ(1000, record.num_shots);
+    EXPECT_EQ(num_qubits, record.num_results);
+    EXPECT_EQ(16, record.words_per_result);
+    ASSERT_EQ(num_qubits * 16, record.bits.size());
+
+    // All qubits agree in every shot
+    size_type num_ones = 0;
+    for (size_type s = 0; s < record.num_shots; ++s)
+    {
+        bool first = record.get(s, 0);
+        num_ones += first;
+        for (size_type i = 1; i < num_qubits; ++i)
+        {
+            ASSERT_EQ(first, record.get(s, i)) << "shot " << s;
+        }
+    }
+    EXPECT_LT(400, num_ones);
+    EXPECT_GT(600, num_ones);
+
+    // Bits past the last shot are cleared
+    EXPECT_EQ(0, record.bits[15] >> (1000 % 64));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(PauliFrameQuantumTest, deterministic)
+{
+    Options opts;
+    opts.batch_words = 1;
+    PauliFrameQuantum sim{opts};
+    sim.set_up(attrs(3, 3));
+    sim.h(Q{0});
+    sim.h(Q{0});
+    sim.x(Q{1});
+    sim.rx(half_pi, Q{2});
+    sim.rx(half_pi, Q{2});
+    sim.mz(Q{0}, R{0});
+    sim.mz(Q{1}, R{1});
+    sim.mz(Q{2}, R{2});
+
+    // Reading results steps through shots and batches
+    for (int i = 0; i < 200; ++i)
+    {
+        EXPECT_EQ(QState::zero, sim.read_result(R{0}));
+        EXPECT_EQ(QState::one, sim.read_result(R{1}));
+        EXPECT_EQ(QState::one, sim.read_result(R{2}));
+        sim.next_shot();
+    }
+
+    // Operations can't be recorded after sampling
+    EXPECT_THROW(sim.h(Q{0}), RuntimeError);
+    EXPECT_THROW(sim.read_result(R{3}), RuntimeError);
+
+    sim.set_up(attrs(1, 0));
+    EXPECT_THROW(sim.t(Q{0}), RuntimeError);
+    EXPECT_THROW(sim.rx(0.1, Q{0}), RuntimeError);
+    EXPECT_THROW(sim.h(Q{1}), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(PauliFrameQuantumTest, mid_circuit)
+{
+    PauliFrameQuantum sim;
+    sim.set_up(attrs(2, 0));
+    sim.h(Q{0});
+    sim.cnot(Q{0}, Q{1});
+
+    // Joint measurements of a Bell state are deterministic but don't fix the
+    // individual outcomes
+    auto xx = sim.measure(make_array({Pauli::x, Pauli::x}),
+                          make_array({Q{1}, Q{0}}));
+    auto yy = sim.measure(make_array({Pauli::y, Pauli::y}),
+                          make_array({Q{0}, Q{1}}));
+    auto m0 = sim.m(Q{0});
+    auto m1 = sim.mresetz(Q{1});
+    auto m2 = sim.m(Q{1});
+    sim.reset(Q{0});
+    sim.h(Q{0});
+    auto m3 = sim.m(Q{0});
+
+    MeasurementRecord record;
+    sim.sample(4096, record);
+    EXPECT_EQ(0, fraction_one(record, xx.value));
+    EXPECT_EQ(1, fraction_one(record, yy.value));
+    EXPECT_NEAR(0.5, fraction_one(record, m0.value), 0.05);
+    EXPECT_NEAR(0.5, fraction_one(record, m3.value), 0.05);
+    EXPECT_EQ(0, fraction_one(record, m2.value));
+    for (size_type s = 0; s < record.num_shots; ++s)
+    {
+        ASSERT_EQ(record.get(s, m0.value), record.get(s, m1.value));
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(PauliFrameQuantumTest, noisy_circuits)
+{
+    // Compare sampled distributions with the exact density matrix
+    constexpr size_type num_qubits = 3;
+    constexpr size_type num_shots = 1 << 15;
+    Options opts;
+    opts.noise.default_gate.depolarizing = 0.05;
+    opts.noise.gates["cnot"].depolarizing = 0.15;
+    opts.noise.readout.zero_to_one = 0.02;
+    opts.noise.readout.one_to_zero = 0.1;
+    DensityMatrixQuantum::Options dm_opts;
+    dm_opts.noise = opts.noise;
+
+    std::mt19937 rng(12345);
+    for (int circuit = 0; circuit < 5; ++circuit)
+    {
+        PauliFrameQuantum frame{opts};
+        DensityMatrixQuantum dm{dm_opts};
+        frame.set_up(attrs(num_qubits, num_qubits));
+        dm.set_up(attrs(num_qubits, 0));
+        for (int i = 0; i < 12; ++i)
+        {
+            this->apply_random_gate(
+                GateSet::clifford, num_qubits, rng, frame, dm);
+        }
+        for (size_type i = 0; i < num_qubits; ++i)
+        {
+            frame.mz(Q{i}, R{i});
+        }
+        MeasurementRecord record;
+        frame.sample(num_shots, record);
+
+        // Exact distribution of the read outcomes
+        constexpr size_type dim = 1 << num_qubits;
+        double expected[dim] = {};
+        for (size_type k = 0; k < dim; ++k)
+        {
+            for (size_type read = 0; read < dim; ++read)
+            {
+                double p = dm.element(k, k).real();
+                for (size_type i = 0; i < num_qubits; ++i)
+                {
+                    bool bit = (k >> i) & 1;
+                    double flip = bit ? opts.noise.readout.one_to_zero
+                                      : opts.noise.readout.zero_to_one;
+                    p *= (bit != bool((read >> i) & 1)) ? flip : 1 - flip;
+                }
+                expected[read] += p;
+            }
+        }
+        double actual[dim] = {};
+        for (size_type s = 0; s < num_shots; ++s)
+        {
+            size_type read = 0;
+            for (size_type i = 0; i < num_qubits; ++i)
+            {
+                read |= size_type{record.get(s, i)} << i;
+            }
+            actual[read] += 1.0 / num_shots;
+        }
+        for (size_type k = 0; k < dim; ++k)
+        {
+            EXPECT_NEAR(expected[k], actual[k], 0.015)
+                << "circuit " << circuit << ", outcome " << k;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(PauliFrameQuantumTest, noise_model)
+{
+    // Only Pauli channels can be sampled
+    Options opts;
+    opts.noise.gates["h"].amplitude_damping = 0.1;
+    EXPECT_THROW(PauliFrameQuantum{opts}, RuntimeError);
+    opts.noise.gates.clear();
+    opts.noise.default_gate.depolarizing = 2;
+    EXPECT_THROW(PauliFrameQuantum{opts}, RuntimeError);
+    opts.noise.default_gate.depolarizing = 0;
+    opts.batch_words = 0;
+    EXPECT_THROW(PauliFrameQuantum{opts}, RuntimeError);
+
+    // Fully depolarizing a qubit leaves it maximally mixed
+    opts.batch_words = 2;
+    opts.noise.gates["x"].depolarizing = 0.75;
+    PauliFrameQuantum sim{opts};
+    sim.set_up(attrs(1, 1));
+    sim.x(Q{0});
+    sim.mz(Q{0}, R{0});
+    MeasurementRecord record;
+    sim.sample(8192, record);
+    EXPECT_NEAR(0.5, fraction_one(record, 0), 0.03);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(PauliFrameQuantumTest, executor)
+{
+    Executor execute{Module{this->test_data_path("bell.ll")}};
+    Options opts;
+    opts.noise.readout.zero_to_one = 0.1;
+    PauliFrameQuantum sim{opts};
+    HistogramRuntime rt{sim};
+
+    // Execute once and sample the remaining shots
+    execute(sim, rt);
+    rt.end_shot();
+    for (int i = 1; i < 1024; ++i)
+    {
+        sim.next_shot();
+        rt.repeat_shot();
+    }
+
+    ASSERT_EQ(1, rt.groups().size());
+    auto const& counts = rt.groups().front().counts;
+    EXPECT_EQ(4, counts.size());
+    EXPECT_LT(350, counts.at("00"));
+    EXPECT_LT(350, counts.at("11"));
+    EXPECT_GT(100, counts.at("01"));
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,206 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/QuantumTestBase.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <random>
+#include <vector>
+
+#include "qiree/Assert.hh"
+#include "qiree/MemManager.hh"
+#include "qiree/Types.hh"
+#include "qirsim/detail/QirArgs.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Test harness for simulators of the quantum interface.
+ *
+ * QIR arrays created by the test are released when it finishes. Random
+ * circuits are built by applying the same sequence of random gates to two
+ * or more simulators and comparing their final states.
+ */
+class QuantumTestBase : public ::qiree::test::Test
+{
+  protected:
+    using Q = Qubit;
+    using R = Result;
+
+    //! Gates drawn by \c apply_random_gate
+    enum class GateSet
+    {
+        clifford,  //!< Clifford gates and quarter-turn rotations
+        universal,  //!< Arbitrary rotations and at most one control
+        multi_controlled,  //!< Universal gates and two controls
+        quarter_turns,  //!< Multi-controlled gates with quarter-turn angles
+    };
+
+    void TearDown() override
+    {
+        for (auto arr : arrays_)
+        {
+            MemManager::array_update_reference_count(arr, -1);
+        }
+    }
+
+    static EntryPointAttrs attrs(size_type qubits, size_type results)
+    {
+        EntryPointAttrs result;
+        result.required_num_qubits = qubits;
+        result.required_num_results = results;
+        return result;
+    }
+
+    //! Create a QIR array that is released at the end of the test
+    template<class T>
+    Array make_array(std::initializer_list<T> values)
+    {
+        Array result = MemManager::array_create_1d(sizeof(T), values.size());
+        std::uint64_t i = 0;
+        for (auto v : values)
+        {
+            std::memcpy(MemManager::array_get_element_ptr_1d(result, i++),
+                        &v,
+                        sizeof(T));
+        }
+        arrays_.push_back(result);
+        return result;
+    }
+
+    // Apply the same random gate to each simulator
+    template<class... S>
+    void apply_random_gate(GateSet gates,
+                           size_type num_qubits,
+                           std::mt19937& rng,
+                           S&... sims);
+
+  private:
+    std::vector<Array> arrays_;
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Apply the same random gate to each simulator.
+ *
+ * Gates act on up to three distinct qubits, so all but the Clifford gate set
+ * need at least three.
+ */
+template<class... S>
+void QuantumTestBase::apply_random_gate(GateSet gates,
+                                        size_type num_qubits,
+                                        std::mt19937& rng,
+                                        S&... sims)
+{
+    constexpr double half_pi = 1.5707963267948966;
+    QIREE_EXPECT(num_qubits >= (gates == GateSet::clifford ? 2 : 3));
+
+    std::uniform_int_distribution<size_type> sample_qubit(0, num_qubits - 1);
+    Q a{sample_qubit(rng)};
+    Q b{(a.value + 1 + sample_qubit(rng) % (num_qubits - 1)) % num_qubits};
+    Q c{(b.value + 1 + sample_qubit(rng) % (num_qubits - 1)) % num_qubits};
+    if (c.value == a.value)
+    {
+        c.value = (c.value + 1) % num_qubits;
+        c.value = c.value == b.value ? (c.value + 1) % num_qubits : c.value;
+    }
+
+    double theta;
+    if (gates == GateSet::universal || gates == GateSet::multi_controlled)
+    {
+        theta = std::uniform_real_distribution<double>(-2, 2)(rng) * half_pi;
+    }
+    else
+    {
+        theta = std::uniform_int_distribution<int>(-4, 4)(rng) * half_pi;
+    }
+
+    auto apply = [&](auto&& gate) { (gate(sims), ...); };
+    if (gates == GateSet::clifford)
+    {
+        Array ctl = this->make_array({a});
+        // clang-format off
+        switch (std::uniform_int_distribution<int>(0, 15)(rng))
+        {
+            case 0: apply([&](auto& s) { s.h(a); }); break;
+            case 1: apply([&](auto& s) { s.s(a); }); break;
+            case 2: apply([&](auto& s) { s.s_adj(a); }); break;
+            case 3: apply([&](auto& s) { s.x(a); }); break;
+            case 4: apply([&](auto& s) { s.y(a); }); break;
+            case 5: apply([&](auto& s) { s.z(a); }); break;
+            case 6: apply([&](auto& s) { s.cnot(a, b); }); break;
+            case 7: apply([&](auto& s) { s.cz(a, b); }); break;
+            case 8: apply([&](auto& s) { s.cy(a, b); }); break;
+            case 9: apply([&](auto& s) { s.swap(a, b); }); break;
+            case 10: apply([&](auto& s) { s.rx(theta, a); }); break;
+            case 11: apply([&](auto& s) { s.ry(theta, a); }); break;
+            case 12: apply([&](auto& s) { s.rz(theta, a); }); break;
+            case 13: apply([&](auto& s) { s.x(ctl, b); }); break;
+            case 14: apply([&](auto& s) { s.y(ctl, b); }); break;
+            case 15: apply([&](auto& s) { s.z(ctl, b); }); break;
+        }
+        // clang-format on
+        return;
+    }
+
+    Array ctl = this->make_array({a});
+    Array ctl2 = this->make_array({a, c});
+    Array paulis = this->make_array({Pauli::x, Pauli::y, Pauli::z});
+    Array qubits = this->make_array({b, c, a});
+    RotationArgs rot{theta, b};
+    detail::PauliRotationArgs prot{Pauli::i, theta, b};
+    detail::ExpArgs exp_args{this->make_array({Pauli::y, Pauli::x}),
+                             theta,
+                             this->make_array({c, b})};
+    int const num_gates = gates == GateSet::universal ? 27 : 29;
+    // clang-format off
+    switch (std::uniform_int_distribution<int>(0, num_gates - 1)(rng))
+    {
+        case 0: apply([&](auto& s) { s.h(a); }); break;
+        case 1: apply([&](auto& s) { s.x(a); }); break;
+        case 2: apply([&](auto& s) { s.z(a); }); break;
+        case 3: apply([&](auto& s) { s.s(a); }); break;
+        case 4: apply([&](auto& s) { s.s_adj(a); }); break;
+        case 5: apply([&](auto& s) { s.t(a); }); break;
+        case 6: apply([&](auto& s) { s.t_adj(a); }); break;
+        case 7: apply([&](auto& s) { s.rx(theta, a); }); break;
+        case 8: apply([&](auto& s) { s.ry(theta, a); }); break;
+        case 9: apply([&](auto& s) { s.rz(theta, a); }); break;
+        case 10: apply([&](auto& s) { s.r(Pauli::y, theta, a); }); break;
+        case 11: apply([&](auto& s) { s.cnot(a, b); }); break;
+        case 12: apply([&](auto& s) { s.cy(a, b); }); break;
+        case 13: apply([&](auto& s) { s.swap(a, b); }); break;
+        case 14: apply([&](auto& s) { s.rxx(theta, a, b); }); break;
+        case 15: apply([&](auto& s) { s.ryy(theta, a, b); }); break;
+        case 16: apply([&](auto& s) { s.rzz(theta, a, b); }); break;
+        case 17: apply([&](auto& s) { s.ccx(a, b, c); }); break;
+        case 18: apply([&](auto& s) { s.exp(paulis, theta, qubits); }); break;
+        case 19: apply([&](auto& s) { s.ry(ctl, &rot); }); break;
+        case 20: apply([&](auto& s) { s.rz(ctl, &rot); }); break;
+        case 21: apply([&](auto& s) { s.exp(ctl, &exp_args); }); break;
+        case 22: apply([&](auto& s) { s.r(ctl, &prot); }); break;
+        case 23: apply([&](auto& s) { s.s(ctl, b); }); break;
+        case 24: apply([&](auto& s) { s.s_adj(ctl, b); }); break;
+        case 25: apply([&](auto& s) { s.y(ctl, b); }); break;
+        case 26: apply([&](auto& s) { s.h(ctl, b); }); break;
+        case 27: apply([&](auto& s) { s.x(ctl2, b); }); break;
+        case 28: apply([&](auto& s) { s.rz(ctl2, &rot); }); break;
+    }
+    // clang-format on
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
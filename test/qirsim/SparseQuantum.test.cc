@@ -0,0 +1,200 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/SparseQuantum.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/SparseQuantum.hh"
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <string>
+
+#include "QuantumTestBase.hh"
+#include "qiree/Assert.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree/Types.hh"
+#include "qirsim/HistogramRuntime.hh"
+#include "qirsim/StateVectorQuantum.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+class SparseQuantumTest : public QuantumTestBase
+{
+  protected:
+    using Options = SparseQuantum::Options;
+
+    //! Compare the stored amplitudes with a state vector
+    static void expect_state(StateVectorQuantum const& expected,
+                             SparseQuantum const& actual)
+    {
+        auto const& psi = expected.state();
+        size_type num_nonzero = 0;
+        for (size_type k = 0; k < psi.size(); ++k)
+        {
+            auto amp = actual.amplitude(k);
+            EXPECT_NEAR(psi[k].real(), amp.real(), 1e-12) << k;
+            EXPECT_NEAR(psi[k].imag(), amp.imag(), 1e-12) << k;
+            num_nonzero += std::norm(psi[k]) > 1e-20;
+        }
+        EXPECT_EQ(num_nonzero, actual.support());
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(SparseQuantumTest, random_circuits)
+{
+    constexpr size_type num_qubits = 5;
+    std::mt19937 rng(12345);
+
+    SparseQuantum sp;
+    StateVectorQuantum sv;
+    for (int circuit = 0; circuit < 10; ++circuit)
+    {
+        sp.set_up(attrs(num_qubits, 0));
+        sv.set_up(attrs(num_qubits, 0));
+        for (int i = 0; i < 40; ++i)
+        {
+            this->apply_random_gate(
+                GateSet::multi_controlled, num_qubits, rng, sp, sv);
+        }
+        expect_state(sv, sp);
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SparseQuantumTest, many_qubits)
+{
+    // Copy three random bits to every other qubit of a 60-qubit register
+    constexpr size_type num_qubits = 60;
+    SparseQuantum sim;
+    sim.set_up(attrs(num_qubits, 0));
+    for (size_type i = 0; i < 3; ++i)
+    {
+        sim.h(Q{i});
+    }
+    for (size_type i = 3; i < num_qubits; ++i)
+    {
+        sim.cnot(Q{i % 3}, Q{i});
+    }
+    sim.t(make_array({Q{0}, Q{1}}), Q{59});
+    EXPECT_EQ(8, sim.support());
+    EXPECT_NEAR(0.5, sim.probability_one(Q{59}), 1e-12);
+    auto all_ones = ~SparseQuantum::Key{0} >> (64 - num_qubits);
+    auto amp = sim.amplitude(all_ones);
+    EXPECT_NEAR(0.25, amp.real(), 1e-12);
+    EXPECT_NEAR(0.25, amp.imag(), 1e-12);
+
+    // Uncomputing cancels every amplitude but one
+    sim.t_adj(make_array({Q{0}, Q{1}}), Q{59});
+    for (size_type i = num_qubits; i-- > 3;)
+    {
+        sim.cnot(Q{i % 3}, Q{i});
+    }
+    for (size_type i = 0; i < 3; ++i)
+    {
+        sim.h(Q{i});
+    }
+    EXPECT_EQ(1, sim.support());
+    EXPECT_EQ(8, sim.peak_support());
+    EXPECT_NEAR(1, std::abs(sim.amplitude(0)), 1e-12);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SparseQuantumTest, measurement)
+{
+    SparseQuantum sim;
+    for (int i = 0; i < 20; ++i)
+    {
+        sim.set_up(attrs(3, 2));
+        sim.h(Q{0});
+        sim.cnot(Q{0}, Q{1});
+
+        // Bell state is a +1 eigenstate of XX
+        auto xx = sim.measure(make_array({Pauli::x, Pauli::x}),
+                              make_array({Q{0}, Q{1}}));
+        EXPECT_EQ(QState::zero, sim.read_result(xx));
+        EXPECT_EQ(2, sim.support());
+
+        sim.mz(Q{0}, R{0});
+        sim.mz(Q{1}, R{1});
+        EXPECT_EQ(sim.read_result(R{0}), sim.read_result(R{1}));
+        EXPECT_EQ(1, sim.support());
+
+        // Z measurement of |+> collapses randomly, and reset restores |0>
+        sim.h(Q{2});
+        auto z = sim.measure(make_array({Pauli::z}), make_array({Q{2}}));
+        EXPECT_NEAR(sim.read_result(z) == QState::one ? 1 : 0,
+                    sim.probability_one(Q{2}),
+                    1e-12);
+        sim.reset(Q{2});
+        auto r = sim.mresetz(Q{0});
+        EXPECT_EQ(sim.read_result(R{0}), sim.read_result(r));
+        EXPECT_EQ(0, sim.probability_one(Q{0}));
+        EXPECT_EQ(0, sim.probability_one(Q{2}));
+        EXPECT_EQ(1, sim.support());
+    }
+    EXPECT_THROW(sim.h(Q{3}), RuntimeError);
+    EXPECT_THROW(sim.read_result(R{5}), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SparseQuantumTest, support_limit)
+{
+    Options opts;
+    opts.max_support = 100;
+    SparseQuantum sim{opts};
+    sim.set_up(attrs(8, 0));
+    for (size_type i = 0; i < 6; ++i)
+    {
+        sim.h(Q{i});
+    }
+    EXPECT_EQ(64, sim.support());
+
+    std::string msg;
+    try
+    {
+        sim.h(Q{6});
+    }
+    catch (RuntimeError const& e)
+    {
+        msg = e.what();
+    }
+    EXPECT_NE(std::string::npos, msg.find("128 nonzero amplitudes after "
+                                          "quantum instruction 'h.body'"))
+        << msg;
+
+    opts.max_qubits = 64;
+    EXPECT_THROW(SparseQuantum{opts}, RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SparseQuantumTest, executor)
+{
+    // The simulator can be used through the dynamically dispatched interface
+    Executor execute{Module{this->test_data_path("bell.ll")}};
+    SparseQuantum sim;
+    HistogramRuntime rt{sim};
+    for (int i = 0; i < 256; ++i)
+    {
+        execute(sim, rt);
+        rt.end_shot();
+    }
+
+    ASSERT_EQ(1, rt.groups().size());
+    auto const& counts = rt.groups().front().counts;
+    EXPECT_EQ(2, counts.size());
+    EXPECT_LT(96, counts.at("00"));
+    EXPECT_LT(96, counts.at("11"));
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
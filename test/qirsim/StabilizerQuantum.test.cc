@@ -0,0 +1,303 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/StabilizerQuantum.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/StabilizerQuantum.hh"
+
+#include <complex>
+#include <random>
+
+#include "QuantumTestBase.hh"
+#include "qiree/Assert.hh"
+#include "qiree/DirectExecutor.hh"
+#include "qiree/Module.hh"
+#include "qiree/Types.hh"
+#include "qirsim/HistogramRuntime.hh"
+#include "qirsim/StateVectorQuantum.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+constexpr double pi = 3.141592653589793;
+
+class StabilizerQuantumTest : public QuantumTestBase
+{
+  protected:
+    static std::vector<std::string> stabilizers(StabilizerQuantum const& sim)
+    {
+        std::vector<std::string> result;
+        for (size_type i = 0; i < sim.num_qubits(); ++i)
+        {
+            result.push_back(sim.stabilizer(i));
+        }
+        return result;
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(StabilizerQuantumTest, single_qubit)
+{
+    StabilizerQuantum sim;
+    auto stabilizer_after = [&sim](auto&& apply) {
+        sim.set_up(attrs(1, 0));
+        apply();
+        return sim.stabilizer(0);
+    };
+
+    EXPECT_EQ("+Z", stabilizer_after([] {}));
+    EXPECT_EQ("+X", stabilizer_after([&] { sim.h(Q{0}); }));
+    EXPECT_EQ("+Y", stabilizer_after([&] {
+                  sim.h(Q{0});
+                  sim.s(Q{0});
+              }));
+    EXPECT_EQ("-Y", stabilizer_after([&] {
+                  sim.h(Q{0});
+                  sim.s_adj(Q{0});
+              }));
+    EXPECT_EQ("-Z", stabilizer_after([&] { sim.x(Q{0}); }));
+    EXPECT_EQ("-Z", stabilizer_after([&] { sim.y(Q{0}); }));
+    EXPECT_EQ("+Z", stabilizer_after([&] { sim.z(Q{0}); }));
+    EXPECT_EQ("-X", stabilizer_after([&] {
+                  sim.h(Q{0});
+                  sim.z(Q{0});
+              }));
+    EXPECT_EQ("-Y", stabilizer_after([&] { sim.rx(pi / 2, Q{0}); }));
+    EXPECT_EQ("+X", stabilizer_after([&] { sim.ry(pi / 2, Q{0}); }));
+    EXPECT_EQ("-X", stabilizer_after([&] { sim.ry(-pi / 2, Q{0}); }));
+    EXPECT_EQ("-Z", stabilizer_after([&] { sim.r(Pauli::y, pi, Q{0}); }));
+    EXPECT_EQ("+Y", stabilizer_after([&] {
+                  sim.h(Q{0});
+                  sim.rz(pi / 2, Q{0});
+              }));
+    EXPECT_EQ("-Y", stabilizer_after([&] {
+                  sim.h(Q{0});
+                  sim.r_adj(Pauli::z, pi / 2, Q{0});
+              }));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StabilizerQuantumTest, bell)
+{
+    StabilizerQuantum sim;
+    int num_ones = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        sim.set_up(attrs(2, 2));
+        sim.h(Q{0});
+        sim.cnot(Q{0}, Q{1});
+        EXPECT_EQ((std::vector<std::string>{"+XX", "+ZZ"}), stabilizers(sim));
+
+        sim.mz(Q{0}, R{0});
+        sim.mz(Q{1}, R{1});
+        EXPECT_EQ(sim.read_result(R{0}), sim.read_result(R{1}));
+        num_ones += (sim.read_result(R{0}) == QState::one);
+        sim.tear_down();
+    }
+    EXPECT_LT(25, num_ones);
+    EXPECT_GT(75, num_ones);
+
+    // Joint measurements of the Bell state are deterministic
+    sim.set_up(attrs(2, 0));
+    sim.h(Q{0});
+    sim.cnot(Q{0}, Q{1});
+    Array qubits = this->make_array({Q{0}, Q{1}});
+    auto measure = [&](Pauli p) {
+        return sim.read_result(sim.measure(this->make_array({p, p}), qubits));
+    };
+    EXPECT_EQ(QState::zero, measure(Pauli::x));
+    EXPECT_EQ(QState::one, measure(Pauli::y));
+    EXPECT_EQ(QState::zero, measure(Pauli::z));
+    EXPECT_EQ((std::vector<std::string>{"+XX", "+ZZ"}), stabilizers(sim));
+    EXPECT_EQ(3, sim.num_results());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StabilizerQuantumTest, ghz)
+{
+    constexpr size_type num_qubits = 1000;
+    StabilizerQuantum sim;
+    std::vector<int> counts(2);
+    for (int shot = 0; shot < 8; ++shot)
+    {
+        sim.set_up(attrs(num_qubits, num_qubits));
+        sim.h(Q{0});
+        for (size_type i = 1; i < num_qubits; ++i)
+        {
+            sim.cnot(Q{i - 1}, Q{i});
+        }
+        sim.mz(Q{num_qubits / 2}, R{0});
+        auto expected = sim.read_result(R{0});
+        for (size_type i = 0; i < num_qubits; ++i)
+        {
+            sim.mz(Q{i}, R{i});
+            ASSERT_EQ(expected, sim.read_result(R{i})) << i;
+        }
+        ++counts[static_cast<int>(expected)];
+    }
+    EXPECT_LT(0, counts[0]);
+    EXPECT_LT(0, counts[1]);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StabilizerQuantumTest, ghz_superposition)
+{
+    // Measure each qubit of a GHZ state in the X or Y basis: every outcome is
+    // random, but the parity is fixed by the stabilizer XXXX (or -YYXX)
+    constexpr size_type num_qubits = 4;
+    StabilizerQuantum sim;
+    for (bool y_basis : {false, true})
+    {
+        std::vector<int> counts(2);
+        for (int shot = 0; shot < 32; ++shot)
+        {
+            sim.set_up(attrs(num_qubits, num_qubits));
+            sim.h(Q{0});
+            for (size_type i = 1; i < num_qubits; ++i)
+            {
+                sim.cnot(Q{i - 1}, Q{i});
+            }
+            for (size_type i = 0; i < num_qubits; ++i)
+            {
+                if (y_basis && i < 2)
+                {
+                    sim.s_adj(Q{i});
+                }
+                sim.h(Q{i});
+            }
+
+            int parity = 0;
+            for (size_type i = 0; i < num_qubits; ++i)
+            {
+                sim.mz(Q{i}, R{i});
+                auto value = sim.read_result(R{i});
+                parity ^= static_cast<int>(value);
+                ++counts[static_cast<int>(value)];
+            }
+            EXPECT_EQ(y_basis ? 1 : 0, parity) << "shot " << shot;
+            sim.tear_down();
+        }
+        EXPECT_LT(0, counts[0]);
+        EXPECT_LT(0, counts[1]);
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StabilizerQuantumTest, reset)
+{
+    StabilizerQuantum sim;
+    sim.set_up(attrs(2, 0));
+    sim.h(Q{0});
+    sim.reset(Q{0});
+    EXPECT_EQ("+ZI", sim.stabilizer(0));
+
+    sim.x(Q{1});
+    sim.swap(Q{0}, Q{1});
+    EXPECT_EQ((std::vector<std::string>{"+IZ", "-ZI"}), stabilizers(sim));
+    auto r = sim.mresetz(Q{0});
+    EXPECT_EQ(QState::one, sim.read_result(r));
+    r = sim.m(Q{0});
+    EXPECT_EQ(QState::zero, sim.read_result(r));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StabilizerQuantumTest, non_clifford)
+{
+    StabilizerQuantum sim;
+    sim.set_up(attrs(3, 0));
+    EXPECT_THROW(sim.t(Q{0}), RuntimeError);
+    EXPECT_THROW(sim.t_adj(Q{0}), RuntimeError);
+    EXPECT_THROW(sim.ccx(Q{0}, Q{1}, Q{2}), RuntimeError);
+    EXPECT_THROW(sim.rx(0.1, Q{0}), RuntimeError);
+    EXPECT_THROW(sim.rz(pi / 4, Q{0}), RuntimeError);
+    EXPECT_THROW(sim.x(this->make_array({Q{0}, Q{1}}), Q{2}), RuntimeError);
+    EXPECT_THROW(sim.h(this->make_array({Q{0}}), Q{2}), RuntimeError);
+
+    // Singly controlled Paulis are Clifford
+    sim.x(Q{0});
+    sim.x(this->make_array({Q{0}}), Q{1});
+    sim.z(this->make_array<Qubit>({}), Q{2});
+    EXPECT_EQ((std::vector<std::string>{"-ZII", "+ZZI", "+IIZ"}),
+              stabilizers(sim));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StabilizerQuantumTest, random_clifford)
+{
+    // Check that the state vector is stabilized by the tableau generators
+    constexpr size_type num_qubits = 5;
+    std::mt19937 rng(12345);
+
+    StabilizerQuantum stab;
+    StateVectorQuantum sv;
+    for (int circuit = 0; circuit < 20; ++circuit)
+    {
+        stab.set_up(attrs(num_qubits, 0));
+        sv.set_up(attrs(num_qubits, 0));
+        for (int i = 0; i < 40; ++i)
+        {
+            this->apply_random_gate(
+                GateSet::clifford, num_qubits, rng, stab, sv);
+        }
+
+        auto const& psi = sv.state();
+        for (size_type i = 0; i < num_qubits; ++i)
+        {
+            // Apply the signed Pauli string to the state vector
+            std::string gen = stab.stabilizer(i);
+            std::uint64_t x = 0, z = 0;
+            for (size_type j = 0; j < num_qubits; ++j)
+            {
+                char c = gen[j + 1];
+                x |= std::uint64_t(c == 'X' || c == 'Y') << j;
+                z |= std::uint64_t(c == 'Z' || c == 'Y') << j;
+            }
+            std::complex<double> phase = gen[0] == '-' ? -1 : 1;
+            for (std::uint64_t m = x & z; m; m &= m - 1)
+            {
+                phase *= std::complex<double>{0, 1};
+            }
+            for (std::uint64_t k = 0; k < psi.size(); ++k)
+            {
+                auto sign = __builtin_parityll(k & z) ? -1.0 : 1.0;
+                auto actual = phase * sign * psi[k];
+                auto expected = psi[k ^ x];
+                ASSERT_NEAR(expected.real(), actual.real(), 1e-12)
+                    << "circuit " << circuit << ", generator " << gen;
+                ASSERT_NEAR(expected.imag(), actual.imag(), 1e-12)
+                    << "circuit " << circuit << ", generator " << gen;
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StabilizerQuantumTest, teleport)
+{
+    DirectExecutor<StabilizerQuantum, HistogramRuntime> execute{
+        Module{this->test_data_path("teleport.ll")}};
+    StabilizerQuantum sim;
+    HistogramRuntime rt{sim};
+    for (int i = 0; i < 64; ++i)
+    {
+        execute(sim, rt);
+        rt.end_shot();
+    }
+
+    ASSERT_EQ(1, rt.groups().size());
+    auto const& counts = rt.groups().front().counts;
+    EXPECT_EQ(4, counts.size());
+    for (auto const& [bits, count] : counts)
+    {
+        EXPECT_EQ('0', bits[2]) << bits;
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
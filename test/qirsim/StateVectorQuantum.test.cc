@@ -0,0 +1,435 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/StateVectorQuantum.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/StateVectorQuantum.hh"
+
+#include <cmath>
+
+#include "QuantumTestBase.hh"
+#include "qiree/Assert.hh"
+#include "qiree/Circuit.hh"
+#include "qiree/Types.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+constexpr double pi = 3.141592653589793;
+constexpr double sqrt_half = 0.70710678118654752440;
+
+class StateVectorQuantumTest : public QuantumTestBase
+{
+  protected:
+    using Complex = StateVectorQuantum::Complex;
+
+    //! Create a QIR array of qubits
+    Array qubits(std::initializer_list<Q> values)
+    {
+        return this->make_array(values);
+    }
+
+    //! Create a QIR array of Paulis
+    Array paulis(std::initializer_list<Pauli> values)
+    {
+        return this->make_array(values);
+    }
+
+    //! Compare the state vector with expected amplitudes
+    static void expect_state(std::vector<Complex> const& expected,
+                             StateVectorQuantum const& sim)
+    {
+        auto const& actual = sim.state();
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_type i = 0; i < expected.size(); ++i)
+        {
+            EXPECT_NEAR(expected[i].real(), actual[i].real(), 1e-12) << i;
+            EXPECT_NEAR(expected[i].imag(), actual[i].imag(), 1e-12) << i;
+        }
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(StateVectorQuantumTest, bell)
+{
+    StateVectorQuantum sim;
+    sim.set_up(attrs(2, 2));
+    EXPECT_EQ(2, sim.num_qubits());
+    EXPECT_EQ(2, sim.num_results());
+
+    sim.h(Q{0});
+    sim.cnot(Q{0}, Q{1});
+    expect_state({sqrt_half, 0, 0, sqrt_half}, sim);
+    EXPECT_NEAR(0.5, sim.probability_one(Q{1}), 1e-12);
+
+    sim.mz(Q{0}, R{0});
+    sim.mz(Q{1}, R{1});
+    EXPECT_EQ(sim.read_result(R{0}), sim.read_result(R{1}));
+    sim.tear_down();
+
+    // Repeated shots sample both outcomes
+    int num_ones = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        sim.set_up(attrs(2, 2));
+        sim.h(Q{0});
+        sim.cnot(Q{0}, Q{1});
+        sim.mz(Q{0}, R{0});
+        sim.mz(Q{1}, R{1});
+        EXPECT_EQ(sim.read_result(R{0}), sim.read_result(R{1}));
+        num_ones += (sim.read_result(R{0}) == QState::one);
+        sim.tear_down();
+    }
+    EXPECT_LT(25, num_ones);
+    EXPECT_GT(75, num_ones);
+
+    EXPECT_THROW(sim.h(Q{2}), RuntimeError);
+    EXPECT_THROW(sim.read_result(R{2}), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StateVectorQuantumTest, single_qubit)
+{
+    StateVectorQuantum sim;
+    sim.set_up(attrs(1, 0));
+
+    sim.x(Q{0});
+    expect_state({0, 1}, sim);
+    sim.y(Q{0});
+    expect_state({{0, -1}, 0}, sim);
+    sim.z(Q{0});
+    sim.s(Q{0});
+    sim.t(Q{0});
+    sim.t_adj(Q{0});
+    sim.s_adj(Q{0});
+    sim.z(Q{0});
+    expect_state({{0, -1}, 0}, sim);
+
+    sim.set_up(attrs(1, 0));
+    sim.h(Q{0});
+    sim.t(Q{0});
+    sim.t(Q{0});
+    sim.s_adj(Q{0});
+    sim.h(Q{0});
+    expect_state({1, 0}, sim);
+
+    // rx(pi/2) = exp(-i pi/4 X)
+    sim.rx(pi / 2, Q{0});
+    expect_state({sqrt_half, {0, -sqrt_half}}, sim);
+    sim.r(Pauli::x, -pi / 2, Q{0});
+    expect_state({1, 0}, sim);
+
+    sim.ry(pi / 3, Q{0});
+    EXPECT_NEAR(0.25, sim.probability_one(Q{0}), 1e-12);
+    sim.r_adj(Pauli::y, pi / 3, Q{0});
+    expect_state({1, 0}, sim);
+
+    sim.rz(pi, Q{0});
+    expect_state({{0, -1}, 0}, sim);
+    // Identity rotation is a global phase
+    sim.r(Pauli::i, pi, Q{0});
+    expect_state({-1, 0}, sim);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StateVectorQuantumTest, controlled)
+{
+    StateVectorQuantum sim;
+    sim.set_up(attrs(3, 0));
+    sim.x(Q{0});
+    sim.ccx(Q{0}, Q{1}, Q{2});
+    expect_state({0, 1, 0, 0, 0, 0, 0, 0}, sim);
+    sim.x(this->qubits({Q{0}}), Q{1});
+    sim.ccx(Q{0}, Q{1}, Q{2});
+    expect_state({0, 0, 0, 0, 0, 0, 0, 1}, sim);
+    sim.swap(Q{0}, Q{2});
+    sim.cz(Q{1}, Q{0});
+    expect_state({0, 0, 0, 0, 0, 0, 0, -1}, sim);
+    sim.z(this->qubits({Q{1}, Q{2}}), Q{0});
+    expect_state({0, 0, 0, 0, 0, 0, 0, 1}, sim);
+
+    // Controlled rotations only act when all controls are set
+    sim.set_up(attrs(2, 0));
+    RotationArgs args{pi, Q{1}};
+    sim.rx(this->qubits({Q{0}}), &args);
+    expect_state({1, 0, 0, 0}, sim);
+    sim.h(Q{0});
+    sim.ry(this->qubits({Q{0}}), &args);
+    expect_state({sqrt_half, 0, 0, sqrt_half}, sim);
+
+    EXPECT_THROW(sim.cnot(Q{1}, Q{1}), RuntimeError);
+    EXPECT_THROW(sim.x(this->qubits({Q{0}}), Q{0}), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StateVectorQuantumTest, pauli)
+{
+    StateVectorQuantum sim;
+    sim.set_up(attrs(2, 0));
+    sim.h(Q{0});
+    sim.cnot(Q{0}, Q{1});
+
+    // rzz(theta) = exp(-i theta/2 ZZ), which is a phase on the Bell state
+    sim.rzz(pi / 2, Q{0}, Q{1});
+    Complex const phase = std::polar(sqrt_half, -pi / 4);
+    expect_state({phase, 0, 0, phase}, sim);
+    sim.exp(this->paulis({Pauli::z, Pauli::z}),
+            pi / 4,
+            this->qubits({Q{1}, Q{0}}));
+    expect_state({sqrt_half, 0, 0, sqrt_half}, sim);
+
+    // Bell state is an eigenstate of XX (+1) and YY (-1)
+    sim.rxx(pi / 3, Q{0}, Q{1});
+    sim.ryy(pi / 3, Q{0}, Q{1});
+    expect_state({sqrt_half, 0, 0, sqrt_half}, sim);
+
+    // exp(i pi/2 XI) = i X
+    sim.exp_adj(this->paulis({Pauli::x}), -pi / 2, this->qubits({Q{0}}));
+    expect_state({0, {0, sqrt_half}, {0, sqrt_half}, 0}, sim);
+
+    // Joint measurements don't disturb eigenstates
+    auto r = sim.measure(this->paulis({Pauli::x, Pauli::x}),
+                         this->qubits({Q{0}, Q{1}}));
+    EXPECT_EQ(QState::zero, sim.read_result(r));
+    r = sim.measure(this->paulis({Pauli::z, Pauli::z}),
+                    this->qubits({Q{0}, Q{1}}));
+    EXPECT_EQ(QState::one, sim.read_result(r));
+    expect_state({0, {0, sqrt_half}, {0, sqrt_half}, 0}, sim);
+
+    // Measuring a single qubit collapses the state
+    r = sim.measure(this->paulis({Pauli::z}), this->qubits({Q{0}}));
+    EXPECT_EQ(2, r.value);
+    EXPECT_NEAR(sim.read_result(r) == QState::one ? 1 : 0,
+                sim.probability_one(Q{0}),
+                1e-12);
+
+    EXPECT_THROW(sim.exp(this->paulis({Pauli::x}),
+                         0.1,
+                         this->qubits({Q{0}, Q{1}})),
+                 RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StateVectorQuantumTest, reset)
+{
+    StateVectorQuantum sim{[] {
+        StateVectorQuantum::Options opts;
+        opts.seed = 12345;
+        opts.max_qubits = 3;
+        return opts;
+    }()};
+    EXPECT_THROW(sim.set_up(attrs(4, 0)), RuntimeError);
+
+    sim.set_up(attrs(2, 0));
+    sim.h(Q{0});
+    sim.reset(Q{0});
+    expect_state({1, 0, 0, 0}, sim);
+
+    sim.x(Q{1});
+    auto r = sim.mresetz(Q{1});
+    EXPECT_EQ(QState::one, sim.read_result(r));
+    expect_state({1, 0, 0, 0}, sim);
+    r = sim.m(Q{1});
+    EXPECT_EQ(QState::zero, sim.read_result(r));
+    EXPECT_EQ(2, sim.num_results());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StateVectorQuantumTest, large)
+{
+    // Exercise the parallel kernels
+    constexpr size_type num_qubits = 18;
+    StateVectorQuantum sim;
+    sim.set_up(attrs(num_qubits, num_qubits));
+    sim.h(Q{0});
+    for (size_type i = 1; i < num_qubits; ++i)
+    {
+        sim.cnot(Q{i - 1}, Q{i});
+    }
+    EXPECT_NEAR(sqrt_half, sim.state().back().real(), 1e-12);
+    EXPECT_NEAR(0.5, sim.probability_one(Q{num_qubits - 1}), 1e-12);
+
+    // Sample the GHZ state without collapsing it
+    sim.defer_measurements(true);
+    for (size_type i = 0; i < num_qubits; ++i)
+    {
+        sim.mz(Q{i}, R{i});
+    }
+    int num_ones{0};
+    for (int shot = 0; shot < 100; ++shot)
+    {
+        sim.resample();
+        auto expected = sim.read_result(R{0});
+        for (size_type i = 1; i < num_qubits; ++i)
+        {
+            EXPECT_EQ(expected, sim.read_result(R{i}));
+        }
+        num_ones += (expected == QState::one);
+    }
+    EXPECT_LT(25, num_ones);
+    EXPECT_GT(75, num_ones);
+    EXPECT_NEAR(sqrt_half, sim.state().back().real(), 1e-12);
+    sim.defer_measurements(false);
+
+    sim.mz(Q{5}, R{5});
+    auto expected = sim.read_result(R{5});
+    for (size_type i = 0; i < num_qubits; ++i)
+    {
+        sim.mz(Q{i}, R{i});
+        EXPECT_EQ(expected, sim.read_result(R{i}));
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StateVectorQuantumTest, deferred)
+{
+    StateVectorQuantum sim;
+    sim.defer_measurements(true);
+    EXPECT_TRUE(sim.deferred_measurements());
+    sim.set_up(attrs(3, 3));
+    sim.h(Q{0});
+    sim.ry(pi / 3, Q{2});  // P(1) = 1/4
+    sim.mz(Q{2}, R{0});
+    sim.mz(Q{0}, R{1});
+    sim.mz(Q{1}, R{2});
+
+    // Measurements don't change the state
+    EXPECT_NEAR(0.5, sim.probability_one(Q{0}), 1e-12);
+    EXPECT_NEAR(0.25, sim.probability_one(Q{2}), 1e-12);
+
+    constexpr int num_shots = 4000;
+    int counts[2][2] = {{0, 0}, {0, 0}};
+    for (int shot = 0; shot < num_shots; ++shot)
+    {
+        if (shot > 0)
+        {
+            sim.resample();
+        }
+        EXPECT_EQ(QState::zero, sim.read_result(R{2}));
+        ++counts[sim.read_result(R{0}) == QState::one]
+                [sim.read_result(R{1}) == QState::one];
+    }
+    EXPECT_NEAR(0.375, counts[0][0] / double(num_shots), 0.03);
+    EXPECT_NEAR(0.375, counts[0][1] / double(num_shots), 0.03);
+    EXPECT_NEAR(0.125, counts[1][0] / double(num_shots), 0.03);
+    EXPECT_NEAR(0.125, counts[1][1] / double(num_shots), 0.03);
+
+    // A new execution samples the new state
+    sim.set_up(attrs(1, 1));
+    sim.x(Q{0});
+    sim.mz(Q{0}, R{0});
+    for (int shot = 0; shot < 10; ++shot)
+    {
+        sim.resample();
+        EXPECT_EQ(QState::one, sim.read_result(R{0}));
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StateVectorQuantumTest, circuit)
+{
+    // Fused gates match the instructions applied one at a time
+    Circuit c;
+    c.push_back({GateOp::h, {}, {0}});
+    c.push_back({GateOp::x, {0}, {1}});
+    c.push_back({GateOp::ry, {}, {2}, {}, 0.5});
+    c.push_back({GateOp::rzz, {}, {1, 2}, {}, 0.25});
+    c.push_back(
+        {GateOp::measure_pauli, {}, {0, 1}, {Pauli::z, Pauli::z}, 0, R{2}});
+    StateVectorQuantum direct;
+    direct.set_up(attrs(3, 2));
+    direct.h(Q{0});
+    direct.cnot(Q{0}, Q{1});
+    direct.ry(0.5, Q{2});
+    direct.rzz(0.25, Q{1}, Q{2});
+
+    for (size_type k : {0, 1, 2, 3})
+    {
+        StateVectorQuantum::Options opts;
+        opts.fusion_qubits = k;
+        StateVectorQuantum sim{opts};
+        sim.set_up(attrs(3, 2));
+        sim.apply(c);
+        expect_state(direct.state(), sim);
+        EXPECT_EQ(QState::zero, sim.read_result(R{2}));
+    }
+
+    // Measurements store results and collapse the state
+    c.clear();
+    c.push_back({GateOp::h, {}, {0}});
+    c.push_back({GateOp::x, {0}, {1}});
+    c.push_back({GateOp::measure_z, {}, {0}, {}, 0, R{1}});
+    c.push_back({GateOp::reset, {}, {0}});
+    StateVectorQuantum::Options opts;
+    opts.fusion_qubits = 2;
+    StateVectorQuantum sim{opts};
+    sim.set_up(attrs(2, 2));
+    sim.apply(c);
+    EXPECT_EQ(3, sim.fused().steps.size());
+    auto one = sim.read_result(R{1});
+    EXPECT_NEAR(one == QState::one ? 1 : 0, sim.probability_one(Q{1}), 1e-12);
+    EXPECT_NEAR(0, sim.probability_one(Q{0}), 1e-12);
+
+    // The circuit must fit in the state
+    c.push_back({GateOp::x, {}, {2}});
+    EXPECT_THROW(sim.apply(c), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StateVectorQuantumTest, branching)
+{
+    StateVectorQuantum sim;
+    sim.start_branching(1000);
+    int num_executions{0};
+    size_type num_shots{0};
+    size_type num_ones{0};
+    while (sim.next_branch())
+    {
+        // Feed forward a measurement
+        sim.set_up(attrs(3, 3));
+        sim.h(Q{0});
+        sim.mz(Q{0}, R{0});
+        if (sim.read_result(R{0}) == QState::one)
+        {
+            sim.x(Q{1});
+        }
+        sim.ry(pi / 3, Q{2});
+        sim.mz(Q{1}, R{1});
+        sim.mz(Q{2}, R{2});
+        EXPECT_EQ(sim.read_result(R{0}), sim.read_result(R{1}));
+        size_type const index
+            = (sim.read_result(R{0}) == QState::one ? 0b011 : 0)
+              | (sim.read_result(R{2}) == QState::one ? 0b100 : 0);
+        EXPECT_NEAR(1.0, std::norm(sim.state()[index]), 1e-12);
+
+        ++num_executions;
+        num_shots += sim.branch_shots();
+        if (sim.read_result(R{2}) == QState::one)
+        {
+            num_ones += sim.branch_shots();
+        }
+    }
+    // One execution per distinct outcome
+    EXPECT_EQ(4, num_executions);
+    EXPECT_EQ(1000, num_shots);
+    EXPECT_NEAR(250, num_ones, 50);
+
+    // Replaying a branch must reach the same measurements
+    sim.start_branching(1000);
+    ASSERT_TRUE(sim.next_branch());
+    sim.set_up(attrs(1, 1));
+    sim.h(Q{0});
+    sim.mz(Q{0}, R{0});
+    ASSERT_TRUE(sim.next_branch());
+    sim.set_up(attrs(1, 1));
+    EXPECT_THROW(sim.next_branch(), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree